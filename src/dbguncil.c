@@ -697,6 +697,11 @@ int pinstrdump(const byte **d, byte b) {
         pdump_instr("NDICT");
         pdump_reg(d);
         break;
+    case UNC_I_NDICTN:
+        pdump_instr("NDICTN");
+        pdump_reg(d);
+        pdump_us(d);
+        break;
     case UNC_I_LSPRS:
         pdump_instr("LSPRS");
         pdump_reg(d);
@@ -75,13 +75,26 @@ int unc0_initarrayfromcat(Unc_View *w, Unc_Array *s,
         s->data = TMALLOC(Unc_Value, &w->world->alloc, Unc_AllocArray, n);
         if (!s->data) return UNCIL_ERR_MEM;
         for (i = 0; i < an; ++i)
-            VCOPY(w, &s->data[i], &av[i]);
+            VIMPOSE(w, &s->data[i], &av[i]);
         for (i = 0; i < bn; ++i)
-            VCOPY(w, &s->data[an + i], &bv[i]);
+            VIMPOSE(w, &s->data[an + i], &bv[i]);
     }
     return UNC_LOCKINITL(s->lock);
 }
 
+/* init empty array with room for n values */
+int unc0_initarrayc(Unc_View *w, Unc_Array *a, Unc_Size n) {
+    a->size = 0;
+    a->capacity = n;
+    if (!n) {
+        a->data = NULL;
+    } else {
+        a->data = TMALLOC(Unc_Value, &w->world->alloc, Unc_AllocArray, n);
+        if (!a->data) return UNCIL_ERR_MEM;
+    }
+    return UNC_LOCKINITL(a->lock);
+}
+
 /* init array and move n values from v */
 int unc0_initarrayraw(Unc_View *w, Unc_Array *a, Unc_Size n, Unc_Value *v) {
     a->size = a->capacity = n;
@@ -247,3 +260,80 @@ int unc0_asetindx(Unc_View *w, Unc_Array *a, Unc_Value *indx, Unc_Value *v) {
     VCOPY(w, &a->data[(Unc_UInt)i], v);
     return 0;
 }
+
+void unc0_initarrayview(Unc_View *w, Unc_ArrayView *v,
+                        Unc_Entity *array, Unc_Size offset, Unc_Size size) {
+    v->array = array;
+    v->offset = offset;
+    v->size = size;
+}
+
+void unc0_droparrayview(Unc_View *w, Unc_ArrayView *v) {
+    UNCIL_DECREFE(w, v->array);
+}
+
+void unc0_sunsetarrayview(Unc_Allocator *alloc, Unc_ArrayView *v) {
+    /* the array is its own entity and is freed separately */
+    (void)alloc;
+    (void)v;
+}
+
+Unc_Size unc0_avlength(Unc_ArrayView *v) {
+    Unc_Size n = LEFTOVER(Unc_Array, v->array)->size;
+    if (n <= v->offset)
+        return 0;
+    n -= v->offset;
+    return n < v->size ? n : v->size;
+}
+
+int unc0_avget(Unc_View *w, Unc_ArrayView *v, Unc_Int i,
+               int permissive, Unc_Value *out) {
+    Unc_Size n = unc0_avlength(v);
+    if (i < 0)
+        i += n;
+    if (i < 0 || (Unc_UInt)i >= n) {
+        if (permissive) {
+            VSETNULL(w, out);
+            return 0;
+        }
+        return UNCIL_ERR_ARG_INDEXOUTOFBOUNDS;
+    }
+    VCOPY(w, out, &LEFTOVER(Unc_Array, v->array)->data[v->offset
+                                                       + (Unc_UInt)i]);
+    return 0;
+}
+
+int unc0_avset(Unc_View *w, Unc_ArrayView *v, Unc_Int i, Unc_Value *x) {
+    Unc_Size n = unc0_avlength(v);
+    if (i < 0)
+        i += n;
+    if (i < 0 || (Unc_UInt)i >= n)
+        return UNCIL_ERR_ARG_INDEXOUTOFBOUNDS;
+    VCOPY(w, &LEFTOVER(Unc_Array, v->array)->data[v->offset + (Unc_UInt)i],
+          x);
+    return 0;
+}
+
+int unc0_avgetindx(Unc_View *w, Unc_ArrayView *v,
+                   Unc_Value *indx, int permissive, Unc_Value *out) {
+    Unc_Int i;
+    int e = unc0_vgetint(w, indx, &i);
+    if (e) {
+        if (e == UNCIL_ERR_CONVERT_TOINT)
+            e = UNCIL_ERR_ARG_INDEXNOTINTEGER;
+        return e;
+    }
+    return unc0_avget(w, v, i, permissive, out);
+}
+
+int unc0_avsetindx(Unc_View *w, Unc_ArrayView *v,
+                   Unc_Value *indx, Unc_Value *x) {
+    Unc_Int i;
+    int e = unc0_vgetint(w, indx, &i);
+    if (e) {
+        if (e == UNCIL_ERR_CONVERT_TOINT)
+            e = UNCIL_ERR_ARG_INDEXNOTINTEGER;
+        return e;
+    }
+    return unc0_avset(w, v, i, x);
+}
@@ -39,10 +39,21 @@ typedef struct Unc_Array {
     UNC_LOCKLIGHT(lock)
 } Unc_Array;
 
+/* a view of size elements of an array starting at offset. it holds a
+   reference to the array, and its elements are those of the array, so
+   creating one does not copy anything. if the array shrinks, so does the
+   view, but it never grows past size */
+typedef struct Unc_ArrayView {
+    Unc_Entity *array;
+    Unc_Size offset;
+    Unc_Size size;
+} Unc_ArrayView;
+
 struct Unc_View;
 
 int unc0_initarray(struct Unc_View *w, Unc_Array *a, Unc_Size n, Unc_Value *v);
 int unc0_initarrayn(struct Unc_View *w, Unc_Array *a, Unc_Size n);
+int unc0_initarrayc(struct Unc_View *w, Unc_Array *a, Unc_Size n);
 int unc0_initarrayfromcat(struct Unc_View *w, Unc_Array *s,
                           Unc_Size an, Unc_Value *av,
                           Unc_Size bn, Unc_Value *bv);
@@ -68,4 +79,21 @@ int unc0_agetindx(struct Unc_View *w, Unc_Array *a,
 int unc0_asetindx(struct Unc_View *w, Unc_Array *a,
                     Unc_Value *indx, Unc_Value *v);
 
+/* the array must already hold a reference for the view */
+void unc0_initarrayview(struct Unc_View *w, Unc_ArrayView *v,
+                        Unc_Entity *array, Unc_Size offset, Unc_Size size);
+void unc0_droparrayview(struct Unc_View *w, Unc_ArrayView *v);
+void unc0_sunsetarrayview(Unc_Allocator *alloc, Unc_ArrayView *v);
+
+/* like array indexing, view indexing does not lock */
+Unc_Size unc0_avlength(Unc_ArrayView *v);
+int unc0_avget(struct Unc_View *w, Unc_ArrayView *v, Unc_Int i,
+               int permissive, Unc_Value *out);
+int unc0_avset(struct Unc_View *w, Unc_ArrayView *v, Unc_Int i,
+               Unc_Value *x);
+int unc0_avgetindx(struct Unc_View *w, Unc_ArrayView *v,
+                   Unc_Value *indx, int permissive, Unc_Value *out);
+int unc0_avsetindx(struct Unc_View *w, Unc_ArrayView *v,
+                   Unc_Value *indx, Unc_Value *x);
+
 #endif /* UNCIL_UARR_H */
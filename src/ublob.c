@@ -39,7 +39,7 @@ int unc0_initblob(Unc_Allocator *alloc, Unc_Blob *s, Unc_Size n,
     s->capacity = s->size = n;
     if (!n) {
         s->data = NULL;
-        return 0;
+        return UNC_LOCKINITL(s->lock);
     }
     if (!(s->data = unc0_malloc(alloc, Unc_AllocBlob, n)))
         return UNCIL_ERR_MEM;
@@ -52,7 +52,7 @@ int unc0_initblobraw(Unc_Allocator *alloc, Unc_Blob *s, Unc_Size n, byte **b) {
     s->capacity = s->size = n;
     if (!n) {
         s->data = NULL;
-        return 0;
+        return UNC_LOCKINITL(s->lock);
     }
     if (!(s->data = unc0_malloc(alloc, Unc_AllocBlob, n)))
         return UNCIL_ERR_MEM;
@@ -86,6 +86,8 @@ typedef struct Unc_World {
     Unc_Value met_blob;         /* blob methods */
     Unc_Value met_arr;          /* array methods */
     Unc_Value met_table;        /* table methods */
+    Unc_Value met_tarr;         /* typed array methods */
+    Unc_Value met_aview;        /* array view methods */
     Unc_Value io_file;          /* I/O file table */
     Unc_Value exc_oom;          /* out of memory exception */
     Unc_HTblS modulecache;      /* module cache */
@@ -95,9 +97,12 @@ typedef struct Unc_World {
     Unc_AtomicLarge refs;       /* refs from non-subviews */
     Unc_EncodingTable encs;     /* character encoding table */
     Unc_AtomicSmall finalize;   /* finalizing? */
+    Unc_UInt hashseed;          /* seed for string hashes */
+    Unc_HTblI interns;          /* interned strings */
     UNC_LOCKFULL(viewlist_lock)
     UNC_LOCKFULL(public_lock)
     UNC_LOCKFULL(entity_lock)
+    UNC_LOCKFULL(intern_lock)
 } Unc_World;
 
 /* represents an Uncil stack frame */
@@ -186,6 +191,8 @@ typedef struct Unc_View {
     Unc_Value met_blob;         /* blob methods */
     Unc_Value met_arr;          /* array methods */
     Unc_Value met_table;        /* table methods */
+    Unc_Value met_tarr;         /* typed array methods */
+    Unc_Value met_aview;        /* array view methods */
     Unc_Value exc;              /* exception */
     Unc_Value tmpval;
     /* import stuff */
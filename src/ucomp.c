@@ -583,6 +583,15 @@ Unc_RetVal compile1us(Unc_CompileContext *c, Unc_QInstr *q, byte b) {
     return 0;
 }
 
+Unc_RetVal compilendict(Unc_CompileContext *c, Unc_QInstr *q) {
+    if (q->o1type != UNC_QOPER_TYPE_UNSIGN)
+        return compile1reg(c, q, UNC_I_NDICT);
+    MUST(pushb(c, UNC_I_NDICTN));
+    MUST(pushdst0(c, q));
+    MUST(pushz(c, q->o1data.o));
+    return 0;
+}
+
 Unc_RetVal compilemlistp(Unc_CompileContext *c, Unc_QInstr *q) {
     MUST(pushb(c, UNC_I_MLISTP));
     MUST(pushdst0(c, q));
@@ -673,7 +682,7 @@ Unc_RetVal compileinstr(Unc_CompileContext *c, Unc_QInstr *q) {
     case UNC_QINSTR_OP_MLIST:
         return compile1reg(c, q, UNC_I_MLIST);
     case UNC_QINSTR_OP_NDICT:
-        return compile1reg(c, q, UNC_I_NDICT);
+        return compilendict(c, q);
     case UNC_QINSTR_OP_GBIND:
     case UNC_QINSTR_OP_SBIND:
         return compilexbind(c, q);
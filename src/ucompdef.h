@@ -48,6 +48,18 @@ SOFTWARE.
 #define UNLIKELY(x) (x)
 #endif
 
+/* x86 always has SSE2 in 64-bit mode. AVX2 code is compiled in with the
+   target attribute and used only if the CPU turns out to support it. define
+   UNCIL_NOSIMD to use portable code only */
+#if !UNCIL_NOSIMD && defined(__GNUC__)                                       \
+        && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define UNCIL_SIMD_SSE2 1
+#if defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+#define UNCIL_SIMD_AVX2 1
+#define HAVE_AVX2() __builtin_cpu_supports("avx2")
+#endif
+#endif
+
 #endif
 
 #endif
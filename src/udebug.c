@@ -541,6 +541,11 @@ static int pinstrdump(Unc_View *w, const byte **d, byte b) {
         printf("%s\t", "NDICT");
         pdump_reg(w, d);
         break;
+    case UNC_I_NDICTN:
+        printf("%s\t", "NDICTN");
+        pdump_reg(w, d);
+        pdump_us(w, d);
+        break;
     case UNC_I_LSPRS:
         printf("%s\t", "LSPRS");
         pdump_reg(w, d);
@@ -86,12 +86,19 @@ Unc_RetVal unc0_initfuncu(Unc_View *w, Unc_Function *fn, Unc_Program *program,
                     e = UNCIL_ERR_MEM;
                     break;
                 }
+                unc0_pin(x, w);
                 e = unc0_bind(x, w, NULL);
-                if (e) break;
+                if (e) {
+                    unc0_unpin(x, w);
+                    break;
+                }
                 fn->refs[i] = x;
                 UNCIL_INCREFE(w, x);
             }
 
+            tmp = i;
+            while (tmp--)
+                unc0_unpin(fn->refs[tmp], w);
             if (e) {
                 while (i--)
                     unc0_hibernate(fn->refs[i], w);
@@ -169,7 +176,7 @@ Unc_RetVal unc0_initfuncc(Unc_View *w, Unc_Function *fn, Unc_CFunc fcp,
     } else
         fn->defaults = NULL;
     if (!e && fn->refc) {
-        Unc_Size i, bc = w->boundcount;
+        Unc_Size i, j, bc = w->boundcount;
         if (!(fn->refs = TMALLOC(Unc_Entity *, alloc,
                                  Unc_AllocFunc, fn->refc)))
             e = UNCIL_ERR_MEM;
@@ -182,12 +189,19 @@ Unc_RetVal unc0_initfuncc(Unc_View *w, Unc_Function *fn, Unc_CFunc fcp,
                     e = UNCIL_ERR_MEM;
                     break;
                 }
+                unc0_pin(x, w);
                 e = unc0_bind(x, w, &initvalues[i]);
-                if (e) break;
+                if (e) {
+                    unc0_unpin(x, w);
+                    break;
+                }
                 fn->refs[i] = x;
                 UNCIL_INCREFE(w, x);
             }
 
+            j = i;
+            while (j--)
+                unc0_unpin(fn->refs[j], w);
             if (e) {
                 while (i--)
                     unc0_hibernate(fn->refs[i], w);
@@ -243,6 +257,8 @@ Unc_RetVal unc0_initbfunc(Unc_View *w, Unc_FunctionBound *bfn,
     case Unc_TTable:
     case Unc_TObject:
     case Unc_TOpaque:
+    case Unc_TTypedArray:
+    case Unc_TArrayView:
         break;
     default:
         return UNCIL_ERR_ARG_CANNOTBINDFUNC;
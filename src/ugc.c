@@ -34,6 +34,8 @@ SOFTWARE.
 #include "uncil.h"
 #include "uobj.h"
 #include "uopaque.h"
+#include "ustr.h"
+#include "utarr.h"
 #include "uval.h"
 #include "uvali.h"
 #include "uvop.h"
@@ -61,15 +63,21 @@ INLINE Unc_Size unc0_gccollect_root_val(Unc_Value *v) {
 static Unc_Size unc0_gccollect_root_htbl(Unc_HTblS *h) {
     Unc_Size z = 0;
     if (h) {
-        Unc_Size i = 0, c = h->capacity;
-        Unc_HTblS_V *nx = NULL;
-        for (;;) {
-            while (!nx && i < c)
-                nx = h->buckets[i++];
-            if (!nx && i >= c)
-                break;
+        Unc_Size i = 0;
+        Unc_HTblS_V *nx;
+        while ((nx = unc0_iterhtbls(h, &i)))
             z += unc0_gccollect_root_val(&nx->val);
-            nx = nx->next;
+    }
+    return z;
+}
+
+static Unc_Size unc0_gccollect_root_htbli(Unc_HTblI *h) {
+    Unc_Size i, z = 0;
+    for (i = 0; i < h->capacity; ++i) {
+        Unc_Entity *e = h->slots[i];
+        if (e && !e->mark) {
+            e->mark = UNC_GC_YELLOW;
+            ++z;
         }
     }
     return z;
@@ -88,10 +96,13 @@ static Unc_Size unc0_gccollect_root(Unc_World *w) {
     Unc_Size y = 0;
     y += unc0_gccollect_root_htbl(&w->pubs);
     y += unc0_gccollect_root_htbl(&w->modulecache);
+    y += unc0_gccollect_root_htbli(&w->interns);
     y += unc0_gccollect_root_val(&w->met_str);
     y += unc0_gccollect_root_val(&w->met_blob);
     y += unc0_gccollect_root_val(&w->met_arr);
     y += unc0_gccollect_root_val(&w->met_table);
+    y += unc0_gccollect_root_val(&w->met_tarr);
+    y += unc0_gccollect_root_val(&w->met_aview);
     y += unc0_gccollect_root_val(&w->io_file);
     y += unc0_gccollect_root_val(&w->exc_oom);
     y += unc0_gccollect_root_val(&w->modulepaths);
@@ -106,6 +117,8 @@ static Unc_Size unc0_gccollect_root(Unc_World *w) {
         y += unc0_gccollect_root_val(&v->met_blob);
         y += unc0_gccollect_root_val(&v->met_arr);
         y += unc0_gccollect_root_val(&v->met_table);
+        y += unc0_gccollect_root_val(&v->met_tarr);
+        y += unc0_gccollect_root_val(&v->met_aview);
         y += unc0_gccollect_root_val(&v->fmain);
         y += unc0_gccollect_root_val(&v->exc);
         y += unc0_gccollect_root_val(&v->coroutine);
@@ -135,16 +148,11 @@ INLINE Unc_Size unc0_gccollect_mark_val(Unc_Value *v, int depth) {
 }
 
 static Unc_Size unc0_gccollect_mark_hv(Unc_HTblV *h, int depth) {
-    Unc_Size y = 0, i = 0, c = h->capacity;
-    Unc_HTblV_V *nx = NULL;
-    for (;;) {
-        while (!nx && i < c)
-            nx = h->buckets[i++];
-        if (!nx && i >= c)
-            break;
-        y += unc0_gccollect_mark_val(&nx->key, depth);
-        y += unc0_gccollect_mark_val(&nx->val, depth);
-        nx = nx->next;
+    Unc_Size y = 0, i = 0;
+    Unc_Value *nx, k;
+    while ((nx = unc0_iterhtblv(h, &i, &k))) {
+        y += unc0_gccollect_mark_val(&k, depth);
+        y += unc0_gccollect_mark_val(nx, depth);
     }
     return y;
 }
@@ -206,6 +214,10 @@ static Unc_Size unc0_gccollect_mark_ent(Unc_Entity *e, int depth) {
         }
         switch (e->type) {
         case Unc_TString:
+            if (LEFTOVER(Unc_String, e)->flags & UNC_STRING_FLAG_SLICE)
+                y += unc0_gccollect_mark_ent(
+                        LEFTOVER(Unc_String, e)->d.b.u.base, depth + 1);
+            break;
         case Unc_TBlob:
         case Unc_TWeakRef:
             break;
@@ -230,6 +242,15 @@ static Unc_Size unc0_gccollect_mark_ent(Unc_Entity *e, int depth) {
         case Unc_TBoundFunction:
             y += unc0_gccollect_mark_fb(LEFTOVER(Unc_FunctionBound, e), depth);
             break;
+        case Unc_TTypedArray:
+            /* the elements are not values, only the blob needs marking */
+            y += unc0_gccollect_mark_ent(LEFTOVER(Unc_TypedArray, e)->blob,
+                                         depth + 1);
+            break;
+        case Unc_TArrayView:
+            y += unc0_gccollect_mark_ent(LEFTOVER(Unc_ArrayView, e)->array,
+                                         depth + 1);
+            break;
         default:
             NEVER_();
         }
@@ -251,7 +272,8 @@ static void unc0_gccollect_mark(Unc_World *w, Unc_Size yellows) {
 static void unc0_gccollect_presweep(Unc_World *w, Unc_View *v) {
     Unc_Entity *e = w->etop;
     while (e) {
-        if (e->creffed)
+        /* sleeping entities have already been scrapped */
+        if (e->creffed && !IS_SLEEPING(e))
             e->mark = UNC_GC_GREEN;
         else if (!e->mark) {
             switch (e->type) {
@@ -25,6 +25,7 @@ SOFTWARE.
 *******************************************************************************/
 
 #include <limits.h>
+#include <time.h>
 
 #define UNCIL_DEFINES
 
@@ -37,28 +38,169 @@ SOFTWARE.
 #include "uvali.h"
 #include "uvop.h"
 
-#define ROTL(x,n) (((x) << (n)) | ((x) >> (sizeof(unsigned) * CHAR_BIT - (n))))
-
-unsigned unc0_hashint(Unc_Int i) {
-    return (Unc_UInt)i * 2600201173U;
-}
-
 unsigned unc0_hashflt(Unc_Float f) {
     byte b[sizeof(Unc_Float)];
     unc0_memcpy(b, &f, sizeof(Unc_Float));
-    return unc0_hashstr(sizeof(Unc_Float), b);
+    return unc0_hashstr(0, sizeof(Unc_Float), b);
+}
+
+/* string hashing. every byte is hashed (sampling only some of them makes it
+   far too easy to produce long collision chains) and the result depends on
+   a seed that is chosen separately for every world. the result is never 0,
+   which Unc_String uses for a hash that has not been computed yet */
+#if UNC_UINT_BIT >= 64
+/* wyhash-style, 64 bits at a time */
+#define U64C(hi, lo) (((Unc_UInt)(hi) << 32) | (Unc_UInt)(lo))
+#define WYP0 U64C(0xa0761d64UL, 0x78bd642fUL)
+#define WYP1 U64C(0xe7037ed1UL, 0xa0b428dbUL)
+#define WYP2 U64C(0x8ebc6af0UL, 0x9c88c6e3UL)
+#define WYP3 U64C(0x589965ccUL, 0x75374cc3UL)
+#define LO32(x) ((x) & 0xFFFFFFFFUL)
+
+INLINE Unc_UInt wyr4(const byte *p) {
+    return (Unc_UInt)p[0] | ((Unc_UInt)p[1] << 8)
+         | ((Unc_UInt)p[2] << 16) | ((Unc_UInt)p[3] << 24);
+}
+
+INLINE Unc_UInt wyr8(const byte *p) {
+    return wyr4(p) | (wyr4(p + 4) << 32);
+}
+
+/* full 64x64->128 multiply, low half in *a, high half in *b */
+INLINE void wymum(Unc_UInt *a, Unc_UInt *b) {
+    Unc_UInt ha = *a >> 32, hb = *b >> 32, la = LO32(*a), lb = LO32(*b);
+    Unc_UInt rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    Unc_UInt t = rl + (rm0 << 32), c = t < rl, lo;
+    lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+}
+
+INLINE Unc_UInt wymix(Unc_UInt a, Unc_UInt b) {
+    wymum(&a, &b);
+    return a ^ b;
+}
+
+/* murmur3 fmix64. every input bit affects every output bit, so the low
+   7 bits (H2) and the rest (H1) are both usable even for keys that only
+   differ in their high bits */
+INLINE unsigned hashfmix(Unc_UInt x) {
+    x ^= x >> 33;
+    x *= U64C(0xff51afd7UL, 0xed558ccdUL);
+    x ^= x >> 33;
+    x *= U64C(0xc4ceb9feUL, 0x1a85ec53UL);
+    x ^= x >> 33;
+    return (unsigned)(x ^ (x >> 32));
+}
+
+unsigned unc0_hashstr(Unc_UInt seed, Unc_Size n, const byte *s) {
+    Unc_UInt a, b;
+    unsigned h;
+    if (n <= 16) {
+        if (n >= 4) {
+            Unc_Size q = (n >> 3) << 2;
+            a = (wyr4(s) << 32) | wyr4(s + q);
+            b = (wyr4(s + n - 4) << 32) | wyr4(s + n - 4 - q);
+        } else if (n) {
+            a = ((Unc_UInt)s[0] << 16) | ((Unc_UInt)s[n >> 1] << 8)
+                                       | s[n - 1];
+            b = 0;
+        } else
+            a = b = 0;
+    } else {
+        Unc_Size i = n;
+        if (i > 48) {
+            Unc_UInt see1 = seed, see2 = seed;
+            do {
+                seed = wymix(wyr8(s) ^ WYP1, wyr8(s + 8) ^ seed);
+                see1 = wymix(wyr8(s + 16) ^ WYP2, wyr8(s + 24) ^ see1);
+                see2 = wymix(wyr8(s + 32) ^ WYP3, wyr8(s + 40) ^ see2);
+                s += 48, i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wymix(wyr8(s) ^ WYP1, wyr8(s + 8) ^ seed);
+            s += 16, i -= 16;
+        }
+        /* may overlap with bytes already hashed, but n > 16 */
+        a = wyr8(s + i - 16);
+        b = wyr8(s + i - 8);
+    }
+    a ^= WYP1;
+    b ^= seed;
+    wymum(&a, &b);
+    a = wymix(a ^ WYP0 ^ (Unc_UInt)n, b ^ WYP1);
+    h = (unsigned)(a ^ (a >> 32));
+    return h ? h : 1;
+}
+#else
+/* murmur3-style, 32 bits at a time */
+#define LO32(x) ((x) & 0xFFFFFFFFUL)
+#define ROTL32(x,n) LO32(((x) << (n)) | (LO32(x) >> (32 - (n))))
+#define MMC1 0xcc9e2d51UL
+#define MMC2 0x1b873593UL
+
+/* murmur3 fmix32 */
+INLINE unsigned hashfmix(Unc_UInt x) {
+    x = LO32(x);
+    x = LO32((x ^ (x >> 16)) * 0x85ebca6bUL);
+    x = LO32((x ^ (x >> 13)) * 0xc2b2ae35UL);
+    return (unsigned)(x ^ (x >> 16));
+}
+
+unsigned unc0_hashstr(Unc_UInt seed, Unc_Size n, const byte *s) {
+    Unc_UInt h = LO32(seed), k;
+    Unc_Size i;
+    for (i = 0; i + 4 <= n; i += 4) {
+        k = (Unc_UInt)s[i] | ((Unc_UInt)s[i + 1] << 8)
+          | ((Unc_UInt)s[i + 2] << 16) | ((Unc_UInt)s[i + 3] << 24);
+        k = ROTL32(LO32(k * MMC1), 15);
+        h ^= LO32(k * MMC2);
+        h = LO32(ROTL32(h, 13) * 5 + 0xe6546b64UL);
+    }
+    k = 0;
+    switch (n & 3) {
+    case 3:
+        k ^= (Unc_UInt)s[i + 2] << 16;
+        /* fall through */
+    case 2:
+        k ^= (Unc_UInt)s[i + 1] << 8;
+        /* fall through */
+    case 1:
+        k ^= s[i];
+        k = ROTL32(LO32(k * MMC1), 15);
+        h ^= LO32(k * MMC2);
+    }
+    h ^= (Unc_UInt)n;
+    h = LO32((h ^ (h >> 16)) * 0x85ebca6bUL);
+    h = LO32((h ^ (h >> 13)) * 0xc2b2ae35UL);
+    h ^= h >> 16;
+    return h ? (unsigned)h : 1;
+}
+#endif
+
+unsigned unc0_hashint(Unc_Int i) {
+    return hashfmix((Unc_UInt)i);
 }
 
 unsigned unc0_hashptr(const void *p) {
-    return (unsigned)((Unc_UInt)p * 2600201173U);
+    return hashfmix((Unc_UInt)(uintptr_t)p);
 }
 
-unsigned unc0_hashstr(Unc_Size n, const byte *s) {
-    Unc_Size i, z = ((3 * n) >> 6) + 1;
-    unsigned x = 2857740885U;
-    for (i = 0; i < n; i += z)
-        x = ROTL(x, 11) ^ *s++;
-    return x * 3690348479U;
+/* not cryptographically random, but it differs between runs (time, ASLR)
+   and between worlds (address), so colliding keys cannot be prepared in
+   advance */
+Unc_UInt unc0_hashseed(const void *p) {
+    Unc_UInt x[4];
+    x[0] = (Unc_UInt)time(NULL);
+    x[1] = (Unc_UInt)clock();
+    x[2] = (Unc_UInt)(uintptr_t)p;
+    x[3] = (Unc_UInt)(uintptr_t)&x;
+    return ((Unc_UInt)unc0_hashstr(x[2], sizeof(x), (const byte *)x)
+                << (UNC_UINT_BIT / 2))
+         ^ unc0_hashstr(x[3], sizeof(x), (const byte *)x);
 }
 
 Unc_HSet *unc0_newhset(Unc_Allocator *alloc) {
@@ -67,6 +209,8 @@ Unc_HSet *unc0_newhset(Unc_Allocator *alloc) {
     return hset;
 }
 
+#define HASHSTR(w, n, s) unc0_hashstr((w)->world->hashseed, n, s)
+
 void unc0_inithset(Unc_HSet *hset, Unc_Allocator *alloc) {
     hset->alloc = alloc;
     hset->entries = 0;
@@ -86,7 +230,7 @@ Unc_RetVal unc0_puthset(Unc_HSet *hset, Unc_Size sn, const unsigned char *s,
         hset->buckets = bb;
         hset->capacity = nc;
     }
-    h = unc0_hashstr(sn, s), h1 = h % hset->capacity;
+    h = unc0_hashstr(0, sn, s), h1 = h % hset->capacity;
     prev = &hset->buckets[h1];
     b = *prev;
     while (b) {
@@ -112,7 +256,7 @@ Unc_RetVal unc0_puthset(Unc_HSet *hset, Unc_Size sn, const unsigned char *s,
                 unsigned hh;
                 b = obb[s];
                 while (b) {
-                    hh = unc0_hashstr(b->size, b->val) % nc;
+                    hh = unc0_hashstr(0, b->size, b->val) % nc;
                     if (hh < oc)
                         *p0 = b, p0 = &b->next;
                     else
@@ -164,6 +308,135 @@ void unc0_freehset(Unc_HSet *hset) {
     unc0_mfree(hset->alloc, hset, sizeof(Unc_HSet));
 }
 
+/* control bytes. a full slot has the low 7 bits of the hash, so bit 7 is
+   set only for free (empty or deleted) slots */
+#define CTRL_EMPTY 0x80U
+#define CTRL_DELETED 0xFEU
+#define CTRL_H2(hash) ((hash) & 0x7FU)
+#define CTRL_H1(hash) ((hash) >> 7)
+
+/* a group is one Unc_UInt worth of control bytes. byte k of a group is
+   always bits 8k..8k+7 of the word, whatever the byte order, and all
+   bytes of a group are tested at once with word arithmetic */
+#define GROUPSZ ((Unc_Size)(UNC_UINT_BIT / 8))
+#define LSBS (UNC_UINT_MAX / 0xFFU)
+#define MSBS (LSBS << 7)
+
+/* bit 7 of every byte equal to h2. may also flag a byte above a match,
+   which is harmless as the keys are compared anyway */
+INLINE Unc_UInt ctrlmatch(Unc_UInt g, unsigned h2) {
+    Unc_UInt x = g ^ (LSBS * h2);
+    return (x - LSBS) & ~x & MSBS;
+}
+
+INLINE Unc_UInt ctrlempty(Unc_UInt g) {
+    return g & ~(g << 6) & MSBS;
+}
+
+INLINE Unc_UInt ctrlfree(Unc_UInt g) {
+    return g & MSBS;
+}
+
+INLINE Unc_UInt ctrlfull(Unc_UInt g) {
+    return ~g & MSBS;
+}
+
+/* index of the lowest flagged byte, m != 0 */
+INLINE Unc_Size ctrlfirst(Unc_UInt m) {
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 4)
+    return (Unc_Size)__builtin_ctzll(m) >> 3;
+#else
+    Unc_Size k = 0;
+    while (!(m & 0x80U))
+        m >>= 8, ++k;
+    return k;
+#endif
+}
+
+/* the control word of a group may be followed by other data about the
+   group, so groups are gw words apart */
+INLINE unsigned ctrlget(const Unc_UInt *ctrl, Unc_Size gw, Unc_Size i) {
+    return (unsigned)(ctrl[i / GROUPSZ * gw] >> (i % GROUPSZ * 8)) & 0xFFU;
+}
+
+INLINE void ctrlset(Unc_UInt *ctrl, Unc_Size gw, Unc_Size i, unsigned c) {
+    unsigned s = (unsigned)(i % GROUPSZ * 8);
+    Unc_UInt *g = &ctrl[i / GROUPSZ * gw];
+    *g = (*g & ~((Unc_UInt)0xFFU << s)) | ((Unc_UInt)c << s);
+}
+
+INLINE Unc_Size maxload(Unc_Size c) {
+    return c - c / 8;
+}
+
+/* smallest capacity that can hold n entries */
+static Unc_Size fitcap(Unc_Size n) {
+    Unc_Size c = GROUPSZ;
+    while (maxload(c) < n)
+        c <<= 1;
+    return c;
+}
+
+static void clearctrl(Unc_UInt *ctrl, Unc_Size gw, Unc_Size c) {
+    Unc_Size i, g = c / GROUPSZ;
+    for (i = 0; i < g; ++i)
+        ctrl[i * gw] = MSBS; /* all CTRL_EMPTY */
+}
+
+/* first free slot on the probe sequence of hash. probes visit groups in
+   triangular order, which covers every group when the group count is a
+   power of two, and the load limit guarantees that some slot is empty */
+static Unc_Size findfree(const Unc_UInt *ctrl, Unc_Size gw,
+                         Unc_Size c, unsigned hash) {
+    Unc_Size gmask = c / GROUPSZ - 1, g = CTRL_H1(hash) & gmask, j = 0;
+    Unc_UInt m;
+    while (!(m = ctrlfree(ctrl[g * gw])))
+        g = (g + ++j) & gmask;
+    return g * GROUPSZ + ctrlfirst(m);
+}
+
+/* first full slot at or after i */
+static Unc_Size findfull(const Unc_UInt *ctrl, Unc_Size c, Unc_Size i) {
+    while (i < c) {
+        Unc_UInt m = ctrlfull(ctrl[i / GROUPSZ]) >> (i % GROUPSZ * 8);
+        if (m) return i + ctrlfirst(m);
+        i = (i / GROUPSZ + 1) * GROUPSZ;
+    }
+    return c;
+}
+
+/* empties slot i. it only needs a tombstone if some probe sequence may
+   have gone past its group, which cannot be if the group has an empty
+   slot */
+INLINE int clearslot(Unc_UInt *ctrl, Unc_Size gw, Unc_Size i) {
+    if (ctrlempty(ctrl[i / GROUPSZ * gw])) {
+        ctrlset(ctrl, gw, i, CTRL_EMPTY);
+        return 1;
+    }
+    ctrlset(ctrl, gw, i, CTRL_DELETED);
+    return 0;
+}
+
+#define PROBE_BEGIN(h, hash) PROBE_BEGIN_G(h, 1, hash)
+#define PROBE_BEGIN_G(h, gw, hash) {                                           \
+        Unc_Size gmask_ = (h)->capacity / GROUPSZ - 1,                         \
+                 g_ = CTRL_H1(hash) & gmask_, j_ = 0, gw_ = (gw);              \
+        unsigned h2_ = CTRL_H2(hash);                                          \
+        for (;;) {                                                             \
+            Unc_UInt c_ = (h)->ctrl[g_ * gw_], m_ = ctrlmatch(c_, h2_);        \
+            while (m_) {                                                       \
+                Unc_Size i_ = g_ * GROUPSZ + ctrlfirst(m_);
+#define PROBE_SLOT i_
+#define PROBE_END()                                                            \
+                m_ &= m_ - 1;                                                  \
+            }                                                                  \
+            if (ctrlempty(c_)) break;                                          \
+            g_ = (g_ + ++j_) & gmask_;                                         \
+        }                                                                      \
+    }
+
+#define TBLSIZE(T, c) ((c) * sizeof(T) + (c) / GROUPSZ * sizeof(Unc_UInt))
+
 Unc_HTblS *unc0_newhtbls(Unc_Allocator *alloc) {
     Unc_HTblS *h = unc0_malloc(alloc, 0, sizeof(Unc_HTblS));
     if (h) unc0_inithtbls(alloc, h);
@@ -173,155 +446,148 @@ Unc_HTblS *unc0_newhtbls(Unc_Allocator *alloc) {
 void unc0_inithtbls(Unc_Allocator *alloc, Unc_HTblS *h) {
     h->entries = 0;
     h->capacity = 0;
-    h->buckets = NULL;
+    h->used = 0;
+    h->slots = NULL;
+    h->ctrl = NULL;
 }
 
 static Unc_HTblS_V *unc0_lookuphtbls(Unc_HTblS *h, unsigned hash, Unc_Size n,
-                const byte *s, Unc_HTblS_V ***prev) {
-    unsigned h1;
-    Unc_HTblS_V *x;
-    if (!h->buckets) {
-        *prev = NULL;
+                const byte *s) {
+    if (!h->entries)
+        return NULL;
+    PROBE_BEGIN(h, hash)
+        Unc_HTblS_V *x = &h->slots[PROBE_SLOT];
+        if (n == x->key_n && !unc0_memcmp(s, x->key, n))
+            return x;
+    PROBE_END()
+    return NULL;
+}
+
+Unc_HTblS_V *unc0_iterhtbls(Unc_HTblS *h, Unc_Size *i) {
+    Unc_Size j = findfull(h->ctrl, h->capacity, *i);
+    if (j >= h->capacity) {
+        *i = h->capacity;
         return NULL;
     }
-    h1 = hash % h->capacity;
-    x = *(*prev = &h->buckets[h1]);
-    while (x) {
-        if (n == x->key_n && !unc0_memcmp(s, &x[1], n))
-            break;
-        x = *(*prev = &x->next);
+    *i = j + 1;
+    return &h->slots[j];
+}
+
+static Unc_RetVal rehashs(Unc_Allocator *alloc, Unc_HTblS *h, Unc_Size nc) {
+    Unc_HTblS_V *ns = NULL, *x;
+    Unc_UInt *nctrl = NULL;
+    Unc_Size i = 0;
+    Unc_UInt seed = alloc->world->hashseed;
+    if (nc) {
+        ns = unc0_malloc(alloc, 0, TBLSIZE(Unc_HTblS_V, nc));
+        if (!ns) return UNCIL_ERR_MEM;
+        nctrl = (Unc_UInt *)(ns + nc);
+        clearctrl(nctrl, 1, nc);
+        while ((x = unc0_iterhtbls(h, &i))) {
+            unsigned hash = unc0_hashstr(seed, x->key_n, x->key);
+            Unc_Size k = findfree(nctrl, 1, nc, hash);
+            ctrlset(nctrl, 1, k, CTRL_H2(hash));
+            ns[k] = *x;
+        }
     }
-    return x;
+    if (h->slots)
+        unc0_mfree(alloc, h->slots, TBLSIZE(Unc_HTblS_V, h->capacity));
+    h->slots = ns;
+    h->ctrl = nctrl;
+    h->capacity = nc;
+    h->used = h->entries;
+    return 0;
 }
 
 Unc_Value *unc0_gethtbls(Unc_View *w, Unc_HTblS *h,
                          Unc_Size n, const byte *s) {
-    Unc_HTblS_V **p;
-    Unc_HTblS_V *o = unc0_lookuphtbls(h, unc0_hashstr(n, s), n, s, &p);
+    Unc_HTblS_V *o = unc0_lookuphtbls(h, HASHSTR(w, n, s), n, s);
     return o ? &o->val : NULL;
 }
 
 Unc_RetVal unc0_puthtbls(Unc_View *w, Unc_HTblS *h, Unc_Size n,
                          const byte *s, Unc_Value **out) {
-    Unc_HTblS_V **p, *o;
+    Unc_HTblS_V *o;
     Unc_Allocator *alloc;
-    unsigned hash = unc0_hashstr(n, s);
-    o = unc0_lookuphtbls(h, hash, n, s, &p);
+    Unc_Size k;
+    byte *key = NULL;
+    unsigned hash = HASHSTR(w, n, s);
+    o = unc0_lookuphtbls(h, hash, n, s);
     if (o) {
         *out = &o->val;
         return 0;
     }
 
     alloc = &w->world->alloc;
-    if (!h->capacity || h->entries == h->capacity) {
-        Unc_Size z = h->capacity, nz = z ? z * 2 : 4, q;
-        Unc_HTblS_V **nb = TMALLOCZ(Unc_HTblS_V *, alloc, 0, nz), **p0, **p1,
-                    *x;
-
-        if (!nb) return UNCIL_ERR_MEM;
-        hash %= nz;
-
-        for (q = 0; q < z; ++q) {
-            x = h->buckets[q];
-            p0 = &nb[q], p1 = &nb[q + z];
-            while (x) {
-                if (unc0_hashstr(x->key_n, (const byte *)&x[1]) % nz >= z)
-                    *p1 = x, x = *(p1 = &x->next);
-                else
-                    *p0 = x, x = *(p0 = &x->next);
-            }
-            if (hash == q)
-                p = p0;
-            else if (hash == q + z)
-                p = p1;
-            *p0 = *p1 = NULL;
-        }
-        if (!p) {
-            ASSERT(!z);
-            p = &nb[hash];
+    if (n && !(key = unc0_malloc(alloc, 0, n)))
+        return UNCIL_ERR_MEM;
+    if (h->used >= maxload(h->capacity)) {
+        Unc_RetVal e = rehashs(alloc, h, fitcap(h->entries + h->entries / 2
+                                                            + 1));
+        if (e) {
+            unc0_mfree(alloc, key, n);
+            return e;
         }
-        TMFREE(Unc_HTblS_V *, alloc, h->buckets, z);
-        h->buckets = nb;
-        h->capacity = nz;
-    } else
-        hash %= h->capacity;
+    }
 
-    o = unc0_malloc(alloc, 0, sizeof(Unc_HTblS_V) + n);
-    if (!o) return UNCIL_ERR_MEM;
-    ASSERT(p);
-    *p = o;
-    o->next = NULL;
+    k = findfree(h->ctrl, 1, h->capacity, hash);
+    if (ctrlget(h->ctrl, 1, k) == CTRL_EMPTY)
+        ++h->used;
+    ctrlset(h->ctrl, 1, k, CTRL_H2(hash));
+    o = &h->slots[k];
     o->key_n = n;
+    o->key = key;
+    if (n) unc0_memcpy(key, s, n);
     VINITNULL(&o->val);
-    unc0_memcpy(&o[1], s, n);
     ++h->entries;
     *out = &o->val;
     return 0;
 }
 
 static void shrinks(Unc_View *w, Unc_HTblS *h) {
-    Unc_Size cc = h->capacity, c = cc >> 1, i;
-    for (i = 0; i < c; ++i) {
-        Unc_HTblS_V **n = &h->buckets[i];
-        while (*n) n = &(*n)->next;
-        *n = h->buckets[i + c];
-    }
-    h->capacity = c;
-    h->buckets = TMREALLOC(Unc_HTblS_V *, &w->world->alloc, 0,
-                 h->buckets, cc, c);
+    (void)rehashs(&w->world->alloc, h, h->entries
+                    ? fitcap(h->entries + h->entries / 2) : 0);
 }
 
 Unc_RetVal unc0_delhtbls(Unc_View *w, Unc_HTblS *h,
                          Unc_Size n, const byte *s) {
-    Unc_HTblS_V **p, *o;
+    Unc_HTblS_V *o;
     Unc_Allocator *alloc = &w->world->alloc;
-    o = unc0_lookuphtbls(h, unc0_hashstr(n, s), n, s, &p);
+    o = unc0_lookuphtbls(h, HASHSTR(w, n, s), n, s);
     if (!o) return 0;
-    *p = o->next;
     VDECREF(w, &o->val);
-    unc0_mfree(alloc, o, sizeof(Unc_HTblS_V) + o->key_n);
-    if (--h->entries * 4 < h->capacity)
+    unc0_mfree(alloc, o->key, o->key_n);
+    if (clearslot(h->ctrl, 1, o - h->slots))
+        --h->used;
+    if (--h->entries * 4 < h->capacity && h->capacity > GROUPSZ)
         shrinks(w, h);
     return 0;
 }
 
 void unc0_compacthtbls(Unc_View *w, Unc_HTblS *h) {
-    while (--h->entries * 2 < h->capacity)
+    if (h->entries * 4 < h->capacity && h->capacity > GROUPSZ)
         shrinks(w, h);
 }
 
 void unc0_drophtbls(Unc_View *w, Unc_HTblS *h) {
-    if (h->buckets) {
-        Unc_Allocator *alloc = &w->world->alloc;
-        Unc_HTblS_V **bb = h->buckets, *b, *nb;
-        Unc_Size s, nc = h->capacity;
-        for (s = 0; s < nc; ++s) {
-            b = bb[s];
-            while (b) {
-                nb = b->next;
-                VDECREF(w, &b->val);
-                unc0_mfree(alloc, b, sizeof(Unc_HTblS_V) + b->key_n);
-                b = nb;
-            }
-        }
-        unc0_mfree(alloc, h->buckets, h->capacity * sizeof(Unc_HTblS_V *));
+    Unc_Allocator *alloc = &w->world->alloc;
+    Unc_HTblS_V *x;
+    Unc_Size i = 0;
+    while ((x = unc0_iterhtbls(h, &i))) {
+        VDECREF(w, &x->val);
+        unc0_mfree(alloc, x->key, x->key_n);
     }
+    if (h->slots)
+        unc0_mfree(alloc, h->slots, TBLSIZE(Unc_HTblS_V, h->capacity));
 }
 
 void unc0_sunsethtbls(Unc_Allocator *alloc, Unc_HTblS *h) {
-    if (h->buckets) {
-        Unc_HTblS_V **bb = h->buckets, *b, *nb;
-        Unc_Size s, nc = h->capacity;
-        for (s = 0; s < nc; ++s) {
-            b = bb[s];
-            while (b) {
-                nb = b->next;
-                unc0_mfree(alloc, b, sizeof(Unc_HTblS_V) + b->key_n);
-                b = nb;
-            }
-        }
-        unc0_mfree(alloc, h->buckets, h->capacity * sizeof(Unc_HTblS_V *));
-    }
+    Unc_HTblS_V *x;
+    Unc_Size i = 0;
+    while ((x = unc0_iterhtbls(h, &i)))
+        unc0_mfree(alloc, x->key, x->key_n);
+    if (h->slots)
+        unc0_mfree(alloc, h->slots, TBLSIZE(Unc_HTblS_V, h->capacity));
 }
 
 void unc0_freehtbls(Unc_View *w, Unc_HTblS *h) {
@@ -329,6 +595,73 @@ void unc0_freehtbls(Unc_View *w, Unc_HTblS *h) {
     unc0_mfree(&w->world->alloc, h, sizeof(Unc_HTblS));
 }
 
+/* the value table is a compact dict: the entries are kept in insertion
+   order in a dense array, and the probed slots only hold indices into it.
+   the indices are as narrow as the entry count allows.
+
+   integer keys in 0 <= k < asize are not hashed at all but kept in a plain
+   array of values instead, like the array part of a Lua table. the size of
+   the array part is chosen again every time the table is resized */
+#define HOLE Unc_TRef /* key type of a removed entry or array slot */
+
+#define HENTRIES(h) ((h)->entries - (h)->acount)
+
+INLINE int idxlevel(Unc_Size c) {
+    Unc_Size n = maxload(c);
+    if (n <= UCHAR_MAX) return 0;
+    if (n <= USHRT_MAX) return 1;
+    if (n <= UINT_MAX) return 2;
+    return 3;
+}
+
+INLINE size_t idxsize(int level) {
+    switch (level) {
+    case 0:  return sizeof(unsigned char);
+    case 1:  return sizeof(unsigned short);
+    case 2:  return sizeof(unsigned int);
+    default: return sizeof(Unc_Size);
+    }
+}
+
+/* the indices of a group follow its control word, so that a probe usually
+   only touches one cache line before it gets to the entry */
+INLINE Unc_Size groupwords(int level) {
+    return 1 + (GROUPSZ * idxsize(level) + sizeof(Unc_UInt) - 1)
+                    / sizeof(Unc_UInt);
+}
+
+INLINE Unc_Size idxget(const Unc_UInt *ctrl, int level, Unc_Size i) {
+    const void *p = ctrl + i / GROUPSZ * groupwords(level) + 1;
+    i %= GROUPSZ;
+    switch (level) {
+    case 0:  return ((const unsigned char *)p)[i];
+    case 1:  return ((const unsigned short *)p)[i];
+    case 2:  return ((const unsigned int *)p)[i];
+    default: return ((const Unc_Size *)p)[i];
+    }
+}
+
+INLINE void idxset(Unc_UInt *ctrl, int level, Unc_Size i, Unc_Size v) {
+    void *p = ctrl + i / GROUPSZ * groupwords(level) + 1;
+    i %= GROUPSZ;
+    switch (level) {
+    case 0:  ((unsigned char *)p)[i] = (unsigned char)v; break;
+    case 1:  ((unsigned short *)p)[i] = (unsigned short)v; break;
+    case 2:  ((unsigned int *)p)[i] = (unsigned int)v; break;
+    default: ((Unc_Size *)p)[i] = v;
+    }
+}
+
+/* entries, then groups, all in one block */
+#define TBLVSIZE(c) (maxload(c) * sizeof(Unc_HTblV_V)                         \
+            + (c) / GROUPSZ * groupwords(idxlevel(c)) * sizeof(Unc_UInt))
+
+#define GW(h) groupwords((h)->level)
+#define ENTRYAT(h, k) (&(h)->slots[idxget((h)->ctrl, (h)->level, (k))])
+
+/* the array part never grows past 2^ABITS */
+#define ABITS (sizeof(Unc_Size) * CHAR_BIT - 8)
+
 Unc_HTblV *unc0_newhtblv(Unc_Allocator *alloc) {
     Unc_HTblV *h = unc0_malloc(alloc, Unc_AllocDict, sizeof(Unc_HTblV));
     if (h) unc0_inithtblv(alloc, h);
@@ -338,33 +671,117 @@ Unc_HTblV *unc0_newhtblv(Unc_Allocator *alloc) {
 void unc0_inithtblv(Unc_Allocator *alloc, Unc_HTblV *h) {
     h->entries = 0;
     h->capacity = 0;
-    h->buckets = NULL;
+    h->used = 0;
+    h->top = 0;
+    h->slots = NULL;
+    h->ctrl = NULL;
+    h->level = 0;
+    h->acount = 0;
+    h->asize = 0;
+    h->arr = NULL;
 }
 
-static Unc_HTblV_V *unc0_lookuphtblv(Unc_View *w, Unc_HTblV *h, unsigned hash, 
-                        Unc_Value *key, Unc_HTblV_V ***prev) {
-    unsigned h1;
-    Unc_HTblV_V *x;
-    if (!h->buckets) {
-        *prev = NULL;
+/* whether the key belongs in an array part of na slots */
+INLINE int arrkey(Unc_Size na, Unc_Value *key, Unc_Size *k) {
+    if (key->type == Unc_TInt && VGETINT(key) >= 0
+                              && (Unc_UInt)VGETINT(key) < (Unc_UInt)na) {
+        *k = (Unc_Size)VGETINT(key);
+        return 1;
+    }
+    return 0;
+}
+
+#define ISINTERNED(e) (LEFTOVER(Unc_String, (e))->flags                      \
+                                            & UNC_STRING_FLAG_INTERNED)
+
+/* entry of the key, or NULL if there is none. *k is set to its slot */
+static Unc_HTblV_V *findv(Unc_View *w, Unc_HTblV *h, unsigned hash,
+                          Unc_Value *key, Unc_Size *k) {
+    if (!HENTRIES(h))
+        return NULL;
+    if (key->type == Unc_TString) {
+        Unc_Entity *ke = VGETENT(key);
+        int ki = ISINTERNED(ke);
+        PROBE_BEGIN_G(h, GW(h), hash)
+            Unc_HTblV_V *x = ENTRYAT(h, PROBE_SLOT);
+            if (x->key.type == Unc_TString) {
+                Unc_Entity *xe = VGETENT(&x->key);
+                if (xe == ke || (!(ki && ISINTERNED(xe))
+                        && unc0_streq(LEFTOVER(Unc_String, xe),
+                                      LEFTOVER(Unc_String, ke)))) {
+                    *k = PROBE_SLOT;
+                    return x;
+                }
+            }
+        PROBE_END()
         return NULL;
     }
-    h1 = hash % h->capacity;
-    x = *(*prev = &h->buckets[h1]);
-    while (x) {
-        if (unc0_vveq(w, &x->key, key))
-            break;
-        x = *(*prev = &x->next);
+    PROBE_BEGIN_G(h, GW(h), hash)
+        Unc_HTblV_V *x = ENTRYAT(h, PROBE_SLOT);
+        if (unc0_vveq(w, &x->key, key)) {
+            *k = PROBE_SLOT;
+            return x;
+        }
+    PROBE_END()
+    return NULL;
+}
+
+static Unc_HTblV_V *findvs(Unc_HTblV *h, unsigned hash,
+                           Unc_Size sn, const byte *s, Unc_Size *k) {
+    if (!HENTRIES(h))
+        return NULL;
+    PROBE_BEGIN_G(h, GW(h), hash)
+        Unc_HTblV_V *x = ENTRYAT(h, PROBE_SLOT);
+        if (x->key.type == Unc_TString &&
+                unc0_streqr(LEFTOVER(Unc_String, VGETENT(&x->key)), sn, s)) {
+            *k = PROBE_SLOT;
+            return x;
+        }
+    PROBE_END()
+    return NULL;
+}
+
+/* slot that points to entry ei, which must exist */
+static Unc_Size findslotat(Unc_HTblV *h, unsigned hash, Unc_Size ei) {
+    PROBE_BEGIN_G(h, GW(h), hash)
+        if (idxget(h->ctrl, h->level, PROBE_SLOT) == ei)
+            return PROBE_SLOT;
+    PROBE_END()
+    NEVER_();
+    return h->capacity;
+}
+
+/* the array part comes first, then the entries in insertion order. the key
+   is borrowed */
+Unc_Value *unc0_iterhtblv(Unc_HTblV *h, Unc_Size *i, Unc_Value *key) {
+    Unc_Size j;
+    for (j = *i; j < h->asize; ++j) {
+        if (h->arr[j].type != HOLE) {
+            *i = j + 1;
+            VINITINT(key, j);
+            return &h->arr[j];
+        }
+    }
+    for (j -= h->asize; j < h->top; ++j) {
+        if (h->slots[j].key.type != HOLE) {
+            *i = h->asize + j + 1;
+            *key = h->slots[j].key;
+            return &h->slots[j].val;
+        }
     }
-    return x;
+    *i = h->asize + h->top;
+    return NULL;
 }
 
 Unc_Value *unc0_gethtblv(Unc_View *w, Unc_HTblV *h, Unc_Value *key) {
-    Unc_HTblV_V **p, *o;
+    Unc_HTblV_V *x;
+    Unc_Size k;
     unsigned hash;
+    if (arrkey(h->asize, key, &k))
+        return h->arr[k].type != HOLE ? &h->arr[k] : NULL;
     if (unc0_hashvalue(w, key, &hash)) return NULL;
-    o = unc0_lookuphtblv(w, h, hash, key, &p);
-    return o ? &o->val : NULL;
+    x = findv(w, h, hash, key, &k);
+    return x ? &x->val : NULL;
 }
 
 INLINE unsigned hashval(Unc_View *w, Unc_Value *key) {
@@ -373,52 +790,153 @@ INLINE unsigned hashval(Unc_View *w, Unc_Value *key) {
     return u;
 }
 
-static Unc_RetVal unc0_inserthtblv(Unc_View *w, Unc_HTblV *h, Unc_Value *key,
-                                   Unc_Value **out, Unc_HTblV_V **p,
-                                   unsigned hash) {
+/* bucket of a key when sizing the array part. 0 holds the key 0 and b > 0
+   holds 2^(b-1) <= k < 2^b */
+static int arrbucket(Unc_Value *key) {
+    Unc_UInt k;
+    int b = 0;
+    if (key->type != Unc_TInt || VGETINT(key) < 0)
+        return -1;
+    k = (Unc_UInt)VGETINT(key);
+    while (k) {
+        if (++b > (int)ABITS)
+            return -1;
+        k >>= 1;
+    }
+    return b;
+}
+
+/* size of the array part: the largest power of two n such that more than
+   half of the keys 0 <= k < n are in use. *fill is how many of them are */
+static Unc_Size arrfit(Unc_HTblV *h, Unc_Value *extra, Unc_Size *fill) {
+    Unc_Size nums[ABITS + 1], i = 0, a = 0, n = 1, na = 0;
+    Unc_Value k;
+    int b;
+    for (b = 0; b <= (int)ABITS; ++b)
+        nums[b] = 0;
+    while (unc0_iterhtblv(h, &i, &k))
+        if ((b = arrbucket(&k)) >= 0)
+            ++nums[b];
+    if (extra && (b = arrbucket(extra)) >= 0)
+        ++nums[b];
+    *fill = 0;
+    for (b = 0; b <= (int)ABITS; ++b, n <<= 1) {
+        a += nums[b];
+        if (a > n / 2)
+            na = n, *fill = a;
+    }
+    return na;
+}
+
+/* places an entry known to be new into a freshly built hash part */
+INLINE void placev(Unc_View *w, Unc_HTblV *t, Unc_Value *key, Unc_Value *val) {
+    unsigned hash = hashval(w, key);
+    Unc_Size k = findfree(t->ctrl, GW(t), t->capacity, hash);
+    ctrlset(t->ctrl, GW(t), k, CTRL_H2(hash));
+    idxset(t->ctrl, t->level, k, t->top);
+    t->slots[t->top].key = *key;
+    t->slots[t->top].val = *val;
+    ++t->top;
+}
+
+/* rebuilds the table with an array part of na slots and a hash part of
+   nc slots, moving entries between the two as needed. this also squeezes
+   out the holes left by removed entries */
+static Unc_RetVal resizev(Unc_View *w, Unc_HTblV *h, Unc_Size na,
+                          Unc_Size nc) {
     Unc_Allocator *alloc = &w->world->alloc;
-    Unc_HTblV_V *o;
-    if (!h->capacity || h->entries == h->capacity) {
-        Unc_Size z = h->capacity, nz = z ? z * 2 : 4, q;
-        Unc_HTblV_V **nb = TMALLOCZ(Unc_HTblV_V *, alloc, Unc_AllocDict, nz),
-                    **p0, **p1, *x;
-
-        if (!nb) return UNCIL_ERR_MEM;
-        hash %= nz;
-
-        for (q = 0; q < z; ++q) {
-            x = h->buckets[q];
-            p0 = &nb[q], p1 = &nb[q + z];
-            while (x) {
-                unsigned u = 0;
-                unc0_hashvalue(w, &x->key, &u);
-                if (u % nz >= z)
-                    *p1 = x, p1 = &x->next;
-                else
-                    *p0 = x, p0 = &x->next;
-                x = x->next;
+    Unc_HTblV t;
+    Unc_Value *narr = h->arr;
+    Unc_Size i, k;
+    t.capacity = nc;
+    t.top = 0;
+    t.slots = NULL;
+    t.ctrl = NULL;
+    t.level = 0;
+    if (nc) {
+        t.slots = unc0_malloc(alloc, Unc_AllocDict, TBLVSIZE(nc));
+        if (!t.slots) return UNCIL_ERR_MEM;
+        t.ctrl = (Unc_UInt *)(t.slots + maxload(nc));
+        t.level = idxlevel(nc);
+        clearctrl(t.ctrl, GW(&t), nc);
+    }
+    if (na != h->asize) {
+        narr = NULL;
+        if (na) {
+            narr = TMALLOC(Unc_Value, alloc, Unc_AllocDict, na);
+            if (!narr) {
+                if (t.slots) unc0_mfree(alloc, t.slots, TBLVSIZE(nc));
+                return UNCIL_ERR_MEM;
             }
-            if (hash == q)
-                p = p0;
-            else if (hash == q + z)
-                p = p1;
-            *p0 = *p1 = NULL;
         }
-        if (!p) {
-            ASSERT(!z);
-            p = &nb[hash];
+        for (i = 0; i < na; ++i) {
+            if (i < h->asize)
+                narr[i] = h->arr[i];
+            else
+                narr[i].type = HOLE;
         }
-        TMFREE(Unc_HTblV_V *, alloc, h->buckets, z);
-        h->buckets = nb;
-        h->capacity = nz;
-    } else
-        hash %= h->capacity;
+        for (i = na; i < h->asize; ++i) {
+            if (h->arr[i].type != HOLE) {
+                Unc_Value key;
+                VINITINT(&key, i);
+                placev(w, &t, &key, &h->arr[i]);
+            }
+        }
+        if (h->arr)
+            TMFREE(Unc_Value, alloc, h->arr, h->asize);
+    }
+    for (i = 0; i < h->top; ++i) {
+        Unc_HTblV_V *x = &h->slots[i];
+        if (x->key.type == HOLE)
+            continue;
+        if (arrkey(na, &x->key, &k))
+            narr[k] = x->val;
+        else
+            placev(w, &t, &x->key, &x->val);
+    }
+    if (h->slots)
+        unc0_mfree(alloc, h->slots, TBLVSIZE(h->capacity));
+    h->arr = narr;
+    h->asize = na;
+    h->acount = h->entries - t.top;
+    h->slots = t.slots;
+    h->ctrl = t.ctrl;
+    h->level = t.level;
+    h->capacity = nc;
+    h->used = h->top = t.top;
+    return 0;
+}
+
+/* resizes the table for n entries, extra being a key about to be added */
+static Unc_RetVal refitv(Unc_View *w, Unc_HTblV *h, Unc_Size n,
+                         Unc_Value *extra) {
+    Unc_Size fill, na = arrfit(h, extra, &fill);
+    n -= fill;
+    return resizev(w, h, na, n ? fitcap(n + n / 2) : 0);
+}
+
+static Unc_RetVal unc0_inserthtblv(Unc_View *w, Unc_HTblV *h, Unc_Value *key,
+                                   Unc_Value **out, unsigned hash) {
+    Unc_HTblV_V *o;
+    Unc_Size k, ml = maxload(h->capacity);
+    if (h->used >= ml || h->top >= ml) {
+        Unc_RetVal e = refitv(w, h, h->entries + 1, key);
+        if (e) return e;
+        if (arrkey(h->asize, key, &k)) {
+            VINITNULL(&h->arr[k]);
+            ++h->acount;
+            ++h->entries;
+            *out = &h->arr[k];
+            return 0;
+        }
+    }
 
-    o = TMALLOC(Unc_HTblV_V, alloc, Unc_AllocDict, 1);
-    if (!o) return UNCIL_ERR_MEM;
-    ASSERT(p);
-    *p = o;
-    o->next = NULL;
+    k = findfree(h->ctrl, GW(h), h->capacity, hash);
+    if (ctrlget(h->ctrl, GW(h), k) == CTRL_EMPTY)
+        ++h->used;
+    ctrlset(h->ctrl, GW(h), k, CTRL_H2(hash));
+    idxset(h->ctrl, h->level, k, h->top);
+    o = &h->slots[h->top++];
     VIMPOSE(w, &o->key, key);
     VINITNULL(&o->val);
     ++h->entries;
@@ -428,149 +946,285 @@ static Unc_RetVal unc0_inserthtblv(Unc_View *w, Unc_HTblV *h, Unc_Value *key,
 
 Unc_RetVal unc0_puthtblv(Unc_View *w, Unc_HTblV *h,
                          Unc_Value *key, Unc_Value **out) {
-    Unc_HTblV_V **p, *o;
+    Unc_HTblV_V *x;
+    Unc_Size k;
     unsigned hash;
-    Unc_RetVal e = unc0_hashvalue(w, key, &hash);
+    Unc_RetVal e;
+    if (arrkey(h->asize, key, &k)) {
+        if (h->arr[k].type == HOLE) {
+            VINITNULL(&h->arr[k]);
+            ++h->acount;
+            ++h->entries;
+        }
+        *out = &h->arr[k];
+        return 0;
+    }
+    e = unc0_hashvalue(w, key, &hash);
     if (e) return e;
-    o = unc0_lookuphtblv(w, h, hash, key, &p);
-    if (o) {
-        *out = &o->val;
+    x = findv(w, h, hash, key, &k);
+    if (x) {
+        *out = &x->val;
         return 0;
     }
-    return unc0_inserthtblv(w, h, key, out, p, hash);
+    if (key->type == Unc_TString && !ISINTERNED(VGETENT(key))) {
+        Unc_String *ks = LEFTOVER(Unc_String, VGETENT(key));
+        if (ks->size <= UNC_INTERN_SHORT) {
+            /* share the key with every other table that uses it */
+            Unc_Value ik;
+            Unc_Entity *ie = unc0_interned(w, hash, ks->size,
+                                           unc0_getstringdata(ks));
+            if (ie) {
+                ik.type = Unc_TString;
+                VGETENT(&ik) = ie;
+                return unc0_inserthtblv(w, h, &ik, out, hash);
+            }
+        }
+    }
+    return unc0_inserthtblv(w, h, key, out, hash);
 }
 
-static void shrinkv(Unc_View *w, Unc_HTblV *h) {
-    Unc_Size cc = h->capacity, c = cc >> 1, i;
-    for (i = 0; i < c; ++i) {
-        Unc_HTblV_V **n = &h->buckets[i];
-        while (*n) n = &(*n)->next;
-        *n = h->buckets[i + c];
-    }
-    h->capacity = c;
-    h->buckets = TMREALLOC(Unc_HTblV_V *, &w->world->alloc, 0,
-                 h->buckets, cc, c);
+/* removes the entry of slot k. the entry becomes a hole, so that the
+   other entries stay where they are */
+static void removev(Unc_View *w, Unc_HTblV *h, Unc_Size k) {
+    Unc_HTblV_V *x = ENTRYAT(h, k);
+    VDECREF(w, &x->key);
+    VDECREF(w, &x->val);
+    x->key.type = HOLE;
+    if (clearslot(h->ctrl, GW(h), k))
+        --h->used;
+    --h->entries;
+    while (h->top && h->slots[h->top - 1].key.type == HOLE)
+        --h->top;
 }
 
-Unc_RetVal unc0_delhtblv(Unc_View *w, Unc_HTblV *h, Unc_Value *key) {
-    Unc_HTblV_V **p, *o;
-    Unc_Allocator *alloc = &w->world->alloc;
-    unsigned hash;
-    Unc_RetVal e = unc0_hashvalue(w, key, &hash);
-    if (e) return e;
-    o = unc0_lookuphtblv(w, h, hash, key, &p);
-    if (!o) return 0;
-    *p = o->next;
-    VDECREF(w, &o->key);
-    VDECREF(w, &o->val);
-    unc0_mfree(alloc, o, sizeof(Unc_HTblV_V));
-    if (--h->entries * 4 < h->capacity)
-        shrinkv(w, h);
-    return 0;
+static void removea(Unc_View *w, Unc_HTblV *h, Unc_Size k) {
+    VDECREF(w, &h->arr[k]);
+    h->arr[k].type = HOLE;
+    --h->acount;
+    --h->entries;
 }
 
-static Unc_HTblV_V *unc0_lookuphtblvs(Unc_HTblV *h, unsigned hash, 
-                        Unc_Size sn, const byte *s, Unc_HTblV_V ***prev) {
-    unsigned h1;
+/* removes the entry at position p, i.e. the one unc0_iterhtblv returned
+   when it set *i to p + 1. the table is never resized, so that other
+   entries stay where they are. call unc0_compacthtblv afterwards */
+void unc0_delhtblvat(Unc_View *w, Unc_HTblV *h, Unc_Size p) {
     Unc_HTblV_V *x;
-    if (!h->buckets) {
-        *prev = NULL;
-        return NULL;
+    if (p < h->asize) {
+        removea(w, h, p);
+        return;
     }
-    h1 = hash % h->capacity;
-    x = *(*prev = &h->buckets[h1]);
-    while (x) {
-        if (x->key.type == Unc_TString &&
-                    unc0_streqr(LEFTOVER(Unc_String, VGETENT(&x->key)), sn, s))
-            break;
-        x = *(*prev = &x->next);
+    p -= h->asize;
+    x = &h->slots[p];
+    removev(w, h, findslotat(h, hashval(w, &x->key), p));
+}
+
+Unc_RetVal unc0_delhtblv(Unc_View *w, Unc_HTblV *h, Unc_Value *key) {
+    Unc_Size k;
+    unsigned hash;
+    Unc_RetVal e;
+    if (arrkey(h->asize, key, &k)) {
+        if (h->arr[k].type != HOLE) {
+            removea(w, h, k);
+            unc0_compacthtblv(w, h);
+        }
+        return 0;
     }
-    return x;
+    e = unc0_hashvalue(w, key, &hash);
+    if (e) return e;
+    if (!findv(w, h, hash, key, &k)) return 0;
+    removev(w, h, k);
+    unc0_compacthtblv(w, h);
+    return 0;
 }
 
 Unc_Value *unc0_gethtblvs(Unc_View *w, Unc_HTblV *h,
                           Unc_Size n, const byte *s) {
-    Unc_HTblV_V **p;
-    Unc_HTblV_V *o = unc0_lookuphtblvs(h, unc0_hashstr(n, s), n, s, &p);
-    return o ? &o->val : NULL;
+    Unc_Size k;
+    Unc_HTblV_V *x = findvs(h, HASHSTR(w, n, s), n, s, &k);
+    return x ? &x->val : NULL;
 }
 
 Unc_RetVal unc0_puthtblvs(Unc_View *w, Unc_HTblV *h,
                           Unc_Size n, const byte *s, Unc_Value **out) {
-    Unc_HTblV_V **p;
-    unsigned hash = unc0_hashstr(n, s);
-    Unc_HTblV_V *o = unc0_lookuphtblvs(h, hash, n, s, &p);
-    if (o) {
-        *out = &o->val;
+    unsigned hash = HASHSTR(w, n, s);
+    Unc_Size k;
+    Unc_HTblV_V *x = findvs(h, hash, n, s, &k);
+    if (x) {
+        *out = &x->val;
         return 0;
     } else {
         Unc_RetVal e;
         Unc_Value tmp;
-        Unc_Entity *en = unc0_wake(w, Unc_TString);
-        if (!en) return UNCIL_ERR_MEM;
-        e = unc0_initstring(&w->world->alloc, LEFTOVER(Unc_String, en), n, s);
-        if (e) return e;
+        Unc_Entity *en = n <= UNC_INTERN_SHORT
+                            ? unc0_interned(w, hash, n, s) : NULL;
+        if (!en) {
+            Unc_String *str;
+            en = unc0_wake(w, Unc_TString);
+            if (!en) return UNCIL_ERR_MEM;
+            str = LEFTOVER(Unc_String, en);
+            e = unc0_initstring(&w->world->alloc, str, n, s);
+            if (e) return e;
+            str->hash = hash;
+        }
         VINITENT(&tmp, Unc_TString, en);
-        return unc0_inserthtblv(w, h, &tmp, out, p, hash);
+        e = unc0_inserthtblv(w, h, &tmp, out, hash);
+        VDECREF(w, &tmp);
+        return e;
     }
 }
 
 Unc_RetVal unc0_delhtblvs(Unc_View *w, Unc_HTblV *h,
                           Unc_Size n, const byte *s) {
-    Unc_HTblV_V **p, *o;
-    Unc_Allocator *alloc = &w->world->alloc;
-    o = unc0_lookuphtblvs(h, unc0_hashstr(n, s), n, s, &p);
-    if (!o) return 0;
-    *p = o->next;
-    VDECREF(w, &o->key);
-    VDECREF(w, &o->val);
-    unc0_mfree(alloc, o, sizeof(Unc_HTblV_V));
-    if (--h->entries * 4 < h->capacity)
-        shrinkv(w, h);
+    Unc_Size k;
+    if (!findvs(h, HASHSTR(w, n, s), n, s, &k)) return 0;
+    removev(w, h, k);
+    unc0_compacthtblv(w, h);
     return 0;
 }
 
+/* makes room for n more entries, so that adding them will not rebuild */
+Unc_RetVal unc0_reservehtblv(Unc_View *w, Unc_HTblV *h, Unc_Size n) {
+    Unc_Size ml = maxload(h->capacity);
+    if (n <= ml - h->top && n <= ml - h->used)
+        return 0;
+    if (n > UNC_SIZE_MAX / 2 / sizeof(Unc_HTblV_V) - HENTRIES(h))
+        return UNCIL_ERR_MEM;
+    return resizev(w, h, h->asize, fitcap(HENTRIES(h) + n));
+}
+
 void unc0_compacthtblv(Unc_View *w, Unc_HTblV *h) {
-    while (--h->entries * 2 < h->capacity)
-        shrinkv(w, h);
+    if ((HENTRIES(h) * 4 < h->capacity && h->capacity > GROUPSZ)
+            || (h->acount * 4 < h->asize && h->asize > GROUPSZ))
+        (void)refitv(w, h, h->entries, NULL);
 }
 
 void unc0_drophtblv(Unc_View *w, Unc_HTblV *h) {
-    if (h->buckets) {
-        Unc_Allocator *alloc = &w->world->alloc;
-        Unc_HTblV_V **bb = h->buckets, *b, *nb;
-        Unc_Size s, nc = h->capacity;
-        for (s = 0; s < nc; ++s) {
-            b = bb[s];
-            while (b) {
-                nb = b->next;
-                VDECREF(w, &b->key);
-                VDECREF(w, &b->val);
-                unc0_mfree(alloc, b, sizeof(Unc_HTblV_V));
-                b = nb;
-            }
-        }
-        unc0_mfree(alloc, h->buckets, h->capacity * sizeof(Unc_HTblV_V *));
+    Unc_Value *v, k;
+    Unc_Size i = 0;
+    while ((v = unc0_iterhtblv(h, &i, &k))) {
+        VDECREF(w, &k);
+        VDECREF(w, v);
     }
+    unc0_sunsethtblv(&w->world->alloc, h);
 }
 
 void unc0_sunsethtblv(Unc_Allocator *alloc, Unc_HTblV *h) {
-    if (h->buckets) {
-        Unc_HTblV_V **bb = h->buckets, *b, *nb;
-        Unc_Size s, nc = h->capacity;
-        for (s = 0; s < nc; ++s) {
-            b = bb[s];
-            while (b) {
-                nb = b->next;
-                unc0_mfree(alloc, b, sizeof(Unc_HTblV_V));
-                b = nb;
-            }
-        }
-        unc0_mfree(alloc, h->buckets, h->capacity * sizeof(Unc_HTblV_V *));
-    }
+    if (h->slots)
+        unc0_mfree(alloc, h->slots, TBLVSIZE(h->capacity));
+    if (h->arr)
+        TMFREE(Unc_Value, alloc, h->arr, h->asize);
 }
 
 void unc0_freehtblv(Unc_View *w, Unc_HTblV *h) {
     unc0_drophtblv(w, h);
     unc0_mfree(&w->world->alloc, h, sizeof(Unc_HTblV));
 }
+
+void unc0_inithtbli(Unc_HTblI *h) {
+    h->entries = 0;
+    h->capacity = 0;
+    h->slots = NULL;
+}
+
+/* the entities themselves are freed along with the rest of the world */
+void unc0_drophtbli(Unc_Allocator *alloc, Unc_HTblI *h) {
+    if (h->slots)
+        TMFREE(Unc_Entity *, alloc, h->slots, h->capacity);
+    unc0_inithtbli(h);
+}
+
+static Unc_Entity *unc0_lookuphtbli(Unc_HTblI *h, unsigned hash,
+                                    Unc_Size n, const byte *s) {
+    Unc_Size mask, i;
+    Unc_Entity *e;
+    if (!h->entries)
+        return NULL;
+    mask = h->capacity - 1;
+    for (i = hash & mask; (e = h->slots[i]); i = (i + 1) & mask) {
+        Unc_String *x = LEFTOVER(Unc_String, e);
+        if (x->hash == hash && unc0_streqr(x, n, s))
+            return e;
+    }
+    return NULL;
+}
+
+static void placehtbli(Unc_Entity **slots, Unc_Size c, Unc_Entity *e) {
+    Unc_Size mask = c - 1, i = LEFTOVER(Unc_String, e)->hash & mask;
+    while (slots[i])
+        i = (i + 1) & mask;
+    slots[i] = e;
+}
+
+static Unc_RetVal unc0_addhtbli(Unc_Allocator *alloc, Unc_HTblI *h,
+                                Unc_Entity *e) {
+    if ((h->entries + 1) * 4 > h->capacity * 3) {
+        Unc_Size i, nc = h->capacity ? h->capacity * 2 : 64;
+        Unc_Entity **ns = TMALLOCZ(Unc_Entity *, alloc, Unc_AllocInternal, nc);
+        if (!ns) return UNCIL_ERR_MEM;
+        for (i = 0; i < h->capacity; ++i)
+            if (h->slots[i])
+                placehtbli(ns, nc, h->slots[i]);
+        if (h->slots)
+            TMFREE(Unc_Entity *, alloc, h->slots, h->capacity);
+        h->slots = ns;
+        h->capacity = nc;
+    }
+    placehtbli(h->slots, h->capacity, e);
+    ++h->entries;
+    return 0;
+}
+
+/* the interned string with these contents, or NULL. does not create one */
+Unc_Entity *unc0_interned(Unc_View *w, unsigned hash,
+                          Unc_Size n, const byte *s) {
+    Unc_World *world = w->world;
+    Unc_Entity *e;
+    (void)UNC_LOCKFP(w, world->intern_lock);
+    e = unc0_lookuphtbli(&world->interns, hash, n, s);
+    UNC_UNLOCKF(world->intern_lock);
+    return e;
+}
+
+/* the interned string with these contents, created if necessary. the
+   world holds a reference to it, the caller does not get another one */
+Unc_RetVal unc0_intern(Unc_View *w, Unc_Size n, const byte *s,
+                       Unc_Entity **out) {
+    Unc_World *world = w->world;
+    unsigned hash = HASHSTR(w, n, s);
+    Unc_Entity *e, *en;
+    Unc_String *str;
+    Unc_RetVal r;
+    if ((e = unc0_interned(w, hash, n, s))) {
+        *out = e;
+        return 0;
+    }
+
+    en = unc0_wake(w, Unc_TString);
+    if (!en) return UNCIL_ERR_MEM;
+    unc0_pin(en, w);
+    str = LEFTOVER(Unc_String, en);
+    r = unc0_initstring(&world->alloc, str, n, s);
+    if (r) {
+        unc0_unwake(en, w);
+        return r;
+    }
+    str->hash = hash;
+    str->flags |= UNC_STRING_FLAG_INTERNED;
+
+    (void)UNC_LOCKFP(w, world->intern_lock);
+    /* another thread may have interned the same string meanwhile */
+    e = unc0_lookuphtbli(&world->interns, hash, n, s);
+    if (!e && !(r = unc0_addhtbli(&world->alloc, &world->interns, en))) {
+        UNCIL_INCREFE(w, en);
+        e = en, en = NULL;
+    }
+    UNC_UNLOCKF(world->intern_lock);
+    if (en) {
+        unc0_unpin(en, w);
+        unc0_hibernate(en, w);
+    } else
+        unc0_unpin(e, w);
+    if (r) return r;
+    *out = e;
+    return 0;
+}
@@ -45,8 +45,11 @@ typedef struct Unc_HSet {
     Unc_HSet_V **buckets;
 } Unc_HSet;
 
+/* the value and string tables use open addressing. every slot has a
+   control byte telling whether it is empty, deleted or full, and if full,
+   7 bits of the hash of its key. control bytes are stored one group per
+   Unc_UInt so that a whole group can be probed at once */
 typedef struct Unc_HTblV_V {
-    struct Unc_HTblV_V *next;
     Unc_Value key;
     Unc_Value val;
 } Unc_HTblV_V;
@@ -54,25 +57,48 @@ typedef struct Unc_HTblV_V {
 typedef struct Unc_HTblV {
     Unc_Size entries;
     Unc_Size capacity;
-    Unc_HTblV_V **buckets;
+    Unc_Size used; /* full and deleted slots */
+    Unc_Size top; /* entries in slots, including removed ones */
+    Unc_HTblV_V *slots; /* entries in insertion order */
+    Unc_UInt *ctrl; /* with the entry index of every full slot */
+    int level; /* width of the indices */
+    Unc_Size acount; /* entries in the array part */
+    Unc_Size asize; /* integer keys 0 <= k < asize go in the array part */
+    Unc_Value *arr;
 } Unc_HTblV;
 
 typedef struct Unc_HTblS_V {
-    struct Unc_HTblS_V *next;
     Unc_Size key_n;
+    byte *key;
     Unc_Value val;
 } Unc_HTblS_V;
 
 typedef struct Unc_HTblS {
     Unc_Size entries;
     Unc_Size capacity;
-    Unc_HTblS_V **buckets;
+    Unc_Size used;
+    Unc_HTblS_V *slots;
+    Unc_UInt *ctrl;
 } Unc_HTblS;
 
+/* set of interned strings, i.e. canonical string entities. an interned
+   string is never freed before the world is, so two interned strings are
+   equal if and only if they are the same entity */
+typedef struct Unc_HTblI {
+    Unc_Size entries;
+    Unc_Size capacity;
+    struct Unc_Entity **slots;
+} Unc_HTblI;
+
+/* runtime strings up to this long are replaced with their interned
+   counterpart, if there is one, when they are stored as table keys */
+#define UNC_INTERN_SHORT 32
+
 unsigned unc0_hashint(Unc_Int i);
 unsigned unc0_hashflt(Unc_Float f);
 unsigned unc0_hashptr(const void *p);
-unsigned unc0_hashstr(Unc_Size n, const byte *s);
+unsigned unc0_hashstr(Unc_UInt seed, Unc_Size n, const byte *s);
+Unc_UInt unc0_hashseed(const void *p);
 
 Unc_HSet *unc0_newhset(Unc_Allocator *alloc);
 void unc0_inithset(Unc_HSet *hset, Unc_Allocator *alloc);
@@ -92,6 +118,7 @@ Unc_RetVal unc0_puthtbls(struct Unc_View *w, Unc_HTblS *h,
 Unc_RetVal unc0_delhtbls(struct Unc_View *w, Unc_HTblS *h,
                          Unc_Size n, const byte *s);
 void unc0_compacthtbls(struct Unc_View *w, Unc_HTblS *h);
+Unc_HTblS_V *unc0_iterhtbls(Unc_HTblS *h, Unc_Size *i);
 void unc0_drophtbls(struct Unc_View *w, Unc_HTblS *h);
 void unc0_sunsethtbls(Unc_Allocator *alloc, Unc_HTblS *h);
 void unc0_freehtbls(struct Unc_View *w, Unc_HTblS *h);
@@ -103,6 +130,9 @@ Unc_RetVal unc0_puthtblv(struct Unc_View *w, Unc_HTblV *h,
                          Unc_Value *key, Unc_Value **out);
 Unc_RetVal unc0_delhtblv(struct Unc_View *w, Unc_HTblV *h, Unc_Value *key);
 void unc0_compacthtblv(struct Unc_View *w, Unc_HTblV *h);
+Unc_RetVal unc0_reservehtblv(struct Unc_View *w, Unc_HTblV *h, Unc_Size n);
+Unc_Value *unc0_iterhtblv(Unc_HTblV *h, Unc_Size *i, Unc_Value *key);
+void unc0_delhtblvat(struct Unc_View *w, Unc_HTblV *h, Unc_Size p);
 Unc_Value *unc0_gethtblvs(struct Unc_View *w, Unc_HTblV *h,
                           Unc_Size n, const byte *s);
 Unc_RetVal unc0_puthtblvs(struct Unc_View *w, Unc_HTblV *h,
@@ -113,4 +143,11 @@ void unc0_drophtblv(struct Unc_View *w, Unc_HTblV *h);
 void unc0_sunsethtblv(Unc_Allocator *alloc, Unc_HTblV *h);
 void unc0_freehtblv(struct Unc_View *w, Unc_HTblV *h);
 
+void unc0_inithtbli(Unc_HTblI *h);
+void unc0_drophtbli(Unc_Allocator *alloc, Unc_HTblI *h);
+Unc_RetVal unc0_intern(struct Unc_View *w, Unc_Size n, const byte *s,
+                       struct Unc_Entity **out);
+struct Unc_Entity *unc0_interned(struct Unc_View *w, unsigned hash,
+                                 Unc_Size n, const byte *s);
+
 #endif /* UNCIL_UHASH_H */
@@ -99,6 +99,8 @@ Unc_View *unc_createex(Unc_Alloc alloc, void *udata, Unc_MMask mmask) {
                 VIMPOSE(view, &world->met_blob, &view->met_blob);
                 VIMPOSE(view, &world->met_arr, &view->met_arr);
                 VIMPOSE(view, &world->met_table, &view->met_table);
+                VIMPOSE(view, &world->met_tarr, &view->met_tarr);
+                VIMPOSE(view, &world->met_aview, &view->met_aview);
                 return view;
             }
         }
@@ -635,6 +637,8 @@ int unc_issame(Unc_View *w, Unc_Value *a, Unc_Value *b) {
     case Unc_TOpaque:
     case Unc_TWeakRef:
     case Unc_TBoundFunction:
+    case Unc_TTypedArray:
+    case Unc_TArrayView:
         return a->v.c == b->v.c;
     default:
         return 0;
@@ -667,9 +671,12 @@ Unc_RetVal unc_getfloat(Unc_View *w, Unc_Value *v, Unc_Float *ret) {
 Unc_RetVal unc_getstring(Unc_View *w, Unc_Value *v,
                          Unc_Size *n, const char **p) {
     Unc_String *s;
+    Unc_RetVal e;
     if (v->type != Unc_TString)
         return UNCIL_ERR_TYPE_NOTSTR;
     s = LEFTOVER(Unc_String, VGETENT(v));
+    e = unc0_strterminate(w, s);
+    if (e) return e;
     *n = s->size;
     *p = (const char *)unc0_getstringdata(s);
     return 0;
@@ -678,9 +685,12 @@ Unc_RetVal unc_getstring(Unc_View *w, Unc_Value *v,
 Unc_RetVal unc_getstringc(Unc_View *w, Unc_Value *v, const char **p) {
     Unc_String *s;
     const char *sp;
+    Unc_RetVal e;
     if (v->type != Unc_TString)
         return UNCIL_ERR_TYPE_NOTSTR;
     s = LEFTOVER(Unc_String, VGETENT(v));
+    e = unc0_strterminate(w, s);
+    if (e) return e;
     sp = (const char *)unc0_getstringdata(s);
     if (unc0_memchr(sp, 0, s->size))
         return UNCIL_ERR_ARG_NULLCHAR;
@@ -998,6 +1008,15 @@ Unc_RetVal unc_newstringcmove(Unc_View *w, Unc_Value *v, char *c) {
     return unc_newstringmove(w, v, sn, c);
 }
 
+Unc_RetVal unc_newsubstring(Unc_View *w, Unc_Value *v, Unc_Value *s,
+                            Unc_Size n, const char *c) {
+    if (s->type != Unc_TString)
+        return UNCIL_ERR_TYPE_NOTSTR;
+    if (unc0_utf8validate(n, c))
+        return UNCIL_ERR_IO_INVALIDENCODING;
+    return unc0_newstringslice(w, v, s, n, (const byte *)c);
+}
+
 Unc_RetVal unc_newblob(Unc_View *w, Unc_Value *v, Unc_Size n, byte **data) {
     Unc_RetVal e;
     Unc_Value tmp;
@@ -1053,6 +1072,19 @@ Unc_RetVal unc_newarrayempty(Unc_View *w, Unc_Value *v) {
     return e;
 }
 
+Unc_RetVal unc_newarrayemptycap(Unc_View *w, Unc_Value *v, Unc_Size n) {
+    Unc_RetVal e;
+    Unc_Value tmp;
+    e = unc0_vrefnew(w, &tmp, Unc_TArray);
+    if (e) return e;
+    e = unc0_initarrayc(w, LEFTOVER(Unc_Array, VGETENT(&tmp)), n);
+    if (e)
+        unc0_unwake(VGETENT(&tmp), w);
+    else
+        VMOVE(w, v, &tmp);
+    return e;
+}
+
 Unc_RetVal unc_newarray(Unc_View *w, Unc_Value *v, Unc_Size n, Unc_Value **p) {
     Unc_RetVal e;
     Unc_Value tmp;
@@ -1099,6 +1131,19 @@ Unc_RetVal unc_newtable(Unc_View *w, Unc_Value *v) {
     return e;
 }
 
+Unc_RetVal unc_newtablecap(Unc_View *w, Unc_Value *v, Unc_Size n) {
+    Unc_RetVal e;
+    Unc_Value tmp;
+    e = unc0_vrefnew(w, &tmp, Unc_TTable);
+    if (e) return e;
+    e = unc0_initdictn(w, LEFTOVER(Unc_Dict, VGETENT(&tmp)), n);
+    if (e)
+        unc0_unwake(VGETENT(&tmp), w);
+    else
+        VMOVE(w, v, &tmp);
+    return e;
+}
+
 Unc_RetVal unc_newobject(Unc_View *w, Unc_Value *v, Unc_Value *prototype) {
     Unc_RetVal e;
     Unc_Value tmp;
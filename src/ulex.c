@@ -37,6 +37,7 @@ SOFTWARE.
 #include "ulex.h"
 #include "umem.h"
 #include "uutf.h"
+#include "uxscanf.h"
 
 #define SWAP(T, a, b) do { T _tmp = a; a = b; b = _tmp; } while (0)
 
@@ -301,7 +302,10 @@ readnum:
                     Unc_Float f;
                 } u;
                 long exp = 0, off = 0;
+                /* decimal digits, for correctly rounded float literals */
+                struct unc0_decimal dec;
                 dot ? (u.f = 0) : (u.i = 0);
+                unc0_decimalinit(&dec);
 
                 if (!dot) {
                     Unc_Int ni;
@@ -327,13 +331,23 @@ readnum:
                         }
                     }
                     while (isdigitb_(c, base)) {
+                        if (base == 10)
+                            unc0_decimaldigit(&dec, c - '0', 0);
                         ni = u.i * base + getdigitb_(c, base);
                         if (ni < u.i) {
                             /* overflow */
-                            u.f = u.i;
-                            while (isdigitb_(c, base)) {
-                                u.f = u.f * base + getdigitb_(c, base);
+                            if (base == 10) {
                                 c = getch(ud);
+                                while (unc0_isdigit(c)) {
+                                    unc0_decimaldigit(&dec, c - '0', 0);
+                                    c = getch(ud);
+                                }
+                            } else {
+                                u.f = u.i;
+                                while (isdigitb_(c, base)) {
+                                    u.f = u.f * base + getdigitb_(c, base);
+                                    c = getch(ud);
+                                }
                             }
                             dot = 1;
                             break;
@@ -356,11 +370,15 @@ waszero:
 
                 if (dot) {
                     while (unc0_isdigit(c)) {
-                        u.f = u.f * 10 + c - '0';
+                        if (base == 10) {
+                            unc0_decimaldigit(&dec, c - '0', 1);
+                        } else {
+                            u.f = u.f * 10 + c - '0';
+                            --off;
+                            if (off >= 0) /* should never happen */
+                                { err = UNCIL_ERR_SYNTAX; goto lexreturn; }
+                        }
                         c = getch(ud);
-                        --off;
-                        if (off >= 0) /* should never happen */
-                            { err = UNCIL_ERR_SYNTAX; goto lexreturn; }
                     }
 
                     if (c == 'E' || c == 'e') {
@@ -387,7 +405,10 @@ waszero:
 noexpneg:
                         off = add_exp(off, exp);
                     }
-                    u.f = unc0_adjexp10(u.f, off);
+                    if (base == 10)
+                        u.f = unc0_decimaltof(&dec, exp);
+                    else
+                        u.f = unc0_adjexp10(u.f, off);
                     buf[0] = ULT_LFloat;
                     unc0_memcpy(buf + 1, &u.f, sizeof(Unc_Float));
                     bufn = sizeof(Unc_Float) + 1;
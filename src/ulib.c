@@ -37,6 +37,7 @@ SOFTWARE.
 #include "uncil.h"
 #include "usort.h"
 #include "ustr.h"
+#include "utarr.h"
 #include "utxt.h"
 #include "uutf.h"
 #include "uvali.h"
@@ -141,7 +142,9 @@ Unc_RetVal unc0_g_require(Unc_View *w, Unc_Tuple args, void *udata) {
     }
 
     VINITENT(&v, Unc_TObject, en);
-    VCOPY(w, ov, &v);
+    /* the module may have required others, moving the cache entries */
+    ov = unc0_gethtbls(w, cache, sn, (const byte *)sp);
+    if (ov) VCOPY(w, ov, &v);
     return unc_returnlocal(w, 0, &v);
 
 memfail:
@@ -271,31 +274,21 @@ Unc_RetVal unc0_g_object(Unc_View *w, Unc_Tuple args, void *udata) {
         Unc_Size i;
         Unc_Object *o = LEFTOVER(Unc_Object, VGETENT(&v));
         Unc_Dict *dict;
-        Unc_HTblV_V *nx;
+        Unc_Value *nx, k;
 
         dict = LEFTOVER(Unc_Dict, VGETENT(&args.values[1]));
         UNC_LOCKL(dict->lock);
-        i = -1;
-        nx = NULL;
-
-        for (;;) {
-            while (!nx) {
-                if (++i >= dict->data.capacity) {
-                    UNC_UNLOCKL(dict->lock);
-                    goto unc0_g_object_exit;
-                }
-                nx = dict->data.buckets[i];
-            }
-            e = unc0_osetindxraw(w, o, &nx->key, &nx->val);
+        i = 0;
+        while ((nx = unc0_iterhtblv(&dict->data, &i, &k))) {
+            e = unc0_osetindxraw(w, o, &k, nx);
             if (e) {
                 unc0_hibernate(VGETENT(&v), w);
                 UNC_UNLOCKL(dict->lock);
                 return e;
             }
-            nx = nx->next;
         }
+        UNC_UNLOCKL(dict->lock);
     }
-unc0_g_object_exit:
     if (freeze) unc0_ofreeze(w, LEFTOVER(Unc_Object, VGETENT(&v)));
     return unc_returnlocal(w, 0, &v);
 }
@@ -466,6 +459,119 @@ fail:
     return e;
 }
 
+static Unc_RetVal unc0_gt_getkind(Unc_View *w, Unc_Value *v, int *kind) {
+    if (VGETTYPE(v) == Unc_TString) {
+        Unc_String *s = LEFTOVER(Unc_String, VGETENT(v));
+        int k = unc0_takindbyname(s->size, unc0_getstringdata(s));
+        if (k >= 0) {
+            *kind = k;
+            return 0;
+        }
+    }
+    return unc0_throwexc(w, "value", "unknown typed array kind");
+}
+
+/* appends to a typed array that is not visible to any other code yet */
+static Unc_RetVal unc0_gt_append(Unc_View *w, Unc_TypedArray *a,
+                                 Unc_Value *v) {
+    Unc_Blob *b = LEFTOVER(Unc_Blob, a->blob);
+    Unc_Size z = (Unc_Size)1 << a->shift;
+    if (b->size + z > b->capacity) {
+        Unc_Size nc = b->capacity < 64 ? 64 : b->capacity * 2;
+        byte *np = unc0_mrealloc(&w->world->alloc, Unc_AllocBlob,
+                                 b->data, b->capacity, nc);
+        if (!np) return UNCIL_ERR_MEM;
+        b->data = np;
+        b->capacity = nc;
+    }
+    b->size += z;
+    return unc0_tastore(a->kind, b->data, (b->size >> a->shift) - 1, v);
+}
+
+Unc_RetVal unc0_g_tarray(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value ta = UNC_BLANK;
+    Unc_Value iter = UNC_BLANK;
+    Unc_Pile pile;
+    Unc_Tuple tuple;
+    Unc_Size i, n;
+    byte *p;
+    int kind;
+
+    e = unc0_gt_getkind(w, &args.values[1], &kind);
+    if (e) return e;
+    if (VGETTYPE(&args.values[2]) == Unc_TArray) {
+        /* no need to go through an iterator */
+        Unc_Value *av;
+        e = unc_lockarray(w, &args.values[2], &n, &av);
+        if (e) return e;
+        e = unc0_newtarray(w, kind, n, &p, &ta);
+        for (i = 0; !e && i < n; ++i)
+            e = unc0_tastore(kind, p, i, &av[i]);
+        unc_unlock(w, &args.values[2]);
+        if (e) {
+            VCLEAR(w, &ta);
+            return unc0_taerror(w, e);
+        }
+        return unc_returnlocal(w, 0, &ta);
+    }
+
+    e = unc0_vgetiter(w, &iter, &args.values[2]);
+    if (e) return e;
+    e = unc0_newtarray(w, kind, 0, &p, &ta);
+    if (e) goto fail;
+
+    do {
+        e = unc_call(w, &iter, 0, &pile);
+        if (e) goto fail;
+        unc_returnvalues(w, &pile, &tuple);
+        if (tuple.count) {
+            e = unc0_gt_append(w, LEFTOVER(Unc_TypedArray, VGETENT(&ta)),
+                               &tuple.values[0]);
+            if (e) {
+                unc_discard(w, &pile);
+                e = unc0_taerror(w, e);
+                goto fail;
+            }
+        }
+        unc_discard(w, &pile);
+    } while (tuple.count);
+
+    VCLEAR(w, &iter);
+    return unc_returnlocal(w, 0, &ta);
+fail:
+    VCLEAR(w, &iter);
+    VCLEAR(w, &ta);
+    return e;
+}
+
+/* like unc_getstring, but the data need not be terminated, which lets
+   slices be read without copying them */
+static Unc_RetVal unc0_getstrbytes(Unc_View *w, Unc_Value *v,
+                                   Unc_Size *n, const char **p) {
+    Unc_String *s;
+    if (v->type != Unc_TString)
+        return UNCIL_ERR_TYPE_NOTSTR;
+    s = LEFTOVER(Unc_String, VGETENT(v));
+    *n = s->size;
+    *p = (const char *)unc0_getstringdata(s);
+    return 0;
+}
+
+/* code point i of s, counting from the end if i is negative, or NULL if
+   out of range (the end of s if it is just past the last code point).
+   *pi is set to the index from the start */
+static const byte *unc0_getstrcodepat(Unc_View *w, Unc_String *s,
+                                      Unc_Int i, Unc_Size *pi) {
+    if (i < 0) {
+        Unc_Size l = unc0_strlength(w, s);
+        if ((Unc_Size)-i > l) return NULL;
+        *pi = l - (Unc_Size)-i;
+    } else
+        *pi = (Unc_Size)i;
+    return unc0_strcodepat(w, s, *pi);
+}
+
 Unc_RetVal unc0_gs_size(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
     Unc_Size sn;
@@ -474,7 +580,7 @@ Unc_RetVal unc0_gs_size(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_Value v;
 
     ASSERT(args.count == 1);
-    e = unc_getstring(w, &args.values[0], &sn, &sp);
+    e = unc0_getstrbytes(w, &args.values[0], &sn, &sp);
     if (e) return e;
     ui = (Unc_Int)sn;
     
@@ -490,9 +596,10 @@ Unc_RetVal unc0_gs_length(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_Value v;
 
     ASSERT(args.count == 1);
-    e = unc_getstring(w, &args.values[0], &sn, &sp);
+    e = unc0_getstrbytes(w, &args.values[0], &sn, &sp);
     if (e) return e;
-    ui = (Unc_Int)unc0_utf8unshift((const byte *)sp, sn);
+    ui = (Unc_Int)unc0_strlength(w, LEFTOVER(Unc_String,
+                                             VGETENT(&args.values[0])));
     
     VINITINT(&v, ui);
     return unc_returnlocal(w, 0, &v);
@@ -500,29 +607,31 @@ Unc_RetVal unc0_gs_length(Unc_View *w, Unc_Tuple args, void *udata) {
 
 Unc_RetVal unc0_gs_find(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
-    Unc_Size sn, sn2;
-    const byte *sp, *sp2;
+    Unc_String *s;
+    Unc_Size sn, sn2, a;
+    const byte *sp, *sp2, *sd;
     Unc_Int ui;
     Unc_Value v;
 
-    e = unc_getstring(w, &args.values[0], &sn, (const char **)&sp);
+    e = unc0_getstrbytes(w, &args.values[0], &sn, (const char **)&sp);
     if (e) return e;
-    e = unc_getstring(w, &args.values[1], &sn2, (const char **)&sp2);
+    e = unc0_getstrbytes(w, &args.values[1], &sn2, (const char **)&sp2);
     if (e) return e;
+    s = LEFTOVER(Unc_String, VGETENT(&args.values[0]));
+    sd = sp;
     if (unc_gettype(w, &args.values[2])) {
         e = unc_getint(w, &args.values[2], &ui);
         if (e) return e;
-        if (ui < 0)
-            sp = unc0_utf8shiftback(sp, &sn, -ui);
-        else
-            sp = unc0_utf8shift(sp, &sn, ui);
+        sp = unc0_getstrcodepat(w, s, ui, &a);
+        if (sp) sn = sd + sn - sp;
     } else {
         ui = 0;
+        a = 0;
     }
     if (sp) {
         const byte *sq = unc0_strsearch(sp, sn, sp2, sn2);
         VINITINT(&v, sq
-            ? unc0_utf8unshift(sp, sq - sp) + (ui < 0 ? 0 : ui) : -1);
+            ? unc0_strcodepof(w, s, sq - sd) - (ui < 0 ? a : 0) : -1);
     } else
         VINITINT(&v, -1);
     
@@ -531,24 +640,26 @@ Unc_RetVal unc0_gs_find(Unc_View *w, Unc_Tuple args, void *udata) {
 
 Unc_RetVal unc0_gs_findlast(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
-    Unc_Size sn, sn2;
+    Unc_String *s;
+    Unc_Size sn, sn2, a;
     const byte *sp, *sp2;
     Unc_Int ui;
     Unc_Value v;
 
-    e = unc_getstring(w, &args.values[0], &sn, (const char **)&sp);
+    e = unc0_getstrbytes(w, &args.values[0], &sn, (const char **)&sp);
     if (e) return e;
-    e = unc_getstring(w, &args.values[1], &sn2, (const char **)&sp2);
+    e = unc0_getstrbytes(w, &args.values[1], &sn2, (const char **)&sp2);
     if (e) return e;
+    s = LEFTOVER(Unc_String, VGETENT(&args.values[0]));
     if (unc_gettype(w, &args.values[2])) {
         e = unc_getint(w, &args.values[2], &ui);
         if (e) return e;
-        if (ui < 0)
-            sp = unc0_utf8shiftaway(sp, &sn, -ui);
-        else if (ui > 0) {
-            Unc_Size qn = sn;
-            (void)unc0_utf8shift(sp, &qn, ui);
-            sn = sn - qn;
+        if (ui) {
+            const byte *sq = unc0_getstrcodepat(w, s, ui, &a);
+            if (sq)
+                sn = sq - sp;
+            else if (ui < 0)
+                sp = NULL;
         }
     } else {
         ui = 0;
@@ -556,7 +667,7 @@ Unc_RetVal unc0_gs_findlast(Unc_View *w, Unc_Tuple args, void *udata) {
     if (sp) {
         const byte *sq = unc0_strsearchr(sp, sn, sp2, sn2);
         VINITINT(&v, sq
-            ? unc0_utf8unshift(sp, sq - sp) + (ui < 0 ? 0 : ui) : -1);
+            ? unc0_strcodepof(w, s, sq - sp) + (ui < 0 ? 0 : ui) : -1);
     } else
         VINITINT(&v, -1);
     
@@ -565,37 +676,42 @@ Unc_RetVal unc0_gs_findlast(Unc_View *w, Unc_Tuple args, void *udata) {
 
 Unc_RetVal unc0_gs_sub(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
-    Unc_Size sn;
-    const byte *sp;
+    Unc_String *s;
+    Unc_Size sn, a;
+    const byte *sp, *se;
     Unc_Int ui1, ui2;
     Unc_Value v = UNC_BLANK;
 
-    e = unc_getstring(w, &args.values[0], &sn, (const char **)&sp);
+    e = unc0_getstrbytes(w, &args.values[0], &sn, (const char **)&sp);
     if (e) return e;
     e = unc_getint(w, &args.values[1], &ui1);
     if (e) return e;
-    if (ui1 < 0)
-        sp = unc0_utf8shiftback(sp, &sn, -ui1);
-    else
-        sp = unc0_utf8shift(sp, &sn, ui1);
+    s = LEFTOVER(Unc_String, VGETENT(&args.values[0]));
+    se = sp + sn;
+    sp = unc0_getstrcodepat(w, s, ui1, &a);
+    sn = sp ? se - sp : 0;
     if (sp && unc_gettype(w, &args.values[2])) {
         const byte *sq;
         e = unc_getint(w, &args.values[2], &ui2);
         if (e) return e;
         if (ui2 >= 0) {
-            if (ui2 <= ui1)
+            if ((Unc_Size)ui2 <= a)
                 e = unc_newstring(w, &v, 0, NULL);
             else {
-                sq = unc0_utf8shift(sp, &sn, ui2 - ui1);
-                if (!sq) sq = sp + sn;
-                e = unc_newstring(w, &v, sq - sp, (const char *)sp);
+                sq = unc0_strcodepat(w, s, (Unc_Size)ui2);
+                if (!sq) sq = se;
+                e = unc0_newstringslice(w, &v, &args.values[0], sq - sp, sp);
             }
         } else {
-            (void)unc0_utf8shiftaway(sp, &sn, -ui2);
-            e = unc_newstring(w, &v, sn, (const char *)sp);
+            Unc_Size l = unc0_strlength(w, s);
+            if ((Unc_Size)-ui2 > l - a)
+                sn = 0;
+            else
+                sn = unc0_strcodepat(w, s, l - (Unc_Size)-ui2) - sp;
+            e = unc0_newstringslice(w, &v, &args.values[0], sn, sp);
         }
     } else
-        e = unc_newstring(w, &v, sn, (const char *)sp);
+        e = unc0_newstringslice(w, &v, &args.values[0], sn, sp);
     return unc_returnlocal(w, e, &v);
 }
 
@@ -606,15 +722,16 @@ Unc_RetVal unc0_gs_charcode(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_Int ui = 0;
     Unc_Value v;
 
-    e = unc_getstring(w, &args.values[0], &sn, (const char **)&sp);
+    e = unc0_getstrbytes(w, &args.values[0], &sn, (const char **)&sp);
     if (e) return e;
     if (unc_gettype(w, &args.values[1])) {
+        const byte *se = sp + sn;
+        Unc_Size a;
         e = unc_getint(w, &args.values[1], &ui);
         if (e) return e;
-        if (ui < 0)
-            sp = unc0_utf8shiftback(sp, &sn, -ui);
-        else
-            sp = unc0_utf8shift(sp, &sn, ui);
+        sp = unc0_getstrcodepat(w, LEFTOVER(Unc_String,
+                                    VGETENT(&args.values[0])), ui, &a);
+        sn = sp ? se - sp : 0;
         if (ui && !sn)
             return unc0_throwexc(w, "value", "string index out of bounds");
     }
@@ -650,7 +767,7 @@ Unc_RetVal unc0_gs_reverse(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_Entity *en;
 
     ASSERT(args.count == 1);
-    e = unc_getstring(w, &args.values[0], &sn, (const char **)&sp);
+    e = unc0_getstrbytes(w, &args.values[0], &sn, (const char **)&sp);
     if (e) return e;
     
     buf = unc0_malloc(&w->world->alloc, Unc_AllocString, sn + 1);
@@ -686,7 +803,7 @@ Unc_RetVal unc0_gs_asciilower(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_Entity *en;
 
     ASSERT(args.count == 1);
-    e = unc_getstring(w, &args.values[0], &sn, (const char **)&sp);
+    e = unc0_getstrbytes(w, &args.values[0], &sn, (const char **)&sp);
     if (e) return e;
     
     buf = unc0_malloc(&w->world->alloc, Unc_AllocString, sn + 1);
@@ -728,7 +845,7 @@ Unc_RetVal unc0_gs_asciiupper(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_Entity *en;
 
     ASSERT(args.count == 1);
-    e = unc_getstring(w, &args.values[0], &sn, (const char **)&sp);
+    e = unc0_getstrbytes(w, &args.values[0], &sn, (const char **)&sp);
     if (e) return e;
     
     buf = unc0_malloc(&w->world->alloc, Unc_AllocString, sn + 1);
@@ -761,51 +878,121 @@ Unc_RetVal unc0_gs_asciiupper(Unc_View *w, Unc_Tuple args, void *udata) {
     return unc_returnlocal(w, 0, &v);
 }
 
+/* the longest string that unc0_gs_allocbuf may be asked for */
+#define UNC_GS_STRMAX ((Unc_Size)UNC_INT_MAX < UNC_SIZE_MAX - 1                \
+                            ? (Unc_Size)UNC_INT_MAX : UNC_SIZE_MAX - 1)
+
+/* allocate room for a new string of n bytes, to be filled in and then
+   passed on to unc0_gs_returnbuf */
+static byte *unc0_gs_allocbuf(Unc_View *w, Unc_Size n) {
+    return unc0_malloc(&w->world->alloc, Unc_AllocString, n + 1);
+}
+
+/* return a string made out of a buffer from unc0_gs_allocbuf. the buffer
+   is consumed even on failure */
+static Unc_RetVal unc0_gs_returnbuf(Unc_View *w, Unc_Size n, byte *buf) {
+    Unc_RetVal e;
+    Unc_Value v;
+    Unc_Entity *en = unc0_wake(w, Unc_TString);
+    if (!en) {
+        unc0_mfree(&w->world->alloc, buf, n + 1);
+        return UNCIL_ERR_MEM;
+    }
+    buf[n] = 0;
+    e = unc0_initstringmove(&w->world->alloc,
+                            LEFTOVER(Unc_String, en), n, buf);
+    if (e) {
+        unc0_mfree(&w->world->alloc, buf, n + 1);
+        unc0_unwake(en, w);
+        return e;
+    }
+    VINITENT(&v, Unc_TString, en);
+    return unc_returnlocal(w, 0, &v);
+}
+
+/* matches found while counting them, so that they need not be searched
+   for again when filling in the result */
+struct unc0_gs_matches {
+    const byte *s0;
+    struct unc0_strbuf pos;
+    Unc_Size i;
+};
+
+/* number of non-overlapping matches of find (findn > 0) in src, at most
+   maxrepl, scanning from the end if dir. the offsets of the first ones
+   are remembered in m, which must be freed with unc0_strbuf_free(&m->pos).
+   they are capped to take about as much memory as src */
+static Unc_Size unc0_gs_countmatches(Unc_View *w, struct unc0_gs_matches *m,
+                                     const byte *src, Unc_Size srcn,
+                                     const byte *find, Unc_Size findn,
+                                     Unc_Size maxrepl, int dir) {
+    Unc_Size k = 0, cap = srcn, off;
+    const byte *sq;
+    m->s0 = src;
+    m->i = 0;
+    unc0_strbuf_init(&m->pos, &w->world->alloc, Unc_AllocInternal);
+    while (k < maxrepl) {
+        sq = dir ? unc0_strsearchr(src, srcn, find, findn)
+                 : unc0_strsearch(src, srcn, find, findn);
+        if (!sq) break;
+        /* if remembering fails, the rest are simply searched for again */
+        if (m->pos.length == k * sizeof(Unc_Size) && m->pos.length < cap) {
+            off = sq - m->s0;
+            unc0_strbuf_putn(&m->pos, sizeof(Unc_Size), (const byte *)&off);
+        }
+        if (dir) {
+            srcn = sq - src;
+        } else {
+            srcn -= sq + findn - src;
+            src = sq + findn;
+        }
+        ++k;
+    }
+    return k;
+}
+
+/* the next match in src counted by unc0_gs_countmatches */
+static const byte *unc0_gs_nextmatch(struct unc0_gs_matches *m,
+                                     const byte *src, Unc_Size srcn,
+                                     const byte *find, Unc_Size findn,
+                                     int dir) {
+    if (m->i < m->pos.length / sizeof(Unc_Size))
+        return m->s0 + ((const Unc_Size *)m->pos.buffer)[m->i++];
+    return dir ? unc0_strsearchr(src, srcn, find, findn)
+               : unc0_strsearch(src, srcn, find, findn);
+}
+
 Unc_RetVal unc0_gs_repeat(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
-    Unc_Size sn;
+    Unc_Size sn, n, k, m;
     const byte *sp;
     byte *buf;
-    Unc_Value v;
-    Unc_Int ui, ut;
-    Unc_Entity *en;
+    Unc_Int ui;
 
     ASSERT(args.count == 2);
-    e = unc_getstring(w, &args.values[0], &sn, (const char **)&sp);
+    e = unc0_getstrbytes(w, &args.values[0], &sn, (const char **)&sp);
     if (e) return e;
     e = unc_getint(w, &args.values[1], &ui);
     if (e) return e;
     if (ui < 0)
         return unc0_throwexc(w, "value",
                     "cannot repeat a negative number of times");
-    
-    if (ui) {
-        buf = unc0_malloc(&w->world->alloc, Unc_AllocString, sn * ui + 1);
-        if (!buf) {
-            return UNCIL_ERR_MEM;
+    if (sn && ui > (Unc_Int)(UNC_GS_STRMAX / sn))
+        return UNCIL_ERR_ARG_STRINGTOOLONG;
+
+    n = sn * (Unc_Size)ui;
+    buf = unc0_gs_allocbuf(w, n);
+    if (!buf) return UNCIL_ERR_MEM;
+
+    /* keep doubling the part already filled in */
+    if (n) {
+        unc0_memcpy(buf, sp, sn);
+        for (k = sn; k < n; k += m) {
+            m = k <= n - k ? k : n - k;
+            unc0_memcpy(buf + k, buf, m);
         }
-    } else
-        buf = NULL;
-    
-    en = unc0_wake(w, Unc_TString);
-    if (!en) {
-        unc0_mfree(&w->world->alloc, buf, sn * ui + 1);
-        return UNCIL_ERR_MEM;
     }
-    
-    for (ut = 0; ut < ui; ++ut)
-        unc0_memcpy(buf + ut * sn, sp, sn);
-    buf[sn * ui] = 0;
-
-    e = unc0_initstringmove(&w->world->alloc,
-                            LEFTOVER(Unc_String, en), sn * ui, buf);
-    if (e) {
-        unc0_mfree(&w->world->alloc, buf, sn * ui + 1);
-        unc0_unwake(en, w);
-        return e;
-    }
-    VINITENT(&v, Unc_TString, en);
-    return unc_returnlocal(w, 0, &v);
+    return unc0_gs_returnbuf(w, n, buf);
 }
 
 int unc0_gs_join_out_(Unc_Size n, const byte *s, void *udata) {
@@ -813,6 +1000,49 @@ int unc0_gs_join_out_(Unc_Size n, const byte *s, void *udata) {
     return unc0_strbuf_putn(buf, n, s);
 }
 
+/* join an array that only contains strings with a single allocation.
+   sets *ok to 0 and returns without doing anything otherwise */
+static Unc_RetVal unc0_gs_joinarray(Unc_View *w, Unc_Value *arr,
+                                    Unc_Size sepn, const byte *sep,
+                                    int *ok) {
+    Unc_RetVal e;
+    Unc_Size an, i, n = 0;
+    Unc_Value *ap;
+    byte *buf, *p;
+
+    e = unc_lockarray(w, arr, &an, &ap);
+    if (e) return e;
+    for (i = 0; i < an; ++i) {
+        Unc_Size sn;
+        if (ap[i].type != Unc_TString) {
+            unc_unlock(w, arr);
+            *ok = 0;
+            return 0;
+        }
+        sn = LEFTOVER(Unc_String, VGETENT(&ap[i]))->size;
+        if (i) sn += sepn;
+        if (sn > UNC_GS_STRMAX - n) {
+            unc_unlock(w, arr);
+            return UNCIL_ERR_ARG_STRINGTOOLONG;
+        }
+        n += sn;
+    }
+
+    buf = unc0_gs_allocbuf(w, n);
+    if (!buf) {
+        unc_unlock(w, arr);
+        return UNCIL_ERR_MEM;
+    }
+    for (i = 0, p = buf; i < an; ++i) {
+        Unc_String *s = LEFTOVER(Unc_String, VGETENT(&ap[i]));
+        if (i) p += unc0_memcpy(p, sep, sepn);
+        p += unc0_memcpy(p, unc0_getstringdata(s), s->size);
+    }
+    unc_unlock(w, arr);
+    *ok = 1;
+    return unc0_gs_returnbuf(w, n, buf);
+}
+
 Unc_RetVal unc0_gs_join(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
     int addsep = 0;
@@ -824,12 +1054,20 @@ Unc_RetVal unc0_gs_join(Unc_View *w, Unc_Tuple args, void *udata) {
     const byte *sep;
     struct unc0_strbuf buf;
 
-    e = unc0_vgetiter(w, &iter, &args.values[1]);
+    e = unc0_getstrbytes(w, &args.values[0], &sepn, (const char **)&sep);
     if (e) return e;
 
-    e = unc_getstring(w, &args.values[0], &sepn, (const char **)&sep);
+    if (unc_gettype(w, &args.values[1]) == Unc_TArray) {
+        /* the arguments may move if the value stack is resized */
+        Unc_Value arr = args.values[1];
+        int ok;
+        e = unc0_gs_joinarray(w, &arr, sepn, sep, &ok);
+        if (e || ok) return e;
+    }
+
+    e = unc0_vgetiter(w, &iter, &args.values[1]);
     if (e) return e;
-    
+
     unc0_strbuf_init(&buf, &w->world->alloc, Unc_AllocString);
 
     do {
@@ -862,18 +1100,18 @@ fail:
 Unc_RetVal unc0_gs_replace(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
     int dir = 0;
-    Unc_Value v = UNC_BLANK;
-    Unc_Size srcn, findn, dstn, maxrepl;
+    Unc_Size srcn, findn, dstn, maxrepl, k, n;
     const byte *src, *find, *dst;
-    struct unc0_strbuf buf;
+    byte *buf, *p;
+    struct unc0_gs_matches m;
 
-    e = unc_getstring(w, &args.values[0], &srcn, (const char **)&src);
+    e = unc0_getstrbytes(w, &args.values[0], &srcn, (const char **)&src);
     if (e) return e;
 
-    e = unc_getstring(w, &args.values[1], &findn, (const char **)&find);
+    e = unc0_getstrbytes(w, &args.values[1], &findn, (const char **)&find);
     if (e) return e;
 
-    e = unc_getstring(w, &args.values[2], &dstn, (const char **)&dst);
+    e = unc0_getstrbytes(w, &args.values[2], &dstn, (const char **)&dst);
     if (e) return e;
 
     if (unc_gettype(w, &args.values[3])) {
@@ -891,109 +1129,113 @@ Unc_RetVal unc0_gs_replace(Unc_View *w, Unc_Tuple args, void *udata) {
     if (!maxrepl)
         return unc_returnlocal(w, 0, &args.values[0]);
 
-    unc0_strbuf_init(&buf, &w->world->alloc, Unc_AllocString);
-
+    /* count the replacements first, so that the result can be allocated
+       at its final size. an empty pattern matches before every code point
+       and at the end */
     if (!findn) {
-        if (dir) {
-            e = unc0_strbuf_putn_rv(&buf, dstn, dst);
-            if (e) goto unc0_gs_replace_fail;
-            while (srcn && --maxrepl) {
+        unc0_strbuf_init_blank(&m.pos);
+        k = unc0_utf8unshift(src, srcn);
+        if (k > maxrepl - 1) k = maxrepl - 1;
+        ++k;
+    } else {
+        k = unc0_gs_countmatches(w, &m, src, srcn, find, findn, maxrepl, dir);
+        if (!k) {
+            unc0_strbuf_free(&m.pos);
+            return unc_returnlocal(w, 0, &args.values[0]);
+        }
+    }
+
+    if (dstn > findn && k > (UNC_GS_STRMAX - srcn) / (dstn - findn)) {
+        e = UNCIL_ERR_ARG_STRINGTOOLONG;
+        goto unc0_gs_replace_fail;
+    }
+    n = srcn - k * findn + k * dstn;
+    buf = unc0_gs_allocbuf(w, n);
+    if (!buf) {
+        e = UNCIL_ERR_MEM;
+        goto unc0_gs_replace_fail;
+    }
+
+    if (dir) {
+        /* fill in from the end */
+        p = buf + n;
+        if (!findn) {
+            p -= dstn;
+            unc0_memcpy(p, dst, dstn);
+            while (--k) {
                 const byte *se = src + srcn,
                            *srcp = unc0_utf8scanbackw(src, se, 0);
-                if (!srcp)
-                    srcn = 0;
-                else {
-                    e = unc0_strbuf_putn_rv(&buf, se - srcp, srcp);
-                    if (e) goto unc0_gs_replace_fail;
-                    srcn = srcp - src;
-                }
-                e = unc0_strbuf_putn_rv(&buf, dstn, dst);
-                if (e) goto unc0_gs_replace_fail;
+                p -= se - srcp;
+                unc0_memcpy(p, srcp, se - srcp);
+                srcn = srcp - src;
+                p -= dstn;
+                unc0_memcpy(p, dst, dstn);
             }
-            if (srcn) {
-                e = unc0_strbuf_putn_rv(&buf, srcn, src);
-                if (e) goto unc0_gs_replace_fail;
-            }
-            unc0_memrev(buf.buffer, buf.length);
         } else {
-            e = unc0_strbuf_putn(&buf, dstn, dst);
-            if (e) goto unc0_gs_replace_fail;
-            while (srcn && --maxrepl) {
+            while (k--) {
                 const byte *se = src + srcn,
-                           *srcp = unc0_utf8scanforw(src, se, 1);
-                if (!srcp) srcp = se;
-                e = unc0_strbuf_putn(&buf, srcp - src, src);
-                if (e) goto unc0_gs_replace_fail;
-                srcn -= srcp - src;
-                src = srcp;
-                e = unc0_strbuf_putn(&buf, dstn, dst);
-                if (e) goto unc0_gs_replace_fail;
-            }
-            if (srcn) {
-                e = unc0_strbuf_putn(&buf, srcn, src);
-                if (e) goto unc0_gs_replace_fail;
+                           *sq = unc0_gs_nextmatch(&m, src, srcn,
+                                                   find, findn, dir),
+                           *sr = sq + findn;
+                p -= se - sr;
+                unc0_memcpy(p, sr, se - sr);
+                p -= dstn;
+                unc0_memcpy(p, dst, dstn);
+                srcn = sq - src;
             }
         }
+        ASSERT(p - buf == srcn);
+        unc0_memcpy(buf, src, srcn);
     } else {
-        if (dir) {
-            while (srcn && maxrepl) {
+        p = buf;
+        if (!findn) {
+            p += unc0_memcpy(p, dst, dstn);
+            while (--k) {
                 const byte *se = src + srcn,
-                           *sq = unc0_strsearchr(src, srcn, find, findn),
-                           *sr;
-                if (!sq) break;
-                sr = sq + findn;
-                e = unc0_strbuf_putn_rv(&buf, se - sr, sr);
-                if (e) goto unc0_gs_replace_fail;
-                e = unc0_strbuf_putn_rv(&buf, dstn, dst);
-                if (e) goto unc0_gs_replace_fail;
-                srcn = sq - src;
-                --maxrepl;
-            }
-            if (srcn) {
-                e = unc0_strbuf_putn_rv(&buf, srcn, src);
-                if (e) goto unc0_gs_replace_fail;
+                           *srcp = unc0_utf8scanforw(src, se, 1);
+                if (!srcp) srcp = se;
+                p += unc0_memcpy(p, src, srcp - src);
+                p += unc0_memcpy(p, dst, dstn);
+                srcn -= srcp - src;
+                src = srcp;
             }
-            unc0_memrev(buf.buffer, buf.length);
         } else {
-            while (srcn && maxrepl) {
-                const byte *sq = unc0_strsearch(src, srcn, find, findn), *sr;
-                if (!sq) break;
-                sr = sq + findn;
-                e = unc0_strbuf_putn(&buf, sq - src, src);
-                if (e) goto unc0_gs_replace_fail;
-                e = unc0_strbuf_putn(&buf, dstn, dst);
-                if (e) goto unc0_gs_replace_fail;
+            while (k--) {
+                const byte *sq = unc0_gs_nextmatch(&m, src, srcn,
+                                                   find, findn, dir),
+                           *sr = sq + findn;
+                p += unc0_memcpy(p, src, sq - src);
+                p += unc0_memcpy(p, dst, dstn);
                 srcn -= sr - src;
                 src = sr;
-                --maxrepl;
-            }
-            if (srcn) {
-                e = unc0_strbuf_putn(&buf, srcn, src);
-                if (e) goto unc0_gs_replace_fail;
             }
         }
+        p += unc0_memcpy(p, src, srcn);
+        ASSERT(p - buf == n);
     }
 
-    e = unc0_buftostring(w, &v, &buf);
-    if (!e) return unc_returnlocal(w, 0, &v);
-
+    unc0_strbuf_free(&m.pos);
+    return unc0_gs_returnbuf(w, n, buf);
 unc0_gs_replace_fail:
-    unc0_strbuf_free(&buf);
+    unc0_strbuf_free(&m.pos);
     return e;
 }
 
 Unc_RetVal unc0_gs_split(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
     int dir = 0;
-    Unc_Value arr = UNC_BLANK, v = UNC_BLANK;
-    Unc_Size srcn, findn, dstn, maxrepl;
+    Unc_Value arr = UNC_BLANK, v = UNC_BLANK, sv;
+    Unc_Size srcn, findn, dstn, maxrepl, i;
     const byte *src, *find;
     Unc_Value *dst;
+    struct unc0_gs_matches m;
 
-    e = unc_getstring(w, &args.values[0], &srcn, (const char **)&src);
+    e = unc0_getstrbytes(w, &args.values[0], &srcn, (const char **)&src);
     if (e) return e;
+    /* the arguments may move if the value stack is resized */
+    sv = args.values[0];
 
-    e = unc_getstring(w, &args.values[1], &findn, (const char **)&find);
+    e = unc0_getstrbytes(w, &args.values[1], &findn, (const char **)&find);
     if (e) return e;
 
     if (unc_gettype(w, &args.values[2])) {
@@ -1008,104 +1250,85 @@ Unc_RetVal unc0_gs_split(Unc_View *w, Unc_Tuple args, void *udata) {
     } else
         maxrepl = UNC_SIZE_MAX;
 
-    dstn = 0;
+    /* count the pieces first, so that the array is only allocated once.
+       an empty pattern splits between code points */
+    if (!findn) {
+        unc0_strbuf_init_blank(&m.pos);
+        dstn = unc0_utf8unshift(src, srcn);
+        if (dstn > maxrepl) dstn = maxrepl + 1;
+    } else
+        dstn = unc0_gs_countmatches(w, &m, src, srcn, find, findn,
+                                    maxrepl, dir) + 1;
+
     e = unc_newarray(w, &arr, dstn, &dst);
-    if (e) return e;
-    
+    if (e) {
+        unc0_strbuf_free(&m.pos);
+        return e;
+    }
+
+    /* when splitting from the end, fill in the array from the end */
     if (!findn) {
         if (dir) {
-            while (srcn && maxrepl--) {
+            for (i = dstn; i > 0; --i) {
                 const byte *se = src + srcn,
-                           *srcp = unc0_utf8scanbackw(src, se, 0);
-                if (!srcp)
-                    srcn = 0;
-                else {
-                    e = unc_newstring(w, &v, se - srcp, (const char *)srcp);
-                    if (e) goto unc0_gs_split_fail;
-                    e = unc_resizearray(w, &arr, dstn + 1, &dst);
-                    if (e) goto unc0_gs_split_fail;
-                    unc_copy(w, &dst[dstn++], &v);
-                    srcn = srcp - src;
-                }
-            }
-            if (srcn) {
-                e = unc_newstring(w, &v, srcn, (const char *)src);
+                           *srcp = i > 1 ? unc0_utf8scanbackw(src, se, 0)
+                                         : src;
+                e = unc0_newstringslice(w, &v, &sv, se - srcp, srcp);
                 if (e) goto unc0_gs_split_fail;
-                e = unc_resizearray(w, &arr, dstn + 1, &dst);
-                if (e) goto unc0_gs_split_fail;
-                unc_copy(w, &dst[dstn++], &v);
+                unc_copy(w, &dst[i - 1], &v);
+                srcn = srcp - src;
             }
         } else {
-            while (srcn && maxrepl--) {
+            for (i = 0; i < dstn; ++i) {
                 const byte *se = src + srcn,
-                           *srcp = unc0_utf8scanforw(src, se, 1);
+                           *srcp = i + 1 < dstn
+                                 ? unc0_utf8scanforw(src, se, 1) : se;
                 if (!srcp) srcp = se;
-                e = unc_newstring(w, &v, srcp - src, (const char *)src);
+                e = unc0_newstringslice(w, &v, &sv, srcp - src, src);
                 if (e) goto unc0_gs_split_fail;
-                e = unc_resizearray(w, &arr, dstn + 1, &dst);
-                if (e) goto unc0_gs_split_fail;
-                unc_copy(w, &dst[dstn++], &v);
+                unc_copy(w, &dst[i], &v);
                 srcn -= srcp - src;
                 src = srcp;
             }
-            if (srcn) {
-                e = unc_newstring(w, &v, srcn, (const char *)src);
-                if (e) goto unc0_gs_split_fail;
-                e = unc_resizearray(w, &arr, dstn + 1, &dst);
-                if (e) goto unc0_gs_split_fail;
-                unc_copy(w, &dst[dstn++], &v);
-            }
         }
     } else {
         if (dir) {
-            while (srcn && maxrepl) {
+            for (i = dstn; i > 1; --i) {
                 const byte *se = src + srcn,
-                           *sq = unc0_strsearchr(src, srcn, find, findn),
-                           *sr;
-                if (!sq) break;
-                sr = sq + findn;
-                e = unc_newstring(w, &v, se - sr, (const char *)sr);
+                           *sq = unc0_gs_nextmatch(&m, src, srcn,
+                                                   find, findn, dir),
+                           *sr = sq + findn;
+                e = unc0_newstringslice(w, &v, &sv, se - sr, sr);
                 if (e) goto unc0_gs_split_fail;
-                e = unc_resizearray(w, &arr, dstn + 1, &dst);
-                if (e) goto unc0_gs_split_fail;
-                unc_copy(w, &dst[dstn++], &v);
+                unc_copy(w, &dst[i - 1], &v);
                 srcn = sq - src;
-                --maxrepl;
             }
-            e = unc_newstring(w, &v, srcn, (const char *)src);
-            if (e) goto unc0_gs_split_fail;
-            e = unc_resizearray(w, &arr, dstn + 1, &dst);
+            e = unc0_newstringslice(w, &v, &sv, srcn, src);
             if (e) goto unc0_gs_split_fail;
-            unc_copy(w, &dst[dstn++], &v);
+            unc_copy(w, &dst[0], &v);
         } else {
-            while (srcn && maxrepl) {
-                const byte *sq = unc0_strsearch(src, srcn, find, findn), *sr;
-                if (!sq) break;
-                sr = sq + findn;
-                e = unc_newstring(w, &v, sq - src, (const char *)src);
+            for (i = 0; i + 1 < dstn; ++i) {
+                const byte *sq = unc0_gs_nextmatch(&m, src, srcn,
+                                                   find, findn, dir),
+                           *sr = sq + findn;
+                e = unc0_newstringslice(w, &v, &sv, sq - src, src);
                 if (e) goto unc0_gs_split_fail;
-                e = unc_resizearray(w, &arr, dstn + 1, &dst);
-                if (e) goto unc0_gs_split_fail;
-                unc_copy(w, &dst[dstn++], &v);
+                unc_copy(w, &dst[i], &v);
                 srcn -= sr - src;
                 src = sr;
-                --maxrepl;
             }
-            e = unc_newstring(w, &v, srcn, (const char *)src);
-            if (e) goto unc0_gs_split_fail;
-            e = unc_resizearray(w, &arr, dstn + 1, &dst);
+            e = unc0_newstringslice(w, &v, &sv, srcn, src);
             if (e) goto unc0_gs_split_fail;
-            unc_copy(w, &dst[dstn++], &v);
+            unc_copy(w, &dst[i], &v);
         }
     }
 
-    if (dir) /* reverse array */
-        unc0_reversevalues(dst, dstn);
-
+    unc0_strbuf_free(&m.pos);
     VCLEAR(w, &v);
     unc_unlock(w, &arr);
     return unc_returnlocal(w, 0, &arr);
 unc0_gs_split_fail:
+    unc0_strbuf_free(&m.pos);
     VCLEAR(w, &v);
     unc_unlock(w, &arr);
     unc_decref(w, &arr);
@@ -1962,60 +2185,208 @@ Unc_RetVal unc0_ga_remove(Unc_View *w, Unc_Tuple args, void *udata) {
     return e;
 }
 
+/* resolves begin and end indices into a range of an array of n elements.
+   negative indices count from the end, and the range is clamped to the
+   array. a null begin is the start and a null end is the end */
+static Unc_RetVal unc0_ga_range(Unc_View *w, Unc_Value *begin,
+                                Unc_Value *end, Unc_Size n,
+                                Unc_Size *offset, Unc_Size *count) {
+    Unc_RetVal e;
+    Unc_Int ui1 = 0, ui2 = (Unc_Int)n;
+
+    if (unc_gettype(w, begin)) {
+        e = unc_getint(w, begin, &ui1);
+        if (e) return e;
+        if (ui1 < 0)
+            ui1 = -ui1 > (Unc_Int)n ? 0 : (Unc_Int)n + ui1;
+        else if (ui1 > (Unc_Int)n)
+            ui1 = (Unc_Int)n;
+    }
+    if (unc_gettype(w, end)) {
+        e = unc_getint(w, end, &ui2);
+        if (e) return e;
+        if (ui2 < 0)
+            ui2 = -ui2 > (Unc_Int)n ? 0 : (Unc_Int)n + ui2;
+        else if (ui2 > (Unc_Int)n)
+            ui2 = (Unc_Int)n;
+    }
+    *offset = (Unc_Size)ui1;
+    *count = ui2 > ui1 ? (Unc_Size)(ui2 - ui1) : 0;
+    return 0;
+}
+
 Unc_RetVal unc0_ga_sub(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
-    Unc_Size sn;
+    Unc_Size sn, so, sc;
     Unc_Value *sp;
-    Unc_Int ui1, ui2;
     Unc_Value v = UNC_BLANK;
 
     e = unc_lockarray(w, &args.values[0], &sn, &sp);
     if (e) return e;
-    e = unc_getint(w, &args.values[1], &ui1);
-    if (e) {
-        unc_unlock(w, &args.values[0]);
-        return e;
-    }
-    if (ui1 < 0)
-        sp = -ui1 > (Unc_Int)sn ? NULL : sp + (sn + ui1),
-            sn = -ui1 > (Unc_Int)sn ? 0 : sn + ui1;
-    else
-        sp = ui1 > (Unc_Int)sn ? NULL : sp + ui1,
-            sn = ui1 > (Unc_Int)sn ? 0 : sn - ui1;
-    if (sp && unc_gettype(w, &args.values[2])) {
-        e = unc_getint(w, &args.values[2], &ui2);
-        if (e) {
-            unc_unlock(w, &args.values[0]);
-            return e;
-        }
-        if (ui2 > (Unc_Int)sn) ui2 = sn;
-        if (ui2 >= 0) {
-            if (ui2 <= ui1)
-                e = unc_newarrayfrom(w, &v, 0, NULL);
-            else {
-                e = unc_newarrayfrom(w, &v, ui2 - ui1, sp);
-            }
-        } else {
-            if ((Unc_Int)sn <= -ui2)
-                e = unc_newarrayfrom(w, &v, 0, NULL);
-            else
-                e = unc_newarrayfrom(w, &v, sn + ui2, sp);
-        }
-    } else
-        e = unc_newarrayfrom(w, &v, sn, sp);
+    e = unc0_ga_range(w, &args.values[1], &args.values[2], sn, &so, &sc);
+    if (!e)
+        e = unc_newarrayfrom(w, &v, sc, sc ? sp + so : NULL);
     unc_unlock(w, &args.values[0]);
     return unc_returnlocal(w, e, &v);
 }
 
+/* makes a new view of begin..end of an array or array view. a view of a
+   view is a view of the same array */
+static Unc_RetVal unc0_gv_make(Unc_View *w, Unc_Value *a, Unc_Value *begin,
+                               Unc_Value *end, Unc_Value *out) {
+    Unc_RetVal e;
+    Unc_Value v;
+    Unc_Entity *arr;
+    Unc_Array *ap;
+    Unc_Size base, n, so, sc;
+
+    switch (VGETTYPE(a)) {
+    case Unc_TArray:
+        arr = VGETENT(a);
+        ap = LEFTOVER(Unc_Array, arr);
+        base = 0;
+        UNC_LOCKL(ap->lock);
+        n = ap->size;
+        break;
+    case Unc_TArrayView:
+    {
+        Unc_ArrayView *av = LEFTOVER(Unc_ArrayView, VGETENT(a));
+        arr = av->array;
+        ap = LEFTOVER(Unc_Array, arr);
+        base = av->offset;
+        UNC_LOCKL(ap->lock);
+        n = unc0_avlength(av);
+        break;
+    }
+    default:
+        return unc0_throwexc(w, "type",
+                                "value is not an array or array view");
+    }
+    e = unc0_ga_range(w, begin, end, n, &so, &sc);
+    UNC_UNLOCKL(ap->lock);
+    if (e) return e;
+
+    e = unc0_vrefnew(w, &v, Unc_TArrayView);
+    if (e) return e;
+    UNCIL_INCREFE(w, arr);
+    unc0_initarrayview(w, LEFTOVER(Unc_ArrayView, VGETENT(&v)),
+                       arr, base + so, sc);
+    VMOVE(w, out, &v);
+    return 0;
+}
+
+Unc_RetVal unc0_ga_view(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+
+    if (VGETTYPE(&args.values[0]) != Unc_TArray)
+        return unc0_throwexc(w, "type", "value is not an array");
+    e = unc0_gv_make(w, &args.values[0], &args.values[1], &args.values[2],
+                     &v);
+    return unc_returnlocal(w, e, &v);
+}
+
+/* decorate-sort-undecorate: the key function is called once per item,
+   without the array locked, and the items are sorted by their keys */
+static Unc_RetVal unc0_ga_sortby(Unc_View *w, Unc_Value *arr,
+                                 Unc_Value *comp, Unc_Value *key,
+                                 Unc_Size threads) {
+    Unc_RetVal e;
+    Unc_Size sn, i, pushed = 0;
+    Unc_Value *sp, *kp, *vp;
+    Unc_Value vals = UNC_BLANK, keys = UNC_BLANK;
+
+    e = unc_lockarray(w, arr, &sn, &sp);
+    if (e) return e;
+    e = unc_newarrayfrom(w, &vals, sn, sp);
+    unc_unlock(w, arr);
+    if (e) return e;
+    e = unc_newarray(w, &keys, sn, &kp);
+    if (e) goto fail;
+    unc_unlock(w, &keys);
+    vp = LEFTOVER(Unc_Array, VGETENT(&vals))->data;
+
+    /* the garbage collector only looks inside arrays reachable from the
+       stack, and the keys may not be referenced from anywhere else */
+    e = unc_push(w, 1, &vals);
+    if (e) goto fail;
+    ++pushed;
+    e = unc_push(w, 1, &keys);
+    if (e) goto fail;
+    ++pushed;
+
+    for (i = 0; i < sn; ++i) {
+        Unc_Pile pile;
+        Unc_Tuple tuple;
+        e = unc_push(w, 1, &vp[i]);
+        if (e) goto fail;
+        e = unc_call(w, key, 1, &pile);
+        if (e) goto fail;
+        unc_returnvalues(w, &pile, &tuple);
+        if (!tuple.count) {
+            unc_discard(w, &pile);
+            e = unc0_throwexc(w, "value", "key function did not return "
+                                          "a value");
+            goto fail;
+        }
+        VCOPY(w, &kp[i], &tuple.values[0]);
+        unc_discard(w, &pile);
+    }
+
+    e = unc0_arrsortby(w, comp, sn, kp, vp, threads);
+    if (e) goto fail;
+
+    e = unc_lockarray(w, arr, &i, &sp);
+    if (e) goto fail;
+    if (i != sn) {
+        unc_unlock(w, arr);
+        e = unc0_throwexc(w, "value", "array modified by other code "
+                                      "while sorting");
+        goto fail;
+    }
+    for (i = 0; i < sn; ++i)
+        VCOPY(w, &sp[i], &vp[i]);
+    unc_unlock(w, arr);
+fail:
+    unc_pop(w, pushed);
+    VCLEAR(w, &keys);
+    VCLEAR(w, &vals);
+    return e;
+}
+
 Unc_RetVal unc0_ga_sort(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
-    Unc_Size sn;
+    Unc_Size sn, threads = 0;
     Unc_Value *sp;
     int hascomp = args.values[1].type;
 
+    /* parallel: null = automatic, true = all processors, false = one
+       thread, or the maximum number of threads */
+    switch (VGETTYPE(&args.values[3])) {
+    case Unc_TNull:
+        break;
+    case Unc_TBool:
+        threads = VGETBOOL(&args.values[3]) ? unc0_mtcpucount() : 1;
+        break;
+    default:
+    {
+        Unc_Int ui;
+        e = unc_getint(w, &args.values[3], &ui);
+        if (e) return e;
+        if (ui < 1)
+            return unc0_throwexc(w, "value",
+                                 "number of threads must be positive");
+        threads = (Unc_Size)ui;
+    }
+    }
+
+    if (args.values[2].type)
+        return unc0_ga_sortby(w, &args.values[0],
+                              hascomp ? &args.values[1] : NULL,
+                              &args.values[2], threads);
     e = unc_lockarray(w, &args.values[0], &sn, &sp);
     if (e) return e;
-    e = unc0_arrsort(w, hascomp ? &args.values[1] : NULL, sn, sp);
+    e = unc0_arrsort(w, hascomp ? &args.values[1] : NULL, sn, sp, threads);
     unc_unlock(w, &args.values[0]);
     return e;
 }
@@ -2080,6 +2451,22 @@ Unc_RetVal unc0_ga_reverse(Unc_View *w, Unc_Tuple args, void *udata) {
     return 0;
 }
 
+Unc_RetVal unc0_gd_new(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Int ui = 0;
+    Unc_Value v = UNC_BLANK;
+
+    if (unc_gettype(w, &args.values[0])) {
+        e = unc_getint(w, &args.values[0], &ui);
+        if (e) return e;
+        if (ui < 0)
+            return unc0_throwexc(w, "value", "table size cannot be negative");
+    }
+    e = unc_newtablecap(w, &v, (Unc_Size)ui);
+    if (e) return e;
+    return unc_returnlocal(w, 0, &v);
+}
+
 Unc_RetVal unc0_gd_length(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_Value v;
 
@@ -2093,9 +2480,9 @@ Unc_RetVal unc0_gd_length(Unc_View *w, Unc_Tuple args, void *udata) {
 Unc_RetVal unc0_gd_copy(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
     Unc_Size i;
-    Unc_Value v;
+    Unc_Value v = UNC_BLANK;
     Unc_Dict *d, *dict;
-    Unc_HTblV_V *nx;
+    Unc_Value *nx, k;
     
     if (args.values[0].type != Unc_TTable)
         return UNCIL_ERR_TYPE_NOTDICT;
@@ -2105,25 +2492,17 @@ Unc_RetVal unc0_gd_copy(Unc_View *w, Unc_Tuple args, void *udata) {
     d = LEFTOVER(Unc_Dict, VGETENT(&v));
     dict = LEFTOVER(Unc_Dict, VGETENT(&args.values[0]));
     UNC_LOCKL(dict->lock);
-    i = -1;
-    nx = NULL;
-
-    for (;;) {
-        while (!nx) {
-            if (++i >= dict->data.capacity) {
-                UNC_UNLOCKL(dict->lock);
-                return unc_returnlocal(w, 0, &v);
-            }
-            nx = dict->data.buckets[i];
-        }
-        e = unc0_dsetindx(w, d, &nx->key, &nx->val);
+    i = 0;
+    while ((nx = unc0_iterhtblv(&dict->data, &i, &k))) {
+        e = unc0_dsetindx(w, d, &k, nx);
         if (e) {
             UNC_UNLOCKL(dict->lock);
             unc0_hibernate(VGETENT(&v), w);
             return e;
         }
-        nx = nx->next;
     }
+    UNC_UNLOCKL(dict->lock);
+    return unc_returnlocal(w, 0, &v);
 }
 
 Unc_RetVal unc0_gd_prune(Unc_View *w, Unc_Tuple args, void *udata) {
@@ -2131,32 +2510,28 @@ Unc_RetVal unc0_gd_prune(Unc_View *w, Unc_Tuple args, void *udata) {
     int pruned = 0;
     Unc_Size gen, i;
     Unc_Dict *dict;
-    Unc_HTblV_V *nx, **prev = NULL;
+    Unc_Value *nx, k;
 
     if (args.values[0].type != Unc_TTable)
         return UNCIL_ERR_TYPE_NOTDICT;
     dict = LEFTOVER(Unc_Dict, VGETENT(&args.values[0]));
-    i = -1;
+    i = 0;
     gen = dict->generation;
-    nx = NULL;
 
     for (;;) {
         int prune;
-        while (!nx) {
-            if (++i >= dict->data.capacity) {
-                if (pruned)
-                    unc0_compacthtblv(w, &dict->data);
-                return 0;
-            }
-            prev = &dict->data.buckets[i];
-            nx = *prev;
+        nx = unc0_iterhtblv(&dict->data, &i, &k);
+        if (!nx) {
+            if (pruned)
+                unc0_compacthtblv(w, &dict->data);
+            return 0;
         }
         {
             Unc_Pile pile;
             Unc_Tuple tuple;
-            e = unc_push(w, 1, &nx->key);
+            e = unc_push(w, 1, &k);
             if (e) return e;
-            e = unc_push(w, 1, &nx->val);
+            e = unc_push(w, 1, nx);
             if (e) return e;
             e = unc_call(w, &args.values[1], 2, &pile);
             if (e) return e;
@@ -2168,22 +2543,243 @@ Unc_RetVal unc0_gd_prune(Unc_View *w, Unc_Tuple args, void *udata) {
                             "table modified by other code while iterating");
         }
         if (prune) {
-            Unc_HTblV_V *nxx = nx->next;
-            VDECREF(w, &nx->key);
-            VDECREF(w, &nx->val);
-            unc0_mfree(&w->world->alloc, nx, sizeof(Unc_HTblV_V));
-            *prev = nx = nxx;
+            unc0_delhtblvat(w, &dict->data, i - 1);
             if (++dict->generation == UNC_INT_MAX)
                 dict->generation = 0;
             gen = dict->generation;
             pruned = 1;
-        } else {
-            prev = &nx->next;
-            nx = nx->next;
         }
     }
 }
 
+static Unc_RetVal unc0_gt_get(Unc_View *w, Unc_Value *v,
+                              Unc_TypedArray **a) {
+    if (VGETTYPE(v) != Unc_TTypedArray) {
+        *a = NULL;
+        return unc0_throwexc(w, "type", "value is not a typed array");
+    }
+    *a = LEFTOVER(Unc_TypedArray, VGETENT(v));
+    return 0;
+}
+
+Unc_RetVal unc0_gt_new(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Int ui;
+    Unc_Value v = UNC_BLANK;
+    byte *p;
+    int kind;
+
+    e = unc0_gt_getkind(w, &args.values[0], &kind);
+    if (e) return e;
+    e = unc_getint(w, &args.values[1], &ui);
+    if (e) return e;
+    if (ui < 0)
+        return unc0_throwexc(w, "value",
+                                "typed array size cannot be negative");
+    e = unc0_newtarray(w, kind, (Unc_Size)ui, &p, &v);
+    if (e) return e;
+    if (ui)
+        unc0_mbzero(p, (Unc_Size)ui * unc0_taelemsize(kind));
+    return unc_returnlocal(w, 0, &v);
+}
+
+Unc_RetVal unc0_gt_fromblob(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    int kind;
+
+    if (VGETTYPE(&args.values[0]) != Unc_TBlob)
+        return unc0_throwexc(w, "type", "value is not a blob");
+    e = unc0_gt_getkind(w, &args.values[1], &kind);
+    if (e) return e;
+    e = unc0_wraptarray(w, &args.values[0], kind, &v);
+    return unc_returnlocal(w, e, &v);
+}
+
+Unc_RetVal unc0_gt_blob(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_TypedArray *a;
+    Unc_Value v = UNC_BLANK;
+
+    e = unc0_gt_get(w, &args.values[0], &a);
+    if (e) return e;
+    VINITENT(&v, Unc_TBlob, a->blob);
+    VINCREF(w, &v);
+    return unc_returnlocal(w, 0, &v);
+}
+
+Unc_RetVal unc0_gt_kind(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_TypedArray *a;
+    Unc_Value v = UNC_BLANK;
+
+    e = unc0_gt_get(w, &args.values[0], &a);
+    if (e) return e;
+    e = unc_newstringc(w, &v, unc0_takindname(a->kind));
+    return unc_returnlocal(w, e, &v);
+}
+
+Unc_RetVal unc0_gt_length(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_TypedArray *a;
+    Unc_Value v;
+
+    e = unc0_gt_get(w, &args.values[0], &a);
+    if (e) return e;
+    VINITINT(&v, (Unc_Int)unc0_talength(a));
+    return unc_returnlocal(w, 0, &v);
+}
+
+Unc_RetVal unc0_gt_copy(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_TypedArray *a;
+    Unc_Blob *b;
+    Unc_Size n;
+    Unc_Value v = UNC_BLANK;
+    byte *p;
+
+    e = unc0_gt_get(w, &args.values[0], &a);
+    if (e) return e;
+    b = LEFTOVER(Unc_Blob, a->blob);
+    UNC_LOCKL(b->lock);
+    n = b->size >> a->shift;
+    e = unc0_newtarray(w, a->kind, n, &p, &v);
+    if (!e && n)
+        unc0_memcpy(p, b->data, n << a->shift);
+    UNC_UNLOCKL(b->lock);
+    return unc_returnlocal(w, e, &v);
+}
+
+Unc_RetVal unc0_gt_toarray(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_TypedArray *a;
+    Unc_Blob *b;
+    Unc_Size i, n;
+    Unc_Value v = UNC_BLANK;
+    Unc_Value *av;
+
+    e = unc0_gt_get(w, &args.values[0], &a);
+    if (e) return e;
+    b = LEFTOVER(Unc_Blob, a->blob);
+    UNC_LOCKL(b->lock);
+    n = b->size >> a->shift;
+    e = unc_newarray(w, &v, n, &av);
+    if (!e) {
+        /* the new array is all nulls, so nothing needs to be decref'd */
+        for (i = 0; i < n; ++i)
+            unc0_taload(a->kind, b->data, i, &av[i]);
+        unc_unlock(w, &v);
+    }
+    UNC_UNLOCKL(b->lock);
+    return unc_returnlocal(w, e, &v);
+}
+
+Unc_RetVal unc0_gt_fill(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_TypedArray *a;
+    Unc_Blob *b;
+    Unc_Size i, n, z;
+
+    e = unc0_gt_get(w, &args.values[0], &a);
+    if (e) return e;
+    b = LEFTOVER(Unc_Blob, a->blob);
+    z = (Unc_Size)1 << a->shift;
+    UNC_LOCKL(b->lock);
+    n = b->size >> a->shift;
+    if (n) {
+        /* store once to convert and check the value, then replicate */
+        e = unc0_tastore(a->kind, b->data, 0, &args.values[1]);
+        for (i = 1; !e && i < n; ++i)
+            unc0_memcpy(b->data + i * z, b->data, z);
+    }
+    UNC_UNLOCKL(b->lock);
+    return e ? unc0_taerror(w, e) : 0;
+}
+
+Unc_RetVal unc0_g_aview(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+
+    e = unc0_gv_make(w, &args.values[1], &args.values[2], &args.values[3],
+                     &v);
+    return unc_returnlocal(w, e, &v);
+}
+
+static Unc_RetVal unc0_gv_get(Unc_View *w, Unc_Value *v,
+                              Unc_ArrayView **a) {
+    if (VGETTYPE(v) != Unc_TArrayView) {
+        *a = NULL;
+        return unc0_throwexc(w, "type", "value is not an array view");
+    }
+    *a = LEFTOVER(Unc_ArrayView, VGETENT(v));
+    return 0;
+}
+
+Unc_RetVal unc0_gv_view(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_ArrayView *a;
+    Unc_Value v = UNC_BLANK;
+
+    e = unc0_gv_get(w, &args.values[0], &a);
+    if (e) return e;
+    e = unc0_gv_make(w, &args.values[0], &args.values[1], &args.values[2],
+                     &v);
+    return unc_returnlocal(w, e, &v);
+}
+
+Unc_RetVal unc0_gv_array(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_ArrayView *a;
+    Unc_Value v = UNC_BLANK;
+
+    e = unc0_gv_get(w, &args.values[0], &a);
+    if (e) return e;
+    VINITENT(&v, Unc_TArray, a->array);
+    VINCREF(w, &v);
+    return unc_returnlocal(w, 0, &v);
+}
+
+Unc_RetVal unc0_gv_offset(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_ArrayView *a;
+    Unc_Value v;
+
+    e = unc0_gv_get(w, &args.values[0], &a);
+    if (e) return e;
+    VINITINT(&v, (Unc_Int)a->offset);
+    return unc_returnlocal(w, 0, &v);
+}
+
+Unc_RetVal unc0_gv_length(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_ArrayView *a;
+    Unc_Value v;
+
+    e = unc0_gv_get(w, &args.values[0], &a);
+    if (e) return e;
+    UNC_LOCKL(LEFTOVER(Unc_Array, a->array)->lock);
+    VINITINT(&v, (Unc_Int)unc0_avlength(a));
+    UNC_UNLOCKL(LEFTOVER(Unc_Array, a->array)->lock);
+    return unc_returnlocal(w, 0, &v);
+}
+
+Unc_RetVal unc0_gv_toarray(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_ArrayView *a;
+    Unc_Array *ap;
+    Unc_Size n;
+    Unc_Value v = UNC_BLANK;
+
+    e = unc0_gv_get(w, &args.values[0], &a);
+    if (e) return e;
+    ap = LEFTOVER(Unc_Array, a->array);
+    UNC_LOCKL(ap->lock);
+    n = unc0_avlength(a);
+    e = unc_newarrayfrom(w, &v, n, n ? ap->data + a->offset : NULL);
+    UNC_UNLOCKL(ap->lock);
+    return unc_returnlocal(w, e, &v);
+}
+
 Unc_RetVal unc0_iter_string(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_Value *arr, *indx;
     Unc_Int i;
@@ -2265,20 +2861,19 @@ Unc_RetVal unc0_iter_array(Unc_View *w, Unc_Tuple args, void *udata) {
 
 Unc_RetVal unc0_iter_table(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_Value *tbl;
-    Unc_Int bucket, gen;
+    Unc_Int slot, gen;
+    Unc_Size i;
     Unc_Dict *dict;
+    Unc_Value *dp, k;
     Unc_RetVal e;
-    void *vp;
 
     (void)udata;
-    ASSERT(unc_boundcount(w) == 4);
+    ASSERT(unc_boundcount(w) == 3);
     tbl = unc_boundvalue(w, 0);
     if (tbl->type != Unc_TTable) return 0;
-    e = unc_getint(w, unc_boundvalue(w, 1), &bucket);
-    if (e) return e;
-    e = unc_getopaqueptr(w, unc_boundvalue(w, 2), &vp);
+    e = unc_getint(w, unc_boundvalue(w, 1), &slot);
     if (e) return e;
-    e = unc_getint(w, unc_boundvalue(w, 3), &gen);
+    e = unc_getint(w, unc_boundvalue(w, 2), &gen);
     if (e) return e;
     dict = LEFTOVER(Unc_Dict, VGETENT(tbl));
     if (gen != (Unc_Int)dict->generation) {
@@ -2286,28 +2881,68 @@ Unc_RetVal unc0_iter_table(Unc_View *w, Unc_Tuple args, void *udata) {
         return unc0_throwexc(w, "value", "table modified while iterating");
     }
 
-    if (!vp) {
-        do {
-            ++bucket;
-            if (bucket >= (Unc_Int)dict->data.capacity) {
-                unc_setnull(w, unc_boundvalue(w, 0));
-                return 0;
-            }
-            vp = dict->data.buckets[bucket];
-        } while (!vp);
-        unc_setint(w, unc_boundvalue(w, 1), bucket);
+    i = (Unc_Size)slot;
+    dp = unc0_iterhtblv(&dict->data, &i, &k);
+    if (!dp) {
+        unc_setnull(w, unc_boundvalue(w, 0));
+        return 0;
     }
+    e = unc_push(w, 1, &k);
+    if (e) return e;
+    e = unc_push(w, 1, dp);
+    if (e) return e;
+    unc_setint(w, unc_boundvalue(w, 1), (Unc_Int)i);
+    return 0;
+}
 
-    {
-        Unc_HTblV_V *dp = (Unc_HTblV_V *)vp;
-        e = unc_push(w, 1, &dp->key);
-        if (e) return e;
-        e = unc_push(w, 1, &dp->val);
-        if (e) return e;
-        vp = dp->next;
+Unc_RetVal unc0_iter_tarray(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_Value *arr, *indx;
+    Unc_TypedArray *a;
+    Unc_Int i;
+    Unc_RetVal e;
+
+    (void)udata;
+    ASSERT(unc_boundcount(w) == 2);
+    arr = unc_boundvalue(w, 0);
+    indx = unc_boundvalue(w, 1);
+    a = LEFTOVER(Unc_TypedArray, VGETENT(arr));
+    e = unc_getint(w, indx, &i);
+    if (!e && i < (Unc_Int)unc0_talength(a)) {
+        Unc_Value v = unc_blank;
+        e = unc0_taget(w, a, i, 0, &v);
+        if (!e) {
+            e = unc_returnlocal(w, e, &v);
+            if (!e) e = unc_push(w, 1, indx);
+            unc_setint(w, indx, i + 1);
+        }
     }
-    unc_setopaqueptr(w, unc_boundvalue(w, 2), vp);
-    return 0;
+
+    return e;
+}
+
+Unc_RetVal unc0_iter_aview(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_Value *arr, *indx;
+    Unc_ArrayView *a;
+    Unc_Int i;
+    Unc_RetVal e;
+
+    (void)udata;
+    ASSERT(unc_boundcount(w) == 2);
+    arr = unc_boundvalue(w, 0);
+    indx = unc_boundvalue(w, 1);
+    a = LEFTOVER(Unc_ArrayView, VGETENT(arr));
+    e = unc_getint(w, indx, &i);
+    if (!e && i < (Unc_Int)unc0_avlength(a)) {
+        Unc_Value v = unc_blank;
+        e = unc0_avget(w, a, i, 0, &v);
+        if (!e) {
+            e = unc_returnlocal(w, e, &v);
+            if (!e) e = unc_push(w, 1, indx);
+            unc_setint(w, indx, i + 1);
+        }
+    }
+
+    return e;
 }
 
 static Unc_RetVal unc0_newcallableobject(Unc_View *v, Unc_Value *o,
@@ -2397,14 +3032,35 @@ static const Unc_ModuleCFunc lib_g_arr[] = {
     { &unc0_ga_find,        "find",         2, 1, 0, UNC_CFUNC_CONCURRENT },
     { &unc0_ga_findlast,    "findlast",     2, 1, 0, UNC_CFUNC_CONCURRENT },
     { &unc0_ga_sub,         "sub",          2, 1, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_ga_view,        "view",         1, 2, 0, UNC_CFUNC_CONCURRENT },
     { &unc0_ga_insert,      "insert",       3, 0, 1, UNC_CFUNC_CONCURRENT },
     { &unc0_ga_remove,      "remove",       2, 1, 0, UNC_CFUNC_CONCURRENT },
     { &unc0_ga_reverse,     "reverse",      1, 0, 0, UNC_CFUNC_CONCURRENT },
     { &unc0_ga_repeat,      "repeat",       2, 0, 0, UNC_CFUNC_CONCURRENT },
-    { &unc0_ga_sort,        "sort",         1, 1, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_ga_sort,        "sort",         1, 3, 0, UNC_CFUNC_CONCURRENT },
+};
+
+static const Unc_ModuleCFunc lib_g_tarr[] = {
+    { &unc0_gt_new,         "new",          2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_gt_fromblob,    "fromblob",     2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_gt_blob,        "blob",         1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_gt_kind,        "kind",         1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_gt_length,      "length",       1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_gt_copy,        "copy",         1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_gt_toarray,     "toarray",      1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_gt_fill,        "fill",         2, 0, 0, UNC_CFUNC_CONCURRENT },
+};
+
+static const Unc_ModuleCFunc lib_g_aview[] = {
+    { &unc0_gv_view,        "view",         1, 2, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_gv_array,       "array",        1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_gv_offset,      "offset",       1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_gv_length,      "length",       1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { &unc0_gv_toarray,     "toarray",      1, 0, 0, UNC_CFUNC_CONCURRENT },
 };
 
 static const Unc_ModuleCFunc lib_g_table[] = {
+    { &unc0_gd_new,         "new",          0, 1, 0, UNC_CFUNC_CONCURRENT },
     { &unc0_gd_length,      "length",       1, 0, 0, UNC_CFUNC_CONCURRENT },
     { &unc0_gd_prune,       "prune",        2, 0, 0, UNC_CFUNC_CONCURRENT },
     { &unc0_gd_copy,        "copy",         1, 0, 0, UNC_CFUNC_CONCURRENT },
@@ -2416,6 +3072,8 @@ Unc_RetVal unc0_stdlibinit(Unc_World *ww, Unc_View *w) {
     Unc_Value met_blob = UNC_BLANK;
     Unc_Value met_arr = UNC_BLANK;
     Unc_Value met_table = UNC_BLANK;
+    Unc_Value met_tarr = UNC_BLANK;
+    Unc_Value met_aview = UNC_BLANK;
 
     MUST(unc0_newcallableobject(w, &met_str, "string", 2, 0, 0,
                                 UNC_CFUNC_CONCURRENT, &unc0_g_str));
@@ -2425,11 +3083,17 @@ Unc_RetVal unc0_stdlibinit(Unc_World *ww, Unc_View *w) {
                                 UNC_CFUNC_CONCURRENT, &unc0_g_array));
     MUST(unc0_newcallableobject(w, &met_table, "table", 2, 0, 0,
                                 UNC_CFUNC_CONCURRENT, &unc0_g_table));
+    MUST(unc0_newcallableobject(w, &met_tarr, "typedarray", 3, 0, 0,
+                                UNC_CFUNC_CONCURRENT, &unc0_g_tarray));
+    MUST(unc0_newcallableobject(w, &met_aview, "arrayview", 2, 2, 0,
+                                UNC_CFUNC_CONCURRENT, &unc0_g_aview));
 
     w->met_str = met_str;
     w->met_blob = met_blob;
     w->met_arr = met_arr;
     w->met_table = met_table;
+    w->met_tarr = met_tarr;
+    w->met_aview = met_aview;
 
     MUST(unc_attrcfunctions(w, &met_str, PASSARRAY(lib_g_str),
                             0, NULL, NULL));
@@ -2439,11 +3103,17 @@ Unc_RetVal unc0_stdlibinit(Unc_World *ww, Unc_View *w) {
                             0, NULL, NULL));
     MUST(unc_attrcfunctions(w, &met_table, PASSARRAY(lib_g_table),
                             0, NULL, NULL));
+    MUST(unc_attrcfunctions(w, &met_tarr, PASSARRAY(lib_g_tarr),
+                            0, NULL, NULL));
+    MUST(unc_attrcfunctions(w, &met_aview, PASSARRAY(lib_g_aview),
+                            0, NULL, NULL));
 
     MUST(unc_setpublic(w, PASSSTRLC("string"), &met_str));
     MUST(unc_setpublic(w, PASSSTRLC("blob"), &met_blob));
     MUST(unc_setpublic(w, PASSSTRLC("array"), &met_arr));
     MUST(unc_setpublic(w, PASSSTRLC("table"), &met_table));
+    MUST(unc_setpublic(w, PASSSTRLC("typedarray"), &met_tarr));
+    MUST(unc_setpublic(w, PASSSTRLC("arrayview"), &met_aview));
 
     {
         Unc_Value q = UNC_BLANK;
@@ -2498,6 +3168,8 @@ Unc_RetVal unc0_stdlibinit(Unc_World *ww, Unc_View *w) {
     VSETNULL(w, &met_blob);
     VSETNULL(w, &met_arr);
     VSETNULL(w, &met_table);
+    VSETNULL(w, &met_tarr);
+    VSETNULL(w, &met_aview);
     w->entityload = 0;
 
     return 0;
@@ -38,6 +38,8 @@ SOFTWARE.
 #define UNCIL_NOLIBIO 1
 #endif
 
+#include "ulibcbor.h"
+
 #if !UNCIL_NOLIBIO
 #include "ulibio.h"
 #endif
@@ -84,6 +86,9 @@ static u64_t unc0_u64_0(void) {
 
 #define CBOR_EOL 1
 
+/* most entries a map is preallocated for based on its encoded length */
+#define CBOR_MAP_PREALLOC 65536
+
 struct cbor_decode_blob {
     Unc_Size n;
     Unc_Size r;
@@ -478,7 +483,9 @@ INLINE Unc_RetVal cbordec_map(struct cbor_decode_context *c, Unc_Value *v,
     if (!c->recurse)
         return UNCIL_ERR_TOODEEP;
     --c->recurse;
-    e = unc_newtable(c->view, v);
+    /* the length comes from the input, so only trust it up to a point */
+    e = unc_newtablecap(c->view, v, forever ? 0 : z < CBOR_MAP_PREALLOC
+                                        ? (Unc_Size)z : CBOR_MAP_PREALLOC);
     if (e) return e;
     e = 0;
     for (i = 0; forever || i < z; ++i) {
@@ -990,9 +997,9 @@ static Unc_RetVal cborenc(struct cbor_encode_context *c, Unc_Value *v) {
     Unc_RetVal e;
     switch (unc_gettype(c->view, v)) {
     case Unc_TNull:
-        return cborenc_raw(c, 74, 22);
+        return cborenc_raw(c, 7, 22);
     case Unc_TBool:
-        return cborenc_raw(c, 74, unc_getbool(c->view, v, 0) ? 21 : 20);
+        return cborenc_raw(c, 7, unc_getbool(c->view, v, 0) ? 21 : 20);
     case Unc_TInt:
     {
         Unc_Int ui;
@@ -1021,7 +1028,7 @@ static Unc_RetVal cborenc(struct cbor_encode_context *c, Unc_Value *v) {
         Unc_Value pr = UNC_BLANK;
         int stag;
         unc_getprototype(c->view, v, &pr);
-        stag = unc_issame(c->view, &pr, c->tagproto);
+        stag = c->tagproto && unc_issame(c->view, &pr, c->tagproto);
         VCLEAR(c->view, &pr);
         if (stag) {
             /* semantic tag! */
@@ -1169,6 +1176,56 @@ Unc_RetVal uncl_cbor_encodefile(Unc_View *w, Unc_Tuple args, void *ud_) {
 }
 #endif
 
+Unc_RetVal unc0_cbor_encodebuf(Unc_View *w, Unc_Value *v,
+                               struct unc0_strbuf *buf) {
+    Unc_RetVal e;
+    struct cbor_encode_context cxt = { NULL, NULL, 0, NULL, NULL, UNC_BLANK };
+    struct cbor_encode_blob rs;
+    cxt.view = w;
+    cxt.out = &cbor_encode_blob_do;
+    cxt.out_data = &rs;
+    cxt.recurse = unc_recurselimit(w);
+    cxt.fle = is_float_le();
+    cxt.tagproto = NULL;
+    cxt.ents = NULL;
+    cxt.ents_n = cxt.ents_c = 0;
+
+    unc0_strbuf_init(&rs.buf, &w->world->alloc, Unc_AllocBlob);
+    rs.err = 0;
+
+    e = cborenc(&cxt, v);
+    if (rs.err) e = rs.err;
+    unc_mfree(w, cxt.ents);
+    if (e)
+        unc0_strbuf_free(&rs.buf);
+    else
+        *buf = rs.buf;
+    return e;
+}
+
+Unc_RetVal unc0_cbor_decodebuf(Unc_View *w, Unc_Size n, const byte *b,
+                               Unc_Value *v) {
+    Unc_RetVal e;
+    struct cbor_decode_context cxt;
+    struct cbor_decode_blob rs;
+
+    rs.n = n;
+    rs.r = 0;
+    rs.c = (byte *)b;
+
+    cxt.view = w;
+    cxt.getch = &cbor_decode_blob_do;
+    cxt.getch_data = &rs;
+    cxt.tagproto = NULL;
+    cxt.recurse = unc_recurselimit(w);
+    cxt.fle = is_float_le();
+
+    e = cbordec(&cxt, v);
+    if (e == CBOR_EOL)
+        e = unc_throwexc(w, "value", "unexpected CBOR terminator");
+    return e;
+}
+
 #define FN(x) &uncl_cbor_##x, #x
 static const Unc_ModuleCFunc lib[] = {
     { FN(decode),        1, 0, 0, UNC_CFUNC_CONCURRENT },
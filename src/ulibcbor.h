@@ -0,0 +1,44 @@
+/*******************************************************************************
+ 
+Uncil -- builtin CBOR library header
+
+Copyright (c) 2021-2023 Sampo Hippeläinen (hisahi)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef UNCIL_ULIBCBOR_H
+#define UNCIL_ULIBCBOR_H
+
+#include "udef.h"
+
+struct unc0_strbuf;
+struct Unc_Value;
+struct Unc_View;
+
+/* encode/decode without semantic tag support, for use outside the cbor
+   module. objects are rejected when encoding, tags decode into objects
+   without a prototype */
+Unc_RetVal unc0_cbor_encodebuf(struct Unc_View *w, struct Unc_Value *v,
+                               struct unc0_strbuf *buf);
+Unc_RetVal unc0_cbor_decodebuf(struct Unc_View *w, Unc_Size n,
+                               const Unc_Byte *b, struct Unc_Value *v);
+
+#endif /* UNCIL_ULIBCBOR_H */
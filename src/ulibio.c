@@ -562,6 +562,58 @@ static int uncdec_out_wrapper(void *data, Unc_Size n, const byte *b) {
 
 enum uncl_io_rw_mode { UNC0_RW_BUF = 0, UNC0_RW_LINE, UNC0_RW_ALL };
 
+#define UNC_IO_READ_CHUNK 4096
+
+/* read the rest of a UTF-8 file in bulk and validate it in one pass,
+   instead of decoding it one character at a time. returns 0 on success,
+   EOF on I/O error, 1 on invalid encoding or an error code if out of
+   memory. an incomplete sequence at the end of the file is dropped,
+   like unc0_cconv_utf8ts does */
+static int uncl_io_file_read_utf8all(Unc_View *w, struct ulib_io_file *file,
+                                     struct unc0_strbuf *buf) {
+    Unc_Size n, k, q = UNC_IO_READ_CHUNK;
+    byte *b;
+    ASSERT(file->f);
+    clearerr(file->f);
+    unc_vmpause(w);
+    for (;;) {
+        size_t r;
+        if (q < buf->length) q = buf->length;
+        b = unc0_strbuf_reserve_next(buf, q);
+        if (!b) {
+            unc_vmresume(w);
+            return UNCIL_ERR_MEM;
+        }
+        r = fread(b, 1, q, file->f);
+        buf->length -= q - r;
+        if (r < q) break;
+    }
+    unc_vmresume(w);
+    if (unc0_io_ferror(file)) return EOF;
+    b = buf->buffer, n = buf->length;
+    for (k = 1; k <= 3 && k <= n; ++k) {
+        byte c = b[n - k];
+        if (c < 0x80) break;
+        if (c >= 0xC0) {
+            if (c < 0xF8 && (c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : 2) > k)
+                n -= k;
+            break;
+        }
+    }
+#if UNCIL_CONVERT_CRLF
+    {
+        Unc_Size i, j;
+        for (i = j = 0; i < n; ++i) {
+            if (b[i] == '\r' && i + 1 < n && b[i + 1] == '\n') continue;
+            b[j++] = b[i];
+        }
+        n = j;
+    }
+#endif
+    buf->length = n;
+    return unc0_utf8validate(n, (const char *)b);
+}
+
 static Unc_RetVal uncl_io_file_read_do(Unc_View *w, Unc_Value *fp,
                                        struct ulib_io_file *file,
                                        enum uncl_io_rw_mode mode,
@@ -619,6 +671,22 @@ static Unc_RetVal uncl_io_file_read_do(Unc_View *w, Unc_Value *fp,
         break;
     }
     case UNCIL_IO_FILE_ENC_UTF8:
+        if (mode == UNC0_RW_ALL) {
+            e = uncl_io_file_read_utf8all(w, file, &wo.buf);
+            if (e == EOF) {
+                e = unc0_io_makeerr(w, "I/O read", errno);
+                goto unlock_fail;
+            } else if (e == 1) {
+                e = unc_throwexc(w, "encoding", "invalid encoding on read");
+                goto unlock_fail;
+            } else if (e) {
+                goto unlock_fail;
+            }
+            if (!wo.buf.length) goto unlock_eof;
+            unc_unlock(w, fp);
+            e = unc0_buftostring(w, &p, &wo.buf);
+            break;
+        }
         if (mode != UNC0_RW_BUF) sz = UNC_SIZE_MAX;
         wo.fail = 0;
 
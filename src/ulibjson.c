@@ -35,6 +35,7 @@ SOFTWARE.
 #include "uutf.h"
 #include "uvsio.h"
 #include "uxprintf.h"
+#include "uxscanf.h"
 
 #if UNCIL_SANDBOXED
 #define UNCIL_NOLIBIO 1
@@ -54,7 +55,44 @@ static int json_decode_string_do(void *p) {
     struct json_decode_string *s = p;
     if (!s->n) return -1;
     --s->n;
-    return *s->c++;
+    return (byte)*s->c++;
+}
+
+/* length of the run of n bytes at s that can be copied as is into a
+   string, i.e. up to the first quote or backslash */
+static Unc_Size json_plainrun(const char *s, Unc_Size n) {
+    const char *q = unc0_memchr(s, '"', n);
+    if (q) n = q - s;
+    q = unc0_memchr(s, '\\', n);
+    return q ? (Unc_Size)(q - s) : n;
+}
+
+/* read such a run from the input without copying it */
+static Unc_Size json_decode_string_run(void *p, const char **r) {
+    struct json_decode_string *s = p;
+    Unc_Size n = json_plainrun(s->c, s->n);
+    *r = s->c;
+    s->c += n;
+    s->n -= n;
+    return n;
+}
+
+/* length of the run of decimal digits at s */
+static Unc_Size json_digitrun(const char *s, Unc_Size n) {
+    Unc_Size i;
+    for (i = 0; i < n; ++i)
+        if (s[i] < '0' || s[i] > '9')
+            break;
+    return i;
+}
+
+static Unc_Size json_decode_string_digits(void *p, const char **r) {
+    struct json_decode_string *s = p;
+    Unc_Size n = json_digitrun(s->c, s->n);
+    *r = s->c;
+    s->c += n;
+    s->n -= n;
+    return n;
 }
 
 #if !UNCIL_NOLIBIO
@@ -88,13 +126,35 @@ static int json_decode_file_do(void *p_) {
         }
         p->i = 0, p->n = c;
     }
-    return p->buffer[p->i++];
+    return (byte)p->buffer[p->i++];
+}
+
+static Unc_Size json_decode_file_run(void *p_, const char **r) {
+    struct json_decode_file *p = p_;
+    Unc_Size n;
+    if (p->err) return 0;
+    n = json_plainrun(p->buffer + p->i, p->n - p->i);
+    *r = p->buffer + p->i;
+    p->i += (int)n;
+    return n;
+}
+
+static Unc_Size json_decode_file_digits(void *p_, const char **r) {
+    struct json_decode_file *p = p_;
+    Unc_Size n;
+    if (p->err) return 0;
+    n = json_digitrun(p->buffer + p->i, p->n - p->i);
+    *r = p->buffer + p->i;
+    p->i += (int)n;
+    return n;
 }
 #endif
 
 struct json_decode_context {
     int next;
     int (*getch)(void *);
+    Unc_Size (*getrun)(void *, const char **);
+    Unc_Size (*getdigits)(void *, const char **);
     void *getch_data;
     Unc_Size recurse;
     Unc_View *view;
@@ -127,8 +187,9 @@ static int jsondec_rest(struct json_decode_context *c, const char *s) {
 static Unc_RetVal jsondec_num(struct json_decode_context *c, Unc_Value *v) {
     int x = c->next;
     Unc_UInt u, up;
-    Unc_Float f;
+    long exp = 0;
     int neg = 0, floated = 0;
+    struct unc0_decimal dec;
     if (x == '-') {
         neg = 1;
         x = jsonnext(c);
@@ -136,51 +197,47 @@ static Unc_RetVal jsondec_num(struct json_decode_context *c, Unc_Value *v) {
     if (!unc0_isdigit(x))
         return jsondec_err(c, "syntax",
             "JSON syntax error: - not followed by digit");
+    unc0_decimalinit(&dec);
     u = 0;
     do {
-        if (floated) {
-            f = (f * 10) + (x - '0');
-        } else {
-            up = u;
-            u = u * 10 + (x - '0');
-            if (up > u) {
-                f = ((Unc_Float)u * 10) + (x - '0');
-                floated = 1;
+        /* take the rest of the digits in bulk if they are buffered */
+        const char *run;
+        Unc_Size n = (*c->getdigits)(c->getch_data, &run);
+        for (;;) {
+            UNC0_DECIMALDIGIT(&dec, x - '0', 0);
+            if (!floated) {
+                up = u;
+                u = u * 10 + (x - '0');
+                if (u / 10 != up)
+                    floated = 1;
             }
+            if (!n--) break;
+            x = *run++;
         }
         x = jsonnext(c);
     } while (unc0_isdigit(x));
 
     if (x == '.') {
-        Unc_Float fp = 0;
-        Unc_Size pow10 = 0, nonzeroes = 0;
-        if (!floated) {
-            floated = 1;
-            f = (Unc_Float)u;
-        }
+        floated = 1;
         x = jsonnext(c);
         if (!unc0_isdigit(x))
             return jsondec_err(c, "syntax",
                 "JSON syntax error: . not followed by digit");
         do {
-            if (fp && ++nonzeroes >= DBL_DIG + 2) {
-                do {
-                    x = jsonnext(c);
-                } while (unc0_isdigit(x));
-                break;
+            const char *run;
+            Unc_Size n = (*c->getdigits)(c->getch_data, &run);
+            for (;;) {
+                UNC0_DECIMALDIGIT(&dec, x - '0', 1);
+                if (!n--) break;
+                x = *run++;
             }
-            fp = (fp * 10) + (x - '0');
             x = jsonnext(c);
         } while (unc0_isdigit(x));
-        f += fp / unc0_mpow10(pow10);
     }
 
     if (x == 'e' || x == 'E') {
         int eneg = 0;
-        if (!floated) {
-            floated = 1;
-            f = (Unc_Float)u;
-        }
+        floated = 1;
         x = jsonnext(c);
         if (x == '-') {
             eneg = 1;
@@ -191,41 +248,27 @@ static Unc_RetVal jsondec_num(struct json_decode_context *c, Unc_Value *v) {
         if (!unc0_isdigit(x))
             return jsondec_err(c, "syntax",
                 "JSON syntax error: e/E not followed by digit");
-        up = u = 0;
         do {
-            up = u;
-            u = u * 10 + (x - '0');
-            if (up > u) {
-                u = UNC_UINT_MAX;
-                break;
-            }
+            /* anything this large is out of range anyway */
+            if (exp < LONG_MAX / 10 - 10)
+                exp = exp * 10 + (x - '0');
             x = jsonnext(c);
         } while (unc0_isdigit(x));
-
-        if (!eneg) {
-            if (u > DBL_MAX_10_EXP * 2)
-                u = DBL_MAX_10_EXP * 2;
-            f *= unc0_mpow10((int)u);
-        } else {
-            if (u > -DBL_MIN_10_EXP * 2)
-                u = -DBL_MIN_10_EXP * 2;
-            f *= unc0_mpow10(-(int)u);
-        }
+        if (eneg) exp = -exp;
     }
 
-    if (neg) {
-        if (floated) {
-            f = -f;
-        } else {
-            if (u > -(Unc_UInt)UNC_INT_MIN)
-                f = -(Unc_Float)u, floated = 1;
-            else
-                unc_setint(c->view, v, -(Unc_Int)u);
-        }
-    } else if (!floated)
+    if (floated) {
+        Unc_Float f = unc0_decimaltof(&dec, exp);
+        unc_setfloat(c->view, v, neg ? -f : f);
+    } else if (neg) {
+        if (u > -(Unc_UInt)UNC_INT_MIN)
+            unc_setfloat(c->view, v, -(Unc_Float)u);
+        else
+            unc_setint(c->view, v, -(Unc_Int)u);
+    } else if (u > (Unc_UInt)UNC_INT_MAX) {
+        unc_setfloat(c->view, v, (Unc_Float)u);
+    } else
         unc_setint(c->view, v, (Unc_Int)u);
-    if (floated)
-        unc_setfloat(c->view, v, f);
     c->next = x;
     return 0;
 }
@@ -240,6 +283,7 @@ static Unc_RetVal jsondec_str(struct json_decode_context *c, Unc_Value *v) {
     Unc_Size buf_c = sizeof(buf_);
     Unc_UChar unext = 0;
     Unc_Size us;
+    const char *run;
     ASSERT(x == '"');
     x = jsonnext(c);
     for (;;) {
@@ -304,6 +348,12 @@ static Unc_RetVal jsondec_str(struct json_decode_context *c, Unc_Value *v) {
                 return jsondec_err(c, "syntax", 
                     "JSON syntax error: invalid escape sequence");
             }
+        } else if (!unext) {
+            /* copy bytes other than escapes as they are (the string is
+               validated as UTF-8 once it is complete) */
+            uc[0] = (byte)x;
+            us = 1 + (*c->getrun)(c->getch_data, &run);
+            goto put;
         } else
             u = x;
         if (unext) {
@@ -320,11 +370,15 @@ static Unc_RetVal jsondec_str(struct json_decode_context *c, Unc_Value *v) {
         if (u >= 0x80) {
             us = unc0_utf8enc(u, sizeof(uc), uc);
         } else {
+            uc[0] = (byte)u;
             us = 1;
         }
+        run = NULL;
+put:
         if (buf_n + us > buf_c) {
-            Unc_Size z = buf_c + 64;
+            Unc_Size z = buf_c * 2;
             char *p;
+            if (z < buf_n + us) z = buf_n + us;
             if (buf_ext)
                 p = unc_mrealloc(c->view, buf, z);
             else {
@@ -336,12 +390,12 @@ static Unc_RetVal jsondec_str(struct json_decode_context *c, Unc_Value *v) {
             buf_c = z;
             buf_ext = 1;
         }
-        if (u >= 0x80) {
+        if (run) {
+            buf[buf_n] = (char)uc[0];
+            unc0_memcpy(&buf[buf_n + 1], run, us - 1);
+        } else
             unc0_memcpy(&buf[buf_n], uc, us);
-            buf_n += us;
-        } else {
-            buf[buf_n++] = (char)u;
-        }
+        buf_n += us;
         x = jsonnext(c);
     }
     if (unext) return jsondec_err(c, "syntax", 
@@ -431,14 +485,18 @@ static Unc_RetVal jsondec_arr(struct json_decode_context *c, Unc_Value *v) {
     return 0;
 }
 
+/* the pairs are collected first, so that the table can be built at its
+   final size without having to grow while it is being filled */
 static Unc_RetVal jsondec_obj(struct json_decode_context *c, Unc_Value *v) {
     Unc_RetVal e;
     int x = c->next;
-    Unc_Value obj = UNC_BLANK, key = UNC_BLANK, val = UNC_BLANK;
+    Unc_Value obj = UNC_BLANK, kv = UNC_BLANK;
+    Unc_Size kv_n = 0, kv_c = 0, i;
+    Unc_Value *kv_v;
     if (!c->recurse)
         return UNCIL_ERR_TOODEEP;
     --c->recurse;
-    e = unc_newtable(c->view, &obj);
+    e = unc_newarray(c->view, &kv, kv_c, &kv_v);
     if (e) return e;
     
     ASSERT(x == '{');
@@ -447,50 +505,36 @@ static Unc_RetVal jsondec_obj(struct json_decode_context *c, Unc_Value *v) {
     for (;;) {
         x = jsondec_skipw(c);
         if (x < 0) {
-            VCLEAR(c->view, &val);
-            VCLEAR(c->view, &key);
-            VCLEAR(c->view, &obj);
-            return jsondec_err(c, "syntax", 
+            e = jsondec_err(c, "syntax", 
                     "JSON syntax error: list not terminated");
+            goto jsondec_obj_fail;
         }
         if (x == '}') {
-            VCLEAR(c->view, &val);
-            VCLEAR(c->view, &key);
             x = jsonnext(c);
             break;
         }
+        if (kv_n == kv_c) {
+            Unc_Size nz = kv_c + 16;
+            e = unc_resizearray(c->view, &kv, nz, &kv_v);
+            if (e) goto jsondec_obj_fail;
+            kv_c = nz;
+        }
         c->next = x;
-        e = jsondec_str(c, &key);
+        e = jsondec_str(c, &kv_v[kv_n++]);
         x = c->next;
-        if (e) {
-            VCLEAR(c->view, &val);
-            VCLEAR(c->view, &key);
-            VCLEAR(c->view, &obj);
-            return e;
-        }
+        if (e) goto jsondec_obj_fail;
         if (x == ':') {
             x = jsonnext(c);
         } else {
-            return jsondec_err(c, "syntax", 
+            e = jsondec_err(c, "syntax", 
                     "JSON syntax error: expected colon in object");
+            goto jsondec_obj_fail;
         }
         c->next = x;
         c->next = jsondec_skipw(c);
-        e = jsondec_val(c, &val);
+        e = jsondec_val(c, &kv_v[kv_n++]);
         x = c->next;
-        if (e) {
-            VCLEAR(c->view, &val);
-            VCLEAR(c->view, &key);
-            VCLEAR(c->view, &obj);
-            return e;
-        }
-        e = unc_setattrv(c->view, &obj, &key, &val);
-        if (e) {
-            VCLEAR(c->view, &val);
-            VCLEAR(c->view, &key);
-            VCLEAR(c->view, &obj);
-            return e;
-        }
+        if (e) goto jsondec_obj_fail;
         c->next = x;
         x = jsondec_skipw(c);
         if (x == ',') {
@@ -499,15 +543,29 @@ static Unc_RetVal jsondec_obj(struct json_decode_context *c, Unc_Value *v) {
             x = jsonnext(c);
             break;
         } else {
-            return jsondec_err(c, "syntax", 
+            e = jsondec_err(c, "syntax", 
                     "JSON syntax error: expected comma in object");
+            goto jsondec_obj_fail;
         }
     }
 
+    e = unc_newtablecap(c->view, &obj, kv_n / 2);
+    if (e) goto jsondec_obj_fail;
+    for (i = 0; i < kv_n; i += 2) {
+        e = unc_setattrv(c->view, &obj, &kv_v[i], &kv_v[i + 1]);
+        if (e) goto jsondec_obj_fail;
+    }
+    unc_unlock(c->view, &kv);
+    VCLEAR(c->view, &kv);
     unc_move(c->view, v, &obj);
     c->next = x;
     ++c->recurse;
     return 0;
+jsondec_obj_fail:
+    unc_unlock(c->view, &kv);
+    VCLEAR(c->view, &kv);
+    VCLEAR(c->view, &obj);
+    return e;
 }
 
 static Unc_RetVal jsondec_val(struct json_decode_context *c, Unc_Value *v) {
@@ -577,6 +635,8 @@ Unc_RetVal uncl_json_decode(Unc_View *w, Unc_Tuple args, void *ud_) {
 
     cxt.view = w;
     cxt.getch = &json_decode_string_do;
+    cxt.getrun = &json_decode_string_run;
+    cxt.getdigits = &json_decode_string_digits;
     cxt.getch_data = &rs;
     cxt.recurse = unc_recurselimit(w);
     
@@ -603,6 +663,8 @@ Unc_RetVal uncl_json_decodefile(Unc_View *w, Unc_Tuple args, void *ud_) {
 
     cxt.view = w;
     cxt.getch = &json_decode_file_do;
+    cxt.getrun = &json_decode_file_run;
+    cxt.getdigits = &json_decode_file_digits;
     cxt.getch_data = &buf;
     cxt.recurse = unc_recurselimit(w);
     
@@ -952,8 +1014,10 @@ INLINE Unc_RetVal jsonenc_val(struct json_encode_context *c, Unc_Value *v) {
         Unc_Float f;
         e = unc_getfloat(c->view, v, &f);
         if (e) return e;
-        return jsonenc_printf(c, "%."EVALSTRINGIFY(DBL_DIG) PRIUnc_Float"g",
-                              f);
+        {
+            char buf[UNC_FTOASHORTEST_BUF];
+            return (*c->out)(unc0_ftoashortest(buf, f), buf, c->out_data);
+        }
     }
     case Unc_TString:
         return jsonenc_str(c, v);
@@ -29,8 +29,14 @@ SOFTWARE.
 #include <float.h>
 
 #include "uarithm.h"
+#include "uarr.h"
+#include "ublob.h"
+#include "udebug.h"
 #include "udef.h"
+#include "umem.h"
 #include "uncil.h"
+#include "utarr.h"
+#include "uvali.h"
 
 #define _USE_MATH_DEFINES
 #include <errno.h>
@@ -351,6 +357,952 @@ uncl_math_clamp_float:
     return unc_returnlocal(w, 0, &v);
 }
 
+/* bulk kernels over vectors of numbers. elements are widened a block at a
+   time into plain Unc_Int or Unc_Float buffers, and the kernels are simple
+   loops over those that the compiler can vectorize. an integer result that
+   would overflow is computed again in floating point, like with the
+   arithmetic operators, but for the whole result at once */
+#define MATH_BLOCK 256
+
+/* a block of integers within these bounds cannot overflow when summed,
+   nor can the sum of the products of two such blocks */
+#define MATH_ISUMMAX (UNC_INT_MAX / MATH_BLOCK)
+#define MATH_IDOTMAX ((Unc_Int)1 << ((sizeof(Unc_Int) * CHAR_BIT - 10) / 2))
+
+/* a vector of numbers: an array or array view, a typed array, or a blob
+   as bytes */
+struct uncl_math_vec {
+    Unc_Entity *ent;        /* array or blob that holds the elements */
+    Unc_ArrayView *view;    /* if a view of the array */
+    int packed;             /* typed array or blob? */
+    int kind;               /* UNC_TA_* if packed */
+    unsigned shift;
+    Unc_Size n;
+    Unc_Value *av;          /* elements if not packed */
+    const byte *p;          /* elements if packed */
+};
+
+/* result of an elementwise kernel. a typed array if any operand was
+   packed, otherwise an array */
+struct uncl_math_out {
+    Unc_Value v;
+    Unc_Value *av;
+    byte *p;
+};
+
+/* scalar operands of an elementwise kernel */
+struct uncl_math_coef {
+    Unc_Int ik, ic;
+    Unc_Float fk, fc;
+};
+
+/* an integer pass returns nonzero if the result must be floats instead,
+   and a float pass returns nonzero if an element is not a number */
+typedef int (*uncl_math_pass)(const struct uncl_math_vec *x,
+                              const struct uncl_math_vec *y,
+                              const struct uncl_math_coef *c,
+                              struct uncl_math_out *o);
+
+static Unc_RetVal uncl_math_getvec(Unc_View *w, Unc_Value *v,
+                                   struct uncl_math_vec *x) {
+    switch (VGETTYPE(v)) {
+    case Unc_TArray:
+        x->ent = VGETENT(v);
+        x->view = NULL;
+        x->packed = 0;
+        x->kind = -1;
+        x->shift = 0;
+        return 0;
+    case Unc_TArrayView:
+        x->view = LEFTOVER(Unc_ArrayView, VGETENT(v));
+        x->ent = x->view->array;
+        x->packed = 0;
+        x->kind = -1;
+        x->shift = 0;
+        return 0;
+    case Unc_TTypedArray:
+    {
+        Unc_TypedArray *a = LEFTOVER(Unc_TypedArray, VGETENT(v));
+        x->ent = a->blob;
+        x->view = NULL;
+        x->packed = 1;
+        x->kind = a->kind;
+        x->shift = a->shift;
+        return 0;
+    }
+    case Unc_TBlob:
+        x->ent = VGETENT(v);
+        x->view = NULL;
+        x->packed = 1;
+        x->kind = UNC_TA_UINT8;
+        x->shift = 0;
+        return 0;
+    default:
+        return unc_throwexc(w, "type",
+                    "value is not an array, array view, typed array or blob");
+    }
+}
+
+static Unc_RetVal uncl_math_notnum(Unc_View *w) {
+    return unc_throwexc(w, "type", "vector element is not a number");
+}
+
+static Unc_RetVal uncl_math_getnum(Unc_View *w, Unc_Value *v,
+                                   Unc_Int *ui, Unc_Float *uf, int *flt) {
+    if (VGETTYPE(v) == Unc_TInt) {
+        *ui = VGETINT(v);
+        *uf = (Unc_Float)*ui;
+        return 0;
+    }
+    *ui = 0;
+    *flt = 1;
+    return unc_getfloat(w, v, uf);
+}
+
+/* can the vector only hold floats? an array is only known once loaded */
+static int uncl_math_isflt(const struct uncl_math_vec *x) {
+    return x->packed && unc0_takindisfloat(x->kind);
+}
+
+static void uncl_math_lock1(struct uncl_math_vec *x) {
+    if (x->packed) {
+        UNC_LOCKL(LEFTOVER(Unc_Blob, x->ent)->lock);
+    } else {
+        UNC_LOCKL(LEFTOVER(Unc_Array, x->ent)->lock);
+    }
+}
+
+static void uncl_math_unlock1(struct uncl_math_vec *x) {
+    if (x->packed) {
+        UNC_UNLOCKL(LEFTOVER(Unc_Blob, x->ent)->lock);
+    } else {
+        UNC_UNLOCKL(LEFTOVER(Unc_Array, x->ent)->lock);
+    }
+}
+
+static void uncl_math_read(struct uncl_math_vec *x) {
+    if (x->packed) {
+        Unc_Blob *b = LEFTOVER(Unc_Blob, x->ent);
+        x->p = b->data;
+        x->n = b->size >> x->shift;
+        x->av = NULL;
+    } else {
+        Unc_Array *a = LEFTOVER(Unc_Array, x->ent);
+        if (x->view) {
+            x->n = unc0_avlength(x->view);
+            x->av = x->n ? a->data + x->view->offset : NULL;
+        } else {
+            x->av = a->data;
+            x->n = a->size;
+        }
+        x->p = NULL;
+    }
+}
+
+/* locks the vectors (y may be NULL) and reads their elements. both may be
+   held by the same entity. the locks are taken in address order so that two
+   threads locking the same pair cannot deadlock */
+static void uncl_math_lock(struct uncl_math_vec *x, struct uncl_math_vec *y) {
+    if (!y || y->ent == x->ent)
+        uncl_math_lock1(x);
+    else if ((const char *)x->ent < (const char *)y->ent) {
+        uncl_math_lock1(x);
+        uncl_math_lock1(y);
+    } else {
+        uncl_math_lock1(y);
+        uncl_math_lock1(x);
+    }
+    uncl_math_read(x);
+    if (y) uncl_math_read(y);
+}
+
+static void uncl_math_unlock(struct uncl_math_vec *x,
+                             struct uncl_math_vec *y) {
+    uncl_math_unlock1(x);
+    if (y && y->ent != x->ent)
+        uncl_math_unlock1(y);
+}
+
+#define MATH_BLOCKLEN(x, i) ((x)->n - (i) < MATH_BLOCK ? (x)->n - (i)         \
+                                                       : MATH_BLOCK)
+
+#define MATH_WIDEN(T, b) do {                                                  \
+        const T *q = (const T *)x->p + i;                                      \
+        for (j = 0; j < n; ++j)                                                \
+            b[j] = q[j];                                                       \
+    } while (0)
+
+/* loads elements [i, i + n) as integers. returns nonzero if they are not
+   all integers */
+static int uncl_math_loadi(const struct uncl_math_vec *x, Unc_Size i,
+                           Unc_Size n, Unc_Int *ib) {
+    Unc_Size j;
+    if (!x->packed) {
+        const Unc_Value *v = x->av + i;
+        for (j = 0; j < n; ++j) {
+            if (VGETTYPE(&v[j]) != Unc_TInt)
+                return 1;
+            ib[j] = VGETINT(&v[j]);
+        }
+        return 0;
+    }
+    switch (x->kind) {
+    case UNC_TA_INT:    MATH_WIDEN(Unc_Int, ib);        break;
+    case UNC_TA_INT8:   MATH_WIDEN(signed char, ib);    break;
+    case UNC_TA_UINT8:  MATH_WIDEN(unsigned char, ib);  break;
+    case UNC_TA_INT16:  MATH_WIDEN(ta_i16, ib);         break;
+    case UNC_TA_UINT16: MATH_WIDEN(ta_u16, ib);         break;
+    case UNC_TA_INT32:  MATH_WIDEN(ta_i32, ib);         break;
+    case UNC_TA_UINT32: MATH_WIDEN(ta_u32, ib);         break;
+    default:
+        return 1;
+    }
+    return 0;
+}
+
+/* loads elements [i, i + n) as floats. returns nonzero if they are not
+   all numbers */
+static int uncl_math_loadf(const struct uncl_math_vec *x, Unc_Size i,
+                           Unc_Size n, Unc_Float *fb) {
+    Unc_Size j;
+    if (!x->packed) {
+        const Unc_Value *v = x->av + i;
+        for (j = 0; j < n; ++j) {
+            switch (VGETTYPE(&v[j])) {
+            case Unc_TInt:
+                fb[j] = (Unc_Float)VGETINT(&v[j]);
+                break;
+            case Unc_TFloat:
+                fb[j] = VGETFLT(&v[j]);
+                break;
+            default:
+                return 1;
+            }
+        }
+        return 0;
+    }
+    switch (x->kind) {
+    case UNC_TA_INT:     MATH_WIDEN(Unc_Int, fb);       break;
+    case UNC_TA_FLOAT:   MATH_WIDEN(Unc_Float, fb);     break;
+    case UNC_TA_INT8:    MATH_WIDEN(signed char, fb);   break;
+    case UNC_TA_UINT8:   MATH_WIDEN(unsigned char, fb); break;
+    case UNC_TA_INT16:   MATH_WIDEN(ta_i16, fb);        break;
+    case UNC_TA_UINT16:  MATH_WIDEN(ta_u16, fb);        break;
+    case UNC_TA_INT32:   MATH_WIDEN(ta_i32, fb);        break;
+    case UNC_TA_UINT32:  MATH_WIDEN(ta_u32, fb);        break;
+    case UNC_TA_FLOAT32: MATH_WIDEN(float, fb);         break;
+    default:
+        NEVER_();
+    }
+    return 0;
+}
+
+static Unc_RetVal uncl_math_outnew(Unc_View *w, struct uncl_math_out *o,
+                                   int packed, int flt, Unc_Size n) {
+    if (packed) {
+        o->av = NULL;
+        return unc0_newtarray(w, flt ? UNC_TA_FLOAT : UNC_TA_INT, n,
+                              &o->p, &o->v);
+    }
+    o->p = NULL;
+    return unc_newarray(w, &o->v, n, &o->av);
+}
+
+static void uncl_math_outdone(Unc_View *w, struct uncl_math_out *o) {
+    if (o->av) unc_unlock(w, &o->v);
+}
+
+static void uncl_math_puti(struct uncl_math_out *o, Unc_Size i,
+                           const Unc_Int *b, Unc_Size n) {
+    Unc_Size j;
+    if (o->p)
+        unc0_memcpy(o->p + i * sizeof(Unc_Int), b, n * sizeof(Unc_Int));
+    else
+        for (j = 0; j < n; ++j)
+            VINITINT(&o->av[i + j], b[j]);
+}
+
+static void uncl_math_putf(struct uncl_math_out *o, Unc_Size i,
+                           const Unc_Float *b, Unc_Size n) {
+    Unc_Size j;
+    if (o->p)
+        unc0_memcpy(o->p + i * sizeof(Unc_Float), b, n * sizeof(Unc_Float));
+    else
+        for (j = 0; j < n; ++j)
+            VINITFLT(&o->av[i + j], b[j]);
+}
+
+/* are all of the integers within [-g, g]? */
+static int uncl_math_iwithin(const Unc_Int *b, Unc_Size n, Unc_Int g) {
+    Unc_Size i;
+    Unc_Int lo = 0, hi = 0;
+    for (i = 0; i < n; ++i) {
+        lo = b[i] < lo ? b[i] : lo;
+        hi = b[i] > hi ? b[i] : hi;
+    }
+    return lo >= -g && hi <= g;
+}
+
+/* adds the sum of a block to *s. returns nonzero on overflow */
+static int uncl_math_isum(const Unc_Int *b, Unc_Size n, Unc_Int *s) {
+    Unc_Size i;
+    Unc_Int t = 0;
+    if (uncl_math_iwithin(b, n, MATH_ISUMMAX)) {
+        for (i = 0; i < n; ++i)
+            t += b[i];
+    } else {
+        for (i = 0; i < n; ++i) {
+            if (ADDOVF(t, b[i])) return 1;
+            t += b[i];
+        }
+    }
+    if (ADDOVF(*s, t)) return 1;
+    *s += t;
+    return 0;
+}
+
+/* float sums use four partial sums, which lets the compiler vectorize them
+   without reassociating, and also loses less precision */
+static Unc_Float uncl_math_fsum(const Unc_Float *b, Unc_Size n) {
+    Unc_Size i;
+    Unc_Float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (i = 0; i + 4 <= n; i += 4) {
+        s0 += b[i];
+        s1 += b[i + 1];
+        s2 += b[i + 2];
+        s3 += b[i + 3];
+    }
+    for (; i < n; ++i)
+        s0 += b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+static Unc_Float uncl_math_fdot(const Unc_Float *a, const Unc_Float *b,
+                                Unc_Size n) {
+    Unc_Size i;
+    Unc_Float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (i = 0; i + 4 <= n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; ++i)
+        s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+/* sum of squared deviations from m */
+static Unc_Float uncl_math_fssd(const Unc_Float *b, Unc_Size n, Unc_Float m) {
+    Unc_Size i;
+    Unc_Float s0 = 0, s1 = 0, s2 = 0, s3 = 0, d0, d1, d2, d3;
+    for (i = 0; i + 4 <= n; i += 4) {
+        d0 = b[i] - m;
+        d1 = b[i + 1] - m;
+        d2 = b[i + 2] - m;
+        d3 = b[i + 3] - m;
+        s0 += d0 * d0;
+        s1 += d1 * d1;
+        s2 += d2 * d2;
+        s3 += d3 * d3;
+    }
+    for (; i < n; ++i) {
+        d0 = b[i] - m;
+        s0 += d0 * d0;
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+static int uncl_math_sumi(const struct uncl_math_vec *x, Unc_Int *out) {
+    Unc_Int ib[MATH_BLOCK], s = 0;
+    Unc_Size i, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadi(x, i, n, ib) || uncl_math_isum(ib, n, &s))
+            return 1;
+    }
+    *out = s;
+    return 0;
+}
+
+static int uncl_math_sumf(const struct uncl_math_vec *x, Unc_Float *out) {
+    Unc_Float fb[MATH_BLOCK], s = 0;
+    Unc_Size i, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadf(x, i, n, fb))
+            return 1;
+        s += uncl_math_fsum(fb, n);
+    }
+    *out = s;
+    return 0;
+}
+
+Unc_RetVal uncl_math_sum(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct uncl_math_vec x;
+    Unc_Int ui = 0;
+    Unc_Float uf = 0;
+    int flt, bad = 0;
+
+    e = uncl_math_getvec(w, &args.values[0], &x);
+    if (e) return e;
+    uncl_math_lock(&x, NULL);
+    flt = uncl_math_isflt(&x) || uncl_math_sumi(&x, &ui);
+    if (flt)
+        bad = uncl_math_sumf(&x, &uf);
+    uncl_math_unlock(&x, NULL);
+    if (bad) return uncl_math_notnum(w);
+    if (flt)
+        unc_setfloat(w, &v, uf);
+    else
+        unc_setint(w, &v, ui);
+    return unc_returnlocal(w, 0, &v);
+}
+
+static int uncl_math_doti(const struct uncl_math_vec *x,
+                          const struct uncl_math_vec *y, Unc_Int *out) {
+    Unc_Int xb[MATH_BLOCK], yb[MATH_BLOCK], s = 0, t, p;
+    Unc_Size i, j, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadi(x, i, n, xb) || uncl_math_loadi(y, i, n, yb))
+            return 1;
+        t = 0;
+        if (uncl_math_iwithin(xb, n, MATH_IDOTMAX)
+                && uncl_math_iwithin(yb, n, MATH_IDOTMAX)) {
+            for (j = 0; j < n; ++j)
+                t += xb[j] * yb[j];
+        } else {
+            for (j = 0; j < n; ++j) {
+                if (MULOVF(xb[j], yb[j])) return 1;
+                p = xb[j] * yb[j];
+                if (ADDOVF(t, p)) return 1;
+                t += p;
+            }
+        }
+        if (ADDOVF(s, t)) return 1;
+        s += t;
+    }
+    *out = s;
+    return 0;
+}
+
+static int uncl_math_dotf(const struct uncl_math_vec *x,
+                          const struct uncl_math_vec *y, Unc_Float *out) {
+    Unc_Float xb[MATH_BLOCK], yb[MATH_BLOCK], s = 0;
+    Unc_Size i, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadf(x, i, n, xb) || uncl_math_loadf(y, i, n, yb))
+            return 1;
+        s += uncl_math_fdot(xb, yb, n);
+    }
+    *out = s;
+    return 0;
+}
+
+Unc_RetVal uncl_math_dot(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct uncl_math_vec x, y;
+    Unc_Int ui = 0;
+    Unc_Float uf = 0;
+    int flt, bad = 0;
+
+    e = uncl_math_getvec(w, &args.values[0], &x);
+    if (e) return e;
+    e = uncl_math_getvec(w, &args.values[1], &y);
+    if (e) return e;
+    uncl_math_lock(&x, &y);
+    if (x.n != y.n) {
+        uncl_math_unlock(&x, &y);
+        return unc_throwexc(w, "value", "vectors have different lengths");
+    }
+    flt = uncl_math_isflt(&x) || uncl_math_isflt(&y)
+                              || uncl_math_doti(&x, &y, &ui);
+    if (flt)
+        bad = uncl_math_dotf(&x, &y, &uf);
+    uncl_math_unlock(&x, &y);
+    if (bad) return uncl_math_notnum(w);
+    if (flt)
+        unc_setfloat(w, &v, uf);
+    else
+        unc_setint(w, &v, ui);
+    return unc_returnlocal(w, 0, &v);
+}
+
+static int uncl_math_minmaxi(const struct uncl_math_vec *x,
+                             Unc_Int *pmin, Unc_Int *pmax) {
+    Unc_Int ib[MATH_BLOCK], lo = UNC_INT_MAX, hi = UNC_INT_MIN;
+    Unc_Size i, j, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadi(x, i, n, ib))
+            return 1;
+        for (j = 0; j < n; ++j) {
+            lo = ib[j] < lo ? ib[j] : lo;
+            hi = ib[j] > hi ? ib[j] : hi;
+        }
+    }
+    *pmin = lo;
+    *pmax = hi;
+    return 0;
+}
+
+/* NaNs are skipped, unless there is nothing else */
+static int uncl_math_minmaxf(const struct uncl_math_vec *x,
+                             Unc_Float *pmin, Unc_Float *pmax) {
+    Unc_Float fb[MATH_BLOCK], lo = unc0_finfty(), hi = -unc0_finfty();
+    Unc_Size i, j, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadf(x, i, n, fb))
+            return 1;
+        for (j = 0; j < n; ++j) {
+            lo = fb[j] < lo ? fb[j] : lo;
+            hi = fb[j] > hi ? fb[j] : hi;
+        }
+    }
+    if (lo > hi)
+        lo = hi = unc0_fnan();
+    *pmin = lo;
+    *pmax = hi;
+    return 0;
+}
+
+Unc_RetVal uncl_math_minmax(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v[2] = UNC_BLANKS;
+    struct uncl_math_vec x;
+    Unc_Int ui0 = 0, ui1 = 0;
+    Unc_Float uf0 = 0, uf1 = 0;
+    int flt, bad = 0;
+
+    e = uncl_math_getvec(w, &args.values[0], &x);
+    if (e) return e;
+    uncl_math_lock(&x, NULL);
+    if (!x.n) {
+        uncl_math_unlock(&x, NULL);
+        return unc_throwexc(w, "value", "vector is empty");
+    }
+    flt = uncl_math_isflt(&x) || uncl_math_minmaxi(&x, &ui0, &ui1);
+    if (flt)
+        bad = uncl_math_minmaxf(&x, &uf0, &uf1);
+    uncl_math_unlock(&x, NULL);
+    if (bad) return uncl_math_notnum(w);
+    if (flt) {
+        unc_setfloat(w, &v[0], uf0);
+        unc_setfloat(w, &v[1], uf1);
+    } else {
+        unc_setint(w, &v[0], ui0);
+        unc_setint(w, &v[1], ui1);
+    }
+    return unc_returnlocalarray(w, 0, 2, v);
+}
+
+Unc_RetVal uncl_math_mean(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct uncl_math_vec x;
+    Unc_Float uf = 0;
+    int bad;
+
+    e = uncl_math_getvec(w, &args.values[0], &x);
+    if (e) return e;
+    uncl_math_lock(&x, NULL);
+    if (!x.n) {
+        uncl_math_unlock(&x, NULL);
+        return unc_throwexc(w, "value", "vector is empty");
+    }
+    bad = uncl_math_sumf(&x, &uf);
+    uf /= (Unc_Float)x.n;
+    uncl_math_unlock(&x, NULL);
+    if (bad) return uncl_math_notnum(w);
+    unc_setfloat(w, &v, uf);
+    return unc_returnlocal(w, 0, &v);
+}
+
+/* two passes, first for the mean and then for the deviations from it */
+Unc_RetVal uncl_math_variance(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct uncl_math_vec x;
+    Unc_Float fb[MATH_BLOCK], m, s = 0;
+    Unc_Int ddof = 0;
+    Unc_Size i, n;
+    int bad;
+
+    e = uncl_math_getvec(w, &args.values[0], &x);
+    if (e) return e;
+    if (unc_gettype(w, &args.values[1])) {
+        e = unc_getint(w, &args.values[1], &ddof);
+        if (e) return e;
+        if (ddof < 0)
+            return unc_throwexc(w, "value", "ddof cannot be negative");
+    }
+    uncl_math_lock(&x, NULL);
+    if (x.n <= (Unc_UInt)ddof) {
+        uncl_math_unlock(&x, NULL);
+        return unc_throwexc(w, "value", "not enough values for variance");
+    }
+    bad = uncl_math_sumf(&x, &m);
+    m /= (Unc_Float)x.n;
+    for (i = 0; !bad && i < x.n; i += n) {
+        n = MATH_BLOCKLEN(&x, i);
+        uncl_math_loadf(&x, i, n, fb);
+        s += uncl_math_fssd(fb, n, m);
+    }
+    uncl_math_unlock(&x, NULL);
+    if (bad) return uncl_math_notnum(w);
+    unc_setfloat(w, &v, s / (Unc_Float)(x.n - (Unc_Size)ddof));
+    return unc_returnlocal(w, 0, &v);
+}
+
+/* runs an elementwise kernel over x and y (which may be NULL). the vectors
+   must be locked */
+static Unc_RetVal uncl_math_elementwise(Unc_View *w,
+                                        const struct uncl_math_vec *x,
+                                        const struct uncl_math_vec *y,
+                                        const struct uncl_math_coef *c,
+                                        int flt, uncl_math_pass fi,
+                                        uncl_math_pass ff, Unc_Value *out) {
+    Unc_RetVal e;
+    struct uncl_math_out o;
+    int packed = x->packed || (y && y->packed);
+
+    o.v = unc_blank;
+    flt = flt || uncl_math_isflt(x) || (y && uncl_math_isflt(y));
+    e = uncl_math_outnew(w, &o, packed, flt, x->n);
+    if (e) return e;
+    if (!flt && (*fi)(x, y, c, &o)) {
+        /* start over with floats */
+        flt = 1;
+        uncl_math_outdone(w, &o);
+        unc_clear(w, &o.v);
+        e = uncl_math_outnew(w, &o, packed, flt, x->n);
+        if (e) return e;
+    }
+    if (flt && (*ff)(x, y, c, &o))
+        e = UNCIL_ERR_CONVERT_TOFLOAT;
+    uncl_math_outdone(w, &o);
+    if (e)
+        unc_clear(w, &o.v);
+    else
+        unc_move(w, out, &o.v);
+    return e;
+}
+
+static Unc_RetVal uncl_math_binary(Unc_View *w, Unc_Tuple args,
+                                   uncl_math_pass fi, uncl_math_pass ff) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct uncl_math_vec x, y;
+
+    e = uncl_math_getvec(w, &args.values[0], &x);
+    if (e) return e;
+    e = uncl_math_getvec(w, &args.values[1], &y);
+    if (e) return e;
+    uncl_math_lock(&x, &y);
+    if (x.n != y.n) {
+        uncl_math_unlock(&x, &y);
+        return unc_throwexc(w, "value", "vectors have different lengths");
+    }
+    e = uncl_math_elementwise(w, &x, &y, NULL, 0, fi, ff, &v);
+    uncl_math_unlock(&x, &y);
+    if (e == UNCIL_ERR_CONVERT_TOFLOAT) return uncl_math_notnum(w);
+    return unc_returnlocal(w, e, &v);
+}
+
+static int uncl_math_addi(const struct uncl_math_vec *x,
+                          const struct uncl_math_vec *y,
+                          const struct uncl_math_coef *c,
+                          struct uncl_math_out *o) {
+    Unc_Int xb[MATH_BLOCK], yb[MATH_BLOCK], rb[MATH_BLOCK], r, ovf;
+    Unc_Size i, j, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadi(x, i, n, xb) || uncl_math_loadi(y, i, n, yb))
+            return 1;
+        /* the sum overflowed if its sign differs from both operands */
+        ovf = 0;
+        for (j = 0; j < n; ++j) {
+            r = (Unc_Int)((Unc_UInt)xb[j] + (Unc_UInt)yb[j]);
+            ovf |= (xb[j] ^ r) & (yb[j] ^ r);
+            rb[j] = r;
+        }
+        if (ovf < 0) return 1;
+        uncl_math_puti(o, i, rb, n);
+    }
+    return 0;
+}
+
+static int uncl_math_addf(const struct uncl_math_vec *x,
+                          const struct uncl_math_vec *y,
+                          const struct uncl_math_coef *c,
+                          struct uncl_math_out *o) {
+    Unc_Float xb[MATH_BLOCK], yb[MATH_BLOCK];
+    Unc_Size i, j, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadf(x, i, n, xb) || uncl_math_loadf(y, i, n, yb))
+            return 1;
+        for (j = 0; j < n; ++j)
+            xb[j] += yb[j];
+        uncl_math_putf(o, i, xb, n);
+    }
+    return 0;
+}
+
+static int uncl_math_muli(const struct uncl_math_vec *x,
+                          const struct uncl_math_vec *y,
+                          const struct uncl_math_coef *c,
+                          struct uncl_math_out *o) {
+    Unc_Int xb[MATH_BLOCK], yb[MATH_BLOCK];
+    Unc_Size i, j, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadi(x, i, n, xb) || uncl_math_loadi(y, i, n, yb))
+            return 1;
+        if (!uncl_math_iwithin(xb, n, MATH_IDOTMAX)
+                || !uncl_math_iwithin(yb, n, MATH_IDOTMAX)) {
+            for (j = 0; j < n; ++j)
+                if (MULOVF(xb[j], yb[j])) return 1;
+        }
+        for (j = 0; j < n; ++j)
+            xb[j] *= yb[j];
+        uncl_math_puti(o, i, xb, n);
+    }
+    return 0;
+}
+
+static int uncl_math_mulf(const struct uncl_math_vec *x,
+                          const struct uncl_math_vec *y,
+                          const struct uncl_math_coef *c,
+                          struct uncl_math_out *o) {
+    Unc_Float xb[MATH_BLOCK], yb[MATH_BLOCK];
+    Unc_Size i, j, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadf(x, i, n, xb) || uncl_math_loadf(y, i, n, yb))
+            return 1;
+        for (j = 0; j < n; ++j)
+            xb[j] *= yb[j];
+        uncl_math_putf(o, i, xb, n);
+    }
+    return 0;
+}
+
+Unc_RetVal uncl_math_add(Unc_View *w, Unc_Tuple args, void *udata) {
+    return uncl_math_binary(w, args, &uncl_math_addi, &uncl_math_addf);
+}
+
+Unc_RetVal uncl_math_mul(Unc_View *w, Unc_Tuple args, void *udata) {
+    return uncl_math_binary(w, args, &uncl_math_muli, &uncl_math_mulf);
+}
+
+static int uncl_math_scalei(const struct uncl_math_vec *x,
+                            const struct uncl_math_vec *y,
+                            const struct uncl_math_coef *c,
+                            struct uncl_math_out *o) {
+    Unc_Int ib[MATH_BLOCK], k = c->ik, a = c->ic, p;
+    Unc_Size i, j, n;
+    int small = k >= -MATH_IDOTMAX && k <= MATH_IDOTMAX
+             && a >= -MATH_ISUMMAX && a <= MATH_ISUMMAX;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadi(x, i, n, ib))
+            return 1;
+        if (!small || !uncl_math_iwithin(ib, n, MATH_IDOTMAX)) {
+            for (j = 0; j < n; ++j) {
+                if (MULOVF(ib[j], k)) return 1;
+                p = ib[j] * k;
+                if (ADDOVF(p, a)) return 1;
+            }
+        }
+        for (j = 0; j < n; ++j)
+            ib[j] = ib[j] * k + a;
+        uncl_math_puti(o, i, ib, n);
+    }
+    return 0;
+}
+
+static int uncl_math_scalef(const struct uncl_math_vec *x,
+                            const struct uncl_math_vec *y,
+                            const struct uncl_math_coef *c,
+                            struct uncl_math_out *o) {
+    Unc_Float fb[MATH_BLOCK], k = c->fk, a = c->fc;
+    Unc_Size i, j, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadf(x, i, n, fb))
+            return 1;
+        for (j = 0; j < n; ++j)
+            fb[j] = fb[j] * k + a;
+        uncl_math_putf(o, i, fb, n);
+    }
+    return 0;
+}
+
+Unc_RetVal uncl_math_scale(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct uncl_math_vec x;
+    struct uncl_math_coef c;
+    int flt = 0;
+
+    e = uncl_math_getvec(w, &args.values[0], &x);
+    if (e) return e;
+    e = uncl_math_getnum(w, &args.values[1], &c.ik, &c.fk, &flt);
+    if (e) return e;
+    c.ic = 0;
+    c.fc = 0;
+    if (unc_gettype(w, &args.values[2])) {
+        e = uncl_math_getnum(w, &args.values[2], &c.ic, &c.fc, &flt);
+        if (e) return e;
+    }
+    uncl_math_lock(&x, NULL);
+    e = uncl_math_elementwise(w, &x, NULL, &c, flt,
+                              &uncl_math_scalei, &uncl_math_scalef, &v);
+    uncl_math_unlock(&x, NULL);
+    if (e == UNCIL_ERR_CONVERT_TOFLOAT) return uncl_math_notnum(w);
+    return unc_returnlocal(w, e, &v);
+}
+
+/* a running sum cannot be vectorized, but it can avoid boxing */
+static int uncl_math_cumsumi(const struct uncl_math_vec *x,
+                             const struct uncl_math_vec *y,
+                             const struct uncl_math_coef *c,
+                             struct uncl_math_out *o) {
+    Unc_Int ib[MATH_BLOCK], s = 0, r;
+    Unc_Size i, j, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadi(x, i, n, ib))
+            return 1;
+        for (j = 0; j < n; ++j) {
+            r = (Unc_Int)((Unc_UInt)s + (Unc_UInt)ib[j]);
+            if (((s ^ r) & (ib[j] ^ r)) < 0) return 1;
+            ib[j] = s = r;
+        }
+        uncl_math_puti(o, i, ib, n);
+    }
+    return 0;
+}
+
+static int uncl_math_cumsumf(const struct uncl_math_vec *x,
+                             const struct uncl_math_vec *y,
+                             const struct uncl_math_coef *c,
+                             struct uncl_math_out *o) {
+    Unc_Float fb[MATH_BLOCK], s = 0;
+    Unc_Size i, j, n;
+    for (i = 0; i < x->n; i += n) {
+        n = MATH_BLOCKLEN(x, i);
+        if (uncl_math_loadf(x, i, n, fb))
+            return 1;
+        for (j = 0; j < n; ++j)
+            fb[j] = s += fb[j];
+        uncl_math_putf(o, i, fb, n);
+    }
+    return 0;
+}
+
+Unc_RetVal uncl_math_cumsum(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct uncl_math_vec x;
+
+    e = uncl_math_getvec(w, &args.values[0], &x);
+    if (e) return e;
+    uncl_math_lock(&x, NULL);
+    e = uncl_math_elementwise(w, &x, NULL, NULL, 0,
+                              &uncl_math_cumsumi, &uncl_math_cumsumf, &v);
+    uncl_math_unlock(&x, NULL);
+    if (e == UNCIL_ERR_CONVERT_TOFLOAT) return uncl_math_notnum(w);
+    return unc_returnlocal(w, e, &v);
+}
+
+/* values outside [lo, hi] and NaNs are not counted. the last bin is closed,
+   so that hi itself is counted */
+Unc_RetVal uncl_math_histogram(Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    Unc_Value *av;
+    struct uncl_math_vec x;
+    Unc_Float fb[MATH_BLOCK], lo = 0, hi = 0, scale;
+    Unc_Size kb[MATH_BLOCK], *counts;
+    Unc_Int bins;
+    Unc_Size i, j, k, n, nb;
+    int bad = 0;
+
+    e = uncl_math_getvec(w, &args.values[0], &x);
+    if (e) return e;
+    e = unc_getint(w, &args.values[1], &bins);
+    if (e) return e;
+    if (bins <= 0)
+        return unc_throwexc(w, "value", "number of bins must be positive");
+    if (unc_gettype(w, &args.values[2])) {
+        e = unc_getfloat(w, &args.values[2], &lo);
+        if (e) return e;
+    }
+    if (unc_gettype(w, &args.values[3])) {
+        e = unc_getfloat(w, &args.values[3], &hi);
+        if (e) return e;
+    }
+    nb = (Unc_Size)bins;
+    if (nb != (Unc_UInt)bins || nb > (Unc_Size)-1 / sizeof(Unc_Size))
+        return UNCIL_ERR_MEM;
+    counts = unc_malloc(w, nb * sizeof(Unc_Size));
+    if (!counts) return UNCIL_ERR_MEM;
+    for (k = 0; k < nb; ++k)
+        counts[k] = 0;
+
+    uncl_math_lock(&x, NULL);
+    if (!unc_gettype(w, &args.values[2]) || !unc_gettype(w, &args.values[3])) {
+        Unc_Float flo, fhi;
+        bad = uncl_math_minmaxf(&x, &flo, &fhi);
+        if (!unc_gettype(w, &args.values[2])) lo = flo;
+        if (!unc_gettype(w, &args.values[3])) hi = fhi;
+    }
+    if (!bad && hi < lo) {
+        uncl_math_unlock(&x, NULL);
+        unc_mfree(w, counts);
+        return unc_throwexc(w, "value", "histogram range is empty");
+    }
+    scale = hi > lo ? (Unc_Float)nb / (hi - lo) : 0;
+    for (i = 0; !bad && i < x.n; i += n) {
+        n = MATH_BLOCKLEN(&x, i);
+        if (uncl_math_loadf(&x, i, n, fb)) {
+            bad = 1;
+            break;
+        }
+        /* hi itself falls on nb, which goes to the last bin, and values
+           out of range get nb + 1, which is not counted */
+        for (j = 0; j < n; ++j)
+            kb[j] = fb[j] >= lo && fb[j] <= hi
+                        ? (Unc_Size)((fb[j] - lo) * scale) : nb + 1;
+        for (j = 0; j < n; ++j) {
+            k = kb[j] == nb ? nb - 1 : kb[j];
+            if (k < nb) ++counts[k];
+        }
+    }
+    uncl_math_unlock(&x, NULL);
+    if (bad) {
+        unc_mfree(w, counts);
+        return uncl_math_notnum(w);
+    }
+
+    e = unc_newarray(w, &v, nb, &av);
+    if (!e) {
+        for (k = 0; k < nb; ++k)
+            VINITINT(&av[k], (Unc_Int)counts[k]);
+        unc_unlock(w, &v);
+    }
+    unc_mfree(w, counts);
+    return unc_returnlocal(w, e, &v);
+}
+
 #define FN(x) &uncl_math_##x, #x
 static const Unc_ModuleCFunc lib[] = {
     { FN(abs),      1, 0, 0, UNC_CFUNC_CONCURRENT },
@@ -384,6 +1336,16 @@ static const Unc_ModuleCFunc lib[] = {
     { FN(min),      1, 0, 1, UNC_CFUNC_CONCURRENT },
     { FN(max),      1, 0, 1, UNC_CFUNC_CONCURRENT },
     { FN(clamp),    3, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FN(sum),      1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FN(dot),      2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FN(minmax),   1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FN(mean),     1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FN(variance), 1, 1, 0, UNC_CFUNC_CONCURRENT },
+    { FN(add),      2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FN(mul),      2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FN(scale),    2, 1, 0, UNC_CFUNC_CONCURRENT },
+    { FN(cumsum),   1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FN(histogram), 2, 2, 0, UNC_CFUNC_CONCURRENT },
 };
 
 INLINE Unc_RetVal setflt_(struct Unc_View *w, const char *name, Unc_Float f) {
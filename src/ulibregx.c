@@ -90,26 +90,27 @@ static Unc_RetVal uncl_regex_getpat_make(Unc_View *w,
                             const char *prefix,
                             void *udata);
 static int unc0_regex_match(Unc_View *w, struct unc_regex_pattern *pat,
-                            Unc_Size sn, const char *ss,
+                            Unc_Value *sv, Unc_Size sn, const char *ss,
                             Unc_Value v[2], void *udata);
 static Unc_RetVal unc0_regex_find(Unc_View *w, struct unc_regex_pattern *pat,
-                                  Unc_Size sn, const char *ss,
+                                  Unc_Value *sv, Unc_Size sn, const char *ss,
                                   Unc_Value v[2], Unc_Size startat,
                                   void *udata);
 static Unc_RetVal unc0_regex_findlast(Unc_View *w,
                                       struct unc_regex_pattern *pat,
+                                      Unc_Value *sv,
                                       Unc_Size sn, const char *ss,
                                       Unc_Value v[2], Unc_Size startat,
                                       void *udata);
 static Unc_RetVal unc0_regex_findall(Unc_View *w,
                                      struct unc_regex_pattern *pat,
-                                     Unc_Size sn, const char *ss,
+                                     Unc_Value *sv, Unc_Size sn, const char *ss,
                                      struct unc0_varr *varr,
                                      Unc_Value v[2], Unc_Size startat,
                                      void *udata);
 static Unc_RetVal unc0_regex_split(Unc_View *w,
                                    struct unc_regex_pattern *pat,
-                                   Unc_Size sn, const char *ss,
+                                   Unc_Value *sv, Unc_Size sn, const char *ss,
                                    struct unc0_varr *varr, int direction,
                                    Unc_Size startat, Unc_Size splits,
                                    void *udata);
@@ -343,7 +344,7 @@ static int unc0_regex_findbidi(int direction,
 }
 
 static int unc0_regex_match(Unc_View *w, struct unc_regex_pattern *pat,
-                            Unc_Size sn, const char *ss,
+                            Unc_Value *sv, Unc_Size sn, const char *ss,
                             Unc_Value v[2], void *udata) {
     Unc_RetVal e = 0;
     pcre2_general_context *gcxt = (pcre2_general_context *)udata;
@@ -373,7 +374,7 @@ static int unc0_regex_match(Unc_View *w, struct unc_regex_pattern *pat,
                 for (i = 0; !e && i < rc; ++i) {
                     Unc_Size z0 = ovec[i * 2];
                     Unc_Size zl = ovec[i * 2 + 1] - z0;
-                    e = unc_newstring(w, &av[i], zl, ss + z0);
+                    e = unc_newsubstring(w, &av[i], sv, zl, ss + z0);
                 }
             }
         }
@@ -385,7 +386,7 @@ static int unc0_regex_match(Unc_View *w, struct unc_regex_pattern *pat,
 }
 
 static Unc_RetVal unc0_regex_find(Unc_View *w, struct unc_regex_pattern *pat,
-                                  Unc_Size sn, const char *ss,
+                                  Unc_Value *sv, Unc_Size sn, const char *ss,
                                   Unc_Value v[2], Unc_Size startat,
                                   void *udata) {
     Unc_RetVal e = 0;
@@ -410,7 +411,7 @@ static Unc_RetVal unc0_regex_find(Unc_View *w, struct unc_regex_pattern *pat,
             for (i = 0; !e && i < rc; ++i) {
                 Unc_Size z0 = ovec[i * 2];
                 Unc_Size zl = ovec[i * 2 + 1] - z0;
-                e = unc_newstring(w, &av[i], zl, ss + z0);
+                e = unc_newsubstring(w, &av[i], sv, zl, ss + z0);
             }
         }
     } else
@@ -422,6 +423,7 @@ static Unc_RetVal unc0_regex_find(Unc_View *w, struct unc_regex_pattern *pat,
 
 static Unc_RetVal unc0_regex_findlast(Unc_View *w,
                                       struct unc_regex_pattern *pat,
+                                      Unc_Value *sv,
                                       Unc_Size sn, const char *ss,
                                       Unc_Value v[2], Unc_Size startat,
                                       void *udata) {
@@ -447,7 +449,7 @@ static Unc_RetVal unc0_regex_findlast(Unc_View *w,
             for (i = 0; !e && i < rc; ++i) {
                 Unc_Size z0 = ovec[i * 2];
                 Unc_Size zl = ovec[i * 2 + 1] - z0;
-                e = unc_newstring(w, &av[i], zl, ss + z0);
+                e = unc_newsubstring(w, &av[i], sv, zl, ss + z0);
             }
         }
     } else
@@ -459,7 +461,7 @@ static Unc_RetVal unc0_regex_findlast(Unc_View *w,
 
 static Unc_RetVal unc0_regex_findall(Unc_View *w,
                                      struct unc_regex_pattern *pat,
-                                     Unc_Size sn, const char *ss,
+                                     Unc_Value *sv, Unc_Size sn, const char *ss,
                                      struct unc0_varr *varr,
                                      Unc_Value v[2], Unc_Size startat,
                                      void *udata) {
@@ -486,7 +488,7 @@ static Unc_RetVal unc0_regex_findall(Unc_View *w,
                 for (i = 0; !e && i < rc; ++i) {
                     Unc_Size z0 = ovec[i * 2];
                     Unc_Size zl = ovec[i * 2 + 1] - z0;
-                    e = unc_newstring(w, &av[i], zl, ss + z0);
+                    e = unc_newsubstring(w, &av[i], sv, zl, ss + z0);
                 }
                 e = unc_newarrayfrom(w, &v[0], 2, v);
                 if (!e) e = unc0_varr_push(w, varr, &v[0]);
@@ -501,7 +503,7 @@ static Unc_RetVal unc0_regex_findall(Unc_View *w,
 
 static Unc_RetVal unc0_regex_split(Unc_View *w,
                                    struct unc_regex_pattern *pat,
-                                   Unc_Size sn, const char *ss,
+                                   Unc_Value *sv, Unc_Size sn, const char *ss,
                                    struct unc0_varr *varr, int direction,
                                    Unc_Size startat, Unc_Size splits,
                                    void *udata) {
@@ -524,17 +526,17 @@ static Unc_RetVal unc0_regex_split(Unc_View *w,
                 e = unc0_regex_makeerr(w, "regex.split()", rc);
             else {
                 if (!e) e = !direction
-                        ? unc_newstring(w, &vs,
+                        ? unc_newsubstring(w, &vs, sv,
                                 ovec[0] - started, ss + started)
-                        : unc_newstring(w, &vs,
+                        : unc_newsubstring(w, &vs, sv,
                                 started - ovec[1], ss + ovec[1]);
                 if (!e) e = unc0_varr_push(w, varr, &vs);
                 if (direction) ended = ovec[0];
             }
         }
         if (!e) e = !direction
-                ? unc_newstring(w, &vs, sn - startat, ss + startat)
-                : unc_newstring(w, &vs, ended, ss);
+                ? unc_newsubstring(w, &vs, sv, sn - startat, ss + startat)
+                : unc_newsubstring(w, &vs, sv, ended, ss);
         if (!e) e = unc0_varr_push(w, varr, &vs);
     } else
         e = UNCIL_ERR_MEM;
@@ -648,13 +650,13 @@ static Unc_RetVal uncl_regex_getpat_make(Unc_View *w,
 }
 
 static int unc0_regex_match(Unc_View *w, struct unc_regex_pattern *pat,
-                            Unc_Size sn, const char *ss,
+                            Unc_Value *sv, Unc_Size sn, const char *ss,
                             Unc_Value v[2], void *udata) {
     return UNCIL_ERR_LOGIC_NOTSUPPORTED;
 }
 
 static Unc_RetVal unc0_regex_find(Unc_View *w, struct unc_regex_pattern *pat,
-                                  Unc_Size sn, const char *ss,
+                                  Unc_Value *sv, Unc_Size sn, const char *ss,
                                   Unc_Value v[2], Unc_Size startat,
                                   void *udata) {
     return UNCIL_ERR_LOGIC_NOTSUPPORTED;
@@ -662,6 +664,7 @@ static Unc_RetVal unc0_regex_find(Unc_View *w, struct unc_regex_pattern *pat,
 
 static Unc_RetVal unc0_regex_findlast(Unc_View *w,
                                       struct unc_regex_pattern *pat,
+                                      Unc_Value *sv,
                                       Unc_Size sn, const char *ss,
                                       Unc_Value v[2], Unc_Size startat,
                                       void *udata) {
@@ -670,7 +673,7 @@ static Unc_RetVal unc0_regex_findlast(Unc_View *w,
 
 static Unc_RetVal unc0_regex_findall(Unc_View *w,
                                      struct unc_regex_pattern *pat,
-                                     Unc_Size sn, const char *ss,
+                                     Unc_Value *sv, Unc_Size sn, const char *ss,
                                      struct unc0_varr *varr,
                                      Unc_Value v[2], Unc_Size startat,
                                      void *udata) {
@@ -679,7 +682,7 @@ static Unc_RetVal unc0_regex_findall(Unc_View *w,
 
 static Unc_RetVal unc0_regex_split(Unc_View *w,
                                    struct unc_regex_pattern *pat,
-                                   Unc_Size sn, const char *ss,
+                                   Unc_Value *sv, Unc_Size sn, const char *ss,
                                    struct unc0_varr *varr, int direction,
                                    Unc_Size startat, Unc_Size splits,
                                    void *udata) {
@@ -985,6 +988,7 @@ static void uncl_regex_unlock(Unc_View *w,
 
 Unc_RetVal uncl_regex_match(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
+    Unc_Value sv;
     Unc_Size sn;
     const char *ss;
     struct unc_regex_pattern pat;
@@ -993,18 +997,21 @@ Unc_RetVal uncl_regex_match(Unc_View *w, Unc_Tuple args, void *udata) {
 
     e = unc_getstring(w, &args.values[0], &sn, &ss);
     if (e) return e;
+    /* the arguments may move if the value stack is resized */
+    sv = args.values[0];
 
     e = uncl_regex_getpat(w, &args.values[1], &args.values[2],
         unc_boundvalue(w, 0), "regex.match()", udata, &pat, &temporary);
     if (e) return e;
     
-    e = unc0_regex_match(w, &pat, sn, ss, v, udata);
+    e = unc0_regex_match(w, &pat, &sv, sn, ss, v, udata);
     uncl_regex_unlock(w, &args.values[1], &pat, temporary);
     return unc_returnlocalarray(w, e, 2, v);
 }
 
 Unc_RetVal uncl_regex_find(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
+    Unc_Value sv;
     Unc_Size sn;
     const char *ss;
     struct unc_regex_pattern pat;
@@ -1014,6 +1021,7 @@ Unc_RetVal uncl_regex_find(Unc_View *w, Unc_Tuple args, void *udata) {
 
     e = unc_getstring(w, &args.values[0], &sn, &ss);
     if (e) return e;
+    sv = args.values[0];
 
     if (unc_gettype(w, &args.values[3])) {
         Unc_Int ui;
@@ -1044,13 +1052,14 @@ Unc_RetVal uncl_regex_find(Unc_View *w, Unc_Tuple args, void *udata) {
         unc_boundvalue(w, 0), "regex.find()", udata, &pat, &temporary);
     if (e) return e;
     
-    e = unc0_regex_find(w, &pat, sn, ss, v, startat, udata);
+    e = unc0_regex_find(w, &pat, &sv, sn, ss, v, startat, udata);
     uncl_regex_unlock(w, &args.values[1], &pat, temporary);
     return unc_returnlocalarray(w, e, 2, v);
 }
 
 Unc_RetVal uncl_regex_findlast(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
+    Unc_Value sv;
     Unc_Size sn;
     const char *ss;
     struct unc_regex_pattern pat;
@@ -1060,6 +1069,7 @@ Unc_RetVal uncl_regex_findlast(Unc_View *w, Unc_Tuple args, void *udata) {
 
     e = unc_getstring(w, &args.values[0], &sn, &ss);
     if (e) return e;
+    sv = args.values[0];
 
     if (unc_gettype(w, &args.values[3])) {
         Unc_Int ui;
@@ -1091,13 +1101,15 @@ Unc_RetVal uncl_regex_findlast(Unc_View *w, Unc_Tuple args, void *udata) {
         unc_boundvalue(w, 0), "regex.findlast()", udata, &pat, &temporary);
     if (e) return e;
 
-    e = unc0_regex_findlast(w, &pat, sn, ss, v, startat, udata);
+    e = unc0_regex_findlast(w, &pat, &sv, sn, ss, v, startat,
+                            udata);
     uncl_regex_unlock(w, &args.values[1], &pat, temporary);
     return unc_returnlocalarray(w, e, 2, v);
 }
 
 Unc_RetVal uncl_regex_findall(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
+    Unc_Value sv;
     Unc_Size sn;
     const char *ss;
     struct unc_regex_pattern pat;
@@ -1108,6 +1120,7 @@ Unc_RetVal uncl_regex_findall(Unc_View *w, Unc_Tuple args, void *udata) {
 
     e = unc_getstring(w, &args.values[0], &sn, &ss);
     if (e) return e;
+    sv = args.values[0];
 
     if (unc_gettype(w, &args.values[3])) {
         Unc_Int ui;
@@ -1144,7 +1157,8 @@ Unc_RetVal uncl_regex_findall(Unc_View *w, Unc_Tuple args, void *udata) {
         return e;
     }
     
-    e = unc0_regex_findall(w, &pat, sn, ss, &buf, v, startat, udata);
+    e = unc0_regex_findall(w, &pat, &sv, sn, ss, &buf, v,
+                           startat, udata);
     unc_clearmany(w, 2, v);
     uncl_regex_unlock(w, &args.values[1], &pat, temporary);
     if (!e) {
@@ -1157,6 +1171,7 @@ Unc_RetVal uncl_regex_findall(Unc_View *w, Unc_Tuple args, void *udata) {
 
 Unc_RetVal uncl_regex_split(Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
+    Unc_Value sv;
     Unc_Size sn;
     const char *ss;
     struct unc_regex_pattern pat;
@@ -1166,6 +1181,7 @@ Unc_RetVal uncl_regex_split(Unc_View *w, Unc_Tuple args, void *udata) {
 
     e = unc_getstring(w, &args.values[0], &sn, &ss);
     if (e) return e;
+    sv = args.values[0];
 
     if (unc_gettype(w, &args.values[3])) {
         Unc_Int ui;
@@ -1190,7 +1206,7 @@ Unc_RetVal uncl_regex_split(Unc_View *w, Unc_Tuple args, void *udata) {
         return e;
     }
     
-    e = unc0_regex_split(w, &pat, sn, ss, &buf,
+    e = unc0_regex_split(w, &pat, &sv, sn, ss, &buf,
                          direction, startat, splits, udata);
     uncl_regex_unlock(w, &args.values[1], &pat, temporary);
     if (!e) {
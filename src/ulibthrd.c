@@ -31,9 +31,12 @@ SOFTWARE.
 #define UNCIL_DEFINES
 
 #include "uarithm.h"
+#include "ublob.h"
 #include "udef.h"
+#include "ulibcbor.h"
 #include "umt.h"
 #include "uncil.h"
+#include "uobj.h"
 #include "uosdef.h"
 #include "uval.h"
 #include "uview.h"
@@ -91,6 +94,7 @@ struct unc_thrd_lock;
 struct unc_thrd_rlock;
 struct unc_thrd_sem;
 struct unc_thrd_mon;
+struct unc_thrd_rwlock;
 
 static Unc_RetVal unc_thrd_thread_new(struct unc_thrd_thread *x);
 static Unc_RetVal unc_thrd_thread_start(struct unc_thrd_thread *x);
@@ -122,6 +126,15 @@ static Unc_RetVal unc_thrd_sem_acquiretimed(struct unc_thrd_sem *sem,
 static Unc_RetVal unc_thrd_sem_release(struct unc_thrd_sem *sem, Unc_Size cnt);
 static void unc_thrd_sem_free(struct unc_thrd_sem *sem);
 
+static Unc_RetVal unc_thrd_rwlock_new(struct unc_thrd_rwlock *rw,
+                                      int preferwriters);
+static Unc_RetVal unc_thrd_rwlock_acquire(struct unc_thrd_rwlock *rw,
+                                          int write);
+static Unc_RetVal unc_thrd_rwlock_acquiretimed(struct unc_thrd_rwlock *rw,
+                                               int write, Unc_Float t);
+static Unc_RetVal unc_thrd_rwlock_release(struct unc_thrd_rwlock *rw);
+static void unc_thrd_rwlock_free(struct unc_thrd_rwlock *rw);
+
 static Unc_RetVal unc_thrd_mon_new(struct unc_thrd_mon *mon);
 static Unc_RetVal unc_thrd_mon_new_lock(struct unc_thrd_mon *mon,
                                  struct unc_thrd_lock *lock);
@@ -141,10 +154,17 @@ static void unc_thrd_mon_free(struct unc_thrd_mon *mon);
 
 static Unc_RetVal unc_thrd_sleep(Unc_Float t);
 
+struct unc_thrd_worker;
+static Unc_RetVal unc_thrd_worker_start(struct unc_thrd_worker *x,
+                                         void (*fn)(void *), void *p);
+
 struct unc_threadobj;
 static Unc_RetVal unc0_subthread(struct unc_threadobj *o);
 INLINE struct unc_threadobj *unc0_getthreadobj(struct unc_thrd_thread *x);
 INLINE int unc0_isthreadfinished(struct unc_threadobj *o);
+#if UNCIL_MT_OK
+static void unc0_poolworker(void *p);
+#endif
 
 #define THREADFAIL          0x0181
 #define THREADTIMEOUT       0x0182
@@ -297,6 +317,28 @@ static void unc_thrd_thread_finished(struct unc_thrd_thread *x) {
     unc_thrd_mon_notifyall(&x->mon);
 }
 
+struct unc_thrd_worker {
+    pthread_t t;
+    void (*fn)(void *);
+    void *p;
+};
+
+static void *unc_thrd_worker__run(void *p) {
+    struct unc_thrd_worker *x = p;
+    (*x->fn)(x->p);
+    return NULL;
+}
+
+static Unc_RetVal unc_thrd_worker_start(struct unc_thrd_worker *x,
+                                         void (*fn)(void *), void *p) {
+    int e;
+    x->fn = fn;
+    x->p = p;
+    e = pthread_create(&x->t, NULL, &unc_thrd_worker__run, x);
+    if (!e) pthread_detach(x->t);
+    return unc_thrd_fmterr(e);
+}
+
 static Unc_RetVal unc_thrd_lock_new(struct unc_thrd_lock *lock) {
     return unc_thrd_fmterr(pthread_mutex_init(&lock->m, NULL));
 }
@@ -523,6 +565,28 @@ static void unc_thrd_thread_finished(struct unc_thrd_thread *x) {
     unc_thrd_mon_notifyall(&x->mon);
 }
 
+struct unc_thrd_worker {
+    thrd_t t;
+    void (*fn)(void *);
+    void *p;
+};
+
+static int unc_thrd_worker__run(void *p) {
+    struct unc_thrd_worker *x = p;
+    (*x->fn)(x->p);
+    return 0;
+}
+
+static Unc_RetVal unc_thrd_worker_start(struct unc_thrd_worker *x,
+                                         void (*fn)(void *), void *p) {
+    int e;
+    x->fn = fn;
+    x->p = p;
+    e = thrd_create(&x->t, &unc_thrd_worker__run, x);
+    if (e == thrd_success) thrd_detach(x->t);
+    return unc_thrd_fmterr(e);
+}
+
 static Unc_RetVal unc_thrd_lock_new(struct unc_thrd_lock *lock) {
     return unc_thrd_fmterr(mtx_init(&lock->m, mtx_timed));
 }
@@ -622,6 +686,8 @@ struct unc_thrd_lock { char t_; };
 struct unc_thrd_rlock { char t_; };
 struct unc_thrd_sem { char t_; };
 struct unc_thrd_mon { char t_; };
+struct unc_thrd_rwlock { char t_; };
+struct unc_thrd_worker { char t_; };
 
 static Unc_RetVal unc_thrd_makeerr(Unc_View *w, int e) {
     return e;
@@ -652,6 +718,11 @@ static void unc_thrd_thread_kill(struct unc_thrd_thread *x) { }
 static void unc_thrd_thread_detach(struct unc_thrd_thread *x) { }
 static void unc_thrd_thread_finished(struct unc_thrd_thread *x) { }
 
+static Unc_RetVal unc_thrd_worker_start(struct unc_thrd_worker *x,
+                                         void (*fn)(void *), void *p) {
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+}
+
 static Unc_RetVal unc_thrd_lock_new(struct unc_thrd_lock *lock) {
     return UNCIL_ERR_LOGIC_NOTSUPPORTED;
 }
@@ -697,6 +768,23 @@ static Unc_RetVal unc_thrd_sem_release(struct unc_thrd_sem *sem, Unc_Size n) {
 }
 static void unc_thrd_sem_free(struct unc_thrd_sem *sem) { }
 
+static Unc_RetVal unc_thrd_rwlock_new(struct unc_thrd_rwlock *rw,
+                                      int preferwriters) {
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+}
+static Unc_RetVal unc_thrd_rwlock_acquire(struct unc_thrd_rwlock *rw,
+                                          int write) {
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+}
+static Unc_RetVal unc_thrd_rwlock_acquiretimed(struct unc_thrd_rwlock *rw,
+                                               int write, Unc_Float t) {
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+}
+static Unc_RetVal unc_thrd_rwlock_release(struct unc_thrd_rwlock *rw) {
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+}
+static void unc_thrd_rwlock_free(struct unc_thrd_rwlock *rw) { }
+
 static Unc_RetVal unc_thrd_mon_new(struct unc_thrd_mon *mon) {
     return UNCIL_ERR_LOGIC_NOTSUPPORTED;
 }
@@ -809,6 +897,117 @@ static void unc_thrd_sem_free(struct unc_thrd_sem *sem) {
 }
 #endif
 
+#if UNCIL_MT_OK
+/* read-write lock on top of a monitor. any number of readers or a single
+   writer may hold it. if writers are preferred, new readers wait while a
+   writer is waiting, otherwise writers wait until there are no readers */
+struct unc_thrd_rwlock {
+    struct unc_thrd_mon mon;
+    Unc_Size readers;
+    Unc_Size writerswaiting;
+    int writer;
+    int preferwriters;
+};
+
+static Unc_RetVal unc_thrd_rwlock_new(struct unc_thrd_rwlock *rw,
+                                      int preferwriters) {
+    rw->readers = 0;
+    rw->writerswaiting = 0;
+    rw->writer = 0;
+    rw->preferwriters = preferwriters;
+    return unc_thrd_mon_new(&rw->mon);
+}
+
+INLINE int unc_thrd_rwlock_busy(struct unc_thrd_rwlock *rw, int write) {
+    if (write)
+        return rw->writer || rw->readers;
+    return rw->writer || (rw->preferwriters && rw->writerswaiting);
+}
+
+INLINE void unc_thrd_rwlock_take(struct unc_thrd_rwlock *rw, int write) {
+    if (write)
+        rw->writer = 1;
+    else
+        ++rw->readers;
+}
+
+static Unc_RetVal unc_thrd_rwlock_acquire(struct unc_thrd_rwlock *rw,
+                                          int write) {
+    Unc_RetVal e;
+    e = unc_thrd_mon_acquire(&rw->mon);
+    if (e) return e;
+    if (write) ++rw->writerswaiting;
+    while (unc_thrd_rwlock_busy(rw, write)) {
+        if ((e = unc_thrd_mon_wait(&rw->mon))) {
+            if (write) --rw->writerswaiting;
+            unc_thrd_mon_release(&rw->mon);
+            return e;
+        }
+    }
+    if (write) --rw->writerswaiting;
+    unc_thrd_rwlock_take(rw, write);
+    unc_thrd_mon_release(&rw->mon);
+    return 0;
+}
+
+static Unc_RetVal unc_thrd_rwlock_acquiretimed(struct unc_thrd_rwlock *rw,
+                                               int write, Unc_Float timeout) {
+    Unc_RetVal e;
+    unc0_countdown cd;
+    e = unc0_countdownfirst(&cd);
+    if (e) return e;
+    e = unc_thrd_mon_acquiretimed(&rw->mon, timeout);
+    if (e) return e;
+    if (unc0_countdownnext(&cd, &timeout)) {
+        unc_thrd_mon_release(&rw->mon);
+        return THREADFAIL;
+    }
+    if (write) ++rw->writerswaiting;
+    while (unc_thrd_rwlock_busy(rw, write)) {
+        if (timeout <= 0)
+            e = THREADTIMEOUT;
+        else if (!(e = unc_thrd_mon_waittimed(&rw->mon, timeout))
+                    && unc0_countdownnext(&cd, &timeout))
+            e = THREADFAIL;
+        if (e == THREADTIMEOUT && !unc_thrd_rwlock_busy(rw, write))
+            e = 0;
+        if (e) {
+            if (write) {
+                /* readers may have been waiting for us */
+                --rw->writerswaiting;
+                unc_thrd_mon_notifyall(&rw->mon);
+            }
+            unc_thrd_mon_release(&rw->mon);
+            return e;
+        }
+    }
+    if (write) --rw->writerswaiting;
+    unc_thrd_rwlock_take(rw, write);
+    unc_thrd_mon_release(&rw->mon);
+    return 0;
+}
+
+/* releases whichever kind of hold there is; there cannot be both */
+static Unc_RetVal unc_thrd_rwlock_release(struct unc_thrd_rwlock *rw) {
+    Unc_RetVal e = unc_thrd_mon_acquire(&rw->mon);
+    if (e) return e;
+    if (rw->writer)
+        rw->writer = 0;
+    else if (rw->readers)
+        --rw->readers;
+    else
+        e = THREADFAIL;
+    if (!e && !rw->readers)
+        unc_thrd_mon_notifyall(&rw->mon);
+    unc_thrd_mon_release(&rw->mon);
+    return e;
+}
+
+static void unc_thrd_rwlock_free(struct unc_thrd_rwlock *rw) {
+    unc_thrd_mon_free(&rw->mon);
+}
+#endif
+
 #if UNCIL_MT_OK
 
 struct unc_threadobj {
@@ -818,11 +1017,35 @@ struct unc_threadobj {
     Unc_AtomicSmall f_run;
     Unc_AtomicSmall f_done;
     Unc_AtomicSmall f_detach;
+    Unc_AtomicSmall f_joined;
     struct unc_thrd_thread t;
     UNC_LOCKLIGHT(lock)
     int phase;
 };
 
+static void unc0_threadreport(Unc_View *w, Unc_RetVal e, int fromcode,
+                              const char *where) {
+    Unc_Value exc = UNC_BLANK;
+    char buf[256];
+    Unc_RetVal e2;
+    Unc_Size esn;
+    char *esc;
+    if (fromcode)
+        unc_getexceptionfromcode(w, &exc, e);
+    else
+        unc_getexception(w, &exc);
+    e2 = unc_exceptiontostringn(w, &exc, &esn, &esc);
+    if (e2) {
+        esn = sizeof(buf);
+        esc = buf;
+        if (unc_exceptiontostring(w, &exc, &esn, buf))
+            strcpy(buf, "unknown error in thread");
+    }
+    fprintf(stderr, "unhandled Uncil exception in %s\n%s\n", where, esc);
+    if (esc != buf) unc_mfree(w, esc);
+    VCLEAR(w, &exc);
+}
+
 static Unc_RetVal unc0_subthread(struct unc_threadobj *o) {
     Unc_RetVal e;
     Unc_View *w = o->u.view;
@@ -859,27 +1082,7 @@ static Unc_RetVal unc0_subthread(struct unc_threadobj *o) {
         VCLEAR(w, &f);
     }
 
-    if (e) {
-        /* error! */
-        Unc_Value exc = UNC_BLANK;
-        char buf[256];
-        Unc_RetVal e2;
-        Unc_Size esn;
-        char *esc;
-        if (fromcode)
-            unc_getexceptionfromcode(w, &exc, e);
-        else
-            unc_getexception(w, &exc);
-        e2 = unc_exceptiontostringn(w, &exc, &esn, &esc);
-        if (e2) {
-            esn = sizeof(buf);
-            esc = buf;
-            if (unc_exceptiontostring(w, &exc, &esn, buf))
-                strcpy(buf, "unknown error in thread");
-        }
-        fprintf(stderr, "unhandled Uncil exception in thread\n%s\n", esc);
-        if (esc != buf) unc_mfree(w, esc);
-    }
+    if (e) unc0_threadreport(w, e, fromcode, "thread");
 
     if (ATOMICSXCG(o->f_done, 1))
         goto unc0_subthread_detached;
@@ -888,8 +1091,10 @@ static Unc_RetVal unc0_subthread(struct unc_threadobj *o) {
     UNC_LOCKL(o->lock);
     o->u.view = NULL;
     VCLEAR(w, &o->f);
-    unc_destroy(w);
     UNC_UNLOCKL(o->lock);
+    /* not under the lock: if nothing else refers to the thread object,
+       destroying the view will also destroy it */
+    unc_destroy(w);
     return e;
 unc0_subthread_detached:
     VCLEAR(w, &o->f);
@@ -914,211 +1119,2466 @@ void unc0_waitonviewthread(Unc_View *w) {
         if (!(o->u.flags & UNCIL_THREAD_FLAG_DAEMON)) {
             while (unc_thrd_thread_join(t))
                 ;
+            ATOMICSSET(o->f_joined, 1);
         }
     }
 }
 #endif
 
-static Unc_RetVal unc0_thread_thread_destr(Unc_View *w, size_t n, void *data) {
 #if UNCIL_MT_OK
-    /* a thread should never get destroyed if it is still running */
-    struct unc_threadobj *o = data;
-    ATOMICSSET(o->f_detach, 1);
-    if (o->phase >= 1)
-        UNC_LOCKL(o->lock);
-    if (o->phase >= 2)
-        unc_thrd_thread_kill(&o->t);
-    if (!o->f_run) {
-        VCLEAR(o->u.view, &o->f);
-        unc_destroy(o->u.view);
-    }
-    if (o->phase >= 1) {
-        UNC_UNLOCKL(o->lock);
-        UNC_LOCKFINAL(o->lock);
+/* how long an idle worker sleeps before rechecking for shutdown/halt */
+#define UNC_POOL_IDLEWAIT 0.1
+
+struct unc_pooltask;
+typedef void (*unc_pooltaskfn)(Unc_View *w, struct unc_pooltask *t);
+
+/* tasks are allocated by whoever submits them. once run has been called,
+   the pool never touches the task again */
+struct unc_pooltask {
+    unc_pooltaskfn run;
+};
+
+/* double-ended queue of tasks. the owning worker pushes and pops from the
+   bottom (LIFO, good locality for nested jobs) while others steal from
+   the top (FIFO, steals the oldest and usually largest work) */
+struct unc_pooldeque {
+    struct unc_pooltask **q;
+    Unc_Size head;
+    Unc_Size count;
+    Unc_Size capacity;
+    UNC_LOCKLIGHT(lock)
+};
+
+struct unc_pool;
+
+struct unc_poolworker {
+    struct unc_pool *pool;
+    Unc_View *view;
+    unsigned long seed;
+    struct unc_pooldeque dq;
+    struct unc_thrd_worker t;
+};
+
+struct unc_pool {
+    Unc_World *world;
+    Unc_Size size;              /* number of workers */
+    Unc_Size started;           /* number of workers actually started */
+    struct unc_poolworker *workers;
+    struct unc_pooldeque inject;/* tasks submitted from outside the pool */
+    struct unc_thrd_mon mon;    /* idle workers sleep on this */
+    Unc_AtomicLarge pending;    /* tasks queued but not yet taken */
+    Unc_AtomicLarge refs;       /* 1 for the opaque + 1 per live worker */
+    Unc_AtomicSmall running;
+    Unc_AtomicSmall shutdown;
+    UNC_LOCKLIGHT(lock)
+};
+
+static Unc_RetVal unc0_pooldeque_init(struct unc_pooldeque *d) {
+    d->q = NULL;
+    d->head = d->count = d->capacity = 0;
+    return UNC_LOCKINITL(d->lock) ? THREADFAIL : 0;
+}
+
+static void unc0_pooldeque_free(Unc_Allocator *alloc,
+                                struct unc_pooldeque *d) {
+    TMFREE(struct unc_pooltask *, alloc, d->q, d->capacity);
+    UNC_LOCKFINAL(d->lock);
+}
+
+static Unc_RetVal unc0_pooldeque_push(Unc_Allocator *alloc,
+                                      struct unc_pooldeque *d,
+                                      Unc_Size n, struct unc_pooltask **t) {
+    Unc_Size i;
+    UNC_LOCKL(d->lock);
+    if (d->count + n > d->capacity) {
+        Unc_Size nc = d->capacity ? d->capacity : 16;
+        struct unc_pooltask **nq;
+        while (nc < d->count + n)
+            nc *= 2;
+        nq = TMALLOC(struct unc_pooltask *, alloc, Unc_AllocLibrary, nc);
+        if (!nq) {
+            UNC_UNLOCKL(d->lock);
+            return UNCIL_ERR_MEM;
+        }
+        for (i = 0; i < d->count; ++i)
+            nq[i] = d->q[(d->head + i) % d->capacity];
+        TMFREE(struct unc_pooltask *, alloc, d->q, d->capacity);
+        d->q = nq;
+        d->head = 0;
+        d->capacity = nc;
     }
-#endif
+    for (i = 0; i < n; ++i, ++d->count)
+        d->q[(d->head + d->count) % d->capacity] = t[i];
+    UNC_UNLOCKL(d->lock);
     return 0;
 }
 
-static Unc_RetVal unc0_thread_lock_destr(Unc_View *w, size_t n, void *data) {
-    unc_thrd_lock_free((struct unc_thrd_lock *)data);
-    return 0;
+static struct unc_pooltask *unc0_pooldeque_take(struct unc_pooldeque *d,
+                                                int bottom) {
+    struct unc_pooltask *t = NULL;
+    UNC_LOCKL(d->lock);
+    if (d->count) {
+        if (bottom)
+            t = d->q[(d->head + --d->count) % d->capacity];
+        else {
+            t = d->q[d->head];
+            d->head = (d->head + 1) % d->capacity;
+            --d->count;
+        }
+    }
+    UNC_UNLOCKL(d->lock);
+    return t;
 }
 
-static Unc_RetVal unc0_thread_rlock_destr(Unc_View *w, size_t n, void *data) {
-    unc_thrd_rlock_free((struct unc_thrd_rlock *)data);
+static Unc_RetVal unc0_poolnew(Unc_View *w, Unc_Size n,
+                               struct unc_pool **out) {
+    Unc_RetVal e;
+    Unc_Allocator *alloc = &w->world->alloc;
+    Unc_Size i;
+    struct unc_pool *p = unc0_malloc(alloc, Unc_AllocLibrary,
+                                     sizeof(struct unc_pool));
+    if (!p) return UNCIL_ERR_MEM;
+    p->workers = TMALLOC(struct unc_poolworker, alloc, Unc_AllocLibrary, n);
+    if (!p->workers) {
+        e = UNCIL_ERR_MEM;
+        goto unc0_poolnew_fail0;
+    }
+    if ((e = unc0_pooldeque_init(&p->inject)))
+        goto unc0_poolnew_fail1;
+    if ((e = unc_thrd_mon_new(&p->mon)))
+        goto unc0_poolnew_fail2;
+    if (UNC_LOCKINITL(p->lock)) {
+        e = THREADFAIL;
+        goto unc0_poolnew_fail3;
+    }
+    for (i = 0; i < n; ++i) {
+        struct unc_poolworker *o = &p->workers[i];
+        o->pool = p;
+        o->view = NULL;
+        o->seed = (unsigned long)i * 2654435761UL + 1;
+        if ((e = unc0_pooldeque_init(&o->dq))) {
+            while (i--)
+                unc0_pooldeque_free(alloc, &p->workers[i].dq);
+            goto unc0_poolnew_fail4;
+        }
+    }
+    p->world = w->world;
+    p->size = n;
+    p->started = 0;
+    ATOMICLSET(p->pending, 0);
+    ATOMICLSET(p->refs, 1);
+    ATOMICSSET(p->running, 0);
+    ATOMICSSET(p->shutdown, 0);
+    *out = p;
     return 0;
+unc0_poolnew_fail4:
+    UNC_LOCKFINAL(p->lock);
+unc0_poolnew_fail3:
+    unc_thrd_mon_free(&p->mon);
+unc0_poolnew_fail2:
+    unc0_pooldeque_free(alloc, &p->inject);
+unc0_poolnew_fail1:
+    TMFREE(struct unc_poolworker, alloc, p->workers, n);
+unc0_poolnew_fail0:
+    unc0_mfree(alloc, p, sizeof(struct unc_pool));
+    return e;
 }
 
-static Unc_RetVal unc0_thread_sem_destr(Unc_View *w, size_t n, void *data) {
-    unc_thrd_sem_free((struct unc_thrd_sem *)data);
-    return 0;
+static void unc0_pooldecref(struct unc_pool *p) {
+    if (!ATOMICLDEC(p->refs)) {
+        Unc_Allocator *alloc = &p->world->alloc;
+        Unc_Size i;
+        for (i = 0; i < p->size; ++i)
+            unc0_pooldeque_free(alloc, &p->workers[i].dq);
+        UNC_LOCKFINAL(p->lock);
+        unc_thrd_mon_free(&p->mon);
+        unc0_pooldeque_free(alloc, &p->inject);
+        TMFREE(struct unc_poolworker, alloc, p->workers, p->size);
+        unc0_mfree(alloc, p, sizeof(struct unc_pool));
+    }
 }
 
-static Unc_RetVal unc0_thread_mon_destr(Unc_View *w, size_t n, void *data) {
-    unc_thrd_mon_free((struct unc_thrd_mon *)data);
-    return 0;
+static void unc0_poolwake(struct unc_pool *p) {
+    unc_thrd_mon_acquire(&p->mon);
+    unc_thrd_mon_notifyall(&p->mon);
+    unc_thrd_mon_release(&p->mon);
 }
 
-static Unc_RetVal uncl_thread_makeerr(Unc_View *w, Unc_RetVal e) {
-    switch (e) {
-    case THREADFAIL:
-        return unc_throwexc(w, "system", "synchronization error");
-    case THREADTIMEOUT:
-        return unc_throwexc(w, "system", "timed out before acquire/wait");
-    case THREADBUSY:
-        return unc_throwexc(w, "system", "synchronization resource busy");
-    case THREADUNDERLYING:
-        return unc_thrd_makeerr(w, e);
-    default:
-        return e;
-    }
+static void unc0_poolshutdown(struct unc_pool *p) {
+    ATOMICSSET(p->shutdown, 1);
+    unc0_poolwake(p);
 }
 
-static Unc_RetVal uncl_thread_thread_new(
-                    Unc_View *w, Unc_Tuple args, void *udata) {
-#if UNCIL_MT_OK
-    Unc_RetVal e;
-    Unc_Value v = UNC_BLANK;
-    Unc_Size an;
-    Unc_Value *a;
-    Unc_View *zw;
-    struct unc_threadobj *thr;
-    int daemon;
-    if (!unc_iscallable(w, &args.values[0]))
-        return unc_throwexc(w, "type", "thread function must be callable");
-    switch (unc_gettype(w, &args.values[1])) {
-    case Unc_TNull:
-        a = NULL;
-        an = 0;
-        break;
-    case Unc_TArray:
-        e = unc_lockarray(w, &args.values[1], &an, &a);
-        if (e) return e;
-        break;
-    default:
-        return unc_throwexc(w, "type",
-                               "thread function args must be an array");
-    }
-    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
-                        sizeof(struct unc_threadobj), (void **)&thr,
-                        &unc0_thread_thread_destr, 0, NULL, 0, NULL);
-    if (e) {
-        unc_unlock(w, &args.values[1]);
-        return e;
-    }
-    daemon = unc_getbool(w, &args.values[2],
-                    w->vtype == Unc_ViewTypeSubDaemon);
-    thr->phase = 0;
-    VIMPOSE(w, &thr->f, &args.values[0]);
-    thr->a = an;
-    ATOMICSSET(thr->f_run, 0);
-    ATOMICSSET(thr->f_done, 0);
-    ATOMICSSET(thr->f_detach, 0);
-    e = UNC_LOCKINITL(thr->lock);
-    if (e)
-        zw = thr->u.view = NULL;
-    else {
-        thr->phase = 1;
+/* workers are started lazily on first use. the views are created here,
+   in the submitting thread, and stay alive for as long as the worker */
+static Unc_RetVal unc0_poolstart(Unc_View *w, struct unc_pool *p) {
+    Unc_RetVal e = 0;
+    if (p->running) return 0;
+    UNC_LOCKL(p->lock);
+    while (p->started < p->size) {
+        struct unc_poolworker *o = &p->workers[p->started];
+        Unc_View *zw;
         (void)UNC_LOCKFP(w, w->world->viewlist_lock);
-        zw = thr->u.view = unc0_newview(w->world,
-                daemon ? Unc_ViewTypeSubDaemon : Unc_ViewTypeSub);
+        zw = unc0_newview(w->world, Unc_ViewTypeSubDaemon);
         UNC_UNLOCKF(w->world->viewlist_lock);
-        if (!zw)
+        if (!zw) {
             e = UNCIL_ERR_MEM;
-        else {
-            unc_copyprogram(zw, w);
-            if (an) e = unc_push(zw, an, a);
+            break;
         }
+        unc_copyprogram(zw, w);
+        o->view = zw;
+        ATOMICLINC(p->refs);
+        e = unc_thrd_worker_start(&o->t, &unc0_poolworker, o);
+        if (e) {
+            ATOMICLDEC(p->refs);
+            o->view = NULL;
+            unc_destroy(zw);
+            break;
+        }
+        ++p->started;
     }
-    unc_unlock(w, &args.values[1]);
-    thr->u.up = thr->u.down = NULL;
-    thr->u.flags = daemon ? UNCIL_THREAD_FLAG_DAEMON : 0;
-    if (!e) {
-        e = unc_thrd_thread_new(&thr->t);
-        if (e) e = uncl_thread_makeerr(w, e);
-        else thr->phase = 2;
-    }
-    if (e && zw)
-        unc_destroy(zw);
-    unc_unlock(w, &v);
-    if (!e) e = unc_push(w, 1, &v);
-    VCLEAR(w, &v);
+    /* callers help run tasks, so a partially started pool still works */
+    if (p->started) e = 0;
+    if (!e) ATOMICSSET(p->running, 1);
+    UNC_UNLOCKL(p->lock);
     return e;
-#else
-    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
-#endif
 }
 
-static Unc_RetVal uncl_thread_thread_start(
-                    Unc_View *w, Unc_Tuple args, void *udata) {
-#if UNCIL_MT_OK
-    Unc_RetVal e;
-    struct unc_threadobj *thr;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&thr, 1, "thread.thread");
-    if (e) return e;
+static struct unc_poolworker *unc0_poolself(struct unc_pool *p,
+                                            Unc_View *w) {
+    Unc_Size i;
+    if (p->running)
+        for (i = 0; i < p->started; ++i)
+            if (p->workers[i].view == w)
+                return &p->workers[i];
+    return NULL;
+}
 
-    UNC_LOCKL(thr->lock);
-    if (thr->f_run)
-        e = unc_throwexc(w, "value", "thread already started");
-    if (thr->f_detach)
-        e = unc_throwexc(w, "value", "thread not valid");
-    if (!e) {
-        ATOMICSSET(thr->f_run, 1);
-        e = unc_thrd_thread_start(&thr->t);
-        if (e) e = uncl_thread_makeerr(w, e);
-        else {
-            Unc_View *zw = thr->u.view;
-            VIMPOSE(zw, &zw->threadme, &args.values[0]);
+static struct unc_pooltask *unc0_pooltake(struct unc_pool *p,
+                                          struct unc_poolworker *self) {
+    struct unc_pooltask *t = NULL;
+    Unc_Size i, k, n = p->size;
+    if (!p->pending) return NULL;
+    if (self) t = unc0_pooldeque_take(&self->dq, 1);
+    if (!t) t = unc0_pooldeque_take(&p->inject, 0);
+    if (!t && n) {
+        if (self) {
+            self->seed = self->seed * 1103515245UL + 12345UL;
+            k = (Unc_Size)(self->seed >> 16) % n;
+        } else
+            k = 0;
+        for (i = 0; !t && i < n; ++i) {
+            struct unc_poolworker *o = &p->workers[(k + i) % n];
+            if (o != self) t = unc0_pooldeque_take(&o->dq, 0);
         }
     }
-    UNC_UNLOCKL(thr->lock);
-    unc_unlock(w, &args.values[0]);
-    return e;
-#else
-    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
-#endif
+    if (t) ATOMICLDEC(p->pending);
+    return t;
 }
 
-static Unc_RetVal uncl_thread_thread_join(
-                    Unc_View *w, Unc_Tuple args, void *udata) {
-#if UNCIL_MT_OK
+/* tasks submitted by a worker go to its own deque, others go to the
+   shared injection queue */
+static Unc_RetVal unc0_poolsubmit(Unc_View *w, struct unc_pool *p,
+                                  struct unc_poolworker *self,
+                                  Unc_Size n, struct unc_pooltask **t) {
     Unc_RetVal e;
-    int finished;
-    struct unc_threadobj *thr;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&thr, 1, "thread.thread");
-    if (e) return e;
-
-    UNC_LOCKL(thr->lock);
-    if (!thr->f_run)
-        e = unc_throwexc(w, "value", "thread not started");
-    if (thr->f_detach)
-        e = unc_throwexc(w, "value", "thread not valid");
-    finished = thr->f_done;
-    UNC_UNLOCKL(thr->lock);
-    if (!e && !finished) {
+    Unc_Size i;
+    /* pending is raised first, so that a worker never goes to sleep
+       while a task is in a queue */
+    for (i = 0; i < n; ++i)
+        ATOMICLINC(p->pending);
+    e = unc0_pooldeque_push(&p->world->alloc,
+                            self ? &self->dq : &p->inject, n, t);
+    if (e) {
+        for (i = 0; i < n; ++i)
+            ATOMICLDEC(p->pending);
+        return e;
+    }
+    unc0_poolwake(p);
+    return 0;
+}
+
+static void unc0_poolworker(void *p_) {
+    struct unc_poolworker *o = p_;
+    struct unc_pool *p = o->pool;
+    Unc_View *w = o->view;
+    unc_vmpause(w);
+    for (;;) {
+        struct unc_pooltask *t = unc0_pooltake(p, o);
+        if (t) {
+            /* hold the runlock like a C function called from the VM
+               would, so that a GC waits for us to pause */
+            UNC_LOCKF(w->runlock);
+            /* if halted, the task will fail right away */
+            (void)unc_vmresume(w);
+            (*t->run)(w, t);
+            unc_vmpause(w);
+            UNC_UNLOCKF(w->runlock);
+            continue;
+        }
+        if (p->shutdown || w->flow == UNC_VIEW_FLOW_HALT)
+            break;
+        unc_thrd_mon_acquire(&p->mon);
+        if (!p->pending && !p->shutdown)
+            (void)unc_thrd_mon_waittimed(&p->mon, UNC_POOL_IDLEWAIT);
+        unc_thrd_mon_release(&p->mon);
+    }
+    unc0_pooldecref(p);
+    unc_destroy(w);
+}
+
+/* a job splits a pmap/pfor into chunks. values created by the workers are
+   not visible to the GC through their own views once they are done with a
+   chunk, so out and exc point into arrays on the calling view's stack */
+struct unc_pooljob {
+    Unc_Value *fn;
+    Unc_Value *in;              /* pmap: inputs, pfor: NULL */
+    Unc_Value *out;             /* pmap: outputs, pfor: NULL */
+    Unc_Int start;              /* pfor: first index */
+    Unc_Size left;              /* chunks not yet finished, under mon */
+    Unc_AtomicSmall failed;
+    Unc_Value *exc;             /* first exception, set once */
+    struct unc_thrd_mon mon;
+};
+
+struct unc_poolchunk {
+    struct unc_pooltask base;
+    struct unc_pooljob *job;
+    Unc_Size lo, hi;
+};
+
+static void unc0_poolchunk_run(Unc_View *w, struct unc_pooltask *t) {
+    struct unc_poolchunk *c = (struct unc_poolchunk *)t;
+    struct unc_pooljob *j = c->job;
+    Unc_RetVal e = 0;
+    Unc_Size i;
+    for (i = c->lo; i < c->hi && !j->failed; ++i) {
+        Unc_Pile pile;
+        Unc_Tuple tuple;
+        if (j->in)
+            e = unc_push(w, 1, &j->in[i]);
+        else {
+            Unc_Value v = UNC_BLANK;
+            VINITINT(&v, j->start + (Unc_Int)i);
+            e = unc_push(w, 1, &v);
+        }
+        if (!e) e = unc_call(w, j->fn, 1, &pile);
+        if (e) break;
+        if (j->out) {
+            unc_returnvalues(w, &pile, &tuple);
+            if (tuple.count) VCOPY(w, &j->out[i], &tuple.values[0]);
+        }
+        unc_discard(w, &pile);
+    }
+    if (e) {
+        Unc_Value exc = UNC_BLANK;
+        unc_getexceptionfromcode(w, &exc, e);
+        if (!ATOMICSXCG(j->failed, 1))
+            VMOVE(w, j->exc, &exc);
+        else
+            VCLEAR(w, &exc);
+    }
+    unc_thrd_mon_acquire(&j->mon);
+    if (!--j->left)
+        unc_thrd_mon_notifyall(&j->mon);
+    unc_thrd_mon_release(&j->mon);
+}
+
+/* split the job into chunks, submit them and help run tasks until all of
+   this job's chunks have finished */
+static Unc_RetVal unc0_poolrun(Unc_View *w, struct unc_pool *p,
+                               struct unc_pooljob *j,
+                               Unc_Size n, Unc_Size chunk) {
+    Unc_RetVal e;
+    Unc_Allocator *alloc = &w->world->alloc;
+    struct unc_poolworker *self;
+    struct unc_poolchunk *c;
+    struct unc_pooltask **ct;
+    Unc_Size i, cn;
+
+    if (p->shutdown)
+        return unc_throwexc(w, "value", "thread pool has been shut down");
+    e = unc0_poolstart(w, p);
+    if (e) return e;
+    self = unc0_poolself(p, w);
+    if (!chunk) {
+        /* about four chunks per participating thread */
+        chunk = n / ((p->started + 1) * 4);
+        if (!chunk) chunk = 1;
+    }
+    cn = n / chunk + (n % chunk != 0);
+    c = TMALLOC(struct unc_poolchunk, alloc, Unc_AllocLibrary, cn);
+    if (!c) return UNCIL_ERR_MEM;
+    ct = TMALLOC(struct unc_pooltask *, alloc, Unc_AllocLibrary, cn);
+    if (!ct) {
+        TMFREE(struct unc_poolchunk, alloc, c, cn);
+        return UNCIL_ERR_MEM;
+    }
+    for (i = 0; i < cn; ++i) {
+        c[i].base.run = &unc0_poolchunk_run;
+        c[i].job = j;
+        c[i].lo = i * chunk;
+        c[i].hi = i + 1 < cn ? (i + 1) * chunk : n;
+        ct[i] = &c[i].base;
+    }
+    j->left = cn;
+    ATOMICSSET(j->failed, 0);
+    e = unc0_poolsubmit(w, p, self, cn, ct);
+    TMFREE(struct unc_pooltask *, alloc, ct, cn);
+    if (e) {
+        TMFREE(struct unc_poolchunk, alloc, c, cn);
+        return e;
+    }
+
+    for (;;) {
+        struct unc_pooltask *t;
+        int done;
+        unc_thrd_mon_acquire(&j->mon);
+        done = !j->left;
+        unc_thrd_mon_release(&j->mon);
+        if (done) break;
+        t = unc0_pooltake(p, self);
+        if (t) {
+            (*t->run)(w, t);
+            continue;
+        }
         unc_vmpause(w);
-        e = unc_thrd_thread_join(&thr->t);
-        unc_vmresume(w);
+        unc_thrd_mon_acquire(&j->mon);
+        if (j->left)
+            (void)unc_thrd_mon_waittimed(&j->mon, UNC_POOL_IDLEWAIT);
+        unc_thrd_mon_release(&j->mon);
+        /* even if halted, chunks still refer to the job, so keep going;
+           they will fail quickly */
+        (void)unc_vmresume(w);
+    }
+    TMFREE(struct unc_poolchunk, alloc, c, cn);
+    return 0;
+}
+#endif
+
+/* futures are opaques with three bound values: the function to call, its
+   argument (the argument array for submit, the input for then, the result
+   array for all) and the result, which is an exception if the future
+   failed. everything else is in struct unc_future */
+#define UNC_FUTURE_FN 0
+#define UNC_FUTURE_ARG 1
+#define UNC_FUTURE_RES 2
+
+#define UNC_FUTURE_MANUAL 0     /* future.new, settled with resolve/reject */
+#define UNC_FUTURE_CALL 1       /* thread.submit */
+#define UNC_FUTURE_THEN 2
+#define UNC_FUTURE_ALL 3
+#define UNC_FUTURE_ANY 4
+
+#define UNC_FUTURE_PENDING 0
+#define UNC_FUTURE_DONE 1
+#define UNC_FUTURE_FAILED 2
+
+struct unc_future;
+
+/* a then/all/any future waiting for another one to settle */
+struct unc_futurelink {
+    struct unc_futurelink *next;
+    struct unc_future *target;
+    Unc_Size index;
+};
+
+struct unc_future {
+#if UNCIL_MT_OK
+    struct unc_pooltask base;   /* must be first */
+    struct unc_pool *pool;
+    struct unc_thrd_mon mon;
+#endif
+    Unc_World *world;           /* NULL if not fully initialized */
+    int kind;
+    int state;
+    int pinned;
+    Unc_Size waiting;           /* all/any: sources that have not settled */
+    Unc_Size left;              /* links to this future not yet delivered */
+    struct unc_futurelink *links;
+    Unc_Value *fn;
+    Unc_Value *arg;
+    Unc_Value *res;
+    /* not counted. pins is the module-wide table that keeps futures alive
+       while nobody else might have a reference to them, that is, while
+       they are pending or have links to deliver. the key is the address */
+    Unc_Value pins;
+};
+
+#define UNC_FUTUREKEY(k, f) VINITINT(k, (Unc_Int)(uintptr_t)(f))
+
+#if UNCIL_MT_OK
+#define UNC_FUTURELOCK(f) unc_thrd_mon_acquire(&(f)->mon)
+#define UNC_FUTUREUNLOCK(f) unc_thrd_mon_release(&(f)->mon)
+#define UNC_FUTURENOTIFY(f) unc_thrd_mon_notifyall(&(f)->mon)
+#else
+#define UNC_FUTURELOCK(f)
+#define UNC_FUTUREUNLOCK(f)
+#define UNC_FUTURENOTIFY(f)
+#endif
+
+static void unc0_futuredeliver(Unc_View *w, struct unc_future *t,
+                               Unc_Size i, int failed, Unc_Value *v);
+
+/* drops a hold on f. once f has settled and nothing holds it, it is
+   unpinned, after which it may be freed at any time */
+static void unc0_futurerelease(Unc_View *w, struct unc_future *f) {
+    int unpin;
+    Unc_Value key, pins;
+    UNC_FUTURELOCK(f);
+    unpin = !--f->left && f->state != UNC_FUTURE_PENDING && f->pinned;
+    if (unpin) {
+        f->pinned = 0;
+        UNC_FUTUREKEY(&key, f);
+        pins = f->pins;
+    }
+    UNC_FUTUREUNLOCK(f);
+    if (unpin)
+        (void)unc0_ddelindx(w, LEFTOVER(Unc_Dict, VGETENT(&pins)), &key);
+}
+
+/* returns 1 if f was settled now, 0 if it had already been settled */
+static int unc0_futuresettle(Unc_View *w, struct unc_future *f,
+                             int failed, Unc_Value *v) {
+    struct unc_futurelink *l, *nl;
+    UNC_FUTURELOCK(f);
+    if (f->state != UNC_FUTURE_PENDING) {
+        UNC_FUTUREUNLOCK(f);
+        return 0;
+    }
+    VCOPY(w, f->res, v);
+    f->state = failed ? UNC_FUTURE_FAILED : UNC_FUTURE_DONE;
+    /* hold on to f until the links have been delivered */
+    ++f->left;
+    l = f->links;
+    f->links = NULL;
+    UNC_FUTURENOTIFY(f);
+    UNC_FUTUREUNLOCK(f);
+    for (; l; l = nl) {
+        nl = l->next;
+        unc0_futuredeliver(w, l->target, l->index, failed, f->res);
+        unc0_mfree(&w->world->alloc, l, sizeof(struct unc_futurelink));
+    }
+    unc0_futurerelease(w, f);
+    return 1;
+}
+
+/* calls the function of a submit or then future and settles it */
+static void unc0_futureexec(Unc_View *w, struct unc_future *f) {
+    Unc_RetVal e;
+    Unc_Pile pile;
+    Unc_Size an = 0;
+    if (f->kind == UNC_FUTURE_THEN) {
+        an = 1;
+        e = unc_push(w, 1, f->arg);
+    } else if (VGETTYPE(f->arg) == Unc_TArray) {
+        Unc_Value *a;
+        e = unc_lockarray(w, f->arg, &an, &a);
+        if (!e) {
+            e = unc_push(w, an, a);
+            unc_unlock(w, f->arg);
+        }
+    } else
+        e = 0;
+    if (!e) e = unc_call(w, f->fn, an, &pile);
+    if (!e) {
+        Unc_Tuple tuple;
+        Unc_Value v = UNC_BLANK;
+        unc_returnvalues(w, &pile, &tuple);
+        /* settle before discarding, so that the GC can see the value */
+        (void)unc0_futuresettle(w, f, 0, tuple.count ? &tuple.values[0] : &v);
+        unc_discard(w, &pile);
+    } else {
+        Unc_Value exc = UNC_BLANK;
+        unc_getexceptionfromcode(w, &exc, e);
+        (void)unc0_futuresettle(w, f, 1, &exc);
+        VCLEAR(w, &exc);
+    }
+}
+
+#if UNCIL_MT_OK
+static void unc0_futurerun(Unc_View *w, struct unc_pooltask *t) {
+    unc0_futureexec(w, (struct unc_future *)t);
+}
+#endif
+
+/* queues a submit or then future to run on its pool. without threads, it
+   runs right away */
+static void unc0_futurelaunch(Unc_View *w, struct unc_future *f) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    struct unc_pool *p = f->pool;
+    struct unc_pooltask *t = &f->base;
+    Unc_Value exc = UNC_BLANK;
+    if (p->shutdown) {
+        unc0_makeexceptionoroom(w, &exc, "value",
+                                "thread pool has been shut down");
+        (void)unc0_futuresettle(w, f, 1, &exc);
+        VCLEAR(w, &exc);
+        return;
+    }
+    e = unc0_poolstart(w, p);
+    if (!e) e = unc0_poolsubmit(w, p, unc0_poolself(p, w), 1, &t);
+    if (e) {
+        unc_getexceptionfromcode(w, &exc, e);
+        (void)unc0_futuresettle(w, f, 1, &exc);
+        VCLEAR(w, &exc);
+    }
+#else
+    unc0_futureexec(w, f);
+#endif
+}
+
+/* called once for every source of t once that source has settled */
+static void unc0_futuredeliver(Unc_View *w, struct unc_future *t,
+                               Unc_Size i, int failed, Unc_Value *v) {
+    int settle = 0;
+    switch (t->kind) {
+    case UNC_FUTURE_THEN:
+        if (failed)
+            (void)unc0_futuresettle(w, t, 1, v);
+        else {
+            VCOPY(w, t->arg, v);
+            unc0_futurelaunch(w, t);
+        }
+        break;
+    case UNC_FUTURE_ALL:
+        UNC_FUTURELOCK(t);
+        if (t->state == UNC_FUTURE_PENDING) {
+            if (failed)
+                settle = 1;
+            else {
+                Unc_Size an;
+                Unc_Value *a;
+                if (!unc_lockarray(w, t->arg, &an, &a)) {
+                    VCOPY(w, &a[i], v);
+                    unc_unlock(w, t->arg);
+                }
+                settle = !--t->waiting;
+            }
+        }
+        UNC_FUTUREUNLOCK(t);
+        if (settle)
+            (void)unc0_futuresettle(w, t, failed, failed ? v : t->arg);
+        break;
+    case UNC_FUTURE_ANY:
+        /* first success wins, or the last failure if all of them fail */
+        UNC_FUTURELOCK(t);
+        if (t->state == UNC_FUTURE_PENDING)
+            settle = !failed || !--t->waiting;
+        UNC_FUTUREUNLOCK(t);
+        if (settle)
+            (void)unc0_futuresettle(w, t, failed, v);
+        break;
+    }
+    unc0_futurerelease(w, t);
+}
+
+/* makes t wait for s. t->left must already include this link */
+static void unc0_futurelink(Unc_View *w, struct unc_future *s,
+                            struct unc_future *t, Unc_Size i) {
+    struct unc_futurelink *l = unc0_malloc(&w->world->alloc,
+                            Unc_AllocLibrary, sizeof(struct unc_futurelink));
+    if (!l) {
+        Unc_Value exc = UNC_BLANK;
+        unc_getexceptionfromcode(w, &exc, UNCIL_ERR_MEM);
+        unc0_futuredeliver(w, t, i, 1, &exc);
+        VCLEAR(w, &exc);
+        return;
+    }
+    UNC_FUTURELOCK(s);
+    if (s->state == UNC_FUTURE_PENDING) {
+        l->next = s->links;
+        l->target = t;
+        l->index = i;
+        s->links = l;
+        UNC_FUTUREUNLOCK(s);
+        return;
+    }
+    UNC_FUTUREUNLOCK(s);
+    unc0_mfree(&w->world->alloc, l, sizeof(struct unc_futurelink));
+    /* already settled, so the result will no longer change */
+    unc0_futuredeliver(w, t, i, s->state == UNC_FUTURE_FAILED, s->res);
+}
+
+/* a channel keeps its values in an array in bound value 0 of the opaque,
+   so that the GC can see them. a bounded channel is a lock-free ring
+   buffer: every slot has a sequence number that tells whether it is
+   free for the sender or the receiver at a given position. an unbounded
+   channel has to be able to grow its buffer, so it uses a lock instead */
+#define UNC_CHANNEL_BUF 0
+#define UNC_CHANNEL_MINSIZE 16
+
+static Unc_RetVal uncl_thread_makeerr(Unc_View *w, Unc_RetVal e);
+
+/* a thread blocked in recv or select. it is registered with every
+   channel it is waiting on */
+struct unc_chanwaiter {
+#if UNCIL_MT_OK
+    struct unc_thrd_mon mon;
+#endif
+    int signaled;
+};
+
+struct unc_channel {
+    Unc_World *world;           /* NULL if not fully initialized */
+    Unc_Size capacity;          /* 0 if unbounded */
+    Unc_Value *bufv;
+    Unc_Value *buf;
+    Unc_AtomicLarge *seq;       /* bounded only, see unc0_chantrypush */
+    Unc_AtomicLarge head;       /* bounded: next position to receive from,
+                                   unbounded: index of the first value */
+    Unc_AtomicLarge tail;       /* bounded: next position to send to,
+                                   unbounded: number of values */
+    Unc_Size size;              /* unbounded: size of the buffer */
+    Unc_AtomicSmall closed;
+    Unc_AtomicLarge turn;       /* where select starts looking from */
+    Unc_AtomicLarge nwaiters;
+    Unc_Size waitersn, waitersc;
+    struct unc_chanwaiter **waiters;
+#if UNCIL_MT_OK
+    Unc_AtomicLarge sendwait;
+    struct unc_thrd_mon mon;    /* senders waiting for room */
+#endif
+    UNC_LOCKLIGHT(lock)         /* unbounded buffer */
+    UNC_LOCKLIGHT(wlock)        /* waiters */
+};
+
+/* bounded channels are a ring where each slot has a sequence number.
+   a slot is free for the sender at position pos if its sequence number is
+   2 * pos, and has a value for the receiver at pos if it is 2 * pos + 1.
+   (doubling keeps the two apart even if the capacity is 1) */
+static int unc0_chantrypush(Unc_View *w, struct unc_channel *c,
+                            Unc_Value *v) {
+    if (c->capacity) {
+        Unc_Size pos = c->tail;
+        for (;;) {
+            Unc_Size i = pos % c->capacity, seq = c->seq[i];
+            if (seq == 2 * pos) {
+                if (ATOMICLCAS(c->tail, pos, pos + 1)) {
+                    /* the slot is ours until seq is updated */
+                    VIMPOSE(w, &c->buf[i], v);
+                    ATOMICLSET(c->seq[i], 2 * pos + 1);
+                    return 1;
+                }
+            } else if (seq < 2 * pos)
+                return 0;
+            else
+                pos = c->tail;
+        }
+    } else {
+        int ok;
+        UNC_LOCKL(c->lock);
+        ok = c->tail < c->size;
+        if (ok) {
+            VIMPOSE(w, &c->buf[(c->head + c->tail) % c->size], v);
+            ++c->tail;
+        }
+        UNC_UNLOCKL(c->lock);
+        return ok;
+    }
+}
+
+/* the value is moved into out, which must be blank */
+static int unc0_chantrypop(Unc_View *w, struct unc_channel *c,
+                           Unc_Value *out) {
+    if (c->capacity) {
+        Unc_Size pos = c->head;
+        for (;;) {
+            Unc_Size i = pos % c->capacity, seq = c->seq[i];
+            if (seq == 2 * pos + 1) {
+                if (ATOMICLCAS(c->head, pos, pos + 1)) {
+                    VSETRAW(out, VGETRAW(&c->buf[i]));
+                    VINITNULL(&c->buf[i]);
+                    ATOMICLSET(c->seq[i], 2 * (pos + c->capacity));
+                    return 1;
+                }
+            } else if (seq < 2 * pos + 1)
+                return 0;
+            else
+                pos = c->head;
+        }
+    } else {
+        int ok;
+        UNC_LOCKL(c->lock);
+        ok = c->tail != 0;
+        if (ok) {
+            Unc_Value *p = &c->buf[c->head];
+            VSETRAW(out, VGETRAW(p));
+            VINITNULL(p);
+            c->head = (c->head + 1) % c->size;
+            --c->tail;
+        }
+        UNC_UNLOCKL(c->lock);
+        return ok;
+    }
+}
+
+static int unc0_chanfull(struct unc_channel *c) {
+    Unc_Size pos = c->tail;
+    return c->capacity && c->seq[pos % c->capacity] < 2 * pos;
+}
+
+static Unc_Size unc0_chancount(struct unc_channel *c) {
+    Unc_Size n;
+    if (c->capacity) {
+        Unc_Size head = c->head, tail = c->tail;
+        n = tail > head ? tail - head : 0;
+        if (n > c->capacity) n = c->capacity;
+    } else {
+        UNC_LOCKL(c->lock);
+        n = c->tail;
+        UNC_UNLOCKL(c->lock);
+    }
+    return n;
+}
+
+/* doubles the buffer of a full unbounded channel. the new array is made
+   before taking the lock, since making it might start a GC */
+static Unc_RetVal unc0_changrow(Unc_View *w, struct unc_channel *c) {
+    Unc_RetVal e;
+    Unc_Value nv = UNC_BLANK, ov = UNC_BLANK;
+    Unc_Value *nb;
+    Unc_Size i, n = c->size;
+    e = unc_newarray(w, &nv, n * 2, &nb);
+    if (e) return e;
+    unc_unlock(w, &nv);
+    UNC_LOCKL(c->lock);
+    if (c->size == n && c->tail == n) {
+        for (i = 0; i < n; ++i) {
+            Unc_Value *p = &c->buf[(c->head + i) % n];
+            VSETRAW(&nb[i], VGETRAW(p));
+            VINITNULL(p);
+        }
+        VSETRAW(&ov, VGETRAW(c->bufv));
+        VSETRAW(c->bufv, VGETRAW(&nv));
+        VINITNULL(&nv);
+        c->buf = nb;
+        c->head = 0;
+        c->size = n * 2;
+    }
+    UNC_UNLOCKL(c->lock);
+    VCLEAR(w, &ov);
+    VCLEAR(w, &nv);
+    return 0;
+}
+
+static void unc0_chanwake(struct unc_channel *c) {
+    Unc_Size i;
+    UNC_LOCKL(c->wlock);
+    for (i = 0; i < c->waitersn; ++i) {
+        struct unc_chanwaiter *t = c->waiters[i];
+#if UNCIL_MT_OK
+        unc_thrd_mon_acquire(&t->mon);
+        t->signaled = 1;
+        unc_thrd_mon_notifyall(&t->mon);
+        unc_thrd_mon_release(&t->mon);
+#else
+        t->signaled = 1;
+#endif
+    }
+    UNC_UNLOCKL(c->wlock);
+}
+
+static void unc0_chanwakesenders(struct unc_channel *c) {
+#if UNCIL_MT_OK
+    if (c->sendwait) {
+        unc_thrd_mon_acquire(&c->mon);
+        unc_thrd_mon_notifyall(&c->mon);
+        unc_thrd_mon_release(&c->mon);
+    }
+#endif
+}
+
+static Unc_RetVal unc0_chanaddwaiter(Unc_Allocator *alloc,
+                                     struct unc_channel *c,
+                                     struct unc_chanwaiter *t) {
+    UNC_LOCKL(c->wlock);
+    if (c->waitersn == c->waitersc) {
+        Unc_Size nc = c->waitersc ? c->waitersc * 2 : 4;
+        struct unc_chanwaiter **nw = TMREALLOC(struct unc_chanwaiter *,
+                            alloc, Unc_AllocLibrary, c->waiters,
+                            c->waitersc, nc);
+        if (!nw) {
+            UNC_UNLOCKL(c->wlock);
+            return UNCIL_ERR_MEM;
+        }
+        c->waiters = nw;
+        c->waitersc = nc;
+    }
+    c->waiters[c->waitersn++] = t;
+    ATOMICLINC(c->nwaiters);
+    UNC_UNLOCKL(c->wlock);
+    return 0;
+}
+
+static void unc0_chandelwaiter(struct unc_channel *c,
+                               struct unc_chanwaiter *t) {
+    Unc_Size i;
+    UNC_LOCKL(c->wlock);
+    for (i = 0; i < c->waitersn; ++i) {
+        if (c->waiters[i] == t) {
+            c->waiters[i] = c->waiters[--c->waitersn];
+            ATOMICLDEC(c->nwaiters);
+            break;
+        }
+    }
+    UNC_UNLOCKL(c->wlock);
+}
+
+static void unc0_chanclose(struct unc_channel *c) {
+    ATOMICSSET(c->closed, 1);
+    unc0_chanwake(c);
+#if UNCIL_MT_OK
+    unc_thrd_mon_acquire(&c->mon);
+    unc_thrd_mon_notifyall(&c->mon);
+    unc_thrd_mon_release(&c->mon);
+#endif
+}
+
+/* *sent is set to 0 if the timeout runs out first */
+static Unc_RetVal unc0_chansend(Unc_View *w, struct unc_channel *c,
+                                Unc_Value *v, int timed, Unc_Float to,
+                                int *sent) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    unc0_countdown cd;
+    int first = 1;
+#endif
+    for (;;) {
+        if (c->closed)
+            return unc_throwexc(w, "value", "channel has been closed");
+        if (unc0_chantrypush(w, c, v)) {
+            if (c->nwaiters) unc0_chanwake(c);
+            *sent = 1;
+            return 0;
+        }
+        if (!c->capacity) {
+            Unc_RetVal e = unc0_changrow(w, c);
+            if (e) return e;
+            continue;
+        }
+#if UNCIL_MT_OK
+        if (timed) {
+            if (first) {
+                if (unc0_countdownfirst(&cd))
+                    return uncl_thread_makeerr(w, THREADFAIL);
+                first = 0;
+            } else if (unc0_countdownnext(&cd, &to))
+                return uncl_thread_makeerr(w, THREADFAIL);
+            if (to <= 0) {
+                *sent = 0;
+                return 0;
+            }
+        }
+        unc_vmpause(w);
+        unc_thrd_mon_acquire(&c->mon);
+        ATOMICLINC(c->sendwait);
+        if (unc0_chanfull(c) && !c->closed)
+            (void)unc_thrd_mon_waittimed(&c->mon,
+                        timed && to < UNC_POOL_IDLEWAIT ? to
+                                                        : UNC_POOL_IDLEWAIT);
+        ATOMICLDEC(c->sendwait);
+        unc_thrd_mon_release(&c->mon);
+        e = unc_vmresume(w);
+        if (e) return e;
+#else
+        /* nobody else could make room */
+        if (!timed)
+            return unc_throwexc(w, "value",
+                        "sending to a full channel would block forever");
+        *sent = 0;
+        return 0;
+#endif
+    }
+}
+
+/* tries to receive from any of the channels, starting from a different
+   one every time for fairness. returns 1 and sets *idx if a value was
+   received (*ok = 1) or if a channel is closed and empty (*ok = 0) */
+static int unc0_chanpoll(Unc_View *w, Unc_Size n, struct unc_channel **cs,
+                         Unc_Size start, Unc_Size *idx, Unc_Value *out,
+                         int *ok) {
+    Unc_Size k;
+    for (k = 0; k < n; ++k) {
+        Unc_Size i = (start + k) % n;
+        struct unc_channel *c = cs[i];
+        int closed = c->closed;
+        if (unc0_chantrypop(w, c, out)) {
+            unc0_chanwakesenders(c);
+            *idx = i;
+            *ok = 1;
+            return 1;
+        } else if (closed) {
+            *idx = i;
+            *ok = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* *idx is set to n if timed out */
+static Unc_RetVal unc0_chanselect(Unc_View *w, Unc_Size n,
+                                  struct unc_channel **cs,
+                                  int timed, Unc_Float to,
+                                  Unc_Size *idx, Unc_Value *out, int *ok) {
+    Unc_Size start = n > 1 ? (Unc_Size)ATOMICLINC(cs[0]->turn) % n : 0;
+#if UNCIL_MT_OK
+    Unc_RetVal e = 0;
+    Unc_Size i, reg;
+    unc0_countdown cd;
+    struct unc_chanwaiter t;
+#endif
+    *ok = 0;
+    if (unc0_chanpoll(w, n, cs, start, idx, out, ok))
+        return 0;
+    *idx = n;
+    if (timed && to <= 0)
+        return 0;
+#if UNCIL_MT_OK
+    if (timed && unc0_countdownfirst(&cd))
+        return uncl_thread_makeerr(w, THREADFAIL);
+    e = unc_thrd_mon_new(&t.mon);
+    if (e) return uncl_thread_makeerr(w, e);
+    t.signaled = 0;
+    for (reg = 0; reg < n; ++reg) {
+        e = unc0_chanaddwaiter(&w->world->alloc, cs[reg], &t);
+        if (e) break;
+    }
+    /* check again, in case something was sent before we registered */
+    while (!e && !unc0_chanpoll(w, n, cs, start, idx, out, ok)) {
+        Unc_Float wt = UNC_POOL_IDLEWAIT;
+        if (timed) {
+            if (unc0_countdownnext(&cd, &to)) {
+                e = uncl_thread_makeerr(w, THREADFAIL);
+                break;
+            }
+            if (to <= 0)
+                break;
+            if (to < wt)
+                wt = to;
+        }
+        unc_vmpause(w);
+        unc_thrd_mon_acquire(&t.mon);
+        if (!t.signaled)
+            (void)unc_thrd_mon_waittimed(&t.mon, wt);
+        t.signaled = 0;
+        unc_thrd_mon_release(&t.mon);
+        e = unc_vmresume(w);
+    }
+    for (i = 0; i < reg; ++i)
+        unc0_chandelwaiter(cs[i], &t);
+    unc_thrd_mon_free(&t.mon);
+    return e;
+#else
+    /* nobody else could send anything */
+    if (!timed)
+        return unc_throwexc(w, "value",
+                    "receiving from an empty channel would block forever");
+    return 0;
+#endif
+}
+
+#if UNCIL_MT_OK
+/* an actor runs a separate world on its own thread. the two worlds share no
+   entities, GC or locks; messages are handed over as raw buffers through
+   mailboxes that belong to neither world. both worlds use the same
+   allocator, so a buffer can change owners without being copied */
+struct unc_actormsg {
+    struct unc_actormsg *next;
+    byte *data;
+    Unc_Size size;
+    Unc_Size capacity;
+    int blob;                   /* moved blob buffer, otherwise CBOR */
+};
+
+struct unc_mailbox {
+    struct unc_actormsg *head;
+    struct unc_actormsg *tail;
+    int closed;
+};
+
+struct unc_actor {
+    Unc_Alloc alloc;            /* allocator shared by both worlds */
+    void *allocdata;
+    struct unc_thrd_mon mon;    /* guards both mailboxes */
+    struct unc_mailbox inbox;   /* parent -> actor */
+    struct unc_mailbox outbox;  /* actor -> parent */
+    Unc_View *view;             /* main view of the actor world */
+    Unc_AtomicLarge refs;       /* 1 per handle + 1 for the thread */
+    Unc_AtomicSmall done;
+    struct unc_thrd_worker t;
+};
+
+/* name of the public variable holding the actor in an actor world.
+   scripts cannot refer to it, since it is not a valid identifier */
+#define UNC_ACTOR_PUBLIC "thread.actor"
+
+static void unc0_actormsgfree(struct unc_actor *a, struct unc_actormsg *m) {
+    if (m->data)
+        (void)(*a->alloc)(a->allocdata, Unc_AllocBlob,
+                          m->capacity, 0, m->data);
+    (void)(*a->alloc)(a->allocdata, Unc_AllocLibrary,
+                      sizeof(struct unc_actormsg), 0, m);
+}
+
+static void unc0_actormboxfree(struct unc_actor *a, struct unc_mailbox *mb) {
+    struct unc_actormsg *m = mb->head, *n;
+    while (m) {
+        n = m->next;
+        unc0_actormsgfree(a, m);
+        m = n;
+    }
+    mb->head = mb->tail = NULL;
+}
+
+static void unc0_actordecref(struct unc_actor *a) {
+    if (!ATOMICLDEC(a->refs)) {
+        Unc_Alloc alloc = a->alloc;
+        void *allocdata = a->allocdata;
+        unc0_actormboxfree(a, &a->inbox);
+        unc0_actormboxfree(a, &a->outbox);
+        unc_thrd_mon_free(&a->mon);
+        (void)(*alloc)(allocdata, Unc_AllocLibrary,
+                       sizeof(struct unc_actor), 0, a);
+    }
+}
+
+static struct unc_actor *unc0_actorself(Unc_View *w) {
+    Unc_Value *v;
+    struct unc_actor *a = NULL;
+    (void)UNC_LOCKFP(w, w->world->public_lock);
+    v = unc0_gethtbls(w, &w->world->pubs, sizeof(UNC_ACTOR_PUBLIC) - 1,
+                      (const byte *)UNC_ACTOR_PUBLIC);
+    if (v && VGETTYPE(v) == Unc_TOpaque)
+        a = *(struct unc_actor **)LEFTOVER(Unc_Opaque, VGETENT(v))->data;
+    UNC_UNLOCKF(w->world->public_lock);
+    return a;
+}
+
+/* turns v into a message. with move, the buffer of a blob is taken over
+   and the blob is left empty; anything else is encoded as CBOR */
+static Unc_RetVal unc0_actorpack(Unc_View *w, struct unc_actor *a,
+                                 Unc_Value *v, int move,
+                                 struct unc_actormsg **out) {
+    Unc_Allocator *alloc = &w->world->alloc;
+    struct unc_actormsg *m = NULL;
+    if (move && unc_gettype(w, v) != Unc_TBlob)
+        return unc_throwexc(w, "type", "only blobs can be moved");
+    m = (*a->alloc)(a->allocdata, Unc_AllocLibrary,
+                    0, sizeof(struct unc_actormsg), NULL);
+    if (!m) return UNCIL_ERR_MEM;
+    m->next = NULL;
+    m->blob = move;
+    if (move) {
+        Unc_Blob *b = LEFTOVER(Unc_Blob, VGETENT(v));
+        UNC_LOCKL(b->lock);
+        /* shrink to fit, so that the receiver knows the real size */
+        m->data = unc0_mrealloc(alloc, Unc_AllocBlob, b->data,
+                                b->capacity, b->size);
+        m->size = m->capacity = b->size;
+        b->data = NULL;
+        b->size = b->capacity = 0;
+        UNC_UNLOCKL(b->lock);
+    } else {
+        struct unc0_strbuf buf;
+        Unc_RetVal e = unc0_cbor_encodebuf(w, v, &buf);
+        if (e) {
+            m->data = NULL;
+            unc0_actormsgfree(a, m);
+            return e;
+        }
+        m->data = buf.buffer;
+        m->size = buf.length;
+        m->capacity = buf.capacity;
     }
+    /* the buffer no longer belongs to this world */
+    alloc->total -= m->capacity;
+    *out = m;
+    return 0;
+}
+
+static Unc_RetVal unc0_actorunpack(Unc_View *w, struct unc_actor *a,
+                                   struct unc_actormsg *m, Unc_Value *out) {
+    Unc_RetVal e;
+    if (m->blob) {
+        Unc_Value tmp;
+        e = unc0_vrefnew(w, &tmp, Unc_TBlob);
+        if (!e) {
+            Unc_Blob *b = LEFTOVER(Unc_Blob, VGETENT(&tmp));
+            e = unc0_initblobmove(&w->world->alloc, b, m->size, m->data);
+            b->capacity = m->capacity;
+            w->world->alloc.total += m->capacity;
+            m->data = NULL;
+            if (e)
+                unc0_unwake(VGETENT(&tmp), w);
+            else
+                VMOVE(w, out, &tmp);
+        }
+    } else
+        e = unc0_cbor_decodebuf(w, m->size, m->data, out);
+    unc0_actormsgfree(a, m);
+    return e;
+}
+
+static Unc_RetVal unc0_actorsend(Unc_View *w, struct unc_actor *a,
+                                 struct unc_mailbox *mb,
+                                 Unc_Value *v, int move) {
+    Unc_RetVal e;
+    struct unc_actormsg *m = NULL;
+    int ok;
+    if (mb->closed)
+        return unc_throwexc(w, "value", "actor mailbox has been closed");
+    e = unc0_actorpack(w, a, v, move, &m);
+    if (e) return e;
+    unc_thrd_mon_acquire(&a->mon);
+    ok = !mb->closed;
+    if (ok) {
+        if (mb->tail)
+            mb->tail->next = m;
+        else
+            mb->head = m;
+        mb->tail = m;
+        unc_thrd_mon_notifyall(&a->mon);
+    }
+    unc_thrd_mon_release(&a->mon);
+    if (ok) return 0;
+    unc0_actormsgfree(a, m);
+    return unc_throwexc(w, "value", "actor mailbox has been closed");
+}
+
+static Unc_RetVal unc0_actorrecv(Unc_View *w, struct unc_actor *a,
+                                 struct unc_mailbox *mb,
+                                 int timed, Unc_Float to,
+                                 Unc_Value *out, int *ok) {
+    Unc_RetVal e = 0;
+    struct unc_actormsg *m = NULL;
+    unc0_countdown cd;
+    *ok = 0;
+    if (timed && unc0_countdownfirst(&cd))
+        return uncl_thread_makeerr(w, THREADFAIL);
+    unc_thrd_mon_acquire(&a->mon);
+    while (!(m = mb->head) && !mb->closed) {
+        Unc_Float wt = UNC_POOL_IDLEWAIT;
+        if (timed) {
+            if (unc0_countdownnext(&cd, &to)) {
+                e = uncl_thread_makeerr(w, THREADFAIL);
+                break;
+            }
+            if (to <= 0)
+                break;
+            if (to < wt)
+                wt = to;
+        }
+        unc_vmpause(w);
+        (void)unc_thrd_mon_waittimed(&a->mon, wt);
+        /* do not hold the monitor while a GC may keep us from resuming */
+        unc_thrd_mon_release(&a->mon);
+        e = unc_vmresume(w);
+        unc_thrd_mon_acquire(&a->mon);
+        if (e) break;
+    }
+    if (m) {
+        mb->head = m->next;
+        if (!mb->head) mb->tail = NULL;
+    }
+    unc_thrd_mon_release(&a->mon);
+    if (e || !m) return e;
+    e = unc0_actorunpack(w, a, m, out);
+    *ok = !e;
+    return e;
+}
+
+static void unc0_actorclose(struct unc_actor *a, struct unc_mailbox *mb) {
+    unc_thrd_mon_acquire(&a->mon);
+    mb->closed = 1;
+    unc_thrd_mon_notifyall(&a->mon);
+    unc_thrd_mon_release(&a->mon);
+}
+
+static Unc_RetVal unc0_actorjoin(Unc_View *w, struct unc_actor *a) {
+    Unc_RetVal e = 0;
+    unc_thrd_mon_acquire(&a->mon);
+    while (!a->done) {
+        unc_vmpause(w);
+        (void)unc_thrd_mon_waittimed(&a->mon, UNC_POOL_IDLEWAIT);
+        unc_thrd_mon_release(&a->mon);
+        e = unc_vmresume(w);
+        unc_thrd_mon_acquire(&a->mon);
+        if (e) break;
+    }
+    unc_thrd_mon_release(&a->mon);
+    return e;
+}
+
+static void unc0_actorrun(void *p) {
+    struct unc_actor *a = p;
+    Unc_View *w = a->view;
+    Unc_Pile pile;
+    Unc_RetVal e = unc_call(w, NULL, 0, &pile);
+    if (e)
+        unc0_threadreport(w, e, 0, "actor");
+    else
+        unc_discard(w, &pile);
+    unc_destroy(w);
+    unc_thrd_mon_acquire(&a->mon);
+    a->view = NULL;
+    a->inbox.closed = a->outbox.closed = 1;
+    ATOMICSSET(a->done, 1);
+    unc_thrd_mon_notifyall(&a->mon);
+    unc_thrd_mon_release(&a->mon);
+    unc0_actordecref(a);
+}
+
+/* module search paths are copied over from the parent world */
+static Unc_RetVal unc0_actorcopypaths(Unc_View *w, Unc_Value *src,
+                                      Unc_View *zw, Unc_Value *dst) {
+    Unc_RetVal e;
+    Unc_Size i, n;
+    Unc_Value *sv, *dv, tmp = UNC_BLANK;
+    if (unc_gettype(w, src) != Unc_TArray)
+        return 0;
+    e = unc_lockarray(w, src, &n, &sv);
+    if (e) return e;
+    e = unc_newarray(zw, &tmp, n, &dv);
+    if (!e) {
+        for (i = 0; i < n; ++i) {
+            Unc_Size sn;
+            const char *ss;
+            if (unc_getstring(w, &sv[i], &sn, &ss))
+                continue;
+            e = unc_newstring(zw, &dv[i], sn, ss);
+            if (e) break;
+        }
+        unc_unlock(zw, &tmp);
+    }
+    unc_unlock(w, src);
+    if (!e) unc_move(zw, dst, &tmp);
+    VCLEAR(zw, &tmp);
+    return e;
+}
+
+static Unc_RetVal unc0_actorsetup(Unc_View *w, Unc_View *zw,
+                                  struct unc_actor *a) {
+    Unc_RetVal e;
+    Unc_Value tok = UNC_BLANK;
+    struct unc_actor **pa;
+    e = unc0_actorcopypaths(w, &w->world->modulepaths,
+                            zw, &zw->world->modulepaths);
+    if (!e) e = unc0_actorcopypaths(w, &w->world->moduledlpaths,
+                            zw, &zw->world->moduledlpaths);
+    if (e) return e;
+    e = unc_newopaque(zw, &tok, NULL, sizeof(struct unc_actor *),
+                      (void **)&pa, NULL, 0, NULL, 0, NULL);
+    if (e) return e;
+    *pa = a;
+    unc_unlock(zw, &tok);
+    e = unc_setpublicc(zw, UNC_ACTOR_PUBLIC, &tok);
+    VCLEAR(zw, &tok);
+    return e;
+}
+#endif
+
+/* a handle to an actor. the parent world gets one from thread.actor.new
+   and the actor world from thread.actor.parent */
+struct unc_actorref {
+    struct unc_actor *actor;
+    int child;
+};
+
+static Unc_RetVal unc0_thread_thread_destr(Unc_View *w, size_t n, void *data) {
+#if UNCIL_MT_OK
+    /* a thread should never get destroyed if it is still running */
+    struct unc_threadobj *o = data;
+    ATOMICSSET(o->f_detach, 1);
+    if (o->phase >= 1)
+        UNC_LOCKL(o->lock);
+    if (o->phase >= 2) {
+        /* a finished thread may be the one destroying its own object */
+        if (!o->f_done)
+            unc_thrd_thread_kill(&o->t);
+        else if (!o->f_joined)
+            unc_thrd_thread_detach(&o->t);
+    }
+    if (!o->f_run) {
+        VCLEAR(o->u.view, &o->f);
+        unc_destroy(o->u.view);
+    }
+    if (o->phase >= 1) {
+        UNC_UNLOCKL(o->lock);
+        UNC_LOCKFINAL(o->lock);
+    }
+#endif
+    return 0;
+}
+
+static Unc_RetVal unc0_thread_lock_destr(Unc_View *w, size_t n, void *data) {
+    unc_thrd_lock_free((struct unc_thrd_lock *)data);
+    return 0;
+}
+
+static Unc_RetVal unc0_thread_rlock_destr(Unc_View *w, size_t n, void *data) {
+    unc_thrd_rlock_free((struct unc_thrd_rlock *)data);
+    return 0;
+}
+
+static Unc_RetVal unc0_thread_sem_destr(Unc_View *w, size_t n, void *data) {
+    unc_thrd_sem_free((struct unc_thrd_sem *)data);
+    return 0;
+}
+
+static Unc_RetVal unc0_thread_mon_destr(Unc_View *w, size_t n, void *data) {
+    unc_thrd_mon_free((struct unc_thrd_mon *)data);
+    return 0;
+}
+
+static Unc_RetVal unc0_thread_rwlock_destr(Unc_View *w, size_t n,
+                                           void *data) {
+    unc_thrd_rwlock_free((struct unc_thrd_rwlock *)data);
+    return 0;
+}
+
+static Unc_RetVal unc0_thread_pool_destr(Unc_View *w, size_t n, void *data) {
+#if UNCIL_MT_OK
+    struct unc_pool *p = *(struct unc_pool **)data;
+    if (p) {
+        unc0_poolshutdown(p);
+        unc0_pooldecref(p);
+    }
+#endif
+    return 0;
+}
+
+static Unc_RetVal unc0_thread_future_destr(Unc_View *w, size_t n,
+                                           void *data) {
+    struct unc_future *f = data;
+    struct unc_futurelink *l, *nl;
+    if (!f->world) return 0;
+    /* pending futures are pinned, so only a future.new that was never
+       settled can still have links */
+    for (l = f->links; l; l = nl) {
+        nl = l->next;
+        unc0_mfree(&f->world->alloc, l, sizeof(struct unc_futurelink));
+    }
+#if UNCIL_MT_OK
+    unc_thrd_mon_free(&f->mon);
+    unc0_pooldecref(f->pool);
+#endif
+    return 0;
+}
+
+static Unc_RetVal unc0_thread_chan_destr(Unc_View *w, size_t n, void *data) {
+    struct unc_channel *c = data;
+    Unc_Allocator *alloc;
+    if (!c->world) return 0;
+    alloc = &c->world->alloc;
+    unc0_tmfree(alloc, (void *)c->seq, sizeof(Unc_AtomicLarge), c->capacity);
+    TMFREE(struct unc_chanwaiter *, alloc, c->waiters, c->waitersc);
+#if UNCIL_MT_OK
+    unc_thrd_mon_free(&c->mon);
+#endif
+    UNC_LOCKFINAL(c->lock);
+    UNC_LOCKFINAL(c->wlock);
+    return 0;
+}
+
+static Unc_RetVal unc0_thread_actor_destr(Unc_View *w, size_t n,
+                                          void *data) {
+#if UNCIL_MT_OK
+    struct unc_actorref *r = data;
+    if (r->actor) {
+        /* nobody can send to the actor once the parent lets go of it */
+        if (!r->child) unc0_actorclose(r->actor, &r->actor->inbox);
+        unc0_actordecref(r->actor);
+    }
+#endif
+    return 0;
+}
+
+static Unc_RetVal uncl_thread_makeerr(Unc_View *w, Unc_RetVal e) {
+    switch (e) {
+    case THREADFAIL:
+        return unc_throwexc(w, "system", "synchronization error");
+    case THREADTIMEOUT:
+        return unc_throwexc(w, "system", "timed out before acquire/wait");
+    case THREADBUSY:
+        return unc_throwexc(w, "system", "synchronization resource busy");
+    case THREADUNDERLYING:
+        return unc_thrd_makeerr(w, e);
+    default:
+        return e;
+    }
+}
+
+static Unc_RetVal uncl_thread_thread_new(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    Unc_Size an;
+    Unc_Value *a;
+    Unc_View *zw;
+    struct unc_threadobj *thr;
+    int daemon;
+    if (!unc_iscallable(w, &args.values[0]))
+        return unc_throwexc(w, "type", "thread function must be callable");
+    switch (unc_gettype(w, &args.values[1])) {
+    case Unc_TNull:
+        a = NULL;
+        an = 0;
+        break;
+    case Unc_TArray:
+        e = unc_lockarray(w, &args.values[1], &an, &a);
+        if (e) return e;
+        break;
+    default:
+        return unc_throwexc(w, "type",
+                               "thread function args must be an array");
+    }
+    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
+                        sizeof(struct unc_threadobj), (void **)&thr,
+                        &unc0_thread_thread_destr, 0, NULL, 0, NULL);
+    if (e) {
+        unc_unlock(w, &args.values[1]);
+        return e;
+    }
+    daemon = unc_getbool(w, &args.values[2],
+                    w->vtype == Unc_ViewTypeSubDaemon);
+    thr->phase = 0;
+    VIMPOSE(w, &thr->f, &args.values[0]);
+    thr->a = an;
+    ATOMICSSET(thr->f_run, 0);
+    ATOMICSSET(thr->f_done, 0);
+    ATOMICSSET(thr->f_detach, 0);
+    ATOMICSSET(thr->f_joined, 0);
+    e = UNC_LOCKINITL(thr->lock);
+    if (e)
+        zw = thr->u.view = NULL;
+    else {
+        thr->phase = 1;
+        (void)UNC_LOCKFP(w, w->world->viewlist_lock);
+        zw = thr->u.view = unc0_newview(w->world,
+                daemon ? Unc_ViewTypeSubDaemon : Unc_ViewTypeSub);
+        UNC_UNLOCKF(w->world->viewlist_lock);
+        if (!zw)
+            e = UNCIL_ERR_MEM;
+        else {
+            unc_copyprogram(zw, w);
+            if (an) e = unc_push(zw, an, a);
+        }
+    }
+    unc_unlock(w, &args.values[1]);
+    thr->u.up = thr->u.down = NULL;
+    thr->u.flags = daemon ? UNCIL_THREAD_FLAG_DAEMON : 0;
+    if (!e) {
+        e = unc_thrd_thread_new(&thr->t);
+        if (e) e = uncl_thread_makeerr(w, e);
+        else thr->phase = 2;
+    }
+    if (e && zw)
+        unc_destroy(zw);
+    unc_unlock(w, &v);
+    if (!e) e = unc_push(w, 1, &v);
+    VCLEAR(w, &v);
+    return e;
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
+}
+
+static Unc_RetVal uncl_thread_thread_start(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    struct unc_threadobj *thr;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&thr, 1, "thread.thread");
+    if (e) return e;
+
+    UNC_LOCKL(thr->lock);
+    if (thr->f_run)
+        e = unc_throwexc(w, "value", "thread already started");
+    if (thr->f_detach)
+        e = unc_throwexc(w, "value", "thread not valid");
+    if (!e) {
+        ATOMICSSET(thr->f_run, 1);
+        e = unc_thrd_thread_start(&thr->t);
+        if (e) e = uncl_thread_makeerr(w, e);
+        else {
+            Unc_View *zw = thr->u.view;
+            VIMPOSE(zw, &zw->threadme, &args.values[0]);
+        }
+    }
+    UNC_UNLOCKL(thr->lock);
+    unc_unlock(w, &args.values[0]);
+    return e;
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
+}
+
+static Unc_RetVal uncl_thread_thread_join(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    int finished;
+    struct unc_threadobj *thr;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&thr, 1, "thread.thread");
+    if (e) return e;
+
+    UNC_LOCKL(thr->lock);
+    if (!thr->f_run)
+        e = unc_throwexc(w, "value", "thread not started");
+    if (thr->f_detach)
+        e = unc_throwexc(w, "value", "thread not valid");
+    finished = thr->f_done;
+    UNC_UNLOCKL(thr->lock);
+    if (!e && !finished) {
+        unc_vmpause(w);
+        e = unc_thrd_thread_join(&thr->t);
+        if (!e) ATOMICSSET(thr->f_joined, 1);
+        unc_vmresume(w);
+    }
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
+}
+
+static Unc_RetVal uncl_thread_thread_jointimed(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    int finished;
+    Unc_Float to;
+    Unc_Value v = UNC_BLANK;
+    struct unc_threadobj *thr;
+    e = unc_getfloat(w, &args.values[1], &to);
+    if (e) return e;
+    if (to < 0)
+        return unc_throwexc(w, "value", "timeout cannot be negative");
+    if (!unc0_fisfinite(to))
+        return unc_throwexc(w, "value", "timeout must be finite");
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&thr, 1, "thread.thread");
+    if (e) return e;
+
+    UNC_LOCKL(thr->lock);
+    if (!thr->f_run)
+        e = unc_throwexc(w, "value", "thread not started");
+    if (thr->f_detach)
+        e = unc_throwexc(w, "value", "thread not valid");
+    finished = thr->f_done;
+    UNC_UNLOCKL(thr->lock);
+    if (!e && !finished) {
+        unc_vmpause(w);
+        e = unc_thrd_thread_jointimed(&thr->t, to);
+        if (e == THREADTIMEOUT)
+            e = 0;
+        unc_vmresume(w);
+        unc_setbool(w, &v, !e);
+    }
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return unc_returnlocal(w, e, &v);
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
+}
+
+static Unc_RetVal uncl_thread_thread_halt(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    struct unc_threadobj *thr;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&thr, 1, "thread.thread");
+    if (e) return e;
+
+    UNC_LOCKL(thr->lock);
+    if (!thr->f_run)
+        e = unc_throwexc(w, "value", "thread not started");
+    if (thr->f_detach)
+        e = unc_throwexc(w, "value", "thread not valid");
+    if (!e && !thr->f_done) unc0_haltview(thr->u.view);
+    UNC_UNLOCKL(thr->lock);
+    unc_unlock(w, &args.values[0]);
+    return e;
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
+}
+
+static Unc_RetVal uncl_thread_thread_hasfinished(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct unc_threadobj *thr;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&thr, 1, "thread.thread");
+    if (e) return e;
+
+    UNC_LOCKL(thr->lock);
+    if (thr->f_detach)
+        e = unc_throwexc(w, "value", "thread not valid");
+    unc_setbool(w, &v, thr->f_done);
+    UNC_UNLOCKL(thr->lock);
+    unc_unlock(w, &args.values[0]);
+    return unc_returnlocal(w, e, &v);
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
+}
+
+static Unc_RetVal uncl_thread_lock_new(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct unc_thrd_lock *lock;
+    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
+                        sizeof(struct unc_thrd_lock), (void **)&lock,
+                        &unc0_thread_lock_destr, 0, NULL, 0, NULL);
+    if (e) return e;
+    e = unc_thrd_lock_new(lock);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &v);
+    return unc_returnlocal(w, e, &v);
+}
+
+static Unc_RetVal uncl_thread_lock_acquire(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    struct unc_thrd_lock *lock;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&lock, 1, "thread.lock");
+    if (e) return e;
+    unc_vmpause(w);
+    e = unc_thrd_lock_acquire(lock);
+    unc_vmresume(w);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_lock_acquiretimed(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Float to;
+    struct unc_thrd_lock *lock;
+    e = unc_getfloat(w, &args.values[1], &to);
+    if (e) return e;
+    if (to < 0)
+        return unc_throwexc(w, "value", "timeout cannot be negative");
+    if (!unc0_fisfinite(to))
+        return unc_throwexc(w, "value", "timeout must be finite");
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&lock, 1, "thread.lock");
+    if (e) return e;
+    unc_vmpause(w);
+    e = unc_thrd_lock_acquiretimed(lock, to);
+    unc_vmresume(w);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_lock_release(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    struct unc_thrd_lock *lock;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&lock, 1, "thread.lock");
+    if (e) return e;
+    e = unc_thrd_lock_release(lock);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_rlock_new(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct unc_thrd_rlock *rlock;
+    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
+                        sizeof(struct unc_thrd_rlock), (void **)&rlock,
+                        &unc0_thread_rlock_destr, 0, NULL, 0, NULL);
+    if (e) return e;
+    e = unc_thrd_rlock_new(rlock);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &v);
+    return unc_returnlocal(w, e, &v);
+}
+
+static Unc_RetVal uncl_thread_rlock_acquire(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    struct unc_thrd_rlock *rlock;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&rlock, 1, "thread.rlock");
+    if (e) return e;
+    unc_vmpause(w);
+    e = unc_thrd_rlock_acquire(rlock);
+    unc_vmresume(w);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_rlock_acquiretimed(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Float to;
+    struct unc_thrd_rlock *rlock;
+    e = unc_getfloat(w, &args.values[1], &to);
+    if (e) return e;
+    if (to < 0)
+        return unc_throwexc(w, "value", "timeout cannot be negative");
+    if (!unc0_fisfinite(to))
+        return unc_throwexc(w, "value", "timeout must be finite");
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&rlock, 1, "thread.rlock");
+    if (e) return e;
+    unc_vmpause(w);
+    e = unc_thrd_rlock_acquiretimed(rlock, to);
+    unc_vmresume(w);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_rlock_release(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    struct unc_thrd_rlock *rlock;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&rlock, 1, "thread.rlock");
+    if (e) return e;
+    e = unc_thrd_rlock_release(rlock);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_sem_new(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    Unc_Int ui;
+    struct unc_thrd_sem *sem;
+    e = unc_getint(w, &args.values[0], &ui);
+    if (e) return e;
+    if (ui < 0) return unc_throwexc(w, "value",
+                    "semaphore may not be initialized with a negative value");
+    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
+                        sizeof(struct unc_thrd_sem), (void **)&sem,
+                        &unc0_thread_sem_destr, 0, NULL, 0, NULL);
+    if (e) return e;
+    e = unc_thrd_sem_new(sem, ui);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &v);
+    return unc_returnlocal(w, e, &v);
+}
+
+static Unc_RetVal uncl_thread_sem_acquire(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Int ui;
+    struct unc_thrd_sem *sem;
+    if (unc_gettype(w, &args.values[1]))
+        e = unc_getint(w, &args.values[1], &ui);
+    else
+        e = 0, ui = 1;
+    if (e) return e;
+    if (ui < 0) return unc_throwexc(w, "value",
+                    "may not acquire a semaphore a negative number of times");
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&sem, 1, "thread.semaphore");
+    if (e) return e;
+    unc_vmpause(w);
+    e = unc_thrd_sem_acquire(sem, ui);
+    unc_vmresume(w);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_sem_acquiretimed(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Int ui;
+    Unc_Float to;
+    struct unc_thrd_sem *sem;
+    if (unc_gettype(w, &args.values[2]))
+        e = unc_getint(w, &args.values[2], &ui);
+    else
+        e = 0, ui = 1;
+    if (e) return e;
+    if (ui < 0) return unc_throwexc(w, "value",
+                    "may not acquire a semaphore a negative number of times");
+    e = unc_getfloat(w, &args.values[1], &to);
+    if (e) return e;
+    if (to < 0)
+        return unc_throwexc(w, "value", "timeout cannot be negative");
+    if (!unc0_fisfinite(to))
+        return unc_throwexc(w, "value", "timeout must be finite");
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&sem, 1, "thread.semaphore");
+    if (e) return e;
+    unc_vmpause(w);
+    e = unc_thrd_sem_acquiretimed(sem, ui, to);
+    unc_vmresume(w);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_sem_release(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Int ui;
+    struct unc_thrd_sem *sem;
+    if (unc_gettype(w, &args.values[1]))
+        e = unc_getint(w, &args.values[1], &ui);
+    else
+        e = 0, ui = 1;
+    if (e) return e;
+    if (ui < 0) return unc_throwexc(w, "value",
+                    "may not release a semaphore a negative number of times");
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&sem, 1, "thread.semaphore");
+    if (e) return e;
+    e = unc_thrd_sem_release(sem, ui);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_rwlock_new(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct unc_thrd_rwlock *rw;
+    int preferwriters = unc_getbool(w, &args.values[0], 0);
+    if (UNCIL_IS_ERR(preferwriters)) return preferwriters;
+    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
+                        sizeof(struct unc_thrd_rwlock), (void **)&rw,
+                        &unc0_thread_rwlock_destr, 0, NULL, 0, NULL);
+    if (e) return e;
+    e = unc_thrd_rwlock_new(rw, preferwriters);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &v);
+    return unc_returnlocal(w, e, &v);
+}
+
+static Unc_RetVal uncl_thread_rwlock_acquire_(Unc_View *w, Unc_Tuple args,
+                                              int write, int timed) {
+    Unc_RetVal e;
+    Unc_Float to = 0;
+    struct unc_thrd_rwlock *rw;
+    if (timed) {
+        e = unc_getfloat(w, &args.values[1], &to);
+        if (e) return e;
+        if (to < 0)
+            return unc_throwexc(w, "value", "timeout cannot be negative");
+        if (!unc0_fisfinite(to))
+            return unc_throwexc(w, "value", "timeout must be finite");
+    }
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&rw, 1, "thread.rwlock");
+    if (e) return e;
+    /* the argument keeps the lock alive. it must not stay locked while
+       waiting, or the holder could not release it */
+    unc_unlock(w, &args.values[0]);
+    unc_vmpause(w);
+    e = timed ? unc_thrd_rwlock_acquiretimed(rw, write, to)
+              : unc_thrd_rwlock_acquire(rw, write);
+    unc_vmresume(w);
+    if (timed && (!e || e == THREADTIMEOUT)) {
+        Unc_Value v = UNC_BLANK;
+        unc_setbool(w, &v, !e);
+        return unc_push(w, 1, &v);
+    }
+    if (e) e = uncl_thread_makeerr(w, e);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_rwlock_acquireread(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    return uncl_thread_rwlock_acquire_(w, args, 0, 0);
+}
+
+static Unc_RetVal uncl_thread_rwlock_acquirereadtimed(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    return uncl_thread_rwlock_acquire_(w, args, 0, 1);
+}
+
+static Unc_RetVal uncl_thread_rwlock_acquirewrite(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    return uncl_thread_rwlock_acquire_(w, args, 1, 0);
+}
+
+static Unc_RetVal uncl_thread_rwlock_acquirewritetimed(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    return uncl_thread_rwlock_acquire_(w, args, 1, 1);
+}
+
+static Unc_RetVal uncl_thread_rwlock_release(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    struct unc_thrd_rwlock *rw;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&rw, 1, "thread.rwlock");
+    if (e) return e;
+    unc_unlock(w, &args.values[0]);
+    e = unc_thrd_rwlock_release(rw);
+    if (e == THREADFAIL)
+        return unc_throwexc(w, "value", "rwlock is not held");
+    if (e) e = uncl_thread_makeerr(w, e);
+    return e;
+}
+
+/* the value of an atomic is only ever accessed with atomic operations, so
+   unlike other opaque values, it is not locked */
+static Unc_RetVal unc0_getatomic(Unc_View *w, Unc_Value *v,
+                                 Unc_AtomicInt **out) {
+    if (VGETTYPE(v) == Unc_TOpaque) {
+        Unc_Opaque *o = LEFTOVER(Unc_Opaque, VGETENT(v));
+        if (unc_issame(w, &o->prototype, unc_boundvalue(w, 0))) {
+            *out = o->data;
+            return 0;
+        }
+    }
+    return unc_throwexc(w, "type", "argument 1 is not a thread.atomic");
+}
+
+static Unc_RetVal uncl_thread_atomic_new(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    Unc_Int ui = 0;
+    Unc_AtomicInt *a;
+    if (unc_gettype(w, &args.values[0])) {
+        e = unc_getint(w, &args.values[0], &ui);
+        if (e) return e;
+    }
+    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
+                        sizeof(Unc_AtomicInt), (void **)&a,
+                        NULL, 0, NULL, 0, NULL);
+    if (e) return e;
+    ATOMICISET(*a, ui);
+    unc_unlock(w, &v);
+    return unc_returnlocal(w, 0, &v);
+}
+
+static Unc_RetVal uncl_thread_atomic_load(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    Unc_AtomicInt *a;
+    e = unc0_getatomic(w, &args.values[0], &a);
+    if (e) return e;
+    unc_setint(w, &v, ATOMICILOAD(*a));
+    return unc_push(w, 1, &v);
+}
+
+static Unc_RetVal uncl_thread_atomic_store(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Int ui;
+    Unc_AtomicInt *a;
+    e = unc_getint(w, &args.values[1], &ui);
+    if (e) return e;
+    e = unc0_getatomic(w, &args.values[0], &a);
+    if (e) return e;
+    ATOMICISET(*a, ui);
+    return 0;
+}
+
+static Unc_RetVal uncl_thread_atomic_add(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    Unc_Int ui = 1;
+    Unc_AtomicInt *a;
+    if (unc_gettype(w, &args.values[1])) {
+        e = unc_getint(w, &args.values[1], &ui);
+        if (e) return e;
+    }
+    e = unc0_getatomic(w, &args.values[0], &a);
+    if (e) return e;
+    unc_setint(w, &v, ATOMICIADD(*a, ui));
+    return unc_push(w, 1, &v);
+}
+
+static Unc_RetVal uncl_thread_atomic_swap(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    Unc_Int ui;
+    Unc_AtomicInt *a;
+    e = unc_getint(w, &args.values[1], &ui);
+    if (e) return e;
+    e = unc0_getatomic(w, &args.values[0], &a);
+    if (e) return e;
+    unc_setint(w, &v, ATOMICIXCG(*a, ui));
+    return unc_push(w, 1, &v);
+}
+
+static Unc_RetVal uncl_thread_atomic_cas(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    Unc_Int expect, ui;
+    Unc_AtomicInt *a;
+    e = unc_getint(w, &args.values[1], &expect);
+    if (e) return e;
+    e = unc_getint(w, &args.values[2], &ui);
+    if (e) return e;
+    e = unc0_getatomic(w, &args.values[0], &a);
+    if (e) return e;
+    unc_setbool(w, &v, ATOMICICAS(*a, expect, ui));
+    return unc_push(w, 1, &v);
+}
+
+#define UNC_CTABLE_STRIPEBITS 5
+#define UNC_CTABLE_STRIPES (1 << UNC_CTABLE_STRIPEBITS)
+
+/* a concurrent table is split into stripes by the hash of the key. every
+   stripe is an ordinary table with a lock of its own, so threads only wait
+   for each other when they work on keys in the same stripe. the stripes
+   are the bound values of the opaque, which keeps them alive */
+struct unc_ctable {
+    Unc_Dict *stripes[UNC_CTABLE_STRIPES];
+};
+
+static Unc_RetVal unc0_getctable(Unc_View *w, Unc_Value *v,
+                                 struct unc_ctable **out) {
+    /* the argument keeps the table alive, so it need not stay locked */
+    Unc_RetVal e = unc0_verifyopaque_arg(w, v, unc_boundvalue(w, 0),
+                        NULL, (void **)out, 1, "thread.ctable");
+    if (!e) unc_unlock(w, v);
+    return e;
+}
+
+/* the stripe tables index their slots with the low bits of the hash, so
+   the stripe is picked with the high bits of a remixed hash instead */
+static Unc_RetVal unc0_ctablestripe(Unc_View *w, struct unc_ctable *t,
+                                    Unc_Value *key, Unc_Dict **out) {
+    unsigned h;
+    Unc_RetVal e = unc0_hashvalue(w, key, &h);
+    if (e) return e;
+    h = (h & 0xFFFFFFFFU) * 0x9E3779B1U;
+    *out = t->stripes[(h & 0xFFFFFFFFU) >> (32 - UNC_CTABLE_STRIPEBITS)];
+    return 0;
+}
+
+static Unc_RetVal uncl_thread_ctable_new(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    Unc_Size i, n = 0;
+    struct unc_ctable *t;
+    if (unc_gettype(w, &args.values[0])) {
+        Unc_Int ui;
+        e = unc_getint(w, &args.values[0], &ui);
+        if (e) return e;
+        if (ui < 0)
+            return unc_throwexc(w, "value", "table size cannot be negative");
+        n = (Unc_Size)ui;
+    }
+    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
+                        sizeof(struct unc_ctable), (void **)&t,
+                        NULL, UNC_CTABLE_STRIPES, NULL, 0, NULL);
+    if (e) return e;
+    for (i = 0; i < UNC_CTABLE_STRIPES; ++i) {
+        Unc_Value *s = unc_opaqueboundvalue(w, &v, i);
+        e = unc_newtablecap(w, s, (n + UNC_CTABLE_STRIPES - 1)
+                                        / UNC_CTABLE_STRIPES);
+        if (e) {
+            unc_unlock(w, &v);
+            VCLEAR(w, &v);
+            return e;
+        }
+        t->stripes[i] = LEFTOVER(Unc_Dict, VGETENT(s));
+    }
+    unc_unlock(w, &v);
+    return unc_returnlocal(w, 0, &v);
+}
+
+static Unc_RetVal uncl_thread_ctable_get(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct unc_ctable *t;
+    Unc_Dict *d;
+    int found;
+    e = unc0_getctable(w, &args.values[0], &t);
+    if (e) return e;
+    e = unc0_ctablestripe(w, t, &args.values[1], &d);
+    if (e) return e;
+    e = unc0_dgetindx(w, d, &args.values[1], &found, &v);
+    if (e) return e;
+    if (!found) return unc_push(w, 1, &args.values[2]);
+    return unc_returnlocal(w, 0, &v);
+}
+
+static Unc_RetVal uncl_thread_ctable_has(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct unc_ctable *t;
+    Unc_Dict *d;
+    int found;
+    e = unc0_getctable(w, &args.values[0], &t);
+    if (e) return e;
+    e = unc0_ctablestripe(w, t, &args.values[1], &d);
+    if (e) return e;
+    e = unc0_dgetindx(w, d, &args.values[1], &found, &v);
+    if (e) return e;
+    VCLEAR(w, &v);
+    unc_setbool(w, &v, found);
+    return unc_push(w, 1, &v);
+}
+
+static Unc_RetVal uncl_thread_ctable_set(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    struct unc_ctable *t;
+    Unc_Dict *d;
+    e = unc0_getctable(w, &args.values[0], &t);
+    if (e) return e;
+    e = unc0_ctablestripe(w, t, &args.values[1], &d);
+    if (e) return e;
+    return unc0_dsetindx(w, d, &args.values[1], &args.values[2]);
+}
+
+static Unc_RetVal uncl_thread_ctable_remove(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct unc_ctable *t;
+    Unc_Dict *d;
+    int found, ok;
+    e = unc0_getctable(w, &args.values[0], &t);
+    if (e) return e;
+    e = unc0_ctablestripe(w, t, &args.values[1], &d);
+    if (e) return e;
+    do {
+        e = unc0_dgetindx(w, d, &args.values[1], &found, &v);
+        if (e || !found) break;
+        e = unc0_dcasindx(w, d, &args.values[1], &v, NULL, &ok);
+        VCLEAR(w, &v);
+    } while (!e && !ok);
+    if (e) return e;
+    unc_setbool(w, &v, found);
+    return unc_push(w, 1, &v);
+}
+
+static Unc_RetVal uncl_thread_ctable_getorset(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct unc_ctable *t;
+    Unc_Dict *d;
+    e = unc0_getctable(w, &args.values[0], &t);
+    if (e) return e;
+    e = unc0_ctablestripe(w, t, &args.values[1], &d);
+    if (e) return e;
+    e = unc0_dgetorsetindx(w, d, &args.values[1], &args.values[2], &v);
+    if (e) return e;
+    return unc_returnlocal(w, 0, &v);
+}
+
+/* the function is called without holding any lock, and its result is only
+   stored if the key still has the value that was given to the function.
+   otherwise it is called again with the new value */
+static Unc_RetVal uncl_thread_ctable_compute(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK, nv = UNC_BLANK;
+    struct unc_ctable *t;
+    Unc_Dict *d;
+    int found, ok;
+    e = unc0_getctable(w, &args.values[0], &t);
+    if (e) return e;
+    e = unc0_ctablestripe(w, t, &args.values[1], &d);
+    if (e) return e;
+    do {
+        Unc_Pile pile;
+        Unc_Tuple tuple;
+        VSETNULL(w, &v);
+        e = unc0_dgetindx(w, d, &args.values[1], &found, &v);
+        if (e) break;
+        e = unc_push(w, 1, &v);
+        if (e) break;
+        e = unc_call(w, &args.values[2], 1, &pile);
+        if (e) break;
+        unc_returnvalues(w, &pile, &tuple);
+        if (tuple.count)
+            VCOPY(w, &nv, &tuple.values[0]);
+        else
+            VSETNULL(w, &nv);
+        unc_discard(w, &pile);
+        e = unc0_dcasindx(w, d, &args.values[1], found ? &v : NULL,
+                          &nv, &ok);
+    } while (!e && !ok);
+    VCLEAR(w, &v);
+    if (e) {
+        VCLEAR(w, &nv);
+        return e;
+    }
+    return unc_returnlocal(w, 0, &nv);
+}
+
+static Unc_RetVal uncl_thread_ctable_length(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct unc_ctable *t;
+    Unc_Size i, n = 0;
+    e = unc0_getctable(w, &args.values[0], &t);
+    if (e) return e;
+    for (i = 0; i < UNC_CTABLE_STRIPES; ++i)
+        n += unc0_dgetsize(w, t->stripes[i]);
+    unc_setint(w, &v, (Unc_Int)n);
+    return unc_push(w, 1, &v);
+}
+
+static Unc_RetVal uncl_thread_ctable_totable(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct unc_ctable *t;
+    Unc_Dict *o;
+    Unc_Size i;
+    e = unc0_getctable(w, &args.values[0], &t);
+    if (e) return e;
+    e = unc_newtable(w, &v);
+    if (e) return e;
+    o = LEFTOVER(Unc_Dict, VGETENT(&v));
+    for (i = 0; i < UNC_CTABLE_STRIPES; ++i) {
+        Unc_Dict *d = t->stripes[i];
+        Unc_Size j = 0;
+        Unc_Value *p, k;
+        UNC_LOCKL(d->lock);
+        while ((p = unc0_iterhtblv(&d->data, &j, &k))) {
+            e = unc0_dsetindx(w, o, &k, p);
+            if (e) break;
+        }
+        UNC_UNLOCKL(d->lock);
+        if (e) {
+            VCLEAR(w, &v);
+            return e;
+        }
+    }
+    return unc_returnlocal(w, 0, &v);
+}
+
+static Unc_RetVal uncl_thread_mon_new(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct unc_thrd_mon *mon;
+    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
+                        sizeof(struct unc_thrd_mon), (void **)&mon,
+                        &unc0_thread_mon_destr, 1, NULL, 0, NULL);
+    if (e) return e;
+    if (unc_gettype(w, &args.values[0])) {
+        void *lock;
+        e = unc0_verifyopaque(w, &args.values[0], unc_boundvalue(w, 2),
+                        NULL, (void **)&lock, NULL);
+        if (!e) {
+            e = unc_thrd_mon_new_rlock(mon, (struct unc_thrd_rlock *)lock);
+        } else {
+            e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 1),
+                            NULL, (void **)&lock, 1, "lock");
+            if (e) return e;
+            e = unc_thrd_mon_new_lock(mon, (struct unc_thrd_lock *)lock);
+        }
+        unc_copy(w, unc_opaqueboundvalue(w, &v, 0), &args.values[0]);
+    } else
+        e = unc_thrd_mon_new(mon);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &v);
+    return unc_returnlocal(w, e, &v);
+}
+
+static Unc_RetVal uncl_thread_mon_acquire(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    struct unc_thrd_mon *mon;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&mon, 1, "thread.monitor");
+    if (e) return e;
+    unc_vmpause(w);
+    e = unc_thrd_mon_acquire(mon);
+    unc_vmresume(w);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_mon_acquiretimed(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Float to;
+    struct unc_thrd_mon *mon;
+    e = unc_getfloat(w, &args.values[1], &to);
+    if (e) return e;
+    if (to < 0)
+        return unc_throwexc(w, "value", "timeout cannot be negative");
+    if (!unc0_fisfinite(to))
+        return unc_throwexc(w, "value", "timeout must be finite");
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&mon, 1, "thread.monitor");
+    if (e) return e;
+    unc_vmpause(w);
+    e = unc_thrd_mon_acquiretimed(mon, to);
+    unc_vmresume(w);
     if (e) e = uncl_thread_makeerr(w, e);
     unc_unlock(w, &args.values[0]);
     return e;
-#else
-    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
-#endif
 }
 
-static Unc_RetVal uncl_thread_thread_jointimed(
+static Unc_RetVal uncl_thread_mon_release(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    struct unc_thrd_mon *mon;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&mon, 1, "thread.monitor");
+    if (e) return e;
+    e = unc_thrd_mon_release(mon);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_mon_wait(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    struct unc_thrd_mon *mon;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&mon, 1, "thread.monitor");
+    if (e) return e;
+    unc_vmpause(w);
+    e = unc_thrd_mon_wait(mon);
+    unc_vmresume(w);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_mon_waittimed(
                     Unc_View *w, Unc_Tuple args, void *udata) {
-#if UNCIL_MT_OK
     Unc_RetVal e;
-    int finished;
     Unc_Float to;
-    Unc_Value v = UNC_BLANK;
-    struct unc_threadobj *thr;
+    struct unc_thrd_mon *mon;
     e = unc_getfloat(w, &args.values[1], &to);
     if (e) return e;
     if (to < 0)
@@ -1126,474 +3586,1113 @@ static Unc_RetVal uncl_thread_thread_jointimed(
     if (!unc0_fisfinite(to))
         return unc_throwexc(w, "value", "timeout must be finite");
     e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&thr, 1, "thread.thread");
+                    NULL, (void **)&mon, 1, "thread.monitor");
     if (e) return e;
+    unc_vmpause(w);
+    e = unc_thrd_mon_waittimed(mon, to);
+    unc_vmresume(w);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
 
-    UNC_LOCKL(thr->lock);
-    if (!thr->f_run)
-        e = unc_throwexc(w, "value", "thread not started");
-    if (thr->f_detach)
-        e = unc_throwexc(w, "value", "thread not valid");
-    finished = thr->f_done;
-    UNC_UNLOCKL(thr->lock);
-    if (!e && !finished) {
-        unc_vmpause(w);
-        e = unc_thrd_thread_jointimed(&thr->t, to);
-        if (e == THREADTIMEOUT)
-            e = 0;
-        unc_vmresume(w);
-        unc_setbool(w, &v, !e);
-    }
+static Unc_RetVal uncl_thread_mon_notify(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Int ui;
+    struct unc_thrd_mon *mon;
+    if (unc_gettype(w, &args.values[1]))
+        e = unc_getint(w, &args.values[1], &ui);
+    else
+        e = 0, ui = 1;
+    if (e) return e;
+    if (ui < 0) return unc_throwexc(w, "value",
+                "may not try to notify a monitor a negative number of times");
+    if (ui == 0) return 0;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&mon, 1, "thread.monitor");
+    if (e) return e;
+    e = unc_thrd_mon_notify(mon, ui);
     if (e) e = uncl_thread_makeerr(w, e);
     unc_unlock(w, &args.values[0]);
-    return unc_returnlocal(w, e, &v);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_mon_notifyall(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    struct unc_thrd_mon *mon;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&mon, 1, "thread.monitor");
+    if (e) return e;
+    e = unc_thrd_mon_notifyall(mon);
+    if (e) e = uncl_thread_makeerr(w, e);
+    unc_unlock(w, &args.values[0]);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_sleep(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Float to;
+    e = unc_getfloat(w, &args.values[0], &to);
+    if (e) return e;
+    if (to < 0)
+        return unc_throwexc(w, "value", "sleep time cannot be negative");
+    if (!unc0_fisfinite(to))
+        return unc_throwexc(w, "value", "sleep time must be finite");
+    unc_vmpause(w);
+    e = unc_thrd_sleep(to);
+    unc_vmresume(w);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_yield(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    unc_vmpause(w);
+    UNC_YIELD();
+    unc_vmresume(w);
+    return 0;
+}
+
+static Unc_RetVal uncl_thread_pool_new(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    Unc_Int ui;
+    struct unc_pool **pp;
+    if (unc_gettype(w, &args.values[0])) {
+        e = unc_getint(w, &args.values[0], &ui);
+        if (e) return e;
+        if (ui < 1)
+            return unc_throwexc(w, "value",
+                                "thread pool must have at least one worker");
+    } else
+        ui = (Unc_Int)unc0_mtcpucount();
+    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
+                        sizeof(struct unc_pool *), (void **)&pp,
+                        &unc0_thread_pool_destr, 0, NULL, 0, NULL);
+    if (e) return e;
+    *pp = NULL;
+    e = unc0_poolnew(w, (Unc_Size)ui, pp);
+    unc_unlock(w, &v);
+    if (!e) e = unc_push(w, 1, &v);
+    VCLEAR(w, &v);
+    return e;
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
+}
+
+#if UNCIL_MT_OK
+/* gets the pool from a thread.pool object and takes a reference to it, so
+   that the object need not stay locked while the pool is in use */
+static Unc_RetVal unc0_getpool(Unc_View *w, Unc_Value *v,
+                               Unc_Value *prototype,
+                               struct unc_pool **out) {
+    Unc_RetVal e;
+    struct unc_pool **pp;
+    e = unc0_verifyopaque(w, v, prototype, NULL, (void **)&pp,
+                          "pool argument is not a thread.pool");
+    if (e) return e;
+    *out = *pp;
+    ATOMICLINC((*pp)->refs);
+    unc_unlock(w, v);
+    return 0;
+}
+#endif
+
+static Unc_RetVal uncl_thread_pool_size(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
+    struct unc_pool **pp;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&pp, 1, "thread.pool");
+    if (e) return e;
+    unc_setint(w, &v, (Unc_Int)(*pp)->size);
+    unc_unlock(w, &args.values[0]);
+    return unc_push(w, 1, &v);
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
+}
+
+static Unc_RetVal uncl_thread_pool_shutdown(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    struct unc_pool **pp;
+    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
+                    NULL, (void **)&pp, 1, "thread.pool");
+    if (e) return e;
+    unc0_poolshutdown(*pp);
+    unc_unlock(w, &args.values[0]);
+    return 0;
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
+}
+
+/* common to pmap and pfor. in = NULL for pfor */
+static Unc_RetVal uncl_thread_prun(Unc_View *w, Unc_Value *fn,
+                                   Unc_Value *vchunk, Unc_Value *vpool,
+                                   Unc_Size n, Unc_Value *in,
+                                   Unc_Value *out, Unc_Int start) {
+    Unc_RetVal e;
+    Unc_Size chunk = 0;
+    if (!unc_iscallable(w, fn))
+        return unc_throwexc(w, "type", "function must be callable");
+    if (unc_gettype(w, vchunk)) {
+        Unc_Int ui;
+        e = unc_getint(w, vchunk, &ui);
+        if (e) return e;
+        if (ui < 1)
+            return unc_throwexc(w, "value", "chunk size must be positive");
+        chunk = (Unc_Size)ui;
+    }
+#if UNCIL_MT_OK
+    {
+        struct unc_pool *p;
+        struct unc_pooljob j;
+        Unc_Value f = UNC_BLANK, keep = UNC_BLANK, exc = UNC_BLANK;
+        if (!n) return 0;
+        e = unc0_getpool(w, unc_gettype(w, vpool) ? vpool
+                                                  : unc_boundvalue(w, 1),
+                         unc_boundvalue(w, 0), &p);
+        if (e) return e;
+        e = unc_thrd_mon_new(&j.mon);
+        if (e) {
+            unc0_pooldecref(p);
+            return uncl_thread_makeerr(w, e);
+        }
+        /* pushing may move the stack and with it the arguments */
+        VCOPY(w, &f, fn);
+        e = unc_newarray(w, &keep, 1, &j.exc);
+        if (!e) {
+            e = unc_push(w, 1, &keep);
+            if (e) unc_unlock(w, &keep);
+        }
+        if (!e) {
+            j.fn = &f;
+            j.in = in;
+            j.out = out;
+            j.start = start;
+            ATOMICSSET(j.failed, 0);
+            e = unc0_poolrun(w, p, &j, n, chunk);
+            if (!e && j.failed)
+                VCOPY(w, &exc, j.exc);
+            unc_unlock(w, &keep);
+            unc_pop(w, 1);
+        }
+        VCLEAR(w, &keep);
+        VCLEAR(w, &f);
+        unc_thrd_mon_free(&j.mon);
+        unc0_pooldecref(p);
+        if (!e && VGETTYPE(&exc))
+            return unc_throw(w, &exc);
+        return e;
+    }
+#else
+    /* no threads, run everything here */
+    {
+        Unc_Size i;
+        Unc_Value f = UNC_BLANK;
+        (void)vpool;
+        (void)chunk;
+        /* pushing may move the stack and with it the arguments */
+        VCOPY(w, &f, fn);
+        e = 0;
+        for (i = 0; i < n; ++i) {
+            Unc_Pile pile;
+            Unc_Tuple tuple;
+            if (in)
+                e = unc_push(w, 1, &in[i]);
+            else {
+                Unc_Value v = UNC_BLANK;
+                VINITINT(&v, start + (Unc_Int)i);
+                e = unc_push(w, 1, &v);
+            }
+            if (!e) e = unc_call(w, &f, 1, &pile);
+            if (e) break;
+            if (out) {
+                unc_returnvalues(w, &pile, &tuple);
+                if (tuple.count) VCOPY(w, &out[i], &tuple.values[0]);
+            }
+            unc_discard(w, &pile);
+        }
+        VCLEAR(w, &f);
+        return e;
+    }
+#endif
+}
+
+static Unc_RetVal uncl_thread_pmap(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Value vin = UNC_BLANK, vout = UNC_BLANK;
+    Unc_Value fn = UNC_BLANK, chunk = UNC_BLANK, pool = UNC_BLANK;
+    Unc_Size i, n;
+    Unc_Value *a, *in, *out;
+    if (unc_gettype(w, &args.values[1]) != Unc_TArray)
+        return unc_throwexc(w, "type", "pmap input must be an array");
+    /* take a snapshot of the input, so that it need not stay locked */
+    e = unc_lockarray(w, &args.values[1], &n, &a);
+    if (e) return e;
+    e = unc_newarray(w, &vin, n, &in);
+    if (e) {
+        unc_unlock(w, &args.values[1]);
+        return e;
+    }
+    for (i = 0; i < n; ++i)
+        VCOPY(w, &in[i], &a[i]);
+    unc_unlock(w, &args.values[1]);
+    e = unc_newarray(w, &vout, n, &out);
+    if (e) {
+        unc_unlock(w, &vin);
+        VCLEAR(w, &vin);
+        return e;
+    }
+    /* pushing may move the stack and with it the arguments */
+    VCOPY(w, &fn, &args.values[0]);
+    VCOPY(w, &chunk, &args.values[2]);
+    VCOPY(w, &pool, &args.values[3]);
+    /* the result is pushed first, so that it and the snapshot are reachable
+       while the job runs */
+    e = unc_push(w, 1, &vout);
+    if (!e) {
+        e = unc_push(w, 1, &vin);
+        if (!e) {
+            e = uncl_thread_prun(w, &fn, &chunk, &pool, n, in, out, 0);
+            if (!e) unc_pop(w, 1);
+        }
+    }
+    unc_unlock(w, &vin);
+    unc_unlock(w, &vout);
+    VCLEAR(w, &vin);
+    VCLEAR(w, &vout);
+    VCLEAR(w, &fn);
+    VCLEAR(w, &chunk);
+    VCLEAR(w, &pool);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_pfor(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Int start, stop;
+    if (unc_gettype(w, &args.values[0]) == Unc_TArray) {
+        Unc_Size an;
+        Unc_Value *a;
+        e = unc_lockarray(w, &args.values[0], &an, &a);
+        if (e) return e;
+        if (an != 2) {
+            unc_unlock(w, &args.values[0]);
+            return unc_throwexc(w, "value",
+                                "pfor range must be [start, stop]");
+        }
+        e = unc_getint(w, &a[0], &start);
+        if (!e) e = unc_getint(w, &a[1], &stop);
+        unc_unlock(w, &args.values[0]);
+        if (e) return e;
+    } else {
+        e = unc_getint(w, &args.values[0], &stop);
+        if (e) return e;
+        start = 0;
+    }
+    if (stop <= start) return 0;
+    return uncl_thread_prun(w, &args.values[1], &args.values[2],
+                            &args.values[3], (Unc_Size)(stop - start),
+                            NULL, NULL, start);
+}
+
+/* future functions have four bound values: the future prototype, the
+   pool prototype, the default pool and the pin table */
+static Unc_RetVal unc0_futurenew(Unc_View *w, Unc_Value *v, int kind,
+                                 Unc_Value *vpool, struct unc_future **out) {
+    Unc_RetVal e;
+    struct unc_future *f;
+#if UNCIL_MT_OK
+    struct unc_pool *p;
+    e = unc0_getpool(w, unc_gettype(w, vpool) ? vpool : unc_boundvalue(w, 2),
+                     unc_boundvalue(w, 1), &p);
+    if (e) return e;
+#else
+    (void)vpool;
+#endif
+    e = unc_newopaque(w, v, unc_boundvalue(w, 0),
+                        sizeof(struct unc_future), (void **)&f,
+                        &unc0_thread_future_destr, 3, NULL, 0, NULL);
+    if (e) {
+#if UNCIL_MT_OK
+        unc0_pooldecref(p);
+#endif
+        return e;
+    }
+    f->world = NULL;
+#if UNCIL_MT_OK
+    e = unc_thrd_mon_new(&f->mon);
+    if (e) {
+        unc_unlock(w, v);
+        VCLEAR(w, v);
+        unc0_pooldecref(p);
+        return uncl_thread_makeerr(w, e);
+    }
+    f->base.run = &unc0_futurerun;
+    f->pool = p;
+#endif
+    f->world = w->world;
+    f->kind = kind;
+    f->state = UNC_FUTURE_PENDING;
+    f->pinned = 0;
+    f->waiting = 0;
+    f->left = 0;
+    f->links = NULL;
+    f->fn = unc_opaqueboundvalue(w, v, UNC_FUTURE_FN);
+    f->arg = unc_opaqueboundvalue(w, v, UNC_FUTURE_ARG);
+    f->res = unc_opaqueboundvalue(w, v, UNC_FUTURE_RES);
+    f->pins = *unc_boundvalue(w, 3);
+    unc_unlock(w, v);
+    /* only future.new can be left pending by dropping every reference */
+    if (kind != UNC_FUTURE_MANUAL) {
+        Unc_Value key;
+        UNC_FUTUREKEY(&key, f);
+        e = unc0_dsetindx(w, LEFTOVER(Unc_Dict, VGETENT(&f->pins)), &key, v);
+        if (e) {
+            VCLEAR(w, v);
+            return e;
+        }
+        f->pinned = 1;
+    }
+    *out = f;
+    return 0;
+}
+
+static Unc_RetVal unc0_getfuture(Unc_View *w, Unc_Value *v,
+                                 struct unc_future **out) {
+    /* the argument keeps the future alive, so it need not stay locked */
+    Unc_RetVal e = unc0_verifyopaque_arg(w, v, unc_boundvalue(w, 0),
+                        NULL, (void **)out, 1, "thread.future");
+    if (!e) unc_unlock(w, v);
+    return e;
+}
+
+static int unc0_futuredone(struct unc_future *f) {
+    int d;
+    UNC_FUTURELOCK(f);
+    d = f->state != UNC_FUTURE_PENDING;
+    UNC_FUTUREUNLOCK(f);
+    return d;
+}
+
+/* *done is set to 0 if the timeout runs out first. an untimed wait helps
+   run tasks from the pool of the future in the meantime; a timed one does
+   not, since a task could take arbitrarily long */
+static Unc_RetVal unc0_futurewait(Unc_View *w, struct unc_future *f,
+                                  int timed, Unc_Float to, int *done) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    unc0_countdown cd;
+    struct unc_pool *p = f->pool;
+    struct unc_poolworker *self = unc0_poolself(p, w);
+    if (timed && unc0_countdownfirst(&cd))
+        return uncl_thread_makeerr(w, THREADFAIL);
+    for (;;) {
+        struct unc_pooltask *t;
+        Unc_Float wt = UNC_POOL_IDLEWAIT;
+        if ((*done = unc0_futuredone(f)))
+            return 0;
+        if (timed) {
+            if (unc0_countdownnext(&cd, &to))
+                return uncl_thread_makeerr(w, THREADFAIL);
+            if (to <= 0)
+                return 0;
+            if (to < wt)
+                wt = to;
+        }
+        t = timed ? NULL : unc0_pooltake(p, self);
+        if (t) {
+            (*t->run)(w, t);
+            continue;
+        }
+        unc_vmpause(w);
+        UNC_FUTURELOCK(f);
+        if (f->state == UNC_FUTURE_PENDING)
+            (void)unc_thrd_mon_waittimed(&f->mon, wt);
+        UNC_FUTUREUNLOCK(f);
+        e = unc_vmresume(w);
+        if (e) return e;
+    }
 #else
-    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+    /* everything else has already run, so nothing could settle f */
+    if ((*done = unc0_futuredone(f)) || timed)
+        return 0;
+    return unc_throwexc(w, "value",
+                        "waiting for a future that can never settle");
 #endif
 }
 
-static Unc_RetVal uncl_thread_thread_halt(
+static Unc_RetVal uncl_thread_submit(
                     Unc_View *w, Unc_Tuple args, void *udata) {
-#if UNCIL_MT_OK
     Unc_RetVal e;
-    struct unc_threadobj *thr;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&thr, 1, "thread.thread");
+    Unc_Value v = UNC_BLANK;
+    struct unc_future *f;
+    if (!unc_iscallable(w, &args.values[0]))
+        return unc_throwexc(w, "type", "function must be callable");
+    switch (unc_gettype(w, &args.values[1])) {
+    case Unc_TNull:
+    case Unc_TArray:
+        break;
+    default:
+        return unc_throwexc(w, "type", "arguments must be an array or null");
+    }
+    e = unc0_futurenew(w, &v, UNC_FUTURE_CALL, &args.values[2], &f);
     if (e) return e;
-
-    UNC_LOCKL(thr->lock);
-    if (!thr->f_run)
-        e = unc_throwexc(w, "value", "thread not started");
-    if (thr->f_detach)
-        e = unc_throwexc(w, "value", "thread not valid");
-    if (!e && !thr->f_done) unc0_haltview(thr->u.view);
-    UNC_UNLOCKL(thr->lock);
-    unc_unlock(w, &args.values[0]);
-    return e;
-#else
-    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
-#endif
+    VCOPY(w, f->fn, &args.values[0]);
+    if (unc_gettype(w, &args.values[1])) {
+        /* take a copy, in case the array is changed before the call */
+        Unc_Size i, n;
+        Unc_Value *a, *c;
+        e = unc_lockarray(w, &args.values[1], &n, &a);
+        if (!e) {
+            e = unc_newarray(w, f->arg, n, &c);
+            if (!e) {
+                for (i = 0; i < n; ++i)
+                    VCOPY(w, &c[i], &a[i]);
+                unc_unlock(w, f->arg);
+            }
+            unc_unlock(w, &args.values[1]);
+        }
+        if (e) {
+            Unc_Value exc = UNC_BLANK;
+            /* settle, so that the future gets unpinned */
+            unc_getexceptionfromcode(w, &exc, e);
+            (void)unc0_futuresettle(w, f, 1, &exc);
+            VCLEAR(w, &exc);
+            VCLEAR(w, &v);
+            return e;
+        }
+    }
+    unc0_futurelaunch(w, f);
+    return unc_returnlocal(w, 0, &v);
 }
 
-static Unc_RetVal uncl_thread_thread_hasfinished(
+static Unc_RetVal uncl_thread_future_new(
                     Unc_View *w, Unc_Tuple args, void *udata) {
-#if UNCIL_MT_OK
     Unc_RetVal e;
     Unc_Value v = UNC_BLANK;
-    struct unc_threadobj *thr;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&thr, 1, "thread.thread");
-    if (e) return e;
-
-    UNC_LOCKL(thr->lock);
-    if (thr->f_detach)
-        e = unc_throwexc(w, "value", "thread not valid");
-    unc_setbool(w, &v, thr->f_done);
-    UNC_UNLOCKL(thr->lock);
-    unc_unlock(w, &args.values[0]);
+    struct unc_future *f;
+    e = unc0_futurenew(w, &v, UNC_FUTURE_MANUAL, &args.values[0], &f);
     return unc_returnlocal(w, e, &v);
-#else
-    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
-#endif
 }
 
-static Unc_RetVal uncl_thread_lock_new(
+static Unc_RetVal uncl_thread_future_done(
                     Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
     Unc_Value v = UNC_BLANK;
-    struct unc_thrd_lock *lock;
-    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
-                        sizeof(struct unc_thrd_lock), (void **)&lock,
-                        &unc0_thread_lock_destr, 0, NULL, 0, NULL);
+    struct unc_future *f;
+    e = unc0_getfuture(w, &args.values[0], &f);
     if (e) return e;
-    e = unc_thrd_lock_new(lock);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &v);
-    return unc_returnlocal(w, e, &v);
+    unc_setbool(w, &v, unc0_futuredone(f));
+    return unc_push(w, 1, &v);
 }
 
-static Unc_RetVal uncl_thread_lock_acquire(
+static Unc_RetVal uncl_thread_future_wait(
                     Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
-    struct unc_thrd_lock *lock;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&lock, 1, "thread.lock");
+    struct unc_future *f;
+    int done;
+    e = unc0_getfuture(w, &args.values[0], &f);
     if (e) return e;
-    unc_vmpause(w);
-    e = unc_thrd_lock_acquire(lock);
-    unc_vmresume(w);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
-    return e;
+    e = unc0_futurewait(w, f, 0, 0, &done);
+    if (e) return e;
+    if (f->state == UNC_FUTURE_FAILED)
+        return unc_throw(w, f->res);
+    return unc_push(w, 1, f->res);
 }
 
-static Unc_RetVal uncl_thread_lock_acquiretimed(
+static Unc_RetVal uncl_thread_future_waittimed(
                     Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
     Unc_Float to;
-    struct unc_thrd_lock *lock;
+    struct unc_future *f;
+    int done;
     e = unc_getfloat(w, &args.values[1], &to);
     if (e) return e;
     if (to < 0)
         return unc_throwexc(w, "value", "timeout cannot be negative");
     if (!unc0_fisfinite(to))
         return unc_throwexc(w, "value", "timeout must be finite");
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&lock, 1, "thread.lock");
+    e = unc0_getfuture(w, &args.values[0], &f);
     if (e) return e;
-    unc_vmpause(w);
-    e = unc_thrd_lock_acquiretimed(lock, to);
-    unc_vmresume(w);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
-    return e;
-}
-
-static Unc_RetVal uncl_thread_lock_release(
-                    Unc_View *w, Unc_Tuple args, void *udata) {
-    Unc_RetVal e;
-    struct unc_thrd_lock *lock;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&lock, 1, "thread.lock");
+    e = unc0_futurewait(w, f, 1, to, &done);
     if (e) return e;
-    e = unc_thrd_lock_release(lock);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
-    return e;
+    unc_setbool(w, &v, done);
+    return unc_push(w, 1, &v);
 }
 
-static Unc_RetVal uncl_thread_rlock_new(
+static Unc_RetVal uncl_thread_future_chain(
                     Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
     Unc_Value v = UNC_BLANK;
-    struct unc_thrd_rlock *rlock;
-    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
-                        sizeof(struct unc_thrd_rlock), (void **)&rlock,
-                        &unc0_thread_rlock_destr, 0, NULL, 0, NULL);
+    struct unc_future *s, *t;
+    e = unc0_getfuture(w, &args.values[0], &s);
     if (e) return e;
-    e = unc_thrd_rlock_new(rlock);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &v);
-    return unc_returnlocal(w, e, &v);
-}
-
-static Unc_RetVal uncl_thread_rlock_acquire(
-                    Unc_View *w, Unc_Tuple args, void *udata) {
-    Unc_RetVal e;
-    struct unc_thrd_rlock *rlock;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&rlock, 1, "thread.rlock");
+    if (!unc_iscallable(w, &args.values[1]))
+        return unc_throwexc(w, "type", "function must be callable");
+    e = unc0_futurenew(w, &v, UNC_FUTURE_THEN, &args.values[2], &t);
     if (e) return e;
-    unc_vmpause(w);
-    e = unc_thrd_rlock_acquire(rlock);
-    unc_vmresume(w);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
-    return e;
+    VCOPY(w, t->fn, &args.values[1]);
+    t->waiting = t->left = 1;
+    unc0_futurelink(w, s, t, 0);
+    return unc_returnlocal(w, 0, &v);
 }
 
-static Unc_RetVal uncl_thread_rlock_acquiretimed(
-                    Unc_View *w, Unc_Tuple args, void *udata) {
+static Unc_RetVal uncl_thread_future_settle(Unc_View *w, Unc_Tuple args,
+                                            int failed) {
     Unc_RetVal e;
-    Unc_Float to;
-    struct unc_thrd_rlock *rlock;
-    e = unc_getfloat(w, &args.values[1], &to);
-    if (e) return e;
-    if (to < 0)
-        return unc_throwexc(w, "value", "timeout cannot be negative");
-    if (!unc0_fisfinite(to))
-        return unc_throwexc(w, "value", "timeout must be finite");
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&rlock, 1, "thread.rlock");
+    struct unc_future *f;
+    e = unc0_getfuture(w, &args.values[0], &f);
     if (e) return e;
-    unc_vmpause(w);
-    e = unc_thrd_rlock_acquiretimed(rlock, to);
-    unc_vmresume(w);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
-    return e;
+    if (f->kind != UNC_FUTURE_MANUAL)
+        return unc_throwexc(w, "value",
+                    "only futures made with future.new can be settled");
+    if (!unc0_futuresettle(w, f, failed, &args.values[1]))
+        return unc_throwexc(w, "value", "future has already been settled");
+    return 0;
 }
 
-static Unc_RetVal uncl_thread_rlock_release(
+static Unc_RetVal uncl_thread_future_resolve(
                     Unc_View *w, Unc_Tuple args, void *udata) {
-    Unc_RetVal e;
-    struct unc_thrd_rlock *rlock;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&rlock, 1, "thread.rlock");
-    if (e) return e;
-    e = unc_thrd_rlock_release(rlock);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
-    return e;
+    return uncl_thread_future_settle(w, args, 0);
 }
 
-static Unc_RetVal uncl_thread_sem_new(
+static Unc_RetVal uncl_thread_future_reject(
                     Unc_View *w, Unc_Tuple args, void *udata) {
-    Unc_RetVal e;
-    Unc_Value v = UNC_BLANK;
-    Unc_Int ui;
-    struct unc_thrd_sem *sem;
-    e = unc_getint(w, &args.values[0], &ui);
-    if (e) return e;
-    if (ui < 0) return unc_throwexc(w, "value",
-                    "semaphore may not be initialized with a negative value");
-    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
-                        sizeof(struct unc_thrd_sem), (void **)&sem,
-                        &unc0_thread_sem_destr, 0, NULL, 0, NULL);
-    if (e) return e;
-    e = unc_thrd_sem_new(sem, ui);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &v);
-    return unc_returnlocal(w, e, &v);
+    return uncl_thread_future_settle(w, args, 1);
 }
 
-static Unc_RetVal uncl_thread_sem_acquire(
-                    Unc_View *w, Unc_Tuple args, void *udata) {
+/* common to all and any */
+static Unc_RetVal uncl_thread_future_combine(Unc_View *w, Unc_Tuple args,
+                                             int kind) {
     Unc_RetVal e;
-    Unc_Int ui;
-    struct unc_thrd_sem *sem;
-    if (unc_gettype(w, &args.values[1]))
-        e = unc_getint(w, &args.values[1], &ui);
-    else
-        e = 0, ui = 1;
-    if (e) return e;
-    if (ui < 0) return unc_throwexc(w, "value",
-                    "may not acquire a semaphore a negative number of times");
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&sem, 1, "thread.semaphore");
+    Unc_Allocator *alloc = &w->world->alloc;
+    Unc_Value vin = UNC_BLANK, v = UNC_BLANK, null = UNC_BLANK;
+    Unc_Size i, n;
+    Unc_Value *a, *in;
+    struct unc_future **src, *t;
+    if (unc_gettype(w, &args.values[0]) != Unc_TArray)
+        return unc_throwexc(w, "type", "futures must be given in an array");
+    /* take a snapshot and keep it on the stack, so that the futures stay
+       alive until they have been linked */
+    e = unc_lockarray(w, &args.values[0], &n, &a);
     if (e) return e;
-    unc_vmpause(w);
-    e = unc_thrd_sem_acquire(sem, ui);
-    unc_vmresume(w);
-    if (e) e = uncl_thread_makeerr(w, e);
+    if (!n && kind == UNC_FUTURE_ANY) {
+        unc_unlock(w, &args.values[0]);
+        return unc_throwexc(w, "value", "any needs at least one future");
+    }
+    e = unc_newarray(w, &vin, n, &in);
+    if (e) {
+        unc_unlock(w, &args.values[0]);
+        return e;
+    }
+    for (i = 0; i < n; ++i)
+        VCOPY(w, &in[i], &a[i]);
     unc_unlock(w, &args.values[0]);
-    return e;
+    unc_unlock(w, &vin);
+    e = unc_push(w, 1, &vin);
+    VCLEAR(w, &vin);
+    if (e) return e;
+    src = TMALLOC(struct unc_future *, alloc, Unc_AllocLibrary, n + 1);
+    if (!src) return UNCIL_ERR_MEM;
+    for (i = 0; i < n; ++i) {
+        e = unc0_verifyopaque(w, &in[i], unc_boundvalue(w, 0), NULL,
+                    (void **)&src[i], "array contains a non-future");
+        if (e) break;
+        unc_unlock(w, &in[i]);
+    }
+    if (!e) e = unc0_futurenew(w, &v, kind, &null, &t);
+    if (!e && kind == UNC_FUTURE_ALL) {
+        Unc_Value *r;
+        e = unc_newarray(w, t->arg, n, &r);
+        if (!e)
+            unc_unlock(w, t->arg);
+        else {
+            Unc_Value exc = UNC_BLANK;
+            unc_getexceptionfromcode(w, &exc, e);
+            (void)unc0_futuresettle(w, t, 1, &exc);
+            VCLEAR(w, &exc);
+            VCLEAR(w, &v);
+        }
+    }
+    if (!e) {
+        t->waiting = t->left = n;
+        if (!n) (void)unc0_futuresettle(w, t, 0, t->arg);
+        for (i = 0; i < n; ++i)
+            unc0_futurelink(w, src[i], t, i);
+    }
+    TMFREE(struct unc_future *, alloc, src, n + 1);
+    if (e) return e;
+    unc_pop(w, 1);
+    return unc_returnlocal(w, 0, &v);
 }
 
-static Unc_RetVal uncl_thread_sem_acquiretimed(
+static Unc_RetVal uncl_thread_future_all(
                     Unc_View *w, Unc_Tuple args, void *udata) {
-    Unc_RetVal e;
-    Unc_Int ui;
-    Unc_Float to;
-    struct unc_thrd_sem *sem;
-    if (unc_gettype(w, &args.values[2]))
-        e = unc_getint(w, &args.values[2], &ui);
-    else
-        e = 0, ui = 1;
-    if (e) return e;
-    if (ui < 0) return unc_throwexc(w, "value",
-                    "may not acquire a semaphore a negative number of times");
-    e = unc_getfloat(w, &args.values[1], &to);
-    if (e) return e;
-    if (to < 0)
-        return unc_throwexc(w, "value", "timeout cannot be negative");
-    if (!unc0_fisfinite(to))
-        return unc_throwexc(w, "value", "timeout must be finite");
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&sem, 1, "thread.semaphore");
-    if (e) return e;
-    unc_vmpause(w);
-    e = unc_thrd_sem_acquiretimed(sem, ui, to);
-    unc_vmresume(w);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
-    return e;
+    return uncl_thread_future_combine(w, args, UNC_FUTURE_ALL);
 }
 
-static Unc_RetVal uncl_thread_sem_release(
+static Unc_RetVal uncl_thread_future_any(
                     Unc_View *w, Unc_Tuple args, void *udata) {
-    Unc_RetVal e;
-    Unc_Int ui;
-    struct unc_thrd_sem *sem;
-    if (unc_gettype(w, &args.values[1]))
-        e = unc_getint(w, &args.values[1], &ui);
-    else
-        e = 0, ui = 1;
-    if (e) return e;
-    if (ui < 0) return unc_throwexc(w, "value",
-                    "may not release a semaphore a negative number of times");
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&sem, 1, "thread.semaphore");
-    if (e) return e;
-    e = unc_thrd_sem_release(sem, ui);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
-    return e;
+    return uncl_thread_future_combine(w, args, UNC_FUTURE_ANY);
 }
 
-static Unc_RetVal uncl_thread_mon_new(
+static Unc_RetVal uncl_thread_chan_new(
                     Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
     Unc_Value v = UNC_BLANK;
-    struct unc_thrd_mon *mon;
-    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
-                        sizeof(struct unc_thrd_mon), (void **)&mon,
-                        &unc0_thread_mon_destr, 1, NULL, 0, NULL);
-    if (e) return e;
+    Unc_Allocator *alloc = &w->world->alloc;
+    Unc_Size i, cap = 0;
+    struct unc_channel *c;
     if (unc_gettype(w, &args.values[0])) {
-        void *lock;
-        e = unc0_verifyopaque(w, &args.values[0], unc_boundvalue(w, 2),
-                        NULL, (void **)&lock, NULL);
-        if (!e) {
-            e = unc_thrd_mon_new_rlock(mon, (struct unc_thrd_rlock *)lock);
-        } else {
-            e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 1),
-                            NULL, (void **)&lock, 1, "lock");
-            if (e) return e;
-            e = unc_thrd_mon_new_lock(mon, (struct unc_thrd_lock *)lock);
+        Unc_Int ui;
+        e = unc_getint(w, &args.values[0], &ui);
+        if (e) return e;
+        if (ui < 1)
+            return unc_throwexc(w, "value",
+                                "channel capacity must be positive");
+        cap = (Unc_Size)ui;
+    }
+    e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
+                        sizeof(struct unc_channel), (void **)&c,
+                        &unc0_thread_chan_destr, 1, NULL, 0, NULL);
+    if (e) return e;
+    c->world = NULL;
+    c->capacity = cap;
+    c->size = cap ? cap : UNC_CHANNEL_MINSIZE;
+    c->bufv = unc_opaqueboundvalue(w, &v, UNC_CHANNEL_BUF);
+    c->seq = NULL;
+    c->waiters = NULL;
+    c->waitersn = c->waitersc = 0;
+    ATOMICLSET(c->head, 0);
+    ATOMICLSET(c->tail, 0);
+    ATOMICLSET(c->turn, 0);
+    ATOMICLSET(c->nwaiters, 0);
+    ATOMICSSET(c->closed, 0);
+    if (cap) {
+        c->seq = TMALLOC(Unc_AtomicLarge, alloc, Unc_AllocLibrary, cap);
+        if (!c->seq) {
+            e = UNCIL_ERR_MEM;
+            goto uncl_thread_chan_new_fail0;
         }
-        unc_copy(w, unc_opaqueboundvalue(w, &v, 0), &args.values[0]);
-    } else
-        e = unc_thrd_mon_new(mon);
-    if (e) e = uncl_thread_makeerr(w, e);
+        for (i = 0; i < cap; ++i)
+            ATOMICLSET(c->seq[i], 2 * i);
+    }
+    e = unc_newarray(w, c->bufv, c->size, &c->buf);
+    if (e) goto uncl_thread_chan_new_fail1;
+    unc_unlock(w, c->bufv);
+#if UNCIL_MT_OK
+    ATOMICLSET(c->sendwait, 0);
+    e = unc_thrd_mon_new(&c->mon);
+    if (e) {
+        e = uncl_thread_makeerr(w, e);
+        goto uncl_thread_chan_new_fail1;
+    }
+#endif
+    if (UNC_LOCKINITL(c->lock)) {
+        e = uncl_thread_makeerr(w, THREADFAIL);
+        goto uncl_thread_chan_new_fail2;
+    }
+    if (UNC_LOCKINITL(c->wlock)) {
+        e = uncl_thread_makeerr(w, THREADFAIL);
+        goto uncl_thread_chan_new_fail3;
+    }
+    c->world = w->world;
     unc_unlock(w, &v);
-    return unc_returnlocal(w, e, &v);
+    return unc_returnlocal(w, 0, &v);
+uncl_thread_chan_new_fail3:
+    UNC_LOCKFINAL(c->lock);
+uncl_thread_chan_new_fail2:
+#if UNCIL_MT_OK
+    unc_thrd_mon_free(&c->mon);
+#endif
+uncl_thread_chan_new_fail1:
+    unc0_tmfree(alloc, (void *)c->seq, sizeof(Unc_AtomicLarge), cap);
+uncl_thread_chan_new_fail0:
+    unc_unlock(w, &v);
+    VCLEAR(w, &v);
+    return e;
 }
 
-static Unc_RetVal uncl_thread_mon_acquire(
+static Unc_RetVal unc0_getchannel(Unc_View *w, Unc_Value *v,
+                                  struct unc_channel **out) {
+    /* the argument keeps the channel alive, so it need not stay locked */
+    Unc_RetVal e = unc0_verifyopaque_arg(w, v, unc_boundvalue(w, 0),
+                        NULL, (void **)out, 1, "thread.channel");
+    if (!e) unc_unlock(w, v);
+    return e;
+}
+
+static Unc_RetVal uncl_thread_chan_send(
                     Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
-    struct unc_thrd_mon *mon;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&mon, 1, "thread.monitor");
+    struct unc_channel *c;
+    int sent;
+    e = unc0_getchannel(w, &args.values[0], &c);
     if (e) return e;
-    unc_vmpause(w);
-    e = unc_thrd_mon_acquire(mon);
-    unc_vmresume(w);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
-    return e;
+    return unc0_chansend(w, c, &args.values[1], 0, 0, &sent);
 }
 
-static Unc_RetVal uncl_thread_mon_acquiretimed(
+static Unc_RetVal uncl_thread_chan_sendtimed(
                     Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
+    Unc_Value v = UNC_BLANK;
     Unc_Float to;
-    struct unc_thrd_mon *mon;
-    e = unc_getfloat(w, &args.values[1], &to);
+    struct unc_channel *c;
+    int sent;
+    e = unc_getfloat(w, &args.values[2], &to);
     if (e) return e;
     if (to < 0)
         return unc_throwexc(w, "value", "timeout cannot be negative");
     if (!unc0_fisfinite(to))
         return unc_throwexc(w, "value", "timeout must be finite");
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&mon, 1, "thread.monitor");
+    e = unc0_getchannel(w, &args.values[0], &c);
     if (e) return e;
-    unc_vmpause(w);
-    e = unc_thrd_mon_acquiretimed(mon, to);
-    unc_vmresume(w);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
-    return e;
+    e = unc0_chansend(w, c, &args.values[1], 1, to, &sent);
+    if (e) return e;
+    unc_setbool(w, &v, sent);
+    return unc_push(w, 1, &v);
 }
 
-static Unc_RetVal uncl_thread_mon_release(
+/* pushes value, ok */
+static Unc_RetVal uncl_thread_chan_recv_(Unc_View *w, Unc_Tuple args,
+                                         int timed) {
+    Unc_RetVal e;
+    Unc_Value v[2] = UNC_BLANKS;
+    Unc_Float to = 0;
+    Unc_Size i;
+    struct unc_channel *c;
+    int ok;
+    if (timed) {
+        e = unc_getfloat(w, &args.values[1], &to);
+        if (e) return e;
+        if (to < 0)
+            return unc_throwexc(w, "value", "timeout cannot be negative");
+        if (!unc0_fisfinite(to))
+            return unc_throwexc(w, "value", "timeout must be finite");
+    }
+    e = unc0_getchannel(w, &args.values[0], &c);
+    if (e) return e;
+    e = unc0_chanselect(w, 1, &c, timed, to, &i, &v[0], &ok);
+    if (e) return e;
+    unc_setbool(w, &v[1], ok);
+    return unc_returnlocalarray(w, 0, 2, v);
+}
+
+static Unc_RetVal uncl_thread_chan_recv(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    return uncl_thread_chan_recv_(w, args, 0);
+}
+
+static Unc_RetVal uncl_thread_chan_recvtimed(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    return uncl_thread_chan_recv_(w, args, 1);
+}
+
+static Unc_RetVal uncl_thread_chan_close(
                     Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
-    struct unc_thrd_mon *mon;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&mon, 1, "thread.monitor");
+    struct unc_channel *c;
+    e = unc0_getchannel(w, &args.values[0], &c);
     if (e) return e;
-    e = unc_thrd_mon_release(mon);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
-    return e;
+    unc0_chanclose(c);
+    return 0;
 }
 
-static Unc_RetVal uncl_thread_mon_wait(
+static Unc_RetVal uncl_thread_chan_closed(
                     Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
-    struct unc_thrd_mon *mon;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&mon, 1, "thread.monitor");
+    Unc_Value v = UNC_BLANK;
+    struct unc_channel *c;
+    e = unc0_getchannel(w, &args.values[0], &c);
     if (e) return e;
-    unc_vmpause(w);
-    e = unc_thrd_mon_wait(mon);
-    unc_vmresume(w);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
-    return e;
+    unc_setbool(w, &v, c->closed);
+    return unc_push(w, 1, &v);
 }
 
-static Unc_RetVal uncl_thread_mon_waittimed(
+static Unc_RetVal uncl_thread_chan_count(
                     Unc_View *w, Unc_Tuple args, void *udata) {
     Unc_RetVal e;
-    Unc_Float to;
-    struct unc_thrd_mon *mon;
-    e = unc_getfloat(w, &args.values[1], &to);
+    Unc_Value v = UNC_BLANK;
+    struct unc_channel *c;
+    e = unc0_getchannel(w, &args.values[0], &c);
     if (e) return e;
-    if (to < 0)
-        return unc_throwexc(w, "value", "timeout cannot be negative");
-    if (!unc0_fisfinite(to))
-        return unc_throwexc(w, "value", "timeout must be finite");
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&mon, 1, "thread.monitor");
+    unc_setint(w, &v, (Unc_Int)unc0_chancount(c));
+    return unc_push(w, 1, &v);
+}
+
+static Unc_RetVal uncl_thread_chan_select(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_RetVal e;
+    Unc_Allocator *alloc = &w->world->alloc;
+    Unc_Value vin = UNC_BLANK, v[3] = UNC_BLANKS;
+    Unc_Float to = 0;
+    Unc_Size i, n;
+    Unc_Value *a, *in;
+    struct unc_channel **cs;
+    int timed = 0, ok;
+    if (unc_gettype(w, &args.values[0]) != Unc_TArray)
+        return unc_throwexc(w, "type", "channels must be given in an array");
+    if (unc_gettype(w, &args.values[1])) {
+        e = unc_getfloat(w, &args.values[1], &to);
+        if (e) return e;
+        if (to < 0)
+            return unc_throwexc(w, "value", "timeout cannot be negative");
+        if (!unc0_fisfinite(to))
+            return unc_throwexc(w, "value", "timeout must be finite");
+        timed = 1;
+    }
+    /* take a snapshot and keep it on the stack, so that the channels stay
+       alive while we wait */
+    e = unc_lockarray(w, &args.values[0], &n, &a);
     if (e) return e;
-    unc_vmpause(w);
-    e = unc_thrd_mon_waittimed(mon, to);
-    unc_vmresume(w);
-    if (e) e = uncl_thread_makeerr(w, e);
+    if (!n) {
+        unc_unlock(w, &args.values[0]);
+        return unc_throwexc(w, "value", "select needs at least one channel");
+    }
+    e = unc_newarray(w, &vin, n, &in);
+    if (e) {
+        unc_unlock(w, &args.values[0]);
+        return e;
+    }
+    for (i = 0; i < n; ++i)
+        VCOPY(w, &in[i], &a[i]);
     unc_unlock(w, &args.values[0]);
-    return e;
+    unc_unlock(w, &vin);
+    e = unc_push(w, 1, &vin);
+    VCLEAR(w, &vin);
+    if (e) return e;
+    cs = TMALLOC(struct unc_channel *, alloc, Unc_AllocLibrary, n);
+    if (!cs) return UNCIL_ERR_MEM;
+    for (i = 0; i < n; ++i) {
+        e = unc0_verifyopaque(w, &in[i], unc_boundvalue(w, 0), NULL,
+                    (void **)&cs[i], "array contains a non-channel");
+        if (e) break;
+        unc_unlock(w, &in[i]);
+    }
+    if (!e) e = unc0_chanselect(w, n, cs, timed, to, &i, &v[1], &ok);
+    TMFREE(struct unc_channel *, alloc, cs, n);
+    if (e) return e;
+    unc_pop(w, 1);
+    if (i < n) unc_setint(w, &v[0], (Unc_Int)i);
+    unc_setbool(w, &v[2], i < n && ok);
+    return unc_returnlocalarray(w, 0, 3, v);
 }
 
-static Unc_RetVal uncl_thread_mon_notify(
+static Unc_RetVal uncl_thread_actor_new(
                     Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
     Unc_RetVal e;
-    Unc_Int ui;
-    struct unc_thrd_mon *mon;
-    if (unc_gettype(w, &args.values[1]))
-        e = unc_getint(w, &args.values[1], &ui);
-    else
-        e = 0, ui = 1;
-    if (e) return e;
-    if (ui < 0) return unc_throwexc(w, "value",
-                "may not try to notify a monitor a negative number of times");
-    if (ui == 0) return 0;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&mon, 1, "thread.monitor");
+    Unc_Value v = UNC_BLANK;
+    Unc_Alloc fn = w->world->alloc.fn;
+    void *fndata = w->world->alloc.data;
+    const char *path;
+    struct unc_actor *a;
+    struct unc_actorref *r;
+    Unc_View *zw;
+    e = unc_getstringc(w, &args.values[0], &path);
     if (e) return e;
-    e = unc_thrd_mon_notify(mon, ui);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
+    a = (*fn)(fndata, Unc_AllocLibrary, 0, sizeof(struct unc_actor), NULL);
+    if (!a) return UNCIL_ERR_MEM;
+    a->alloc = fn;
+    a->allocdata = fndata;
+    a->inbox.head = a->inbox.tail = NULL;
+    a->outbox.head = a->outbox.tail = NULL;
+    a->inbox.closed = a->outbox.closed = 0;
+    ATOMICLSET(a->refs, 1);
+    ATOMICSSET(a->done, 0);
+    e = unc_thrd_mon_new(&a->mon);
+    if (e) {
+        (void)(*fn)(fndata, Unc_AllocLibrary, sizeof(struct unc_actor), 0, a);
+        return uncl_thread_makeerr(w, e);
+    }
+    zw = a->view = unc_createex(fn, fndata, w->world->mmask);
+    if (!zw) {
+        e = UNCIL_ERR_MEM;
+        goto uncl_thread_actor_new_fail;
+    }
+    e = unc0_actorsetup(w, zw, a);
+    if (!e) {
+        e = unc_loadfileauto(zw, path);
+        if (e == UNCIL_ERR_IO_GENERIC)
+            e = unc_throwexc(w, "io", "could not open actor script");
+    }
+    if (!e) e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
+                        sizeof(struct unc_actorref), (void **)&r,
+                        &unc0_thread_actor_destr, 0, NULL, 0, NULL);
+    if (e) goto uncl_thread_actor_new_fail;
+    r->actor = a;
+    r->child = 0;
+    unc_unlock(w, &v);
+    ATOMICLINC(a->refs);
+    e = unc_thrd_worker_start(&a->t, &unc0_actorrun, a);
+    if (e) {
+        ATOMICLDEC(a->refs);
+        a->view = NULL;
+        unc_destroy(zw);
+        VCLEAR(w, &v);
+        return uncl_thread_makeerr(w, e);
+    }
+    return unc_returnlocal(w, 0, &v);
+uncl_thread_actor_new_fail:
+    if (zw) unc_destroy(zw);
+    a->view = NULL;
+    unc0_actordecref(a);
     return e;
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
 }
 
-static Unc_RetVal uncl_thread_mon_notifyall(
+static Unc_RetVal uncl_thread_actor_parent(
                     Unc_View *w, Unc_Tuple args, void *udata) {
+    Unc_Value v = UNC_BLANK;
+#if UNCIL_MT_OK
     Unc_RetVal e;
-    struct unc_thrd_mon *mon;
-    e = unc0_verifyopaque_arg(w, &args.values[0], unc_boundvalue(w, 0),
-                    NULL, (void **)&mon, 1, "thread.monitor");
-    if (e) return e;
-    e = unc_thrd_mon_notifyall(mon);
-    if (e) e = uncl_thread_makeerr(w, e);
-    unc_unlock(w, &args.values[0]);
+    struct unc_actorref *r;
+    struct unc_actor *a = unc0_actorself(w);
+    if (a) {
+        e = unc_newopaque(w, &v, unc_boundvalue(w, 0),
+                          sizeof(struct unc_actorref), (void **)&r,
+                          &unc0_thread_actor_destr, 0, NULL, 0, NULL);
+        if (e) return e;
+        ATOMICLINC(a->refs);
+        r->actor = a;
+        r->child = 1;
+        unc_unlock(w, &v);
+    }
+#endif
+    return unc_returnlocal(w, 0, &v);
+}
+
+#if UNCIL_MT_OK
+static Unc_RetVal unc0_getactor(Unc_View *w, Unc_Value *v,
+                                struct unc_actorref **out) {
+    /* the argument keeps the actor alive, so it need not stay locked */
+    Unc_RetVal e = unc0_verifyopaque_arg(w, v, unc_boundvalue(w, 0),
+                        NULL, (void **)out, 1, "thread.actor");
+    if (!e) unc_unlock(w, v);
     return e;
 }
 
-static Unc_RetVal uncl_thread_sleep(
+/* mailbox that the holder of r sends to */
+INLINE struct unc_mailbox *unc0_actorsendbox(struct unc_actorref *r) {
+    return r->child ? &r->actor->outbox : &r->actor->inbox;
+}
+
+/* mailbox that the holder of r receives from */
+INLINE struct unc_mailbox *unc0_actorrecvbox(struct unc_actorref *r) {
+    return r->child ? &r->actor->inbox : &r->actor->outbox;
+}
+#endif
+
+static Unc_RetVal uncl_thread_actor_send(
                     Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
     Unc_RetVal e;
-    Unc_Float to;
-    e = unc_getfloat(w, &args.values[0], &to);
+    struct unc_actorref *r;
+    e = unc0_getactor(w, &args.values[0], &r);
     if (e) return e;
-    if (to < 0)
-        return unc_throwexc(w, "value", "sleep time cannot be negative");
-    if (!unc0_fisfinite(to))
-        return unc_throwexc(w, "value", "sleep time must be finite");
-    unc_vmpause(w);
-    e = unc_thrd_sleep(to);
-    unc_vmresume(w);
-    return e;
+    return unc0_actorsend(w, r->actor, unc0_actorsendbox(r),
+                          &args.values[1], 0);
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
 }
 
-static Unc_RetVal uncl_thread_yield(
+static Unc_RetVal uncl_thread_actor_sendmove(
                     Unc_View *w, Unc_Tuple args, void *udata) {
-    unc_vmpause(w);
-    UNC_YIELD();
-    unc_vmresume(w);
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    struct unc_actorref *r;
+    e = unc0_getactor(w, &args.values[0], &r);
+    if (e) return e;
+    return unc0_actorsend(w, r->actor, unc0_actorsendbox(r),
+                          &args.values[1], 1);
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
+}
+
+/* pushes value, ok */
+static Unc_RetVal uncl_thread_actor_recv_(Unc_View *w, Unc_Tuple args,
+                                          int timed) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    Unc_Value v[2] = UNC_BLANKS;
+    Unc_Float to = 0;
+    struct unc_actorref *r;
+    int ok;
+    if (timed) {
+        e = unc_getfloat(w, &args.values[1], &to);
+        if (e) return e;
+        if (to < 0)
+            return unc_throwexc(w, "value", "timeout cannot be negative");
+        if (!unc0_fisfinite(to))
+            return unc_throwexc(w, "value", "timeout must be finite");
+    }
+    e = unc0_getactor(w, &args.values[0], &r);
+    if (e) return e;
+    e = unc0_actorrecv(w, r->actor, unc0_actorrecvbox(r),
+                       timed, to, &v[0], &ok);
+    if (e) return e;
+    unc_setbool(w, &v[1], ok);
+    return unc_returnlocalarray(w, 0, 2, v);
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
+}
+
+static Unc_RetVal uncl_thread_actor_recv(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    return uncl_thread_actor_recv_(w, args, 0);
+}
+
+static Unc_RetVal uncl_thread_actor_recvtimed(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+    return uncl_thread_actor_recv_(w, args, 1);
+}
+
+static Unc_RetVal uncl_thread_actor_close(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    struct unc_actorref *r;
+    e = unc0_getactor(w, &args.values[0], &r);
+    if (e) return e;
+    unc0_actorclose(r->actor, unc0_actorsendbox(r));
     return 0;
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
+}
+
+static Unc_RetVal uncl_thread_actor_join(
+                    Unc_View *w, Unc_Tuple args, void *udata) {
+#if UNCIL_MT_OK
+    Unc_RetVal e;
+    struct unc_actorref *r;
+    e = unc0_getactor(w, &args.values[0], &r);
+    if (e) return e;
+    if (r->child)
+        return unc_throwexc(w, "value", "an actor cannot join its parent");
+    return unc0_actorjoin(w, r->actor);
+#else
+    return UNCIL_ERR_LOGIC_NOTSUPPORTED;
+#endif
 }
 
 static Unc_RetVal uncl_thread_setup_acq_rel(Unc_View *w,
@@ -1648,6 +4747,84 @@ static const Unc_ModuleCFunc lib_sem[] = {
     { FNsem(acquiretimed),      2, 1, 0, UNC_CFUNC_CONCURRENT },
 };
 
+#define FNrwlock(x) &uncl_thread_rwlock_##x, #x
+static const Unc_ModuleCFunc lib_rwlock[] = {
+    { FNrwlock(new),                0, 1, 0, UNC_CFUNC_CONCURRENT },
+    { FNrwlock(acquireread),        1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNrwlock(acquirereadtimed),   2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNrwlock(acquirewrite),       1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNrwlock(acquirewritetimed),  2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNrwlock(release),            1, 0, 0, UNC_CFUNC_CONCURRENT },
+};
+
+#define FNatomic(x) &uncl_thread_atomic_##x, #x
+static const Unc_ModuleCFunc lib_atomic[] = {
+    { FNatomic(new),            0, 1, 0, UNC_CFUNC_CONCURRENT },
+    { FNatomic(load),           1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNatomic(store),          2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNatomic(add),            1, 1, 0, UNC_CFUNC_CONCURRENT },
+    { FNatomic(swap),           2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNatomic(cas),            3, 0, 0, UNC_CFUNC_CONCURRENT },
+};
+
+#define FNctable(x) &uncl_thread_ctable_##x, #x
+static const Unc_ModuleCFunc lib_ctable[] = {
+    { FNctable(new),            0, 1, 0, UNC_CFUNC_CONCURRENT },
+    { FNctable(get),            2, 1, 0, UNC_CFUNC_CONCURRENT },
+    { FNctable(has),            2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNctable(set),            3, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNctable(remove),         2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNctable(getorset),       3, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNctable(compute),        3, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNctable(length),         1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNctable(totable),        1, 0, 0, UNC_CFUNC_CONCURRENT },
+};
+
+#define FNpool(x) &uncl_thread_pool_##x, #x
+static const Unc_ModuleCFunc lib_pool[] = {
+    { FNpool(new),              0, 1, 0, UNC_CFUNC_CONCURRENT },
+    { FNpool(size),             1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNpool(shutdown),         1, 0, 0, UNC_CFUNC_CONCURRENT },
+};
+
+#define FNfuture(x) &uncl_thread_future_##x, #x
+static const Unc_ModuleCFunc lib_future[] = {
+    { FNfuture(new),            0, 1, 0, UNC_CFUNC_CONCURRENT },
+    { FNfuture(done),           1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNfuture(wait),           1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNfuture(waittimed),      2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNfuture(chain),          2, 1, 0, UNC_CFUNC_CONCURRENT },
+    { FNfuture(resolve),        2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNfuture(reject),         2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNfuture(all),            1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNfuture(any),            1, 0, 0, UNC_CFUNC_CONCURRENT },
+};
+
+#define FNchan(x) &uncl_thread_chan_##x, #x
+static const Unc_ModuleCFunc lib_chan[] = {
+    { FNchan(new),              0, 1, 0, UNC_CFUNC_CONCURRENT },
+    { FNchan(send),             2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNchan(sendtimed),        3, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNchan(recv),             1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNchan(recvtimed),        2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNchan(close),            1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNchan(closed),           1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNchan(count),            1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNchan(select),           1, 1, 0, UNC_CFUNC_CONCURRENT },
+};
+
+#define FNactor(x) &uncl_thread_actor_##x, #x
+static const Unc_ModuleCFunc lib_actor[] = {
+    { FNactor(close),           1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNactor(join),            1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNactor(new),             1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNactor(parent),          0, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNactor(recv),            1, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNactor(recvtimed),       2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNactor(send),            2, 0, 0, UNC_CFUNC_CONCURRENT },
+    { FNactor(sendmove),        2, 0, 0, UNC_CFUNC_CONCURRENT },
+};
+
 #define FNmon(x) &uncl_thread_mon_##x, #x
 static const Unc_ModuleCFunc lib_mon[] = {
     { FNmon(acquiretimed),      2, 0, 0, UNC_CFUNC_CONCURRENT },
@@ -1664,12 +4841,26 @@ Unc_RetVal uncilmain_thread(Unc_View *w) {
     Unc_Value thread_rlock = UNC_BLANK;
     Unc_Value thread_semaphore = UNC_BLANK;
     Unc_Value thread_monitor = UNC_BLANK;
+    Unc_Value thread_pool = UNC_BLANK;
+    Unc_Value thread_future = UNC_BLANK;
+    Unc_Value thread_channel = UNC_BLANK;
+    Unc_Value thread_rwlock = UNC_BLANK;
+    Unc_Value thread_atomic = UNC_BLANK;
+    Unc_Value thread_actor = UNC_BLANK;
+    Unc_Value thread_ctable = UNC_BLANK;
     
     e = unc_newtable(w, &thread_thread);
     if (!e) e = unc_newtable(w, &thread_lock);
     if (!e) e = unc_newtable(w, &thread_rlock);
     if (!e) e = unc_newtable(w, &thread_semaphore);
     if (!e) e = unc_newtable(w, &thread_monitor);
+    if (!e) e = unc_newtable(w, &thread_pool);
+    if (!e) e = unc_newtable(w, &thread_future);
+    if (!e) e = unc_newtable(w, &thread_channel);
+    if (!e) e = unc_newtable(w, &thread_rwlock);
+    if (!e) e = unc_newtable(w, &thread_atomic);
+    if (!e) e = unc_newtable(w, &thread_actor);
+    if (!e) e = unc_newtable(w, &thread_ctable);
     if (e) goto uncilmain_thread_fail;
     
     e = unc_exportcfunction(w, "sleep", &uncl_thread_sleep,
@@ -1726,6 +4917,34 @@ Unc_RetVal uncilmain_thread(Unc_View *w) {
         if (!e) e = unc_setattrc(w, &thread_monitor, OPOVERLOAD(name), &v);
         if (e) goto uncilmain_thread_fail;
 
+        e = unc_newstringc(w, &v, "thread.pool");
+        if (!e) e = unc_setattrc(w, &thread_pool, OPOVERLOAD(name), &v);
+        if (e) goto uncilmain_thread_fail;
+
+        e = unc_newstringc(w, &v, "thread.future");
+        if (!e) e = unc_setattrc(w, &thread_future, OPOVERLOAD(name), &v);
+        if (e) goto uncilmain_thread_fail;
+
+        e = unc_newstringc(w, &v, "thread.channel");
+        if (!e) e = unc_setattrc(w, &thread_channel, OPOVERLOAD(name), &v);
+        if (e) goto uncilmain_thread_fail;
+
+        e = unc_newstringc(w, &v, "thread.rwlock");
+        if (!e) e = unc_setattrc(w, &thread_rwlock, OPOVERLOAD(name), &v);
+        if (e) goto uncilmain_thread_fail;
+
+        e = unc_newstringc(w, &v, "thread.atomic");
+        if (!e) e = unc_setattrc(w, &thread_atomic, OPOVERLOAD(name), &v);
+        if (e) goto uncilmain_thread_fail;
+
+        e = unc_newstringc(w, &v, "thread.actor");
+        if (!e) e = unc_setattrc(w, &thread_actor, OPOVERLOAD(name), &v);
+        if (e) goto uncilmain_thread_fail;
+
+        e = unc_newstringc(w, &v, "thread.ctable");
+        if (!e) e = unc_setattrc(w, &thread_ctable, OPOVERLOAD(name), &v);
+        if (e) goto uncilmain_thread_fail;
+
         e = uncl_thread_setup_acq_rel(w, &thread_lock,
                                          &uncl_thread_lock_acquire,
                                          &uncl_thread_lock_release);
@@ -1760,6 +4979,49 @@ Unc_RetVal uncilmain_thread(Unc_View *w) {
             e = unc_setattrc(w, &thread_monitor, "new", &v);
             if (e) goto uncilmain_thread_fail;
         }
+
+        {
+            /* the default pool starts its workers on first use */
+            Unc_Value thread_par_binds[2] = UNC_BLANKS;
+            unc_copy(w, &thread_par_binds[0], &thread_pool);
+#if UNCIL_MT_OK
+            {
+                struct unc_pool **pp;
+                e = unc_newopaque(w, &thread_par_binds[1], &thread_pool,
+                                  sizeof(struct unc_pool *), (void **)&pp,
+                                  &unc0_thread_pool_destr, 0, NULL, 0, NULL);
+                if (!e) {
+                    *pp = NULL;
+                    e = unc0_poolnew(w, unc0_mtcpucount(), pp);
+                    unc_unlock(w, &thread_par_binds[1]);
+                }
+            }
+            if (!e)
+#endif
+            e = unc_exportcfunction(w, "pmap", &uncl_thread_pmap,
+                                    2, 2, 0, UNC_CFUNC_CONCURRENT, NULL,
+                                    2, thread_par_binds, 0, NULL, NULL);
+            if (!e) e = unc_exportcfunction(w, "pfor", &uncl_thread_pfor,
+                                    2, 2, 0, UNC_CFUNC_CONCURRENT, NULL,
+                                    2, thread_par_binds, 0, NULL, NULL);
+            if (!e) {
+                Unc_Value thread_future_binds[4] = UNC_BLANKS;
+                unc_copy(w, &thread_future_binds[0], &thread_future);
+                unc_copy(w, &thread_future_binds[1], &thread_pool);
+                unc_copy(w, &thread_future_binds[2], &thread_par_binds[1]);
+                e = unc_newtable(w, &thread_future_binds[3]);
+                if (!e) e = unc_exportcfunction(w, "submit",
+                                    &uncl_thread_submit,
+                                    1, 2, 0, UNC_CFUNC_CONCURRENT, NULL,
+                                    4, thread_future_binds, 0, NULL, NULL);
+                if (!e) e = unc_attrcfunctions(w, &thread_future,
+                                    PASSARRAY(lib_future),
+                                    4, thread_future_binds, NULL);
+                unc_clearmany(w, PASSARRAY(thread_future_binds));
+            }
+            unc_clearmany(w, PASSARRAY(thread_par_binds));
+            if (e) goto uncilmain_thread_fail;
+        }
         VCLEAR(w, &v);
     }
 
@@ -1773,12 +5035,31 @@ Unc_RetVal uncilmain_thread(Unc_View *w) {
                                    1, &thread_semaphore, NULL);
     if (!e) e = unc_attrcfunctions(w, &thread_monitor, PASSARRAY(lib_mon),
                                    1, &thread_monitor, NULL);
+    if (!e) e = unc_attrcfunctions(w, &thread_pool, PASSARRAY(lib_pool),
+                                   1, &thread_pool, NULL);
+    if (!e) e = unc_attrcfunctions(w, &thread_channel, PASSARRAY(lib_chan),
+                                   1, &thread_channel, NULL);
+    if (!e) e = unc_attrcfunctions(w, &thread_rwlock, PASSARRAY(lib_rwlock),
+                                   1, &thread_rwlock, NULL);
+    if (!e) e = unc_attrcfunctions(w, &thread_atomic, PASSARRAY(lib_atomic),
+                                   1, &thread_atomic, NULL);
+    if (!e) e = unc_attrcfunctions(w, &thread_actor, PASSARRAY(lib_actor),
+                                   1, &thread_actor, NULL);
+    if (!e) e = unc_attrcfunctions(w, &thread_ctable, PASSARRAY(lib_ctable),
+                                   1, &thread_ctable, NULL);
     
     e = unc_setpublicc(w, "thread", &thread_thread);
     if (!e) e = unc_setpublicc(w, "lock", &thread_lock);
     if (!e) e = unc_setpublicc(w, "rlock", &thread_rlock);
     if (!e) e = unc_setpublicc(w, "semaphore", &thread_semaphore);
     if (!e) e = unc_setpublicc(w, "monitor", &thread_monitor);
+    if (!e) e = unc_setpublicc(w, "pool", &thread_pool);
+    if (!e) e = unc_setpublicc(w, "future", &thread_future);
+    if (!e) e = unc_setpublicc(w, "channel", &thread_channel);
+    if (!e) e = unc_setpublicc(w, "rwlock", &thread_rwlock);
+    if (!e) e = unc_setpublicc(w, "atomic", &thread_atomic);
+    if (!e) e = unc_setpublicc(w, "actor", &thread_actor);
+    if (!e) e = unc_setpublicc(w, "ctable", &thread_ctable);
 
 uncilmain_thread_fail:
     VCLEAR(w, &thread_thread);
@@ -1786,5 +5067,12 @@ uncilmain_thread_fail:
     VCLEAR(w, &thread_rlock);
     VCLEAR(w, &thread_semaphore);
     VCLEAR(w, &thread_monitor);
+    VCLEAR(w, &thread_pool);
+    VCLEAR(w, &thread_future);
+    VCLEAR(w, &thread_channel);
+    VCLEAR(w, &thread_rwlock);
+    VCLEAR(w, &thread_atomic);
+    VCLEAR(w, &thread_actor);
+    VCLEAR(w, &thread_ctable);
     return e;
 }
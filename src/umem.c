@@ -43,6 +43,15 @@ SOFTWARE.
 #include <string.h>
 #endif
 
+/* other architectures use the portable loops (and the C library, whose
+   memchr is usually vectorized already) */
+#if UNCIL_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#if UNCIL_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
 #if !UNCIL_NOSTDALLOC
 /* define UNCIL_STDALLOC_NOT_THREADSAFE if malloc/realloc/free
                                             is not thread-safe */
@@ -74,6 +83,36 @@ void *unc0_stdalloc(void *udata, Unc_Alloc_Purpose purpose,
 }
 #endif /* !UNCIL_NOSTDALLOC */
 
+#if UNCIL_SIMD_SSE2
+#if UNCIL_NOLIBC
+static const byte *memchr_sse2(const byte *p, byte c, size_t n) {
+    __m128i v = _mm_set1_epi8((char)c);
+    for (; n >= 16; p += 16, n -= 16) {
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v,
+                            _mm_loadu_si128((const __m128i *)p)));
+        if (m) return p + __builtin_ctz(m);
+    }
+    for (; n; ++p, --n)
+        if (*p == c) return p;
+    return NULL;
+}
+#endif
+
+static const byte *memrchr_sse2(const byte *p, byte c, size_t n) {
+    __m128i v = _mm_set1_epi8((char)c);
+    while (n >= 16) {
+        unsigned m;
+        n -= 16;
+        m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v,
+                            _mm_loadu_si128((const __m128i *)(p + n))));
+        if (m) return p + n + (31 - __builtin_clz(m));
+    }
+    while (n--)
+        if (p[n] == c) return p + n;
+    return NULL;
+}
+#endif
+
 #if UNCIL_NOLIBC
 
 void unc0_memcpy_f(void *dst, const void *src, size_t sz) {
@@ -103,12 +142,16 @@ size_t unc0_memmove(void *dst, const void *src, size_t sz) {
 }
 
 void *unc0_memchr(const void *m, int c, size_t sz) {
+#if UNCIL_SIMD_SSE2
+    return (void *)memchr_sse2(m, (byte)c, sz);
+#else
     const unsigned char *p = m, x = (unsigned char)c;
     size_t i;
     for (i = 0; i < sz; ++i)
         if (p[i] == x)
             return (void *)&p[i];
     return NULL;
+#endif
 }
 
 size_t unc0_memset(void *dst, int c, size_t sz) {
@@ -122,8 +165,16 @@ size_t unc0_memset(void *dst, int c, size_t sz) {
 int unc0_memcmp(const void *dst, const void *src, size_t sz) {
     const unsigned char *a = dst, *b = src;
     unsigned char x, y;
-    size_t i;
-    for (i = 0; i < sz; ++i) {
+    size_t i = 0;
+#if UNCIL_SIMD_SSE2
+    /* skip equal blocks, then find the first difference below */
+    for (; i + 16 <= sz; i += 16)
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(
+                    _mm_loadu_si128((const __m128i *)(a + i)),
+                    _mm_loadu_si128((const __m128i *)(b + i)))) != 0xFFFF)
+            break;
+#endif
+    for (; i < sz; ++i) {
         x = a[i], y = b[i];
         if (x != y) return (int)x - (int)y;
     }
@@ -212,11 +263,15 @@ size_t unc0_memsetv(void *dst, int c, size_t sz) {
 }
 
 void *unc0_memrchr(const void *p, int c, size_t n) {
+#if UNCIL_SIMD_SSE2
+    return (void *)memrchr_sse2(p, (byte)c, n);
+#else
     unsigned char *b = (unsigned char *)p + n;
     while (n--)
         if (*--b == c)
             return b;
     return NULL;
+#endif
 }
 
 void unc0_memrev(void *dst, size_t sz) {
@@ -485,12 +540,129 @@ size_t unc0_tmemmove(void *dst, const void *src, size_t sz, size_t n) {
     return n;
 }
 
+/* the substring searches below check many candidate positions at once by
+   comparing the first and last byte of the needle against two shifted
+   loads of the haystack, and only run memcmp where both match. they return
+   the match, or NULL and the number of candidates left unchecked (fewer
+   than a vector's worth) in *left. the forward versions leave those at
+   the end, the reverse versions at the start. needle_n >= 2 */
+#if UNCIL_SIMD_SSE2
+static const byte *strsearch_sse2(const byte *h, Unc_Size hn,
+                                  const byte *nd, Unc_Size nn,
+                                  Unc_Size *left) {
+    __m128i f = _mm_set1_epi8((char)nd[0]), l = _mm_set1_epi8((char)nd[nn - 1]);
+    Unc_Size i = 0, k = hn - nn + 1;
+    for (; i + 16 <= k; i += 16) {
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(f, _mm_loadu_si128((const __m128i *)(h + i))),
+            _mm_cmpeq_epi8(l, _mm_loadu_si128(
+                                    (const __m128i *)(h + i + nn - 1)))));
+        for (; m; m &= m - 1) {
+            const byte *p = h + i + __builtin_ctz(m);
+            if (!unc0_memcmp(p + 1, nd + 1, nn - 2))
+                return p;
+        }
+    }
+    *left = k - i;
+    return NULL;
+}
+
+static const byte *strsearchr_sse2(const byte *h, Unc_Size hn,
+                                   const byte *nd, Unc_Size nn,
+                                   Unc_Size *left) {
+    __m128i f = _mm_set1_epi8((char)nd[0]), l = _mm_set1_epi8((char)nd[nn - 1]);
+    Unc_Size k = hn - nn + 1;
+    while (k >= 16) {
+        unsigned m;
+        k -= 16;
+        m = (unsigned)_mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(f, _mm_loadu_si128((const __m128i *)(h + k))),
+            _mm_cmpeq_epi8(l, _mm_loadu_si128(
+                                    (const __m128i *)(h + k + nn - 1)))));
+        while (m) {
+            int b = 31 - __builtin_clz(m);
+            if (!unc0_memcmp(h + k + b + 1, nd + 1, nn - 2))
+                return h + k + b;
+            m &= ~(1U << b);
+        }
+    }
+    *left = k;
+    return NULL;
+}
+#endif
+
+#if UNCIL_SIMD_AVX2
+__attribute__((target("avx2")))
+static const byte *strsearch_avx2(const byte *h, Unc_Size hn,
+                                  const byte *nd, Unc_Size nn,
+                                  Unc_Size *left) {
+    __m256i f = _mm256_set1_epi8((char)nd[0]),
+            l = _mm256_set1_epi8((char)nd[nn - 1]);
+    Unc_Size i = 0, k = hn - nn + 1;
+    for (; i + 32 <= k; i += 32) {
+        unsigned m = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(f, _mm256_loadu_si256((const __m256i *)(h + i))),
+            _mm256_cmpeq_epi8(l, _mm256_loadu_si256(
+                                    (const __m256i *)(h + i + nn - 1)))));
+        for (; m; m &= m - 1) {
+            const byte *p = h + i + __builtin_ctz(m);
+            if (!unc0_memcmp(p + 1, nd + 1, nn - 2))
+                return p;
+        }
+    }
+    *left = k - i;
+    return NULL;
+}
+
+__attribute__((target("avx2")))
+static const byte *strsearchr_avx2(const byte *h, Unc_Size hn,
+                                   const byte *nd, Unc_Size nn,
+                                   Unc_Size *left) {
+    __m256i f = _mm256_set1_epi8((char)nd[0]),
+            l = _mm256_set1_epi8((char)nd[nn - 1]);
+    Unc_Size k = hn - nn + 1;
+    while (k >= 32) {
+        unsigned m;
+        k -= 32;
+        m = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(f, _mm256_loadu_si256((const __m256i *)(h + k))),
+            _mm256_cmpeq_epi8(l, _mm256_loadu_si256(
+                                    (const __m256i *)(h + k + nn - 1)))));
+        while (m) {
+            int b = 31 - __builtin_clz(m);
+            if (!unc0_memcmp(h + k + b + 1, nd + 1, nn - 2))
+                return h + k + b;
+            m &= ~(1U << b);
+        }
+    }
+    *left = k;
+    return NULL;
+}
+#endif
+
 /* (raw) string search */
 const byte *unc0_strsearch(const byte *haystack, Unc_Size haystack_n,
                            const byte *needle, Unc_Size needle_n) {
     byte s0;
     const byte *next;
     if (!needle_n) return haystack;
+    if (needle_n > haystack_n) return NULL;
+    if (needle_n == 1) return unc0_memchr(haystack, needle[0], haystack_n);
+#if UNCIL_SIMD_SSE2
+    {
+        Unc_Size left;
+#if UNCIL_SIMD_AVX2
+        next = haystack_n >= 64 && HAVE_AVX2()
+            ? strsearch_avx2(haystack, haystack_n, needle, needle_n, &left)
+            : strsearch_sse2(haystack, haystack_n, needle, needle_n, &left);
+#else
+        next = strsearch_sse2(haystack, haystack_n, needle, needle_n, &left);
+#endif
+        if (next || !left) return next;
+        haystack += haystack_n - needle_n + 1 - left;
+        haystack_n = left + needle_n - 1;
+    }
+#endif
     s0 = needle[0];
     haystack_n -= needle_n - 1;
     while ((next = unc0_memchr(haystack, s0, haystack_n))) {
@@ -507,12 +679,28 @@ const byte *unc0_strsearchr(const byte *haystack, Unc_Size haystack_n,
     byte s0;
     const byte *next;
     if (!needle_n) return haystack;
+    if (needle_n > haystack_n) return NULL;
+    if (needle_n == 1) return unc0_memrchr(haystack, needle[0], haystack_n);
+#if UNCIL_SIMD_SSE2
+    {
+        Unc_Size left;
+#if UNCIL_SIMD_AVX2
+        next = haystack_n >= 64 && HAVE_AVX2()
+            ? strsearchr_avx2(haystack, haystack_n, needle, needle_n, &left)
+            : strsearchr_sse2(haystack, haystack_n, needle, needle_n, &left);
+#else
+        next = strsearchr_sse2(haystack, haystack_n, needle, needle_n, &left);
+#endif
+        if (next || !left) return next;
+        haystack_n = left + needle_n - 1;
+    }
+#endif
     s0 = needle[0];
     haystack_n -= needle_n - 1;
     while ((next = unc0_memrchr(haystack, s0, haystack_n))) {
         if (!unc0_memcmp(next + 1, needle + 1, needle_n - 1))
             return next;
-        haystack_n = next - haystack - 1;
+        haystack_n = next - haystack;
     }
     return NULL;
 }
@@ -57,6 +57,8 @@ static void unc0_reqrestorestate(Unc_View *w, Unc_ModuleFrame *sav) {
     w->met_blob = sav->met_blob;
     w->met_arr = sav->met_arr;
     w->met_table = sav->met_table;
+    w->met_tarr = sav->met_tarr;
+    w->met_aview = sav->met_aview;
     w->curdir_n = sav->curdir_n;
     w->curdir = sav->curdir;
     w->fmain = sav->fmain;
@@ -72,6 +74,8 @@ static void unc0_reqstorestate(Unc_View *w, Unc_ModuleFrame *sav) {
     sav->met_blob = w->met_blob;
     sav->met_arr = w->met_arr;
     sav->met_table = w->met_table;
+    sav->met_tarr = w->met_tarr;
+    sav->met_aview = w->met_aview;
     sav->curdir_n = w->curdir_n;
     sav->curdir = w->curdir;
     sav->fmain = w->fmain;
@@ -84,6 +88,8 @@ static void unc0_reqstorestate(Unc_View *w, Unc_ModuleFrame *sav) {
     VINITNULL(&w->met_blob);
     VINITNULL(&w->met_arr);
     VINITNULL(&w->met_table);
+    VINITNULL(&w->met_tarr);
+    VINITNULL(&w->met_aview);
     unc0_inithtbls(&w->world->alloc, w->pubs = &sav->temp_pubs);
     unc0_inithtbls(&w->world->alloc, w->exports = &sav->temp_exports);
 }
@@ -93,15 +99,10 @@ static Unc_RetVal unc0_reqimposestate(Unc_View *w, Unc_ModuleFrame *sav,
     Unc_RetVal e = 0;
     Unc_HTblS *exports = w->exports;
     Unc_HTblS_V *node;
-    Unc_Size i, ie;
-    for (i = 0, ie = exports->capacity; i < ie; ++i) {
-        node = exports->buckets[i];
-        while (node) {
-            e = unc0_osetattrs(w, obj, node->key_n, (const byte *)(&node[1]),
-                                    &node->val);
-            if (e) break;
-            node = node->next;
-        }
+    Unc_Size i = 0;
+    while ((node = unc0_iterhtbls(exports, &i))) {
+        e = unc0_osetattrs(w, obj, node->key_n, node->key, &node->val);
+        if (e) break;
     }
     return e;
 }
@@ -40,6 +40,8 @@ typedef struct Unc_ModuleFrame {
     Unc_Value met_blob;
     Unc_Value met_arr;
     Unc_Value met_table;
+    Unc_Value met_tarr;
+    Unc_Value met_aview;
     Unc_Value fmain;
     char import;
     size_t curdir_n;
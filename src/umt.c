@@ -48,6 +48,30 @@ Unc_AtomicSmall unc0_nonatomicsxchg(Unc_AtomicSmall *var,
     *var = val;
     return old;
 }
+
+int unc0_nonatomiclcas(Unc_AtomicLarge *var, Unc_Size *expect, Unc_Size val) {
+    if (*var != *expect) {
+        *expect = *var;
+        return 0;
+    }
+    *var = val;
+    return 1;
+}
+
+Unc_Int unc0_nonatomicixchg(Unc_AtomicInt *var, Unc_Int val) {
+    Unc_Int old = *var;
+    *var = val;
+    return old;
+}
+
+int unc0_nonatomicicas(Unc_AtomicInt *var, Unc_Int *expect, Unc_Int val) {
+    if (*var != *expect) {
+        *expect = *var;
+        return 0;
+    }
+    *var = val;
+    return 1;
+}
 #endif
 
 #if UNCIL_MT_OK
@@ -64,10 +88,16 @@ void unc0_mtpause(Unc_View *view) {
     
     v = w->view;
     while (v) {
-        /*while (!UNC_LOCKFQ(w->runlock))
-            UNC_YIELD();*/
-        UNC_LOCKF(v->runlock);
-        UNC_UNLOCKF(v->runlock);
+        /* a view that is waiting (in the pause loop or blocked in C code
+           after unc_vmpause) still holds its runlock, but will not touch
+           anything until flow is set back to RUN */
+        while (!v->paused) {
+            if (UNC_LOCKFQ(v->runlock)) {
+                UNC_UNLOCKF(v->runlock);
+                break;
+            }
+            UNC_YIELD();
+        }
         v = v->nextview;
     }
 
@@ -178,3 +208,93 @@ void unc0_c11_paused(Unc_View *view) { (void)view; }
 void unc0_c11_resumed(Unc_View *view) { (void)view; }
 
 #endif
+
+#if UNCIL_MT_OK && UNCIL_IS_POSIX
+#include <unistd.h>
+#endif
+
+Unc_Size unc0_mtcpucount(void) {
+#if UNCIL_MT_OK && defined(_SC_NPROCESSORS_ONLN)
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n > 0) return (Unc_Size)n;
+#endif
+    return 1;
+}
+
+/* at most this many threads are used by unc0_mtfork */
+#define UNC_MTFORK_MAX 64
+
+struct unc0_mtforkjob {
+    void (*fn)(void *p, Unc_Size i);
+    void *p;
+    Unc_Size i, n, t;
+};
+
+/* thread k of t does the calls k, k + t, k + 2t, ... */
+static void unc0_mtfork_do(struct unc0_mtforkjob *j) {
+    Unc_Size i;
+    for (i = j->i; i < j->n; i += j->t)
+        (*j->fn)(j->p, i);
+}
+
+#if UNCIL_MT_OK && UNCIL_MT_PTHREAD
+static void *unc0_mtfork_run(void *p) {
+    unc0_mtfork_do(p);
+    return NULL;
+}
+#define UNC_MTFORK_THREAD pthread_t
+#define UNC_MTFORK_START(h, j) !pthread_create(&(h), NULL, &unc0_mtfork_run, j)
+#define UNC_MTFORK_JOIN(h) pthread_join(h, NULL)
+#elif UNCIL_MT_OK && UNCIL_MT_C11
+static int unc0_mtfork_run(void *p) {
+    unc0_mtfork_do(p);
+    return 0;
+}
+#define UNC_MTFORK_THREAD thrd_t
+#define UNC_MTFORK_START(h, j)                                                 \
+    (thrd_create(&(h), &unc0_mtfork_run, j) == thrd_success)
+#define UNC_MTFORK_JOIN(h) thrd_join(h, NULL)
+#endif
+
+/* this does not use the worker pool of the thread library, which only
+   exists once a program has loaded that module and runs its tasks on
+   views of its own. callers only fork for large inputs (see
+   UNCIL_SORT_PARALLEL), where starting the threads costs little next to
+   the work done on them */
+void unc0_mtfork(Unc_Size n, Unc_Size t, void (*fn)(void *p, Unc_Size i),
+                 void *p) {
+#ifdef UNC_MTFORK_THREAD
+    struct unc0_mtforkjob j[UNC_MTFORK_MAX];
+    UNC_MTFORK_THREAD h[UNC_MTFORK_MAX];
+    int ok[UNC_MTFORK_MAX];
+    Unc_Size i;
+    if (t > n) t = n;
+    if (t > UNC_MTFORK_MAX) t = UNC_MTFORK_MAX;
+    if (t < 1) t = 1;
+    for (i = 0; i < t; ++i) {
+        j[i].fn = fn;
+        j[i].p = p;
+        j[i].i = i;
+        j[i].n = n;
+        j[i].t = t;
+    }
+    for (i = 1; i < t; ++i)
+        ok[i] = UNC_MTFORK_START(h[i], &j[i]);
+    unc0_mtfork_do(&j[0]);
+    for (i = 1; i < t; ++i) {
+        if (ok[i])
+            UNC_MTFORK_JOIN(h[i]);
+        else
+            unc0_mtfork_do(&j[i]);
+    }
+#else
+    struct unc0_mtforkjob j;
+    (void)t;
+    j.fn = fn;
+    j.p = p;
+    j.i = 0;
+    j.n = n;
+    j.t = 1;
+    unc0_mtfork_do(&j);
+#endif
+}
@@ -42,6 +42,7 @@ struct Unc_View;
 typedef atomic_flag Unc_AtomicFlag;
 typedef _Atomic int Unc_AtomicSmall;
 typedef _Atomic Unc_Size Unc_AtomicLarge;
+typedef _Atomic Unc_Int Unc_AtomicInt;
 #ifdef UNCIL_DEFINES
 #define ATOMICSSET(a, x) (void)(a = (x))
 #define ATOMICSINC(a) (++a)
@@ -50,6 +51,13 @@ typedef _Atomic Unc_Size Unc_AtomicLarge;
 #define ATOMICLSET(a, x) (void)(a = (x))
 #define ATOMICLINC(a) (++a)
 #define ATOMICLDEC(a) (--a)
+#define ATOMICLCAS(a, e, x) atomic_compare_exchange_strong(&(a), &(e), (x))
+#define ATOMICLLOAD(a) atomic_load(&(a))
+#define ATOMICILOAD(a) atomic_load(&(a))
+#define ATOMICISET(a, x) atomic_store(&(a), (x))
+#define ATOMICIADD(a, x) (atomic_fetch_add(&(a), (x)) + (x))
+#define ATOMICIXCG(a, x) atomic_exchange(&(a), (x))
+#define ATOMICICAS(a, e, x) atomic_compare_exchange_strong(&(a), &(e), (x))
 #define ATOMICFLAGTAS(a) atomic_flag_test_and_set(&(a))
 #define ATOMICFLAGCLR(a) atomic_flag_clear(&(a))
 #endif /* UNCIL_DEFINES */
@@ -60,6 +68,7 @@ typedef _Atomic Unc_Size Unc_AtomicLarge;
 typedef volatile char Unc_AtomicFlag;
 typedef volatile sig_atomic_t Unc_AtomicSmall;
 typedef volatile Unc_Size Unc_AtomicLarge;
+typedef volatile Unc_Int Unc_AtomicInt;
 #ifdef UNCIL_DEFINES
 #define ATOMICSSET(a, x) __atomic_store_n(&(a), (x), __ATOMIC_SEQ_CST)
 #define ATOMICSINC(a) __atomic_add_fetch(&(a), 1, __ATOMIC_SEQ_CST)
@@ -68,6 +77,15 @@ typedef volatile Unc_Size Unc_AtomicLarge;
 #define ATOMICLSET(a, x) __atomic_store_n(&(a), (x), __ATOMIC_SEQ_CST)
 #define ATOMICLINC(a) __atomic_add_fetch(&(a), 1, __ATOMIC_SEQ_CST)
 #define ATOMICLDEC(a) __atomic_sub_fetch(&(a), 1, __ATOMIC_SEQ_CST)
+#define ATOMICLCAS(a, e, x) __atomic_compare_exchange_n(&(a), &(e), (x), 0,    \
+                                    __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#define ATOMICLLOAD(a) __atomic_load_n(&(a), __ATOMIC_SEQ_CST)
+#define ATOMICILOAD(a) __atomic_load_n(&(a), __ATOMIC_SEQ_CST)
+#define ATOMICISET(a, x) __atomic_store_n(&(a), (x), __ATOMIC_SEQ_CST)
+#define ATOMICIADD(a, x) __atomic_add_fetch(&(a), (x), __ATOMIC_SEQ_CST)
+#define ATOMICIXCG(a, x) __atomic_exchange_n(&(a), (x), __ATOMIC_SEQ_CST)
+#define ATOMICICAS(a, e, x) __atomic_compare_exchange_n(&(a), &(e), (x), 0,    \
+                                    __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
 #define ATOMICFLAGTAS(a) __atomic_test_and_set(&(a), __ATOMIC_SEQ_CST)
 #define ATOMICFLAGCLR(a) __atomic_clear(&(a))
 #endif /* UNCIL_DEFINES */
@@ -83,12 +101,16 @@ typedef volatile sig_atomic_t Unc_AtomicFlag;
 typedef volatile sig_atomic_t Unc_AtomicSmall;
 #endif
 typedef volatile Unc_Size Unc_AtomicLarge;
+typedef volatile Unc_Int Unc_AtomicInt;
 #ifdef UNCIL_DEFINES
 #if UNCIL_MT_OK
 #error "atomic operations required for multithreaded build"
 #endif
 int unc0_nonatomictas(Unc_AtomicFlag *v);
 Unc_AtomicSmall unc0_nonatomicsxchg(Unc_AtomicSmall *var, Unc_AtomicSmall val);
+int unc0_nonatomiclcas(Unc_AtomicLarge *var, Unc_Size *expect, Unc_Size val);
+Unc_Int unc0_nonatomicixchg(Unc_AtomicInt *var, Unc_Int val);
+int unc0_nonatomicicas(Unc_AtomicInt *var, Unc_Int *expect, Unc_Int val);
 #define ATOMICSSET(a, x) (a = (x))
 #define ATOMICSINC(a) (++a)
 #define ATOMICSDEC(a) (--a)
@@ -96,6 +118,13 @@ Unc_AtomicSmall unc0_nonatomicsxchg(Unc_AtomicSmall *var, Unc_AtomicSmall val);
 #define ATOMICLSET(a, x) (a = (x))
 #define ATOMICLINC(a) (++a)
 #define ATOMICLDEC(a) (--a)
+#define ATOMICLCAS(a, e, x) unc0_nonatomiclcas(&(a), &(e), x)
+#define ATOMICLLOAD(a) (a)
+#define ATOMICILOAD(a) (a)
+#define ATOMICISET(a, x) (a = (x))
+#define ATOMICIADD(a, x) (a += (x))
+#define ATOMICIXCG(a, x) unc0_nonatomicixchg(&(a), x)
+#define ATOMICICAS(a, e, x) unc0_nonatomicicas(&(a), &(e), x)
 #define ATOMICFLAGTAS(a) unc0_nonatomictas(&(a))
 #define ATOMICFLAGCLR(a) (a = 0)
 #define UNC_NONATOMIC 1
@@ -267,4 +296,18 @@ void unc0_c11_resumed(struct Unc_View *view);
 
 #endif /* locks etc. */
 
+#ifdef UNCIL_DEFINES
+/* native threads for internal parallel algorithms.
+    unc0_mtcpucount() returns the number of processors available (1 if
+        unknown or if the build is single-threaded)
+    unc0_mtfork(n, t, fn, p) calls fn(p, i) for every i in [0, n[ on up to
+        t threads, including the calling one, and returns once all calls have
+        finished. if threads cannot be started, the calling thread does the
+        remaining work. fn must not touch the VM or allocate managed memory
+*/
+Unc_Size unc0_mtcpucount(void);
+void unc0_mtfork(Unc_Size n, Unc_Size t, void (*fn)(void *p, Unc_Size i),
+                 void *p);
+#endif /* UNCIL_DEFINES */
+
 #endif /* UNCIL_UMT_H */
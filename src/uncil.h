@@ -175,11 +175,15 @@ Unc_RetVal unc_newstring(Unc_View *w, Unc_Value *v, Unc_Size n, const char *c);
 Unc_RetVal unc_newstringc(Unc_View *w, Unc_Value *v, const char *c);
 Unc_RetVal unc_newstringmove(Unc_View *w, Unc_Value *v, Unc_Size n, char *c);
 Unc_RetVal unc_newstringcmove(Unc_View *w, Unc_Value *v, char *c);
+Unc_RetVal unc_newsubstring(Unc_View *w, Unc_Value *v, Unc_Value *s,
+                            Unc_Size n, const char *c);
 Unc_RetVal unc_newarrayempty(Unc_View *w, Unc_Value *v);
+Unc_RetVal unc_newarrayemptycap(Unc_View *w, Unc_Value *v, Unc_Size n);
 Unc_RetVal unc_newarray(Unc_View *w, Unc_Value *v, Unc_Size n, Unc_Value **p);
 Unc_RetVal unc_newarrayfrom(Unc_View *w, Unc_Value *v,
                             Unc_Size n, Unc_Value *a);
 Unc_RetVal unc_newtable(Unc_View *w, Unc_Value *v);
+Unc_RetVal unc_newtablecap(Unc_View *w, Unc_Value *v, Unc_Size n);
 Unc_RetVal unc_newobject(Unc_View *w, Unc_Value *v, Unc_Value *prototype);
 Unc_RetVal unc_newblob(Unc_View *w, Unc_Value *v, Unc_Size n, Unc_Byte **data);
 Unc_RetVal unc_newblobfrom(Unc_View *w, Unc_Value *v,
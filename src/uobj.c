@@ -42,6 +42,20 @@ Unc_RetVal unc0_initdict(Unc_View *w, Unc_Dict *o) {
     return UNC_LOCKINITL(o->lock) ? UNCIL_ERR_MEM : 0;
 }
 
+/* init table with room for n entries */
+Unc_RetVal unc0_initdictn(Unc_View *w, Unc_Dict *o, Unc_Size n) {
+    Unc_RetVal e;
+    unc0_inithtblv(&w->world->alloc, &o->data);
+    if (n && (e = unc0_reservehtblv(w, &o->data, n)))
+        return e;
+    o->generation = 0;
+    if (UNC_LOCKINITL(o->lock)) {
+        unc0_drophtblv(w, &o->data);
+        return UNCIL_ERR_MEM;
+    }
+    return 0;
+}
+
 Unc_RetVal unc0_initobj(Unc_View *w, Unc_Object *o, Unc_Value *proto) {
     unc0_inithtblv(&w->world->alloc, &o->data);
     if (proto)
@@ -104,6 +118,53 @@ Unc_RetVal unc0_ddelindx(Unc_View *w, Unc_Dict *o, Unc_Value *attr) {
     return e;
 }
 
+/* gets the value of attr, setting it to v first if attr is not in the
+   table. both happen under the same lock, so of several threads doing this
+   at once, only one can set the value */
+Unc_RetVal unc0_dgetorsetindx(Unc_View *w, Unc_Dict *o,
+                              Unc_Value *attr, Unc_Value *v, Unc_Value *out) {
+    Unc_Value *p;
+    Unc_RetVal e;
+    UNC_LOCKL(o->lock);
+    p = unc0_gethtblv(w, &o->data, attr);
+    if (!p) {
+        e = unc0_puthtblv(w, &o->data, attr, &p);
+        if (e) {
+            UNC_UNLOCKL(o->lock);
+            return e;
+        }
+        VCOPY(w, p, v);
+        nextgen(o);
+    }
+    VCOPY(w, out, p);
+    UNC_UNLOCKL(o->lock);
+    return 0;
+}
+
+/* sets attr to v (or removes it if v is NULL), but only if its value is
+   still the same as expect, or if expect is NULL, if it is still not in
+   the table. *ok tells whether it was set */
+Unc_RetVal unc0_dcasindx(Unc_View *w, Unc_Dict *o, Unc_Value *attr,
+                         Unc_Value *expect, Unc_Value *v, int *ok) {
+    Unc_Value *p;
+    Unc_RetVal e = 0;
+    UNC_LOCKL(o->lock);
+    p = unc0_gethtblv(w, &o->data, attr);
+    *ok = expect ? p && unc_issame(w, p, expect) : !p;
+    if (*ok && v) {
+        if (!p) {
+            e = unc0_puthtblv(w, &o->data, attr, &p);
+            if (!e) nextgen(o);
+        }
+        if (!e) VCOPY(w, p, v);
+    } else if (*ok && p) {
+        nextgen(o);
+        e = unc0_delhtblv(w, &o->data, attr);
+    }
+    UNC_UNLOCKL(o->lock);
+    return e;
+}
+
 Unc_RetVal unc0_dgetattrv(Unc_View *w, Unc_Dict *o,
                           Unc_Value *attr, int *found, Unc_Value *out) {
     return unc0_dgetindx(w, o, attr, found, out);
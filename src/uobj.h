@@ -48,6 +48,7 @@ typedef struct Unc_Object {
 struct Unc_View;
 
 Unc_RetVal unc0_initdict(struct Unc_View *w, Unc_Dict *o);
+Unc_RetVal unc0_initdictn(struct Unc_View *w, Unc_Dict *o, Unc_Size n);
 Unc_RetVal unc0_initobj(struct Unc_View *w, Unc_Object *o, Unc_Value *proto);
 
 Unc_RetVal unc0_dgetattrv(struct Unc_View *w, Unc_Dict *o,
@@ -67,6 +68,10 @@ Unc_RetVal unc0_dgetindx(struct Unc_View *w, Unc_Dict *o,
 Unc_RetVal unc0_dsetindx(struct Unc_View *w, Unc_Dict *o,
                          Unc_Value *attr, Unc_Value *v);
 Unc_RetVal unc0_ddelindx(struct Unc_View *w, Unc_Dict *o, Unc_Value *attr);
+Unc_RetVal unc0_dgetorsetindx(struct Unc_View *w, Unc_Dict *o,
+                              Unc_Value *attr, Unc_Value *v, Unc_Value *out);
+Unc_RetVal unc0_dcasindx(struct Unc_View *w, Unc_Dict *o, Unc_Value *attr,
+                         Unc_Value *expect, Unc_Value *v, int *ok);
 Unc_Size unc0_dgetsize(Unc_View *w, Unc_Dict *o);
 
 Unc_RetVal unc0_ogetattrv(struct Unc_View *w, Unc_Object *o,
@@ -155,6 +155,7 @@ SOFTWARE.
 #define UNC_I_DCALLS            0xD8
 #define UNC_I_DCALL             0xD9
 #define UNC_I_DTAIL             0xDA
+#define UNC_I_NDICTN            0xDB
 #define UNC_I_FCALLS            0xDC
 #define UNC_I_FCALL             0xDD
 #define UNC_I_FTAIL             0xDE
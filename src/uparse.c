@@ -1197,7 +1197,7 @@ static Unc_RetVal loctoexh_code(Unc_Allocator *alloc, Unc_ParserParent *p,
         }
         
         o = oo;
-        qi += qu;
+        qi = qc + i + qu;
         qu += i;
         qd = qu + 1;
         if (o > 0 && qi->o0type == UNC_QOPER_TYPE_LOCAL) {
@@ -1555,7 +1555,22 @@ static Unc_RetVal killvalue(Unc_ParserContext *c) {
 static Unc_RetVal eatexpr(Unc_ParserContext *c, int prec);
 static Unc_RetVal eatelist(Unc_ParserContext *c, int stack, Unc_Size *pushed);
 static Unc_RetVal eatfunc(Unc_ParserContext *c, int ftype);
-static Unc_RetVal eatobjdef(Unc_ParserContext *c, Unc_Dst tr);
+static Unc_RetVal eatobjdef(Unc_ParserContext *c, Unc_Dst tr, Unc_Size *n);
+
+/* tells the NDICT that made the table in tr how many entries it will have.
+   look for it from the end, since its index may have moved since */
+static void hintndict(Unc_ParserContext *c, Unc_Dst tr, Unc_Size n) {
+    Unc_Size i = c->cd_n;
+    while (i--) {
+        Unc_QInstr *q = &c->cd[i];
+        if (q->op == UNC_QINSTR_OP_NDICT && q->o0type == UNC_QOPER_TYPE_TMP
+                                         && q->o0data == tr) {
+            q->o1type = UNC_QOPER_TYPE_UNSIGN;
+            q->o1data.o = n;
+            return;
+        }
+    }
+}
 
 static Unc_RetVal wrapmov(Unc_ParserContext *c, Unc_QOperand *op) {
     if (!c->fence && c->next.op == UNC_QINSTR_OP_MOV) {
@@ -1730,13 +1745,16 @@ INLINE Unc_RetVal eatatomx(Unc_ParserContext *c, Unc_QOperand *op, int write) {
     case ULT_SBraceL:
     {
         Unc_Dst tr;
+        Unc_Size n;
         MUST(tmpalloc(c, &tr));
         consume(c);
         MUST(emit1(c, UNC_QINSTR_OP_NDICT, QOPER_TMP(tr)));
         if (!++c->allownl) return UNCIL_ERR(SYNTAX_TOODEEP);
-        MUST(eatobjdef(c, tr));
+        MUST(eatobjdef(c, tr, &n));
         if (peek(c) != ULT_SBraceR)
             return UNCIL_ERR(SYNTAX);
+        if (n)
+            hintndict(c, tr, n);
         consume(c);
         --c->allownl;
         writable = 0;
@@ -3708,9 +3726,10 @@ static Unc_RetVal eatdellist(Unc_ParserContext *c) {
     }
 }
 
-static Unc_RetVal eatobjdef(Unc_ParserContext *c, Unc_Dst tr) {
+static Unc_RetVal eatobjdef(Unc_ParserContext *c, Unc_Dst tr, Unc_Size *n) {
     Unc_Dst tr2, tr3 = 0;
     Unc_QOperand op;
+    *n = 0;
     MUST(tmpalloc(c, &tr2));
     for (;;) {
         switch (peek(c)) {
@@ -3767,6 +3786,7 @@ eatobjdef_gotvalue:
         MUST(wrapreg(c, &op, tr2));
         MUST(emit3(c, UNC_QINSTR_OP_SINDX,
                         QOPER_TMP(0), QOPER_TMP(tr), op.type, op.data));
+        ++*n;
         switch (peek(c)) {
         case ULT_SBraceR:
             return 0;
@@ -45,6 +45,8 @@ void unc0_initprogram(Unc_Program *program) {
     program->main_doff = 0;
     program->next = NULL;
     program->pname = NULL;
+    program->istrs = NULL;
+    program->istrs_n = 0;
 }
 
 Unc_RetVal unc0_upgradeprogram(Unc_Program *program, Unc_Allocator *alloc) {
@@ -62,6 +64,8 @@ void unc0_dropprogram(Unc_Program *program, Unc_Allocator *alloc) {
     unc0_mfree(alloc, program->code, program->code_sz);
     unc0_mfree(alloc, program->data, program->data_sz);
     if (program->pname) unc0_mmfree(alloc, program->pname);
+    if (program->istrs)
+        TMFREE(Unc_Entity *, alloc, program->istrs, program->istrs_n);
     unc0_initprogram(program);
 }
 
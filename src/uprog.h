@@ -42,6 +42,9 @@ typedef struct Unc_Program {
     Unc_Size main_doff;
     struct Unc_Program *next;
     char *pname; /* unc0_mmalloc */
+    /* interned strings by data offset, filled in as they are used */
+    Unc_Entity **istrs;
+    Unc_Size istrs_n;
 } Unc_Program;
 
 Unc_Program *unc0_newprogram(Unc_Allocator *alloc);
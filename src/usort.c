@@ -26,6 +26,7 @@ SOFTWARE.
 
 /* sorting algorithm based on WikiSort by M. McFadden */
 
+#include <limits.h>
 #include <setjmp.h>
 
 #define UNCIL_DEFINES
@@ -34,6 +35,7 @@ SOFTWARE.
 #include "ucompdef.h"
 #include "ucommon.h"
 #include "usort.h"
+#include "ustr.h"
 #include "uval.h"
 #include "uvali.h"
 #include "uvop.h"
@@ -46,11 +48,28 @@ struct unc0_sortenv {
     Unc_RetVal e;
     Unc_Value *buf;
     Unc_Size bufn;
+    /* if not NULL, the sorted values are int indices into keys */
+    Unc_Value *keys;
+    /* if not 0, every value compared is of this type (and not NaN) */
+    int kind;
 };
 
 static Unc_RetVal unc0_arrcmp(struct unc0_sortenv *s, Unc_Value *a,
                                                       Unc_Value *b) {
     Unc_RetVal e;
+    if (s->keys) {
+        a = &s->keys[VGETINT(a)];
+        b = &s->keys[VGETINT(b)];
+    }
+    switch (s->kind) {
+    case Unc_TInt:
+        return (VGETINT(a) > VGETINT(b)) - (VGETINT(a) < VGETINT(b));
+    case Unc_TFloat:
+        return (VGETFLT(a) > VGETFLT(b)) - (VGETFLT(a) < VGETFLT(b));
+    case Unc_TString:
+        return unc0_cmpstr(LEFTOVER(Unc_String, VGETENT(a)),
+                           LEFTOVER(Unc_String, VGETENT(b)));
+    }
     if (LIKELY(!s->fn)) {
         e = unc0_vvcmpe(s->w, a, b, s->e);
         if (UNLIKELY(UNCIL_IS_ERR_CMP(e))) goto unc0_arrcmp_err;
@@ -61,22 +80,18 @@ static Unc_RetVal unc0_arrcmp(struct unc0_sortenv *s, Unc_Value *a,
         Unc_Pile ret;
         Unc_Tuple tuple;
         if (UNLIKELY(s->e)) return 0;
-        if ((e = unc_newpile(w, &ret)))
-            return e;
+        /* the arguments go on the stack before the pile is made */
         if ((e = unc0_stackpush(w, &w->sval, 1, a)))
-            return e;
+            goto unc0_arrcmp_err;
         if ((e = unc0_stackpush(w, &w->sval, 1, b))) {
             unc0_restoredepth(w, &w->sval, d);
-            return e;
+            goto unc0_arrcmp_err;
         }
-        w->region.base[ret.r] -= 2;
-        e = unc0_fcallv(w, s->fn, 2, 1, 1, 1, 0);
-        if (!e)
-            e = unc0_run(w);
-        else if (UNCIL_IS_ERR(e))
+        if ((e = unc_call(w, s->fn, 2, &ret)))
             goto unc0_arrcmp_err;
         unc_returnvalues(w, &ret, &tuple);
         if (tuple.count < 1) {
+            unc_discard(w, &ret);
             e = unc_throwexc(w, "value", "comparator did not return a value");
             goto unc0_arrcmp_err;
         }
@@ -86,12 +101,14 @@ static Unc_RetVal unc0_arrcmp(struct unc0_sortenv *s, Unc_Value *a,
             break;
         case Unc_TFloat:
             if (tuple.values[0].v.f != tuple.values[0].v.f) {
+                unc_discard(w, &ret);
                 e = unc_throwexc(w, "value", "comparator returned NaN");
                 goto unc0_arrcmp_err;
             }
             e = unc0_cmpflt(tuple.values[0].v.f, 0);
             break;
         default:
+            unc_discard(w, &ret);
             e = unc_throwexc(w, "value",
                 "comparator did not return a valid numeric value");
             goto unc0_arrcmp_err;
@@ -1131,9 +1148,289 @@ INLINE Unc_RetVal unc0_arrsort_i(struct unc0_sortenv *s,
     return e;
 }
 
-Unc_RetVal unc0_arrsort(Unc_View *w, Unc_Value *fn,
-                        Unc_Size n, Unc_Value *arr) {
+/* arrays of at least this many ints or floats are radix sorted */
+#define RADIXMIN 64
+/* bits per radix sort pass */
+#define RADIXBITS 8
+#define RADIXN (1 << RADIXBITS)
+#define RADIXPASSES ((sizeof(Unc_UInt) * CHAR_BIT + RADIXBITS - 1) / RADIXBITS)
+#define RADIXSIGN ((Unc_UInt)1 << (sizeof(Unc_UInt) * CHAR_BIT - 1))
+
+/* returns the type shared by all n values if it is int, float or string,
+   and 0 otherwise. floats are only accepted if none of them are NaN */
+static int unc0_sortkind(Unc_Size n, const Unc_Value *a) {
+    Unc_Size i;
+    int t = VGETTYPE(a);
+    switch (t) {
+    case Unc_TInt:
+    case Unc_TString:
+        for (i = 1; i < n; ++i)
+            if (VGETTYPE(&a[i]) != t)
+                return 0;
+        return t;
+    case Unc_TFloat:
+        for (i = 0; i < n; ++i)
+            if (VGETTYPE(&a[i]) != t || VGETFLT(&a[i]) != VGETFLT(&a[i]))
+                return 0;
+        return t;
+    default:
+        return 0;
+    }
+}
+
+/* maps an int or float to an unsigned int that sorts the same way */
+INLINE Unc_UInt unc0_radixkey(int kind, const Unc_Value *v) {
+    Unc_UInt u = 0;
+    Unc_Float f;
+    if (kind == Unc_TInt)
+        return (Unc_UInt)VGETINT(v) ^ RADIXSIGN;
+    /* -0 and +0 compare equal and must stay in order, so they share a key */
+    f = VGETFLT(v);
+    if (f != 0)
+        unc0_memcpy(&u, &f, sizeof(u));
+    return (u & RADIXSIGN) ? ~u : u ^ RADIXSIGN;
+}
+
+#define RADIXVAL(i_) (keys ? &keys[VGETINT(&src[i_])] : &src[i_])
+
+/* stable LSD radix sort of n ints or floats (of the given kind), or of n
+   int indices into keys if keys is not NULL. tmp must have room for n
+   values and cnt for RADIXPASSES * RADIXN counts */
+static void unc0_radixsort_i(int kind, Unc_Size n, Unc_Value *a,
+                             Unc_Value *keys, Unc_Value *tmp, Unc_Size *cnt) {
+    Unc_Size i, p;
+    Unc_Value *src = a, *dst = tmp;
+
+    for (i = 0; i < RADIXPASSES * RADIXN; ++i)
+        cnt[i] = 0;
+    /* count the digits of every pass at once */
+    for (i = 0; i < n; ++i) {
+        Unc_UInt u = unc0_radixkey(kind, RADIXVAL(i));
+        for (p = 0; p < RADIXPASSES; ++p) {
+            ++cnt[p * RADIXN + (u & (RADIXN - 1))];
+            u >>= RADIXBITS;
+        }
+    }
+
+    for (p = 0; p < RADIXPASSES; ++p) {
+        Unc_Size *c = &cnt[p * RADIXN], q = 0, k;
+        unsigned shift = (unsigned)(p * RADIXBITS);
+        /* skip passes where every value has the same digit */
+        k = (unc0_radixkey(kind, RADIXVAL(0)) >> shift) & (RADIXN - 1);
+        if (c[k] == n) continue;
+        for (k = 0; k < RADIXN; ++k) {
+            Unc_Size t = c[k];
+            c[k] = q;
+            q += t;
+        }
+        for (i = 0; i < n; ++i) {
+            k = (unc0_radixkey(kind, RADIXVAL(i)) >> shift) & (RADIXN - 1);
+            dst[c[k]++] = src[i];
+        }
+        dst = src;
+        src = src == a ? tmp : a;
+    }
+
+    if (src != a)
+        TMEMCPY(Unc_Value, a, src, n);
+}
+
+#undef RADIXVAL
+
+/* as unc0_radixsort_i, but allocates its own buffers. only fails if out of
+   memory, or if floats cannot be radix sorted */
+static Unc_RetVal unc0_radixsort(Unc_View *w, int kind, Unc_Size n,
+                                 Unc_Value *a, Unc_Value *keys) {
+    Unc_Allocator *alloc = &w->world->alloc;
+    Unc_Size *cnt;
+    Unc_Value *tmp;
+
+    if (kind == Unc_TFloat && sizeof(Unc_Float) != sizeof(Unc_UInt))
+        return UNCIL_ERR_MEM;
+    tmp = TMALLOC(Unc_Value, alloc, Unc_AllocInternal, n);
+    if (!tmp) return UNCIL_ERR_MEM;
+    cnt = TMALLOC(Unc_Size, alloc, Unc_AllocInternal, RADIXPASSES * RADIXN);
+    if (!cnt) {
+        TMFREE(Unc_Value, alloc, tmp, n);
+        return UNCIL_ERR_MEM;
+    }
+    unc0_radixsort_i(kind, n, a, keys, tmp, cnt);
+    TMFREE(Unc_Size, alloc, cnt, RADIXPASSES * RADIXN);
+    TMFREE(Unc_Value, alloc, tmp, n);
+    return 0;
+}
+
+#if UNCIL_MT_OK
+/* arrays of at least this many items that can be compared natively are
+   sorted on multiple threads by default */
+#ifndef UNCIL_SORT_PARALLEL
+#define UNCIL_SORT_PARALLEL 1048576
+#endif
+/* every thread gets at least this many items to sort */
+#define PARMIN 4096
+
+/* stable merge of l[0..ln[ and r[0..rn[ into out */
+static void unc0_psort_merge(struct unc0_sortenv *s,
+                             Unc_Value *l, Unc_Size ln,
+                             Unc_Value *r, Unc_Size rn, Unc_Value *out) {
+    Unc_Value *le = l + ln, *re = r + rn;
+    while (l < le && r < re)
+        *out++ = CMP(r, l) < 0 ? *r++ : *l++;
+    if (l < le) COPY_N(out, l, le - l);
+    if (r < re) COPY_N(out, r, re - r);
+}
+
+/* the number of items taken from l when the first k items of the merge of
+   l[0..ln[ and r[0..rn[ are taken ("merge path" partitioning) */
+static Unc_Size unc0_psort_corank(struct unc0_sortenv *s, Unc_Size k,
+                                  Unc_Value *l, Unc_Size ln,
+                                  Unc_Value *r, Unc_Size rn) {
+    Unc_Size lo = k > rn ? k - rn : 0, hi = k < ln ? k : ln;
+    while (lo < hi) {
+        Unc_Size i = lo + (hi - lo) / 2;
+        if (CMP(&r[k - i - 1], &l[i]) < 0)
+            hi = i;
+        else
+            lo = i + 1;
+    }
+    return lo;
+}
+
+/* stable bottom-up merge sort with a buffer of n values */
+static void unc0_psort_msort(struct unc0_sortenv *s, Unc_Size n,
+                             Unc_Value *a, Unc_Value *buf) {
+    Unc_Size i, width;
+    Unc_Value *src = a, *dst = buf, *t;
+    for (i = 0; i < n; i += IBUF)
+        unc0_sortins(s, a + i, a + MIN(i + IBUF, n));
+    for (width = IBUF; width < n; width *= 2) {
+        for (i = 0; i < n; i += 2 * width) {
+            Unc_Size m = MIN(i + width, n), e = MIN(i + 2 * width, n);
+            unc0_psort_merge(s, src + i, m - i, src + m, e - m, dst + i);
+        }
+        t = src, src = dst, dst = t;
+    }
+    if (src != a)
+        COPY_N(a, src, n);
+}
+
+struct unc0_psort {
+    struct unc0_sortenv *s;
+    Unc_Value *a, *buf;
+    Unc_Size n, chunks;
+    Unc_Size *cnt;
+    /* for merge passes: source, destination, chunks per run and tasks per
+       pair of runs being merged */
+    Unc_Value *src, *dst;
+    Unc_Size width, parts;
+};
+
+#define PSORT_CHUNK(p_, i_) ((p_)->n / (p_)->chunks * (i_)                    \
+                    + ((p_)->n % (p_)->chunks * (i_)) / (p_)->chunks)
+
+static void unc0_psort_chunk(void *q, Unc_Size i) {
+    struct unc0_psort *p = q;
+    struct unc0_sortenv *s = p->s;
+    Unc_Size lo = PSORT_CHUNK(p, i), n = PSORT_CHUNK(p, i + 1) - lo;
+    if ((s->kind == Unc_TInt || (s->kind == Unc_TFloat
+                && sizeof(Unc_Float) == sizeof(Unc_UInt))) && n >= RADIXMIN)
+        unc0_radixsort_i(s->kind, n, p->a + lo, s->keys, p->buf + lo,
+                         p->cnt + i * RADIXPASSES * RADIXN);
+    else
+        unc0_psort_msort(s, n, p->a + lo, p->buf + lo);
+}
+
+static void unc0_psort_pass(void *q, Unc_Size t) {
+    struct unc0_psort *p = q;
+    struct unc0_sortenv *s = p->s;
+    Unc_Size pair = t / p->parts, part = t % p->parts;
+    Unc_Size c = pair * 2 * p->width;
+    Unc_Size lo = PSORT_CHUNK(p, c);
+    Unc_Size mid = PSORT_CHUNK(p, MIN(c + p->width, p->chunks));
+    Unc_Size hi = PSORT_CHUNK(p, MIN(c + 2 * p->width, p->chunks));
+    Unc_Size ln = mid - lo, rn = hi - mid;
+    Unc_Size k0 = (hi - lo) / p->parts * part
+                + (hi - lo) % p->parts * part / p->parts;
+    Unc_Size k1 = (hi - lo) / p->parts * (part + 1)
+                + (hi - lo) % p->parts * (part + 1) / p->parts;
+    Unc_Value *l = p->src + lo, *r = p->src + mid;
+    Unc_Size i0 = unc0_psort_corank(s, k0, l, ln, r, rn);
+    Unc_Size i1 = unc0_psort_corank(s, k1, l, ln, r, rn);
+    unc0_psort_merge(s, l + i0, i1 - i0, r + (k0 - i0), (k1 - i1) - (k0 - i0),
+                     p->dst + lo + k0);
+}
+
+/* sorts the chunks on their own threads and then merges pairs of runs
+   until one is left, splitting every merge among the threads */
+static Unc_RetVal unc0_psort(struct unc0_sortenv *s, Unc_Size n,
+                             Unc_Value *arr, Unc_Size threads) {
+    Unc_Allocator *alloc = &s->w->world->alloc;
+    struct unc0_psort p;
+    Unc_Value *t;
+
+    p.buf = TMALLOC(Unc_Value, alloc, Unc_AllocInternal, n);
+    if (!p.buf) return UNCIL_ERR_MEM;
+    p.cnt = TMALLOC(Unc_Size, alloc, Unc_AllocInternal,
+                    threads * RADIXPASSES * RADIXN);
+    if (!p.cnt) {
+        TMFREE(Unc_Value, alloc, p.buf, n);
+        return UNCIL_ERR_MEM;
+    }
+    p.s = s;
+    p.a = arr;
+    p.n = n;
+    p.chunks = threads;
+    unc0_mtfork(threads, threads, &unc0_psort_chunk, &p);
+
+    p.src = arr;
+    p.dst = p.buf;
+    for (p.width = 1; p.width < p.chunks; p.width *= 2) {
+        Unc_Size pairs = (p.chunks + 2 * p.width - 1) / (2 * p.width);
+        p.parts = (threads + pairs - 1) / pairs;
+        unc0_mtfork(pairs * p.parts, threads, &unc0_psort_pass, &p);
+        t = p.src, p.src = p.dst, p.dst = t;
+    }
+    if (p.src != arr)
+        COPY_N(arr, p.src, n);
+
+    TMFREE(Unc_Size, alloc, p.cnt, threads * RADIXPASSES * RADIXN);
+    TMFREE(Unc_Value, alloc, p.buf, n);
+    return 0;
+}
+
+#undef PSORT_CHUNK
+#endif /* UNCIL_MT_OK */
+
+static Unc_RetVal unc0_arrsort_go(struct unc0_sortenv *s, Unc_Size n,
+                                  Unc_Value *arr, Unc_Size threads) {
     Unc_RetVal e;
+    if (!s->fn) {
+        s->kind = unc0_sortkind(n, s->keys ? s->keys : arr);
+#if UNCIL_MT_OK
+        if (!threads)
+            threads = n >= UNCIL_SORT_PARALLEL ? unc0_mtcpucount() : 1;
+        if (threads > n / PARMIN)
+            threads = n / PARMIN;
+        if (s->kind && threads > 1) {
+            e = unc0_psort(s, n, arr, threads);
+            if (!e) return 0;
+        }
+#else
+        (void)threads;
+#endif
+        if ((s->kind == Unc_TInt || s->kind == Unc_TFloat) && n >= RADIXMIN) {
+            /* if out of memory, fall back to the in-place sort */
+            e = unc0_radixsort(s->w, s->kind, n, arr, s->keys);
+            if (!e) return 0;
+        }
+    }
+    e = unc0_arrsort_i(s, arr, arr + n);
+    if (s->buf) TMFREE(Unc_Value, &s->w->world->alloc, s->buf, s->bufn);
+    return e;
+}
+
+Unc_RetVal unc0_arrsort(Unc_View *w, Unc_Value *fn,
+                        Unc_Size n, Unc_Value *arr, Unc_Size threads) {
     struct unc0_sortenv s;
     if (n < 2) return 0;
 
@@ -1142,9 +1439,49 @@ Unc_RetVal unc0_arrsort(Unc_View *w, Unc_Value *fn,
     s.fn = fn;
     s.w = w;
     s.e = 0;
-    
-    e = unc0_arrsort_i(&s, arr, arr + n);
+    s.keys = NULL;
+    s.kind = 0;
+    return unc0_arrsort_go(&s, n, arr, threads);
+}
+
+Unc_RetVal unc0_arrsortby(Unc_View *w, Unc_Value *fn, Unc_Size n,
+                          Unc_Value *keys, Unc_Value *arr, Unc_Size threads) {
+    Unc_RetVal e;
+    struct unc0_sortenv s;
+    Unc_Value *indx;
+    Unc_Size i;
+    if (n < 2) return 0;
+
+    indx = TMALLOC(Unc_Value, &w->world->alloc, Unc_AllocInternal, n);
+    if (!indx) return UNCIL_ERR_MEM;
+    for (i = 0; i < n; ++i)
+        VINITINT(&indx[i], (Unc_Int)i);
 
-    if (s.buf) TMFREE(Unc_Value, &w->world->alloc, s.buf, s.bufn);
+    s.buf = NULL;
+    s.bufn = 0;
+    s.fn = fn;
+    s.w = w;
+    s.e = 0;
+    s.keys = keys;
+    s.kind = 0;
+    e = unc0_arrsort_go(&s, n, indx, threads);
+
+    if (!e) {
+        /* apply the permutation in place by following its cycles */
+        for (i = 0; i < n; ++i) {
+            Unc_Size j = i, k;
+            Unc_Value v;
+            if ((Unc_Size)VGETINT(&indx[i]) == i) continue;
+            v = arr[i];
+            while ((k = (Unc_Size)VGETINT(&indx[j])) != i) {
+                arr[j] = arr[k];
+                VINITINT(&indx[j], (Unc_Int)j);
+                j = k;
+            }
+            arr[j] = v;
+            VINITINT(&indx[j], (Unc_Int)j);
+        }
+    }
+    TMFREE(Unc_Value, &w->world->alloc, indx, n);
     return e;
 }
@@ -29,7 +29,13 @@ SOFTWARE.
 
 #include "uval.h"
 
+/* threads is the most threads to sort on if fn is NULL, or 0 to choose
+   automatically (more than one only for large arrays) */
 Unc_RetVal unc0_arrsort(Unc_View *w, Unc_Value *fn,
-                        Unc_Size n, Unc_Value *arr);
+                        Unc_Size n, Unc_Value *arr, Unc_Size threads);
+/* sorts arr by keys, where keys[i] is the key of arr[i]. fn, if not NULL,
+   compares keys. keys is not modified */
+Unc_RetVal unc0_arrsortby(Unc_View *w, Unc_Value *fn, Unc_Size n,
+                          Unc_Value *keys, Unc_Value *arr, Unc_Size threads);
 
 #endif /* UNCIL_USORT_H */
@@ -30,12 +30,17 @@ SOFTWARE.
 #include "uncil.h"
 #include "ustr.h"
 #include "uutf.h"
+#include "uvali.h"
+#include "uview.h"
 
 /* create empty string */
 Unc_RetVal unc0_initstringempty(Unc_Allocator *alloc, Unc_String *s) {
     (void)alloc;
     s->size = 0;
     s->flags = 0;
+    s->index = NULL;
+    s->lflags = 0;
+    s->hash = 0;
     return 0;
 }
 
@@ -49,11 +54,15 @@ Unc_RetVal unc0_initstring(Unc_Allocator *alloc, Unc_String *s,
         unc0_memcpy(p, b, n);
         p[n] = 0;
         s->d.b.data.p = p;
+        s->d.b.u.cap = n;
     } else {
         unc0_memcpy(s->d.a, b, n);
         s->d.a[n] = 0;
     }
     s->flags = 0;
+    s->index = NULL;
+    s->lflags = 0;
+    s->hash = 0;
     return 0;
 }
 
@@ -76,6 +85,9 @@ static Unc_RetVal unc0_initstringnotowned(Unc_Allocator *alloc, Unc_String *s,
         s->d.a[n] = 0,
         s->flags = 0;
     }
+    s->index = NULL;
+    s->lflags = 0;
+    s->hash = 0;
     return 0;
 }
 
@@ -91,12 +103,16 @@ Unc_RetVal unc0_initstringmove(Unc_Allocator *alloc, Unc_String *s,
     if (n > UNC_INT_MAX) return UNCIL_ERR_ARG_STRINGTOOLONG;
     if ((s->size = n) >= UNC_STRING_SHORT) {
         s->d.b.data.c = b;
+        s->d.b.u.cap = n;
     } else {
         unc0_memcpy(s->d.a, b, n);
         s->d.a[n] = 0;
         unc0_mfree(alloc, b, n);
     }
     s->flags = 0;
+    s->index = NULL;
+    s->lflags = 0;
+    s->hash = 0;
     return 0;
 }
 
@@ -113,12 +129,16 @@ Unc_RetVal unc0_initstringfromcat(Unc_Allocator *alloc, Unc_String *s,
         unc0_memcpy(p + an, b, bn);
         p[n] = 0;
         s->d.b.data.p = p;
+        s->d.b.u.cap = n;
     } else {
         byte *p = s->d.a;
         unc0_memcpy(p, a, an);
         unc0_memcpy(p + an, b, bn);
     }
     s->flags = 0;
+    s->index = NULL;
+    s->lflags = 0;
+    s->hash = 0;
     return 0;
 }
 
@@ -139,8 +159,65 @@ Unc_RetVal unc0_initstringfromcatr(Unc_Allocator *alloc, Unc_String *s,
 /* create string by concatenating a and b (Uncil strings) */
 Unc_RetVal unc0_initstringfromcatlr(Unc_Allocator *alloc, Unc_String *s,
                         const Unc_String *a, const Unc_String *b) {
-    return unc0_initstringfromcat(alloc, s, a->size, unc0_getstringdata(a),
-                                            b->size, unc0_getstringdata(b));
+    Unc_RetVal e = unc0_initstringfromcat(alloc, s,
+                                    a->size, unc0_getstringdata(a),
+                                    b->size, unc0_getstringdata(b));
+    if (!e && (a->lflags & b->lflags & UNC_STRING_LFLAG_ASCII))
+        s->lflags |= UNC_STRING_LFLAG_ASCII;
+    return e;
+}
+
+/* size of the code point index of a string with n code points (n > 0) */
+#define UNC_STRING_INDEXSIZE(n) (sizeof(Unc_Size)                              \
+                            * (2 + ((n) - 1) / UNC_STRING_INDEXSTEP))
+
+static void unc0_strdropindex(Unc_Allocator *alloc, Unc_String *s) {
+    unc0_mfree(alloc, s->index, UNC_STRING_INDEXSIZE(s->index[0]));
+    s->index = NULL;
+}
+
+/* whether s may be appended to in place. the caller must also make sure
+   that nobody else holds a reference to s */
+int unc0_strcanappend(const Unc_String *s) {
+    return !(s->flags & (UNC_STRING_FLAG_NOTOWNED | UNC_STRING_FLAG_INTERNED
+                       | UNC_STRING_FLAG_SLICE));
+}
+
+/* append n bytes from b to s in place. the buffer grows geometrically,
+   so building a string piece by piece takes linear time. b must not
+   point into s */
+Unc_RetVal unc0_strappend(Unc_Allocator *alloc, Unc_String *s,
+                          Unc_Size n, const byte *b) {
+    Unc_Size on = s->size, nn = on + n;
+    byte *p;
+    if (nn > UNC_INT_MAX || nn < on) return UNCIL_ERR_ARG_STRINGTOOLONG;
+    if (s->index) unc0_strdropindex(alloc, s);
+    if (nn < UNC_STRING_SHORT) {
+        p = s->d.a;
+    } else if (on < UNC_STRING_SHORT) {
+        Unc_Size c = nn * 2 > nn && nn * 2 <= UNC_INT_MAX ? nn * 2 : nn;
+        p = unc0_malloc(alloc, Unc_AllocString, c + 1);
+        if (!p) return UNCIL_ERR_MEM;
+        unc0_memcpy(p, s->d.a, on);
+        s->d.b.data.p = p;
+        s->d.b.u.cap = c;
+    } else if (nn > s->d.b.u.cap) {
+        Unc_Size c = s->d.b.u.cap + (s->d.b.u.cap >> 1);
+        if (c < nn || c > UNC_INT_MAX) c = nn;
+        p = unc0_mrealloc(alloc, Unc_AllocString, s->d.b.data.p,
+                          s->d.b.u.cap + 1, c + 1);
+        if (!p) return UNCIL_ERR_MEM;
+        s->d.b.data.p = p;
+        s->d.b.u.cap = c;
+    } else {
+        p = s->d.b.data.p;
+    }
+    unc0_memcpy(p + on, b, n);
+    p[nn] = 0;
+    s->size = nn;
+    s->lflags &= ~UNC_STRING_LFLAG_ASCII;
+    s->hash = 0;
+    return 0;
 }
 
 /* pointer to string data */
@@ -152,10 +229,104 @@ const byte *unc0_getstringdata(const Unc_String *s) {
         return s->d.a;
 }
 
+/* create string from the n bytes at b, which lie within the string base.
+   long enough substrings become slices sharing the buffer of base */
+Unc_RetVal unc0_initstringslice(Unc_View *w, Unc_String *s,
+                        Unc_Entity *base, Unc_Size n, const byte *b) {
+    Unc_String *bs = LEFTOVER(Unc_String, base);
+    if (bs->flags & UNC_STRING_FLAG_SLICE) {
+        /* slice the original buffer unless b is in our own copy of it */
+        Unc_String *os = LEFTOVER(Unc_String, bs->d.b.u.base);
+        const byte *od = unc0_getstringdata(os);
+        if (b >= od && b + n <= od + os->size)
+            base = bs->d.b.u.base, bs = os;
+    }
+    if (n < UNC_STRING_SLICEMIN || n < bs->size / UNC_STRING_SLICERATIO
+            || (bs->flags & UNC_STRING_FLAG_NOTOWNED)) {
+        Unc_RetVal e = unc0_initstring(&w->world->alloc, s, n, b);
+        if (!e) s->lflags |= bs->lflags & UNC_STRING_LFLAG_ASCII;
+        return e;
+    }
+    s->size = n;
+    s->d.b.data.c = b;
+    s->d.b.u.base = base;
+    s->flags = UNC_STRING_FLAG_SLICE;
+    s->index = NULL;
+    s->lflags = bs->lflags & UNC_STRING_LFLAG_ASCII;
+    s->hash = 0;
+    UNCIL_INCREFE(w, base);
+    return 0;
+}
+
+/* create a new string value from the n bytes at b, which lie within the
+   string value base (see unc0_initstringslice). the bytes must be valid
+   UTF-8 */
+Unc_RetVal unc0_newstringslice(Unc_View *w, Unc_Value *v,
+                        Unc_Value *base, Unc_Size n, const byte *b) {
+    Unc_RetVal e;
+    Unc_Value tmp;
+    /* base may be moved by a collection in unc0_vrefnew */
+    Unc_Entity *be = VGETENT(base);
+    e = unc0_vrefnew(w, &tmp, Unc_TString);
+    if (e) return e;
+    e = unc0_initstringslice(w, LEFTOVER(Unc_String, VGETENT(&tmp)),
+                             be, n, b);
+    if (e)
+        unc0_unwake(VGETENT(&tmp), w);
+    else
+        VMOVE(w, v, &tmp);
+    return e;
+}
+
+/* make sure the data of s is followed by a null terminator. slices that
+   do not end where their base does get a copy of their own */
+Unc_RetVal unc0_strterminate(Unc_View *w, Unc_String *s) {
+    Unc_Size n = s->size;
+    const byte *d;
+    byte *p;
+    if (!(s->flags & UNC_STRING_FLAG_SLICE))
+        return 0;
+    /* another thread may have just made the copy */
+    (void)UNC_LOCKFP(w, w->world->entity_lock);
+    d = s->d.b.data.c;
+    UNC_UNLOCKF(w->world->entity_lock);
+    if (!d[n]) return 0;
+    p = unc0_malloc(&w->world->alloc, Unc_AllocString, n + 1);
+    if (!p) return UNCIL_ERR_MEM;
+    unc0_memcpy(p, d, n);
+    p[n] = 0;
+    /* readers on other threads may still be using the old data, which
+       stays valid because the base is kept until the slice is dropped */
+    (void)UNC_LOCKFP(w, w->world->entity_lock);
+    if (!(s->lflags & UNC_STRING_LFLAG_SLICECOPY)) {
+        s->d.b.data.p = p;
+        s->lflags |= UNC_STRING_LFLAG_SLICECOPY;
+        p = NULL;
+    }
+    UNC_UNLOCKF(w->world->entity_lock);
+    if (p) unc0_mfree(&w->world->alloc, p, n + 1);
+    return 0;
+}
+
 /* drop/delete string */
-void unc0_dropstring(Unc_Allocator *alloc, Unc_String *s) {
-    if (s->size >= UNC_STRING_SHORT && !(s->flags & UNC_STRING_FLAG_NOTOWNED))
-        unc0_mfree(alloc, s->d.b.data.p, s->size + 1);
+void unc0_dropstring(Unc_View *w, Unc_String *s) {
+    if (s->flags & UNC_STRING_FLAG_SLICE) {
+        Unc_Entity *base = s->d.b.u.base;
+        unc0_sunsetstring(&w->world->alloc, s);
+        UNCIL_DECREFE(w, base);
+    } else
+        unc0_sunsetstring(&w->world->alloc, s);
+}
+
+/* sunset string (free without releasing the base of a slice) */
+void unc0_sunsetstring(Unc_Allocator *alloc, Unc_String *s) {
+    if (s->index) unc0_strdropindex(alloc, s);
+    if (s->flags & UNC_STRING_FLAG_SLICE) {
+        if (s->lflags & UNC_STRING_LFLAG_SLICECOPY)
+            unc0_mfree(alloc, s->d.b.data.p, s->size + 1);
+    } else if (s->size >= UNC_STRING_SHORT
+            && !(s->flags & UNC_STRING_FLAG_NOTOWNED))
+        unc0_mfree(alloc, s->d.b.data.p, s->d.b.u.cap + 1);
 }
 
 /* string-string equality check */
@@ -188,6 +359,87 @@ int unc0_cmpstr(Unc_String *a, Unc_String *b) {
     return 0;
 }
 
+/* the code point index of s, or NULL if s is all ASCII (in which case the
+   flag is set), too short to be worth indexing or memory ran out */
+static const Unc_Size *unc0_strindex(Unc_View *w, Unc_String *s) {
+    const byte *d, *p, *e;
+    Unc_Size n, k, *x;
+    if (s->lflags & UNC_STRING_LFLAG_ASCII) return NULL;
+    if (s->index) return s->index;
+    d = unc0_getstringdata(s);
+    n = unc0_utf8unshift(d, s->size);
+    if (n == s->size) {
+        (void)UNC_LOCKFP(w, w->world->entity_lock);
+        s->lflags |= UNC_STRING_LFLAG_ASCII;
+        UNC_UNLOCKF(w->world->entity_lock);
+        return NULL;
+    }
+    if (s->size < UNC_STRING_INDEXMIN) return NULL;
+    x = unc0_malloc(&w->world->alloc, Unc_AllocString,
+                    UNC_STRING_INDEXSIZE(n));
+    if (!x) return NULL;
+    x[0] = n;
+    x[1] = 0;
+    e = d + s->size;
+    for (k = 1, p = d; k <= (n - 1) / UNC_STRING_INDEXSTEP; ++k) {
+        p = unc0_utf8scanforw(p, e, UNC_STRING_INDEXSTEP);
+        x[1 + k] = p - d;
+    }
+    /* another thread may have built one at the same time */
+    (void)UNC_LOCKFP(w, w->world->entity_lock);
+    if (!s->index) {
+        s->index = x;
+        x = NULL;
+    }
+    UNC_UNLOCKF(w->world->entity_lock);
+    if (x) unc0_mfree(&w->world->alloc, x, UNC_STRING_INDEXSIZE(n));
+    return s->index;
+}
+
+/* number of code points in s */
+Unc_Size unc0_strlength(Unc_View *w, Unc_String *s) {
+    const Unc_Size *x = unc0_strindex(w, s);
+    if (x) return x[0];
+    if (s->lflags & UNC_STRING_LFLAG_ASCII) return s->size;
+    return unc0_utf8unshift(unc0_getstringdata(s), s->size);
+}
+
+/* pointer to code point i of s, the end of s if i is the number of code
+   points in it, and NULL if i is beyond that */
+const byte *unc0_strcodepat(Unc_View *w, Unc_String *s, Unc_Size i) {
+    const byte *d = unc0_getstringdata(s);
+    const Unc_Size *x = unc0_strindex(w, s);
+    Unc_Size n = s->size;
+    if (x) {
+        if (i >= x[0]) return i == x[0] ? d + n : NULL;
+        return unc0_utf8scanforw(d + x[1 + i / UNC_STRING_INDEXSTEP], d + n,
+                                 i % UNC_STRING_INDEXSTEP);
+    }
+    if (s->lflags & UNC_STRING_LFLAG_ASCII) return i <= n ? d + i : NULL;
+    return unc0_utf8shift(d, &n, i);
+}
+
+/* index of the code point at byte offset off of s */
+Unc_Size unc0_strcodepof(Unc_View *w, Unc_String *s, Unc_Size off) {
+    const byte *d = unc0_getstringdata(s);
+    const Unc_Size *x = unc0_strindex(w, s);
+    if (x) {
+        /* find the last indexed code point at or before off */
+        Unc_Size lo = 0, hi = (x[0] - 1) / UNC_STRING_INDEXSTEP;
+        while (lo < hi) {
+            Unc_Size mid = hi - (hi - lo) / 2;
+            if (x[1 + mid] <= off)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        return lo * UNC_STRING_INDEXSTEP
+             + unc0_utf8unshift(d + x[1 + lo], off - x[1 + lo]);
+    }
+    if (s->lflags & UNC_STRING_LFLAG_ASCII) return off;
+    return unc0_utf8unshift(d, off);
+}
+
 /* string code point index getter */
 Unc_RetVal unc0_sgetcodepat(Unc_View *w, Unc_String *s, Unc_Value *indx,
                                  int permissive, Unc_Value *out) {
@@ -201,27 +453,19 @@ Unc_RetVal unc0_sgetcodepat(Unc_View *w, Unc_String *s, Unc_Value *indx,
         return e;
     }
     if (i < 0) {
-        const byte *d = unc0_getstringdata(s);
-        const byte *p = unc0_utf8scanbackw(d, d + s->size, -(i + 1));
-        if (!p) {
-            if (permissive) {
-                VSETNULL(w, out);
-                return 0;
-            }
-            return UNCIL_ERR_ARG_INDEXOUTOFBOUNDS;
-        }
-        s0 = p;
-    } else {
-        const byte *d = unc0_getstringdata(s);
-        const byte *p = unc0_utf8scanforw(d, d + s->size, i);
-        if (!p) {
-            if (permissive) {
-                VSETNULL(w, out);
-                return 0;
-            }
-            return UNCIL_ERR_ARG_INDEXOUTOFBOUNDS;
+        Unc_Size l = unc0_strlength(w, s);
+        if ((Unc_Size)-i > l)
+            s0 = NULL;
+        else
+            s0 = unc0_strcodepat(w, s, l - (Unc_Size)-i);
+    } else
+        s0 = unc0_strcodepat(w, s, (Unc_Size)i);
+    if (!s0 || s0 == unc0_getstringdata(s) + s->size) {
+        if (permissive) {
+            VSETNULL(w, out);
+            return 0;
         }
-        s0 = p;
+        return UNCIL_ERR_ARG_INDEXOUTOFBOUNDS;
     }
     s1 = unc0_utf8nextchar(s0, &n);
     return unc_newstring(w, out, s1 - s0, (const char *)s0);
@@ -36,13 +36,39 @@ typedef struct Unc_StringData {
         byte *p;
         const byte *c;
     } data;
-    void *pad_;
+    union {
+        Unc_Size cap;           /* bytes allocated for data, minus one */
+        Unc_Entity *base;       /* if UNC_STRING_FLAG_SLICE */
+    } u;
 } Unc_StringData;
 
 /* must be at least 1 */
 #define UNC_STRING_SHORT sizeof(Unc_StringData)
 
+/* substrings at least this long share the buffer of the string they were
+   taken from instead of copying it... */
+#define UNC_STRING_SLICEMIN 64
+/* ...unless they are shorter than 1/UNC_STRING_SLICERATIO of it, so that
+   a small slice does not keep a large buffer alive */
+#define UNC_STRING_SLICERATIO 8
+
+/* strings with non-ASCII characters at least this long get an index for
+   finding code points by their index, with the byte offset of every
+   UNC_STRING_INDEXSTEP-th code point */
+#define UNC_STRING_INDEXMIN 256
+#define UNC_STRING_INDEXSTEP 64
+
 #define UNC_STRING_FLAG_NOTOWNED 1
+#define UNC_STRING_FLAG_INTERNED 4
+/* data points into the buffer of u.base, and is not terminated */
+#define UNC_STRING_FLAG_SLICE 8
+
+/* lflags are set lazily on strings other threads may already see, and
+   are only ever changed while holding entity_lock */
+/* slice whose data has been copied to a terminated buffer of its own */
+#define UNC_STRING_LFLAG_SLICECOPY 1
+/* known to consist only of ASCII characters */
+#define UNC_STRING_LFLAG_ASCII 2
 
 typedef struct Unc_String {
     Unc_Size size;
@@ -51,6 +77,11 @@ typedef struct Unc_String {
         Unc_StringData b;
     } d;
     int flags;
+    int lflags;
+    Unc_AtomicLarge hash;       /* 0 until computed by unc0_hashvalue */
+    /* built on demand; [0] = number of code points, [1 + k] = byte offset
+       of code point k * UNC_STRING_INDEXSTEP */
+    Unc_Size *index;
 } Unc_String;
 
 Unc_RetVal unc0_initstringempty(Unc_Allocator *alloc, Unc_String *s);
@@ -72,15 +103,28 @@ Unc_RetVal unc0_initstringfromcatr(Unc_Allocator *alloc, Unc_String *s,
                         Unc_Size n, const byte *a, const Unc_String *b);
 Unc_RetVal unc0_initstringfromcatlr(Unc_Allocator *alloc, Unc_String *s,
                         const Unc_String *a, const Unc_String *b);
+int unc0_strcanappend(const Unc_String *s);
+Unc_RetVal unc0_strappend(Unc_Allocator *alloc, Unc_String *s,
+                          Unc_Size n, const byte *b);
 const byte *unc0_getstringdata(const Unc_String *s);
-void unc0_dropstring(Unc_Allocator *alloc, Unc_String *s);
+
+struct Unc_View;
+Unc_RetVal unc0_initstringslice(struct Unc_View *w, Unc_String *s,
+                        Unc_Entity *base, Unc_Size n, const byte *b);
+Unc_RetVal unc0_newstringslice(struct Unc_View *w, Unc_Value *v,
+                        Unc_Value *base, Unc_Size n, const byte *b);
+Unc_RetVal unc0_strterminate(struct Unc_View *w, Unc_String *s);
+void unc0_dropstring(struct Unc_View *w, Unc_String *s);
+void unc0_sunsetstring(Unc_Allocator *alloc, Unc_String *s);
 
 int unc0_streq(Unc_String *a, Unc_String *b);
 int unc0_streqr(Unc_String *a, Unc_Size n, const byte *b);
 int unc0_cmpstr(Unc_String *a, Unc_String *b);
 int unc0_strreqr(Unc_Size an, const byte *a, Unc_Size bn, const byte *b);
 
-struct Unc_View;
+Unc_Size unc0_strlength(struct Unc_View *w, Unc_String *s);
+const byte *unc0_strcodepat(struct Unc_View *w, Unc_String *s, Unc_Size i);
+Unc_Size unc0_strcodepof(struct Unc_View *w, Unc_String *s, Unc_Size off);
 Unc_RetVal unc0_sgetcodepat(struct Unc_View *w, Unc_String *s, Unc_Value *i,
                      int permissive, Unc_Value *v);
 const byte *unc0_strsearch(const byte *haystack, Unc_Size haystack_n,
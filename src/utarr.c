@@ -0,0 +1,331 @@
+/*******************************************************************************
+ 
+Uncil -- typed array impl
+
+Copyright (c) 2021-2023 Sampo Hippeläinen (hisahi)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*******************************************************************************/
+
+#define UNCIL_DEFINES
+
+#include "uarithm.h"
+#include "ublob.h"
+#include "udebug.h"
+#include "uerr.h"
+#include "umem.h"
+#include "uncil.h"
+#include "utarr.h"
+#include "uval.h"
+#include "uvali.h"
+
+static const char * const unc0_takindnames[UNC_TA_KINDS] = {
+    "int",
+    "float",
+    "int8",
+    "uint8",
+    "int16",
+    "uint16",
+    "int32",
+    "uint32",
+    "float32"
+};
+
+static const unsigned char unc0_taelemsizes[UNC_TA_KINDS] = {
+    sizeof(Unc_Int),
+    sizeof(Unc_Float),
+    sizeof(signed char),
+    sizeof(unsigned char),
+    sizeof(ta_i16),
+    sizeof(ta_u16),
+    sizeof(ta_i32),
+    sizeof(ta_u32),
+    sizeof(float)
+};
+
+/* returns -1 if no such kind */
+int unc0_takindbyname(Unc_Size n, const byte *s) {
+    int k;
+    for (k = 0; k < UNC_TA_KINDS; ++k) {
+        const char *c = unc0_takindnames[k];
+        if (unc0_strlen(c) == n && !unc0_memcmp(c, s, n))
+            return k;
+    }
+    /* the native kinds can also be named by their width */
+    if (n == 5 && !unc0_memcmp(s, "int64", 5) && sizeof(Unc_Int) == 8)
+        return UNC_TA_INT;
+    if (n == 7 && !unc0_memcmp(s, "float64", 7) && sizeof(Unc_Float) == 8)
+        return UNC_TA_FLOAT;
+    return -1;
+}
+
+const char *unc0_takindname(int kind) {
+    ASSERT(kind >= 0 && kind < UNC_TA_KINDS);
+    return unc0_takindnames[kind];
+}
+
+Unc_Size unc0_taelemsize(int kind) {
+    ASSERT(kind >= 0 && kind < UNC_TA_KINDS);
+    return unc0_taelemsizes[kind];
+}
+
+int unc0_takindisfloat(int kind) {
+    return kind == UNC_TA_FLOAT || kind == UNC_TA_FLOAT32;
+}
+
+/* the blob must already hold a reference for the typed array */
+void unc0_inittarray(Unc_View *w, Unc_TypedArray *a,
+                     Unc_Entity *blob, int kind) {
+    unsigned s = 0;
+    Unc_Size z = unc0_taelemsize(kind);
+    while (((Unc_Size)1 << s) < z)
+        ++s;
+    ASSERT(((Unc_Size)1 << s) == z);
+    a->blob = blob;
+    a->kind = kind;
+    a->shift = s;
+}
+
+Unc_RetVal unc0_wraptarray(Unc_View *w, Unc_Value *blob, int kind,
+                           Unc_Value *out) {
+    Unc_RetVal e;
+    Unc_Value v;
+    ASSERT(VGETTYPE(blob) == Unc_TBlob);
+    e = unc0_vrefnew(w, &v, Unc_TTypedArray);
+    if (e) return e;
+    VINCREF(w, blob);
+    unc0_inittarray(w, LEFTOVER(Unc_TypedArray, VGETENT(&v)),
+                    VGETENT(blob), kind);
+    VMOVE(w, out, &v);
+    return 0;
+}
+
+Unc_RetVal unc0_newtarray(Unc_View *w, int kind, Unc_Size n,
+                          byte **p, Unc_Value *out) {
+    Unc_RetVal e;
+    Unc_Value b = UNC_BLANK;
+    Unc_Size z = unc0_taelemsize(kind);
+    if (n > UNC_SIZE_MAX / z)
+        return UNCIL_ERR_MEM;
+    *p = NULL;
+    e = unc_newblob(w, &b, n * z, p);
+    if (e) return e;
+    unc_unlock(w, &b);
+    e = unc0_wraptarray(w, &b, kind, out);
+    VCLEAR(w, &b);
+    return e;
+}
+
+void unc0_droptarray(Unc_View *w, Unc_TypedArray *a) {
+    UNCIL_DECREFE(w, a->blob);
+}
+
+void unc0_sunsettarray(Unc_Allocator *alloc, Unc_TypedArray *a) {
+    /* the blob is its own entity and is freed separately */
+    (void)alloc;
+    (void)a;
+}
+
+/* blob data comes from the allocator, so it is suitably aligned for the
+   element types */
+void unc0_taload(int kind, const byte *p, Unc_Size i, Unc_Value *v) {
+    switch (kind) {
+    case UNC_TA_INT:
+        VINITINT(v, ((const Unc_Int *)p)[i]);
+        break;
+    case UNC_TA_FLOAT:
+        VINITFLT(v, ((const Unc_Float *)p)[i]);
+        break;
+    case UNC_TA_INT8:
+        VINITINT(v, ((const signed char *)p)[i]);
+        break;
+    case UNC_TA_UINT8:
+        VINITINT(v, p[i]);
+        break;
+    case UNC_TA_INT16:
+        VINITINT(v, ((const ta_i16 *)p)[i]);
+        break;
+    case UNC_TA_UINT16:
+        VINITINT(v, ((const ta_u16 *)p)[i]);
+        break;
+    case UNC_TA_INT32:
+        VINITINT(v, ((const ta_i32 *)p)[i]);
+        break;
+    case UNC_TA_UINT32:
+        VINITINT(v, ((const ta_u32 *)p)[i]);
+        break;
+    case UNC_TA_FLOAT32:
+        VINITFLT(v, ((const float *)p)[i]);
+        break;
+    default:
+        NEVER_();
+    }
+}
+
+/* out-of-range conversions to float are undefined, so saturate to inf */
+INLINE float unc0_tafloat32(Unc_Float f) {
+    if (f > FLT_MAX)
+        return (float)unc0_finfty();
+    if (f < -FLT_MAX)
+        return (float)-unc0_finfty();
+    return (float)f;
+}
+
+Unc_RetVal unc0_tastore(int kind, byte *p, Unc_Size i, Unc_Value *v) {
+    Unc_Int x;
+    if (unc0_takindisfloat(kind)) {
+        Unc_Float f;
+        switch (VGETTYPE(v)) {
+        case Unc_TInt:
+            f = (Unc_Float)VGETINT(v);
+            break;
+        case Unc_TFloat:
+            f = VGETFLT(v);
+            break;
+        default:
+            return UNCIL_ERR_CONVERT_TOFLOAT;
+        }
+        if (kind == UNC_TA_FLOAT)
+            ((Unc_Float *)p)[i] = f;
+        else
+            ((float *)p)[i] = unc0_tafloat32(f);
+        return 0;
+    }
+    if (VGETTYPE(v) != Unc_TInt)
+        return UNCIL_ERR_CONVERT_TOINT;
+    x = VGETINT(v);
+    switch (kind) {
+    case UNC_TA_INT:
+        ((Unc_Int *)p)[i] = x;
+        return 0;
+    case UNC_TA_INT8:
+        if (x < -128 || x > 127) break;
+        ((signed char *)p)[i] = (signed char)x;
+        return 0;
+    case UNC_TA_UINT8:
+        if (x < 0 || x > 255) break;
+        p[i] = (byte)x;
+        return 0;
+    case UNC_TA_INT16:
+        if (x < -32768L || x > 32767L) break;
+        ((ta_i16 *)p)[i] = (ta_i16)x;
+        return 0;
+    case UNC_TA_UINT16:
+        if (x < 0 || x > 65535L) break;
+        ((ta_u16 *)p)[i] = (ta_u16)x;
+        return 0;
+    case UNC_TA_INT32:
+        if (x < -2147483647L - 1 || x > 2147483647L) break;
+        ((ta_i32 *)p)[i] = (ta_i32)x;
+        return 0;
+    case UNC_TA_UINT32:
+        if (x < 0 || (Unc_UInt)x > 4294967295UL) break;
+        ((ta_u32 *)p)[i] = (ta_u32)x;
+        return 0;
+    default:
+        NEVER_();
+    }
+    return UNCIL_ERR_ARG_INTOVERFLOW;
+}
+
+Unc_RetVal unc0_taerror(Unc_View *w, Unc_RetVal e) {
+    switch (e) {
+    case UNCIL_ERR_CONVERT_TOINT:
+        return unc0_throwexc(w, "type",
+            "typed array value must be an integer");
+    case UNCIL_ERR_CONVERT_TOFLOAT:
+        return unc0_throwexc(w, "type",
+            "typed array value must be a number");
+    case UNCIL_ERR_ARG_INTOVERFLOW:
+        return unc0_throwexc(w, "value",
+            "value out of range for typed array");
+    default:
+        return e;
+    }
+}
+
+Unc_Size unc0_talength(Unc_TypedArray *a) {
+    return LEFTOVER(Unc_Blob, a->blob)->size >> a->shift;
+}
+
+Unc_RetVal unc0_taget(Unc_View *w, Unc_TypedArray *a, Unc_Int i,
+                      int permissive, Unc_Value *out) {
+    Unc_Blob *b = LEFTOVER(Unc_Blob, a->blob);
+    Unc_Size n;
+    Unc_Value v;
+    UNC_LOCKL(b->lock);
+    n = b->size >> a->shift;
+    if (i < 0)
+        i += n;
+    if (i < 0 || (Unc_UInt)i >= n) {
+        UNC_UNLOCKL(b->lock);
+        if (permissive) {
+            VSETNULL(w, out);
+            return 0;
+        }
+        return UNCIL_ERR_ARG_INDEXOUTOFBOUNDS;
+    }
+    unc0_taload(a->kind, b->data, (Unc_Size)i, &v);
+    UNC_UNLOCKL(b->lock);
+    VMOVE(w, out, &v);
+    return 0;
+}
+
+Unc_RetVal unc0_taset(Unc_View *w, Unc_TypedArray *a, Unc_Int i,
+                      Unc_Value *v) {
+    Unc_Blob *b = LEFTOVER(Unc_Blob, a->blob);
+    Unc_Size n;
+    Unc_RetVal e;
+    UNC_LOCKL(b->lock);
+    n = b->size >> a->shift;
+    if (i < 0)
+        i += n;
+    if (i < 0 || (Unc_UInt)i >= n) {
+        UNC_UNLOCKL(b->lock);
+        return UNCIL_ERR_ARG_INDEXOUTOFBOUNDS;
+    }
+    e = unc0_tastore(a->kind, b->data, (Unc_Size)i, v);
+    UNC_UNLOCKL(b->lock);
+    return e ? unc0_taerror(w, e) : 0;
+}
+
+Unc_RetVal unc0_tagetindx(Unc_View *w, Unc_TypedArray *a,
+                          Unc_Value *indx, int permissive, Unc_Value *out) {
+    Unc_Int i;
+    Unc_RetVal e = unc0_vgetint(w, indx, &i);
+    if (e) {
+        if (e == UNCIL_ERR_CONVERT_TOINT)
+            e = UNCIL_ERR_ARG_INDEXNOTINTEGER;
+        return e;
+    }
+    return unc0_taget(w, a, i, permissive, out);
+}
+
+Unc_RetVal unc0_tasetindx(Unc_View *w, Unc_TypedArray *a,
+                          Unc_Value *indx, Unc_Value *v) {
+    Unc_Int i;
+    Unc_RetVal e = unc0_vgetint(w, indx, &i);
+    if (e) {
+        if (e == UNCIL_ERR_CONVERT_TOINT)
+            e = UNCIL_ERR_ARG_INDEXNOTINTEGER;
+        return e;
+    }
+    return unc0_taset(w, a, i, v);
+}
@@ -0,0 +1,110 @@
+/*******************************************************************************
+ 
+Uncil -- typed array header
+
+Copyright (c) 2021-2023 Sampo Hippeläinen (hisahi)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*******************************************************************************/
+
+#ifndef UNCIL_UTARR_H
+#define UNCIL_UTARR_H
+
+#include "udef.h"
+#include "umem.h"
+#include "umt.h"
+#include "uval.h"
+
+/* element kinds */
+#define UNC_TA_INT              0       /* Unc_Int */
+#define UNC_TA_FLOAT            1       /* Unc_Float */
+#define UNC_TA_INT8             2
+#define UNC_TA_UINT8            3
+#define UNC_TA_INT16            4
+#define UNC_TA_UINT16           5
+#define UNC_TA_INT32            6
+#define UNC_TA_UINT32           7
+#define UNC_TA_FLOAT32          8
+#define UNC_TA_KINDS            9
+
+/* element types for the 16 and 32-bit kinds */
+#if UNCIL_C99 && defined(INT32_MAX)
+typedef int16_t ta_i16;
+typedef uint16_t ta_u16;
+typedef int32_t ta_i32;
+typedef uint32_t ta_u32;
+#else
+typedef short ta_i16;
+typedef unsigned short ta_u16;
+#if INT_MAX == 2147483647
+typedef int ta_i32;
+typedef unsigned ta_u32;
+#else
+typedef long ta_i32;
+typedef unsigned long ta_u32;
+#endif
+#endif
+
+/* a typed array stores its elements unboxed in a blob, which it shares
+   (blob() and fromblob() do not copy). the length is derived from the
+   size of the blob, and the blob lock also guards the elements */
+typedef struct Unc_TypedArray {
+    Unc_Entity *blob;
+    int kind;
+    unsigned shift;     /* log2 of element size */
+} Unc_TypedArray;
+
+struct Unc_View;
+
+int unc0_takindbyname(Unc_Size n, const byte *s);
+const char *unc0_takindname(int kind);
+Unc_Size unc0_taelemsize(int kind);
+int unc0_takindisfloat(int kind);
+
+void unc0_inittarray(struct Unc_View *w, Unc_TypedArray *a,
+                     Unc_Entity *blob, int kind);
+/* makes a new typed array of the given kind over the blob */
+Unc_RetVal unc0_wraptarray(struct Unc_View *w, Unc_Value *blob, int kind,
+                           Unc_Value *out);
+/* makes a new typed array with n elements in a new blob. the data of the
+   blob is returned in *p and is not initialized */
+Unc_RetVal unc0_newtarray(struct Unc_View *w, int kind, Unc_Size n,
+                          byte **p, Unc_Value *out);
+void unc0_droptarray(struct Unc_View *w, Unc_TypedArray *a);
+void unc0_sunsettarray(Unc_Allocator *alloc, Unc_TypedArray *a);
+
+/* element i of data p. taload does not decref v */
+void unc0_taload(int kind, const byte *p, Unc_Size i, Unc_Value *v);
+Unc_RetVal unc0_tastore(int kind, byte *p, Unc_Size i, Unc_Value *v);
+/* turns an error from tastore into an exception */
+Unc_RetVal unc0_taerror(struct Unc_View *w, Unc_RetVal e);
+
+/* like array indexing, single element access does not lock */
+Unc_Size unc0_talength(Unc_TypedArray *a);
+Unc_RetVal unc0_taget(struct Unc_View *w, Unc_TypedArray *a, Unc_Int i,
+                      int permissive, Unc_Value *out);
+Unc_RetVal unc0_taset(struct Unc_View *w, Unc_TypedArray *a, Unc_Int i,
+                      Unc_Value *v);
+Unc_RetVal unc0_tagetindx(struct Unc_View *w, Unc_TypedArray *a,
+                          Unc_Value *indx, int permissive, Unc_Value *out);
+Unc_RetVal unc0_tasetindx(struct Unc_View *w, Unc_TypedArray *a,
+                          Unc_Value *indx, Unc_Value *v);
+
+#endif /* UNCIL_UTARR_H */
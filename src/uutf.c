@@ -26,8 +26,16 @@ SOFTWARE.
 
 #define UNCIL_DEFINES
 
+#include "ucompdef.h"
 #include "uutf.h"
 
+#if UNCIL_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#if UNCIL_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
 Unc_Size unc0_utf8enc(Unc_UChar u, Unc_Size n, byte *out) {
     Unc_Size i = 0;
     if (u < 0x80UL) {
@@ -210,13 +218,141 @@ const byte *unc0_utf8lastchar(const byte *sb, Unc_Size n) {
     return unc0_utf8scanbackw(sb, sb + n, 0);
 }
 
+#if UNCIL_SIMD_AVX2
+/* validates 32 bytes at a time, after Keiser & Lemire, "Validating UTF-8 In
+   Less Than One Instruction Per Byte" (2021). every pair of adjacent bytes
+   is classified with three table lookups (on the high and low nibble of the
+   first byte and the high nibble of the second) into the kinds of error it
+   could be part of. the tables are adjusted to accept what the scalar code
+   accepts, i.e. surrogates and code points up to 0x1FFFFF, and bytes
+   0xF8-0xFF are checked for separately.
+   returns the number of bytes checked (a multiple of 32). a sequence may
+   continue past them, so the caller must check the rest from the last
+   lead byte. *bad is set if an error was found */
+#define UTF8_TOO_SHORT 0x01     /* 11______ 0_______, 11______ 11______ */
+#define UTF8_TOO_LONG 0x02      /* 0_______ 10______ */
+#define UTF8_OVERLONG_3 0x04    /* 11100000 100_____ */
+#define UTF8_OVERLONG_2 0x20    /* 1100000_ 10______ */
+#define UTF8_OVERLONG_4 0x40    /* 11110000 1000____ */
+#define UTF8_TWO_CONTS 0x80     /* 10______ 10______ */
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+#define UTF8_TABLE(a0, a1, a2, a3, a4, a5, a6, a7,                            \
+                   a8, a9, aA, aB, aC, aD, aE, aF)                            \
+    _mm256_setr_epi8(a0, a1, a2, a3, a4, a5, a6, a7,                          \
+                     a8, a9, aA, aB, aC, aD, aE, aF,                          \
+                     a0, a1, a2, a3, a4, a5, a6, a7,                          \
+                     a8, a9, aA, aB, aC, aD, aE, aF)
+
+__attribute__((target("avx2")))
+static Unc_Size unc0_utf8validate_avx2(const byte *s, Unc_Size n, int *bad) {
+    /* high nibble of first byte */
+    const __m256i t1 = UTF8_TABLE(
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        (char)UTF8_TWO_CONTS, (char)UTF8_TWO_CONTS,
+        (char)UTF8_TWO_CONTS, (char)UTF8_TWO_CONTS,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+        UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_3,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_4);
+    /* low nibble of first byte */
+    const __m256i t2 = UTF8_TABLE(
+        (char)(UTF8_CARRY | UTF8_OVERLONG_2 | UTF8_OVERLONG_3
+                          | UTF8_OVERLONG_4),
+        (char)(UTF8_CARRY | UTF8_OVERLONG_2),
+        (char)UTF8_CARRY, (char)UTF8_CARRY,
+        (char)UTF8_CARRY, (char)UTF8_CARRY,
+        (char)UTF8_CARRY, (char)UTF8_CARRY,
+        (char)UTF8_CARRY, (char)UTF8_CARRY,
+        (char)UTF8_CARRY, (char)UTF8_CARRY,
+        (char)UTF8_CARRY, (char)UTF8_CARRY,
+        (char)UTF8_CARRY, (char)UTF8_CARRY);
+    /* high nibble of second byte */
+    const __m256i t3 = UTF8_TABLE(
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS
+                             | UTF8_OVERLONG_3 | UTF8_OVERLONG_4),
+        (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS
+                             | UTF8_OVERLONG_3),
+        (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS),
+        (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS),
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT);
+    /* sequences that the last bytes of a block begin, but do not end */
+    const __m256i tail = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        (char)0xEF, (char)0xDF, (char)0xBF);
+    const __m256i nib = _mm256_set1_epi8(0x0F);
+    __m256i prev = _mm256_setzero_si256(), err = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    Unc_Size i;
+    for (i = 0; i + 32 <= n; i += 32) {
+        __m256i in = _mm256_loadu_si256((const __m256i *)(s + i));
+        if (!_mm256_movemask_epi8(in)) {
+            /* all ASCII; only check that the previous block ended well */
+            err = _mm256_or_si256(err, incomplete);
+            incomplete = _mm256_setzero_si256();
+        } else {
+            __m256i p = _mm256_permute2x128_si256(prev, in, 0x21);
+            __m256i p1 = _mm256_alignr_epi8(in, p, 15);
+            __m256i p2 = _mm256_alignr_epi8(in, p, 14);
+            __m256i p3 = _mm256_alignr_epi8(in, p, 13);
+            __m256i sc = _mm256_and_si256(_mm256_and_si256(
+                _mm256_shuffle_epi8(t1, _mm256_and_si256(
+                                    _mm256_srli_epi16(p1, 4), nib)),
+                _mm256_shuffle_epi8(t2, _mm256_and_si256(p1, nib))),
+                _mm256_shuffle_epi8(t3, _mm256_and_si256(
+                                    _mm256_srli_epi16(in, 4), nib)));
+            /* the third and fourth bytes of 3- and 4-byte sequences must
+               be continuation bytes, and are the only ones that may follow
+               a continuation byte */
+            __m256i must = _mm256_and_si256(_mm256_or_si256(
+                _mm256_subs_epu8(p2, _mm256_set1_epi8((char)(0xE0 - 0x80))),
+                _mm256_subs_epu8(p3, _mm256_set1_epi8((char)(0xF0 - 0x80)))),
+                _mm256_set1_epi8((char)0x80));
+            err = _mm256_or_si256(err, _mm256_xor_si256(must, sc));
+            err = _mm256_or_si256(err,
+                    _mm256_subs_epu8(in, _mm256_set1_epi8((char)0xF7)));
+            incomplete = _mm256_subs_epu8(in, tail);
+        }
+        prev = in;
+    }
+    *bad = !_mm256_testz_si256(err, err);
+    return i;
+}
+#endif
+
 int unc0_utf8validate(Unc_Size n, const char *s) {
     int c;
     unsigned j;
     Unc_UChar u, m;
+#if UNCIL_SIMD_AVX2
+    if (n >= 64 && HAVE_AVX2()) {
+        int bad;
+        Unc_Size i = unc0_utf8validate_avx2((const byte *)s, n, &bad), k;
+        if (bad) return 1;
+        /* back up to the lead byte of a sequence that the blocks cut off */
+        for (k = 1; k <= 3; ++k) {
+            byte b = (byte)s[i - k];
+            if (b < 0x80) break;
+            if (b >= 0xC0) {
+                if ((b >= 0xF0 ? 4 : b >= 0xE0 ? 3 : 2) > k) i -= k;
+                break;
+            }
+        }
+        s += i;
+        n -= i;
+    }
+#endif
     while (n--) {
         c = *s++;
         if (!(c & 0x80)) {
+#if UNCIL_SIMD_SSE2
+            while (n >= 16 && !_mm_movemask_epi8(
+                                _mm_loadu_si128((const __m128i *)s)))
+                s += 16, n -= 16;
+#endif
             continue;
         } else if ((c & 0xE0) == 0xC0) {
             j = 1;
@@ -332,11 +468,63 @@ Unc_Size unc0_utf8reshift(const byte *s, Unc_Size z, Unc_Size n) {
     return sp - s;
 }
 
-Unc_Size unc0_utf8unshift(const byte *s, Unc_Size n) {
+#if UNCIL_SIMD_AVX2
+/* number of continuation bytes in the first n - n % 32 bytes of s */
+__attribute__((target("avx2")))
+static Unc_Size unc0_utf8conts_avx2(const byte *s, Unc_Size n) {
+    const __m256i lim = _mm256_set1_epi8(-64), zero = _mm256_setzero_si256();
     Unc_Size q = 0;
+    n /= 32;
+    while (n) {
+        /* count per byte lane for at most 255 blocks, then sum up */
+        Unc_Size k = n < 255 ? n : 255;
+        __m256i acc = zero;
+        n -= k;
+        for (; k; --k, s += 32)
+            acc = _mm256_sub_epi8(acc, _mm256_cmpgt_epi8(lim,
+                        _mm256_loadu_si256((const __m256i *)s)));
+        acc = _mm256_sad_epu8(acc, zero);
+        {
+            __m128i h = _mm_add_epi64(_mm256_castsi256_si128(acc),
+                                      _mm256_extracti128_si256(acc, 1));
+            q += (Unc_Size)_mm_cvtsi128_si32(h)
+               + (Unc_Size)_mm_cvtsi128_si32(_mm_srli_si128(h, 8));
+        }
+    }
+    return q;
+}
+#endif
+
+/* number of code points in the n bytes at s */
+Unc_Size unc0_utf8unshift(const byte *s, Unc_Size n) {
+    Unc_Size q = n;
+#if UNCIL_SIMD_AVX2
+    if (n >= 256 && HAVE_AVX2()) {
+        q -= unc0_utf8conts_avx2(s, n);
+        s += n - n % 32;
+        n %= 32;
+    }
+#endif
+#if UNCIL_SIMD_SSE2
+    {
+        /* continuation bytes are the signed bytes below -64 */
+        const __m128i lim = _mm_set1_epi8(-64), zero = _mm_setzero_si128();
+        while (n >= 16) {
+            Unc_Size k = n / 16 < 255 ? n / 16 : 255;
+            __m128i acc = zero;
+            n -= k * 16;
+            for (; k; --k, s += 16)
+                acc = _mm_sub_epi8(acc, _mm_cmplt_epi8(
+                            _mm_loadu_si128((const __m128i *)s), lim));
+            acc = _mm_sad_epu8(acc, zero);
+            q -= (Unc_Size)_mm_cvtsi128_si32(acc)
+               + (Unc_Size)_mm_cvtsi128_si32(_mm_srli_si128(acc, 8));
+        }
+    }
+#endif
     while (n--)
-        if ((*s++ & 0xC0) != 0x80)
-            ++q;
+        if ((*s++ & 0xC0) == 0x80)
+            --q;
     return q;
 }
 
@@ -37,6 +37,7 @@ SOFTWARE.
 #include "uobj.h"
 #include "uopaque.h"
 #include "ustr.h"
+#include "utarr.h"
 #include "uval.h"
 #include "uvali.h"
 #include "uvop.h"
@@ -113,6 +114,10 @@ INLINE size_t entitysize(Unc_ValueType type) {
         return ASIZEOF(Unc_Entity) + sizeof(Unc_WeakCounter);
     case Unc_TBoundFunction:
         return ASIZEOF(Unc_Entity) + sizeof(Unc_FunctionBound);
+    case Unc_TTypedArray:
+        return ASIZEOF(Unc_Entity) + sizeof(Unc_TypedArray);
+    case Unc_TArrayView:
+        return ASIZEOF(Unc_Entity) + sizeof(Unc_ArrayView);
     default:
         NEVER_();
     }
@@ -137,8 +142,10 @@ void unc0_scrap(Unc_Entity *e, Unc_Allocator *alloc, Unc_View *w) {
             unc0_unbind(e, w), --w->recurse;
         break;
     case Unc_TString:
-        if (w) --w->recurse;
-        unc0_dropstring(alloc, LEFTOVER(Unc_String, e));
+        if (w)
+            unc0_dropstring(w, LEFTOVER(Unc_String, e)), --w->recurse;
+        else
+            unc0_sunsetstring(alloc, LEFTOVER(Unc_String, e));
         break;
     case Unc_TBlob:
         if (w) --w->recurse;
@@ -190,6 +197,18 @@ void unc0_scrap(Unc_Entity *e, Unc_Allocator *alloc, Unc_View *w) {
         else
             unc0_sunsetbfunc(alloc, LEFTOVER(Unc_FunctionBound, e));
         break;
+    case Unc_TTypedArray:
+        if (w)
+            unc0_droptarray(w, LEFTOVER(Unc_TypedArray, e)), --w->recurse;
+        else
+            unc0_sunsettarray(alloc, LEFTOVER(Unc_TypedArray, e));
+        break;
+    case Unc_TArrayView:
+        if (w)
+            unc0_droparrayview(w, LEFTOVER(Unc_ArrayView, e)), --w->recurse;
+        else
+            unc0_sunsetarrayview(alloc, LEFTOVER(Unc_ArrayView, e));
+        break;
     default:
         break;
     }
@@ -255,24 +274,41 @@ void unc0_wreck(Unc_Entity *e, struct Unc_World *w) {
     unc0_efree(e, &w->alloc);
 }
 
+/* an entity under construction is not reachable yet, so a collection
+   triggered by allocations made while initializing it would scrap it.
+   pinning keeps it alive until it has been stored somewhere */
+void unc0_pin(Unc_Entity *e, struct Unc_View *w) {
+    e->creffed = 1;
+    e->vid = w->vid;
+}
+
+void unc0_unpin(Unc_Entity *e, struct Unc_View *w) {
+    (void)prepent(w, e);
+}
+
 void unc0_unwake(Unc_Entity *e, struct Unc_View *w) {
+    /* e may already have been scrapped, so we must not pause here; a
+       collection during the pause would free e under us. if the lock is
+       busy, leave e on the list as sleeping for the GC to free */
 #if DEBUG_NO_SLEEPERS
-    (void)UNC_LOCKFP(w, w->world->entity_lock);
-    unc0_wreck(e, w->world);
-    UNC_UNLOCKF(w->world->entity_lock);
+    e->mark = SLEEPING;
+    if (UNC_LOCKFQ(w->world->entity_lock)) {
+        unc0_wreck(e, w->world);
+        UNC_UNLOCKF(w->world->entity_lock);
+    }
 #else
     int i = w->sleeper_next;
+    e->mark = SLEEPING;
     if (w->sleepers[i]) {
-        if (!UNC_LOCKFP(w, w->world->entity_lock) || w->sleepers[i]) {
-            ASSERT(w->sleepers[i]->mark == SLEEPING);
-            unc0_wreck(w->sleepers[i], w->world);
-            --w->entityload;
-        }
+        if (!UNC_LOCKFQ(w->world->entity_lock))
+            return;
+        ASSERT(w->sleepers[i]->mark == SLEEPING);
+        unc0_wreck(w->sleepers[i], w->world);
+        --w->entityload;
         UNC_UNLOCKF(w->world->entity_lock);
     }
     w->sleepers[i] = e;
     w->sleeper_next = (i + 1) % UNC_SLEEPER_VALUES;
-    e->mark = SLEEPING;
 #endif
 }
 
@@ -298,7 +334,9 @@ static const char * const unc0_valueRefTypeNames[] = {
     "function",
     "opaque",
     "weakref",
-    "boundfunction"
+    "boundfunction",
+    "typedarray",
+    "arrayview"
 };
 
 const char *unc0_getvaluetypename(Unc_ValueType t) {
@@ -377,7 +415,16 @@ Unc_RetVal unc0_hashvalue(Unc_View *w, Unc_Value *v, unsigned *hash) {
     case Unc_TString:
     {
         Unc_String *s = LEFTOVER(Unc_String, VGETENT(v));
-        *hash = unc0_hashstr(s->size, unc0_getstringdata(s));
+        /* strings are immutable, so the hash only needs to be computed
+           once. it is published with a single atomic store, so a nonzero
+           hash is always complete, and racing threads store the same one */
+        unsigned h = (unsigned)ATOMICLLOAD(s->hash);
+        if (!h) {
+            h = unc0_hashstr(w->world->hashseed, s->size,
+                             unc0_getstringdata(s));
+            ATOMICLSET(s->hash, h);
+        }
+        *hash = h;
         return 0;
     }
     case Unc_TObject:
@@ -408,6 +455,8 @@ Unc_RetVal unc0_hashvalue(Unc_View *w, Unc_Value *v, unsigned *hash) {
     case Unc_TBoundFunction:
     case Unc_TOpaquePtr:
     case Unc_TWeakRef:
+    case Unc_TTypedArray:
+    case Unc_TArrayView:
         return UNCIL_ERR_UNHASHABLE;
     default:
         NEVER();
@@ -449,6 +498,10 @@ int unc0_vcvt2bool(Unc_View *w, Unc_Value *v) {
         return LEFTOVER(Unc_Blob, VGETENT(v))->size != 0;
     case Unc_TArray:
         return LEFTOVER(Unc_Array, VGETENT(v))->size != 0;
+    case Unc_TTypedArray:
+        return unc0_talength(LEFTOVER(Unc_TypedArray, VGETENT(v))) != 0;
+    case Unc_TArrayView:
+        return unc0_avlength(LEFTOVER(Unc_ArrayView, VGETENT(v))) != 0;
     case Unc_TTable:
         return LEFTOVER(Unc_Dict, VGETENT(v))->data.entries != 0;
     case Unc_TObject:
@@ -499,6 +552,8 @@ Unc_RetVal unc0_vgetint(Unc_View *w, Unc_Value *v, Unc_Int *out) {
     case Unc_TOpaquePtr:
     case Unc_TWeakRef:
     case Unc_TBoundFunction:
+    case Unc_TTypedArray:
+    case Unc_TArrayView:
         return UNCIL_ERR_CONVERT_TOINT;
     default:
         NEVER_();
@@ -527,6 +582,8 @@ Unc_RetVal unc0_vgetfloat(Unc_View *w, Unc_Value *v, Unc_Float *out) {
     case Unc_TOpaquePtr:
     case Unc_TWeakRef:
     case Unc_TBoundFunction:
+    case Unc_TTypedArray:
+    case Unc_TArrayView:
         return UNCIL_ERR_CONVERT_TOFLOAT;
     default:
         NEVER_();
@@ -49,8 +49,10 @@ typedef enum Unc_ValueType {
     Unc_TOpaque         = -7,
     Unc_TWeakRef        = -8,
     Unc_TBoundFunction  = -9,
+    Unc_TTypedArray     = -10,
+    Unc_TArrayView      = -11,
     /* types below are not externally visible, internal use only */
-    Unc_TRef            = -10
+    Unc_TRef            = -12
 } Unc_ValueType;
 typedef signed short Unc_ValueTypeSmall;
 
@@ -97,6 +99,8 @@ void unc0_scrap(Unc_Entity *e, Unc_Allocator *alloc, struct Unc_View *w);
 void unc0_efree(Unc_Entity *e, Unc_Allocator *alloc);
 void unc0_hibernate(Unc_Entity *e, struct Unc_View *w);
 void unc0_unwake(Unc_Entity *e, struct Unc_View *w);
+void unc0_pin(Unc_Entity *e, struct Unc_View *w);
+void unc0_unpin(Unc_Entity *e, struct Unc_View *w);
 void unc0_fetchweak(struct Unc_View *w, Unc_Value *wp, Unc_Value *dst);
 
 /* these functions DO NOT lock! */
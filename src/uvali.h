@@ -115,10 +115,11 @@ SOFTWARE.
    should not be used for any other purpose than the aforementioned one */
 #define VCLEAR(w, D) do { Unc_Value *t_N_ = (D); VDECREF(w, t_N_);             \
                           VINITFAST(t_N_); } while (0)
-/* assign value without incref */
-#define VMOVE(w, D, V) do { Unc_Value *v2_ = (D);                              \
+/* assign value without incref. V is read before D is decref'd, since D may
+   hold the only reference to the entity that V lives in */
+#define VMOVE(w, D, V) do { Unc_Value *v2_ = (D), r2_ = VGETRAW(V);            \
                             VDECREF(w, v2_);                                   \
-                            VSETRAW(v2_, VGETRAW(V)); } while (0)
+                            VSETRAW(v2_, r2_); } while (0)
 /* assign value with incref */
 #define VCOPY(w, D, V) do { Unc_Value *v1_ = (V);                              \
                             VINCREF(w, v1_);                                   \
@@ -55,14 +55,19 @@ Unc_World *unc0_launch(Unc_Alloc allocfn, void *udata) {
     world->view = NULL;
     world->viewlast = NULL;
     world->wmode = 0;
+    world->hashseed = unc0_hashseed(world);
     if ((e = UNC_LOCKINITF(world->viewlist_lock))) goto unc0_launch_fail_l0;
     if ((e = UNC_LOCKINITF(world->public_lock))) goto unc0_launch_fail_l1;
     if ((e = UNC_LOCKINITF(world->entity_lock))) goto unc0_launch_fail_l2;
+    if ((e = UNC_LOCKINITF(world->intern_lock))) goto unc0_launch_fail_l3;
     unc0_inithtbls(&alloc, &world->pubs);
+    unc0_inithtbli(&world->interns);
     VINITNULL(&world->met_str);
     VINITNULL(&world->met_blob);
     VINITNULL(&world->met_arr);
     VINITNULL(&world->met_table);
+    VINITNULL(&world->met_tarr);
+    VINITNULL(&world->met_aview);
     VINITNULL(&world->io_file);
     world->ccxt.alloc = NULL;
     unc0_inithtbls(&alloc, &world->modulecache);
@@ -76,6 +81,8 @@ Unc_World *unc0_launch(Unc_Alloc allocfn, void *udata) {
     return world;
 
 unc0_launch_fail:
+    UNC_LOCKFINAF(world->intern_lock);
+unc0_launch_fail_l3:
     UNC_LOCKFINAF(world->entity_lock);
 unc0_launch_fail_l2:
     UNC_LOCKFINAF(world->public_lock);
@@ -184,6 +191,8 @@ Unc_View *unc0_newview(Unc_World *w, Unc_ViewType vtype) {
     view->met_blob = w->met_blob;
     view->met_arr = w->met_arr;
     view->met_table = w->met_table;
+    view->met_tarr = w->met_tarr;
+    view->met_aview = w->met_aview;
     view->uncfname = NULL;
     view->trampoline = NULL;
     if (!(view->vtype = vtype))
@@ -209,26 +218,29 @@ Unc_View *unc0_newview(Unc_World *w, Unc_ViewType vtype) {
         /* look for free ID */
         Unc_Size s = 0;
         Unc_View *lv = w->viewlast;
-        view->vid = w->vnid;
-        while (lv) {
-            if (lv->vid == s) {
-                lv = lv->prevview;
-                ++s;
-            } else {
-                view->vid = s;
-                break;
-            }
+        while (lv && lv->vid == s) {
+            lv = lv->prevview;
+            ++s;
         }
-        if (!lv || view->vid == w->vnid) {
+        if (s >= w->vnid) {
             NEVER_();
             goto fail5;
         }
-        view->prevview = lv;
-        if ((view->nextview = lv->nextview))
-            lv->nextview->prevview = view;
-        else
-            w->viewlast = view;
-        lv->nextview = view;
+        view->vid = s;
+        if (!lv) {
+            /* the free ID is above all of the ones in use */
+            if ((view->nextview = w->view))
+                view->nextview->prevview = view;
+            view->prevview = NULL;
+            w->view = view;
+        } else {
+            view->prevview = lv;
+            if ((view->nextview = lv->nextview))
+                lv->nextview->prevview = view;
+            else
+                w->viewlast = view;
+            lv->nextview = view;
+        }
     }
     if (!w->viewlast) w->viewlast = view;
     ++w->viewc;
@@ -237,6 +249,8 @@ Unc_View *unc0_newview(Unc_World *w, Unc_ViewType vtype) {
     VINCREF(view, &view->met_blob);
     VINCREF(view, &view->met_arr);
     VINCREF(view, &view->met_table);
+    VINCREF(view, &view->met_tarr);
+    VINCREF(view, &view->met_aview);
     return view;
 fail5:
 #if UNCIL_MT_OK
@@ -342,7 +356,9 @@ void unc0_scuttle(Unc_View *v, Unc_World *w) {
         unc0_efree(e, &alloc);
         e = ee;
     }
+    unc0_drophtbli(&alloc, &w->interns);
     
+    UNC_LOCKFINAF(w->intern_lock);
     UNC_LOCKFINAF(w->entity_lock);
     UNC_LOCKFINAF(w->public_lock);
     UNC_LOCKFINAF(w->viewlist_lock);
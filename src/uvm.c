@@ -42,6 +42,7 @@ SOFTWARE.
 #include "uobj.h"
 #include "uops.h"
 #include "ustr.h"
+#include "utarr.h"
 #include "uvali.h"
 #include "uview.h"
 #include "uvlq.h"
@@ -274,13 +275,17 @@ MAYBEINLINE Unc_Frame *unc0_exitframe1(Unc_View *w, Unc_Value *wv) {
         unc0_vmrestoredepth(w, &w->sval, f->sval_r);
     } else {
         Unc_RetVal e;
+        Unc_Value tmp;
         ASSERT(ft == Unc_FrameCallSpew || ft == Unc_FrameMain);
+        /* wv may be a register holding the only reference to the value */
+        VIMPOSE(w, &tmp, wv);
         unc0_vmrestoredepth(w, &w->sreg, f->sreg_r);
         /* unc0_vmshrinksregheuristic(w, f->sreg_r); */
         unc0_vmrestoredepth(w, &w->sval, f->sval_r);
-        e = unc0_stackpushv(w, &w->sval, wv);
+        e = unc0_stackpushv(w, &w->sval, &tmp);
         ASSERT(!e); /* we reserved the space, it should be there */
         (void)e;
+        VDECREF(w, &tmp);
     }
     return f;
 }
@@ -704,6 +709,45 @@ void unc0_loadstrpx(const byte *offp, Unc_Size *l, const byte **b) {
     unc0_loadstrp(offp, l, b);
 }
 
+static Unc_RetVal unc0_loadistrslow(Unc_View *w, Unc_Size off,
+                                    Unc_Value *v) {
+    Unc_Program *p = w->program;
+    Unc_Entity *e;
+    Unc_Size sl;
+    const byte *sb;
+    Unc_RetVal r;
+    unc0_loadstr(w, off, &sl, &sb);
+    r = unc0_intern(w, sl, sb, &e);
+    if (r) return r;
+    /* entries only ever go from NULL to an interned string, which lives as
+       long as the world does, so readers do not need the lock */
+    (void)UNC_LOCKFP(w, w->world->intern_lock);
+    if (!p->istrs && p->data_sz) {
+        p->istrs = TMALLOCZ(Unc_Entity *, &w->world->alloc,
+                            Unc_AllocInternal, p->data_sz);
+        if (p->istrs) p->istrs_n = p->data_sz;
+    }
+    if (off < p->istrs_n)
+        p->istrs[off] = e;
+    UNC_UNLOCKF(w->world->intern_lock);
+    v->type = Unc_TString;
+    VGETENT(v) = e;
+    return 0;
+}
+
+/* loads the string at the given offset as an interned string. no new
+   reference is taken; the world keeps it alive */
+FORCEINLINE Unc_RetVal unc0_loadistr(Unc_View *w, Unc_Size off,
+                                     Unc_Value *v) {
+    Unc_Program *p = w->program;
+    if (off < p->istrs_n && p->istrs[off]) {
+        v->type = Unc_TString;
+        VGETENT(v) = p->istrs[off];
+        return 0;
+    }
+    return unc0_loadistrslow(w, off, v);
+}
+
 FORCEINLINE Unc_Size unc0_diffregion(Unc_View *w) {
     ASSERT(w->region.top >= w->region.base ||
         !(w->frames.top > w->frames.base &&
@@ -1309,6 +1353,8 @@ unc0_vveq_o:
     case Unc_TTable:
     case Unc_TFunction:
     case Unc_TWeakRef:
+    case Unc_TTypedArray:
+    case Unc_TArrayView:
         return VGETTYPE(a) == VGETTYPE(b) && VGETENT(a) == VGETENT(b);
     case Unc_TBoundFunction:
         if (VGETTYPE(a) != VGETTYPE(b))
@@ -1617,10 +1663,22 @@ static void unc0_vmobcat(Unc_View *w, jmp_buf *env,
     switch (VGETTYPE(a)) {
     case Unc_TString:
         if (VGETTYPE(b) == Unc_TString) {
+            Unc_Entity *ea = VGETENT(a);
+            /* s = s ~ t: if the register holds the only reference to s,
+               nobody can see it change, so append to it in place */
+            if (tr == a && ea != VGETENT(b) && ea->refs == 1 && !ea->weaks
+                    && unc0_strcanappend(LEFTOVER(Unc_String, ea))) {
+                Unc_String *sb = LEFTOVER(Unc_String, VGETENT(b));
+                e = unc0_strappend(&w->world->alloc,
+                                   LEFTOVER(Unc_String, ea),
+                                   sb->size, unc0_getstringdata(sb));
+                if (e) THROWERRVMPC(e);
+                return;
+            }
             e = makestrcatss(w, &out, LEFTOVER(Unc_String, VGETENT(a)),
                                       LEFTOVER(Unc_String, VGETENT(b)));
             if (e) THROWERRVMPC(e);
-            VCOPY(w, tr, &out);
+            VMOVE(w, tr, &out);
             return;
         }
         THROWERRVMPC(unc0_err_unsup2(w, VGETTYPE(a), VGETTYPE(b)));
@@ -1629,7 +1687,7 @@ static void unc0_vmobcat(Unc_View *w, jmp_buf *env,
             e = makeblobcatss(w, &out, LEFTOVER(Unc_Blob, VGETENT(a)),
                                        LEFTOVER(Unc_Blob, VGETENT(b)));
             if (e) THROWERRVMPC(e);
-            VCOPY(w, tr, &out);
+            VMOVE(w, tr, &out);
             return;
         }
         THROWERRVMPC(unc0_err_unsup2(w, VGETTYPE(a), VGETTYPE(b)));
@@ -1638,7 +1696,7 @@ static void unc0_vmobcat(Unc_View *w, jmp_buf *env,
             e = makearrcatss(w, &out, LEFTOVER(Unc_Array, VGETENT(a)),
                                       LEFTOVER(Unc_Array, VGETENT(b)));
             if (e) THROWERRVMPC(e);
-            VCOPY(w, tr, &out);
+            VMOVE(w, tr, &out);
             return;
         }
         THROWERRVMPC(unc0_err_unsup2(w, VGETTYPE(a), VGETTYPE(b)));
@@ -1712,7 +1770,9 @@ INLINE void dofmake(Unc_View *w, jmp_buf *env, Unc_Value *tr,
     Unc_RetVal e;
     Unc_Entity *en = unc0_wake(w, Unc_TFunction);
     if (!en) THROWERRVMPC(UNCIL_ERR_MEM);
+    unc0_pin(en, w);
     e = unc0_initfuncu(w, LEFTOVER(Unc_Function, en), w->program, offset, 0);
+    unc0_unpin(en, w);
     if (UNLIKELY(e)) {
         unc0_unwake(en, w);
         THROWERRVMPC(e);
@@ -1877,11 +1937,11 @@ FORCEINLINE void checkstackge(Unc_View *w, jmp_buf *env, Unc_Size n,
 }
 
 INLINE void dondict(Unc_View *w, jmp_buf *env, Unc_Value *tr,
-                    const byte *vmpc) {
+                    Unc_Size n, const byte *vmpc) {
     Unc_RetVal e;
     Unc_Entity *en = unc0_wake(w, Unc_TTable);
     if (!en) THROWERRVMPC(UNCIL_ERR_MEM);
-    e = unc0_initdict(w, LEFTOVER(Unc_Dict, en));
+    e = unc0_initdictn(w, LEFTOVER(Unc_Dict, en), n);
     if (UNLIKELY(e)) {
         unc0_unwake(en, w);
         THROWERRVMPC(e);
@@ -2045,7 +2105,7 @@ INLINE void unc0_unrecover(Unc_View *w) {
     OD_(LSPRS   )   OD_(LSPR    )   OD_(CSTK    )   OD_(CSTKG   )              \
     OD_(MLIST   )   OD_(NDICT   )   OD_(MLISTP  )   OD_(IITER   )              \
     OD_(FMAKE   )   OD_(FBIND   )   OD_(INEXTS  )   OD_(INEXT   )              \
-    OD_(DCALLS  )   OD_(DCALL   )   OD_(DTAIL   )   OI_(xDB)                   \
+    OD_(DCALLS  )   OD_(DCALL   )   OD_(DTAIL   )   OD_(NDICTN  )                   \
     OD_(FCALLS  )   OD_(FCALL   )   OD_(FTAIL   )   OI_(xDF)                   \
     OI_(xE0)        OI_(xE1)        OI_(xE2)        OI_(xE3)                   \
     OI_(xE4)        OI_(xE5)        OI_(xE6)        OI_(xE7)                   \
@@ -2167,13 +2227,10 @@ nextinstr:
     {
         unsigned tmp;
         Unc_Value *s = GETREG();
-        Unc_Size sl;
-        const byte *sb;
-        Unc_Value v = UNC_BLANK;
-        unc0_loadstr(w, GETVLQ(), &sl, &sb);
+        Unc_Value v;
         CHECKPAUSE();
-        MUST(unc_newstring(w, &v, sl, (const char *)sb));
-        VMOVE(w, s, &v);
+        MUST(unc0_loadistr(w, GETVLQ(), &v));
+        VCOPY(w, s, &v);
         GOTONEXT();
     }
     OPCODE(LDNUL)
@@ -2223,10 +2280,9 @@ nextinstr:
         unsigned tmp;
         Unc_Value *s = GETREG();
         Unc_Value *a = GETREG();
-        Unc_Size sl;
-        const byte *sb;
-        unc0_loadstr(w, GETVLQ(), &sl, &sb);
-        MUST(unc0_vgetattr(w, a, sl, sb, 0, s));
+        Unc_Value i;
+        MUST(unc0_loadistr(w, GETVLQ(), &i));
+        MUST(unc0_vgetattri(w, a, &i, 0, s));
         GOTONEXT();
     }
     OPCODE(LDATTRQ)
@@ -2234,10 +2290,9 @@ nextinstr:
         unsigned tmp;
         Unc_Value *s = GETREG();
         Unc_Value *a = GETREG();
-        Unc_Size sl;
-        const byte *sb;
-        unc0_loadstr(w, GETVLQ(), &sl, &sb);
-        MUST(unc0_vgetattr(w, a, sl, sb, 1, s));
+        Unc_Value i;
+        MUST(unc0_loadistr(w, GETVLQ(), &i));
+        MUST(unc0_vgetattri(w, a, &i, 1, s));
         GOTONEXT();
     }
     OPCODE(LDINDX)
@@ -2245,7 +2300,15 @@ nextinstr:
         Unc_Value *s = GETREG();
         Unc_Value *a = GETREG();
         Unc_Value *b = GETREG();
-        MUST(unc0_vgetindx(w, a, b, 0, s));
+        if (VGETTYPE(a) == Unc_TTypedArray && VGETTYPE(b) == Unc_TInt) {
+            MUST(unc0_taget(w, LEFTOVER(Unc_TypedArray, VGETENT(a)),
+                            VGETINT(b), 0, s));
+        } else if (VGETTYPE(a) == Unc_TArrayView && VGETTYPE(b) == Unc_TInt) {
+            MUST(unc0_avget(w, LEFTOVER(Unc_ArrayView, VGETENT(a)),
+                            VGETINT(b), 0, s));
+        } else {
+            MUST(unc0_vgetindx(w, a, b, 0, s));
+        }
         GOTONEXT();
     }
     OPCODE(LDINDXQ)
@@ -2253,7 +2316,15 @@ nextinstr:
         Unc_Value *s = GETREG();
         Unc_Value *a = GETREG();
         Unc_Value *b = GETREG();
-        MUST(unc0_vgetindx(w, a, b, 1, s));
+        if (VGETTYPE(a) == Unc_TTypedArray && VGETTYPE(b) == Unc_TInt) {
+            MUST(unc0_taget(w, LEFTOVER(Unc_TypedArray, VGETENT(a)),
+                            VGETINT(b), 1, s));
+        } else if (VGETTYPE(a) == Unc_TArrayView && VGETTYPE(b) == Unc_TInt) {
+            MUST(unc0_avget(w, LEFTOVER(Unc_ArrayView, VGETENT(a)),
+                            VGETINT(b), 1, s));
+        } else {
+            MUST(unc0_vgetindx(w, a, b, 1, s));
+        }
         GOTONEXT();
     }
     OPCODE(MOV)
@@ -2280,11 +2351,10 @@ nextinstr:
         unsigned tmp;
         Unc_Value *s = GETREG();
         Unc_Value *a = GETREG();
-        Unc_Size sl;
-        const byte *sb;
-        unc0_loadstr(w, GETVLQ(), &sl, &sb);
+        Unc_Value i;
         CHECKPAUSE();
-        MUST(unc0_vsetattr(w, a, sl, sb, s));
+        MUST(unc0_loadistr(w, GETVLQ(), &i));
+        MUST(unc0_vsetattrv(w, a, &i, s));
         GOTONEXT();
     }
     OPCODE(STWITH)
@@ -2301,7 +2371,15 @@ nextinstr:
         Unc_Value *a = GETREG();
         Unc_Value *b = GETREG();
         CHECKPAUSE();
-        MUST(unc0_vsetindx(w, a, b, s));
+        if (VGETTYPE(a) == Unc_TTypedArray && VGETTYPE(b) == Unc_TInt) {
+            MUST(unc0_taset(w, LEFTOVER(Unc_TypedArray, VGETENT(a)),
+                            VGETINT(b), s));
+        } else if (VGETTYPE(a) == Unc_TArrayView && VGETTYPE(b) == Unc_TInt) {
+            MUST(unc0_avset(w, LEFTOVER(Unc_ArrayView, VGETENT(a)),
+                            VGETINT(b), s));
+        } else {
+            MUST(unc0_vsetindx(w, a, b, s));
+        }
         GOTONEXT();
     }
     OPCODE(STSTK)
@@ -2339,11 +2417,10 @@ nextinstr:
     {
         unsigned tmp;
         Unc_Value *a = GETREG();
-        Unc_Size sl;
-        const byte *sb;
-        unc0_loadstr(w, GETVLQ(), &sl, &sb);
+        Unc_Value i;
         CHECKPAUSE();
-        MUST(unc0_vdelattr(w, a, sl, sb));
+        MUST(unc0_loadistr(w, GETVLQ(), &i));
+        MUST(unc0_vdelattrv(w, a, &i));
         GOTONEXT();
     }
     OPCODE(DEINDX)
@@ -2359,11 +2436,10 @@ nextinstr:
         unsigned tmp;
         Unc_Value *s = GETREG();
         Unc_Value *a = GETREG();
-        Unc_Size sl;
-        const byte *sb;
-        unc0_loadstr(w, GETVLQ(), &sl, &sb);
+        Unc_Value i;
         CHECKPAUSE();
-        MUST(unc0_vgetattrf(w, a, sl, sb, 0, s));
+        MUST(unc0_loadistr(w, GETVLQ(), &i));
+        MUST(unc0_vgetattrfi(w, a, &i, 0, s));
         GOTONEXT();
     }
     OPCODE(ADD_RR)
@@ -2730,7 +2806,16 @@ nextinstr:
     {
         Unc_Value *s = GETREG();
         CHECKPAUSE();
-        dondict(w, &env, s, pc);
+        dondict(w, &env, s, 0, pc);
+        GOTONEXT();
+    }
+    OPCODE(NDICTN)
+    {
+        unsigned tmp;
+        Unc_Value *s = GETREG();
+        Unc_Size n = GETVLQ();
+        CHECKPAUSE();
+        dondict(w, &env, s, n, pc);
         GOTONEXT();
     }
     OPCODE(MLISTP)
@@ -2774,10 +2859,13 @@ nextinstr:
         Unc_Value *t = GETREG();
         const byte *tpc = w->jbase + GETJUMPDST(w), *rpc = (pc += JUMPWIDTH);
         Unc_Size sd = unc0_stackdepth(&w->sval);
-        Unc_Frame *oldtop = w->frames.top;
+        Unc_Size oldtop_r = w->frames.top - w->frames.base;
+        Unc_Frame *oldtop;
         pc += JUMPWIDTH;
         CHECKPAUSE();
         dofcall(w, &env, 0, 1, 0, t, &rpc);
+        /* the frame stack may have been reallocated */
+        oldtop = w->frames.base + oldtop_r;
         if (oldtop == w->frames.top) {
             /* C call */
             if (sd == unc0_stackdepth(&w->sval))
@@ -2796,9 +2884,12 @@ nextinstr:
         Unc_Value *t = GETREG();
         const byte *tpc = w->jbase + GETJUMPDST(w), *rpc = (pc += JUMPWIDTH);
         Unc_Size sd = unc0_stackdepth(&w->sval);
-        Unc_Frame *oldtop = w->frames.top;
+        Unc_Size oldtop_r = w->frames.top - w->frames.base;
+        Unc_Frame *oldtop;
         CHECKPAUSE();
         dofcall(w, &env, 0, 1, 0, t, &rpc);
+        /* the frame stack may have been reallocated */
+        oldtop = w->frames.base + oldtop_r;
         if (oldtop == w->frames.top) {
             /* C call */
             if (sd == unc0_stackdepth(&w->sval)) {
@@ -2842,11 +2933,13 @@ nextinstr:
         Unc_Size argc = *pc++;
         Unc_Value *t = GETREG();
         Unc_Frame *oldtop;
+        Unc_Size oldtop_r;
         Unc_FramePartial f;
         const byte *rpc = pc;
         CHECKPAUSE();
         unc0_unwindtotry(w);
         oldtop = --w->frames.top;
+        oldtop_r = oldtop - w->frames.base;
         unc0_dotailpre(w, &f, oldtop);
         if (unc0_shouldexitonpframe(&f)) {
             /* if we are in main, we need to catch errors */
@@ -2868,6 +2961,8 @@ nextinstr:
         } else
             dofcall(w, &env, argc,
                 unc0_shouldspewonpframe(&f), f.target, t, &rpc);
+        /* the frame stack may have been reallocated */
+        oldtop = w->frames.base + oldtop_r;
         if (UNLIKELY(oldtop == w->frames.top)) {
             /* recover from C call */
             if (unc0_shouldexitonpframe(&f))
@@ -2906,11 +3001,13 @@ nextinstr:
         Unc_Size argc = unc0_diffregion(w);
         Unc_Value *t = GETREG();
         Unc_Frame *oldtop;
+        Unc_Size oldtop_r;
         Unc_FramePartial f;
         const byte *rpc = pc;
         CHECKPAUSE();
         unc0_unwindtotry(w);
         oldtop = --w->frames.top;
+        oldtop_r = oldtop - w->frames.base;
         unc0_dotailpre(w, &f, oldtop);
         if (unc0_shouldexitonpframe(&f)) {
             /* if we are in main, we need to catch errors */
@@ -2932,6 +3029,8 @@ nextinstr:
         } else
             dofcall(w, &env, argc,
                 unc0_shouldspewonpframe(&f), f.target, t, &rpc);
+        /* the frame stack may have been reallocated */
+        oldtop = w->frames.base + oldtop_r;
         if (UNLIKELY(oldtop == w->frames.top)) {
             /* recover from C call */
             if (unc0_shouldexitonpframe(&f))
@@ -3045,7 +3144,6 @@ nextinstr:
     OPCODEINV(xBD)
     OPCODEINV(xBE)
     OPCODEINV(xBF)
-    OPCODEINV(xDB)
     OPCODEINV(xDF)
     OPCODEINV(xE0)
     OPCODEINV(xE1)
@@ -3105,7 +3203,9 @@ vmerror:
         f = unc0_unwindframeerr(w);
         if (f->type == Unc_FrameTry) {
             /* try block */
+            Unc_Size ro = w->regs - w->sreg.base;
             unc0_vmshrinksreg(w);
+            w->regs = w->sreg.base + ro;
             VCOPY(w, w->regs, &w->exc);
             pc = w->jbase + f->target;
             regs = w->regs;
@@ -35,6 +35,7 @@ SOFTWARE.
 #include "uobj.h"
 #include "uopaque.h"
 #include "ustr.h"
+#include "utarr.h"
 #include "uvali.h"
 #include "uvm.h"
 #include "uvop.h"
@@ -65,7 +66,7 @@ INLINE int unc0_vvcmpe_(Unc_View *w, Unc_Value *a, Unc_Value *b, int e) {
     case Unc_TFloat:
         switch (VGETTYPE(b)) {
         case Unc_TInt:
-            return unc0_cmpflt(VGETINT(a), VGETFLT(b));
+            return unc0_cmpflt(VGETFLT(a), VGETINT(b));
         case Unc_TFloat:
             return unc0_cmpflt(VGETFLT(a), VGETFLT(b));
         default:
@@ -100,7 +101,7 @@ unc0_vvcmp_o:
             case Unc_TInt:
                 return unc0_cmpint(VGETINT(&vout), 0);
             case Unc_TFloat:
-                return unc0_cmpflt(VGETINT(&vout), 0);
+                return unc0_cmpflt(VGETFLT(&vout), 0);
             default:
                 break;
             }
@@ -143,6 +144,10 @@ Unc_RetVal unc0_vgetattrf(Unc_View *w, Unc_Value *a,
         return unc0_vgetattr(w, &w->world->met_arr, sl, sb, q, v);
     case Unc_TTable:
         return unc0_vgetattr(w, &w->world->met_table, sl, sb, q, v);
+    case Unc_TTypedArray:
+        return unc0_vgetattr(w, &w->world->met_tarr, sl, sb, q, v);
+    case Unc_TArrayView:
+        return unc0_vgetattr(w, &w->world->met_aview, sl, sb, q, v);
     case Unc_TObject:
     case Unc_TOpaque:
         return unc0_vgetattr(w, a, sl, sb, q, v);
@@ -307,6 +312,45 @@ Unc_RetVal unc0_vdelattrv(Unc_View *w, Unc_Value *a, Unc_Value *i) {
     }
 }
 
+/* i is an interned string. tables and objects can look it up as a value,
+   which is faster, since its hash is known and it compares by identity */
+Unc_RetVal unc0_vgetattri(Unc_View *w, Unc_Value *a, Unc_Value *i, int q,
+                          Unc_Value *v) {
+    switch (VGETTYPE(a)) {
+    case Unc_TTable:
+    case Unc_TObject:
+        return unc0_vgetattrv(w, a, i, q, v);
+    default:
+    {
+        Unc_String *s = LEFTOVER(Unc_String, VGETENT(i));
+        return unc0_vgetattr(w, a, s->size, unc0_getstringdata(s), q, v);
+    }
+    }
+}
+
+Unc_RetVal unc0_vgetattrfi(Unc_View *w, Unc_Value *a, Unc_Value *i, int q,
+                           Unc_Value *v) {
+    switch (VGETTYPE(a)) {
+    case Unc_TString:
+        return unc0_vgetattri(w, &w->world->met_str, i, q, v);
+    case Unc_TBlob:
+        return unc0_vgetattri(w, &w->world->met_blob, i, q, v);
+    case Unc_TArray:
+        return unc0_vgetattri(w, &w->world->met_arr, i, q, v);
+    case Unc_TTable:
+        return unc0_vgetattri(w, &w->world->met_table, i, q, v);
+    case Unc_TTypedArray:
+        return unc0_vgetattri(w, &w->world->met_tarr, i, q, v);
+    case Unc_TArrayView:
+        return unc0_vgetattri(w, &w->world->met_aview, i, q, v);
+    case Unc_TObject:
+    case Unc_TOpaque:
+        return unc0_vgetattri(w, a, i, q, v);
+    default:
+        return UNCIL_ERR_ARG_NOTATTRABLE;
+    }
+}
+
 Unc_RetVal unc0_vgetindx(Unc_View *w, Unc_Value *a, Unc_Value *i,
                          int q, Unc_Value *v) {
     switch (VGETTYPE(a)) {
@@ -316,6 +360,12 @@ Unc_RetVal unc0_vgetindx(Unc_View *w, Unc_Value *a, Unc_Value *i,
         return unc0_blgetbyte(w, LEFTOVER(Unc_Blob, VGETENT(a)), i, q, v);
     case Unc_TArray:
         return unc0_agetindx(w, LEFTOVER(Unc_Array, VGETENT(a)), i, q, v);
+    case Unc_TTypedArray:
+        return unc0_tagetindx(w, LEFTOVER(Unc_TypedArray, VGETENT(a)),
+                              i, q, v);
+    case Unc_TArrayView:
+        return unc0_avgetindx(w, LEFTOVER(Unc_ArrayView, VGETENT(a)),
+                              i, q, v);
     case Unc_TTable: {
         Unc_Value r = UNC_BLANK;
         Unc_RetVal e;
@@ -367,6 +417,10 @@ Unc_RetVal unc0_vsetindx(Unc_View *w, Unc_Value *a,
     }
     case Unc_TArray:
         return unc0_asetindx(w, LEFTOVER(Unc_Array, VGETENT(a)), i, v);
+    case Unc_TTypedArray:
+        return unc0_tasetindx(w, LEFTOVER(Unc_TypedArray, VGETENT(a)), i, v);
+    case Unc_TArrayView:
+        return unc0_avsetindx(w, LEFTOVER(Unc_ArrayView, VGETENT(a)), i, v);
     case Unc_TTable:
         return unc0_dsetindx(w, LEFTOVER(Unc_Dict, VGETENT(a)), i, v);
     case Unc_TObject:
@@ -380,6 +434,8 @@ Unc_RetVal unc0_vdelindx(Unc_View *w, Unc_Value *a, Unc_Value *i) {
     switch (VGETTYPE(a)) {
     case Unc_TString:
     case Unc_TBlob:
+    case Unc_TTypedArray:
+    case Unc_TArrayView:
         return UNCIL_ERR_ARG_CANNOTDELETEINDEX;
     case Unc_TArray:
     {
@@ -399,6 +455,8 @@ Unc_RetVal unc0_iter_string(Unc_View *w, Unc_Tuple args, void *udata);
 Unc_RetVal unc0_iter_blob(Unc_View *w, Unc_Tuple args, void *udata);
 Unc_RetVal unc0_iter_array(Unc_View *w, Unc_Tuple args, void *udata);
 Unc_RetVal unc0_iter_table(Unc_View *w, Unc_Tuple args, void *udata);
+Unc_RetVal unc0_iter_tarray(Unc_View *w, Unc_Tuple args, void *udata);
+Unc_RetVal unc0_iter_aview(Unc_View *w, Unc_Tuple args, void *udata);
 
 Unc_RetVal unc0_vgetiter(Unc_View *w, Unc_Value *out, Unc_Value *in) {
     switch (VGETTYPE(in)) {
@@ -411,10 +469,12 @@ Unc_RetVal unc0_vgetiter(Unc_View *w, Unc_Value *out, Unc_Value *in) {
         
         VIMPOSE(w, &initvalues[0], in);
         VINITINT(&initvalues[1], 0);
+        unc0_pin(en, w);
         e = unc0_initfuncc(w, LEFTOVER(Unc_Function, en), 
                     &unc0_iter_string, 0, 0, 0,
                     0, NULL, 2, initvalues, 0, NULL,
                     "(string iterator)", NULL);
+        unc0_unpin(en, w);
         if (e) {
             unc0_unwake(en, w);
             return e;
@@ -431,10 +491,12 @@ Unc_RetVal unc0_vgetiter(Unc_View *w, Unc_Value *out, Unc_Value *in) {
         
         VIMPOSE(w, &initvalues[0], in);
         VINITINT(&initvalues[1], 0);
+        unc0_pin(en, w);
         e = unc0_initfuncc(w, LEFTOVER(Unc_Function, en), 
                     &unc0_iter_blob, 0, 0, 0,
                     0, NULL, 2, initvalues, 0, NULL,
                     "(blob iterator)", NULL);
+        unc0_unpin(en, w);
         if (e) {
             unc0_unwake(en, w);
             return e;
@@ -451,10 +513,56 @@ Unc_RetVal unc0_vgetiter(Unc_View *w, Unc_Value *out, Unc_Value *in) {
         
         VIMPOSE(w, &initvalues[0], in);
         VINITINT(&initvalues[1], 0);
+        unc0_pin(en, w);
         e = unc0_initfuncc(w, LEFTOVER(Unc_Function, en), 
                     &unc0_iter_array, 0, 0, 0,
                     0, NULL, 2, initvalues, 0, NULL,
                     "(array iterator)", NULL);
+        unc0_unpin(en, w);
+        if (e) {
+            unc0_unwake(en, w);
+            return e;
+        }
+        VSETENT(w, out, Unc_TFunction, en);
+        return 0;
+    }
+    case Unc_TTypedArray:
+    {
+        Unc_RetVal e;
+        Unc_Entity *en = unc0_wake(w, Unc_TFunction);
+        Unc_Value initvalues[2];
+        if (!en) return UNCIL_ERR_MEM;
+        
+        VIMPOSE(w, &initvalues[0], in);
+        VINITINT(&initvalues[1], 0);
+        unc0_pin(en, w);
+        e = unc0_initfuncc(w, LEFTOVER(Unc_Function, en), 
+                    &unc0_iter_tarray, 0, 0, 0,
+                    0, NULL, 2, initvalues, 0, NULL,
+                    "(typed array iterator)", NULL);
+        unc0_unpin(en, w);
+        if (e) {
+            unc0_unwake(en, w);
+            return e;
+        }
+        VSETENT(w, out, Unc_TFunction, en);
+        return 0;
+    }
+    case Unc_TArrayView:
+    {
+        Unc_RetVal e;
+        Unc_Entity *en = unc0_wake(w, Unc_TFunction);
+        Unc_Value initvalues[2];
+        if (!en) return UNCIL_ERR_MEM;
+        
+        VIMPOSE(w, &initvalues[0], in);
+        VINITINT(&initvalues[1], 0);
+        unc0_pin(en, w);
+        e = unc0_initfuncc(w, LEFTOVER(Unc_Function, en), 
+                    &unc0_iter_aview, 0, 0, 0,
+                    0, NULL, 2, initvalues, 0, NULL,
+                    "(array view iterator)", NULL);
+        unc0_unpin(en, w);
         if (e) {
             unc0_unwake(en, w);
             return e;
@@ -466,17 +574,18 @@ Unc_RetVal unc0_vgetiter(Unc_View *w, Unc_Value *out, Unc_Value *in) {
     {
         Unc_RetVal e;
         Unc_Entity *en = unc0_wake(w, Unc_TFunction);
-        Unc_Value initvalues[4];
+        Unc_Value initvalues[3];
         if (!en) return UNCIL_ERR_MEM;
         
         VIMPOSE(w, &initvalues[0], in);
-        VINITINT(&initvalues[1], -1);
-        VINITPTR(&initvalues[2], NULL);
-        VINITINT(&initvalues[3], LEFTOVER(Unc_Dict, VGETENT(in))->generation);
+        VINITINT(&initvalues[1], 0);
+        VINITINT(&initvalues[2], LEFTOVER(Unc_Dict, VGETENT(in))->generation);
+        unc0_pin(en, w);
         e = unc0_initfuncc(w, LEFTOVER(Unc_Function, en), 
                     &unc0_iter_table, 0, 0, 0,
-                    0, NULL, 4, initvalues, 0, NULL,
+                    0, NULL, 3, initvalues, 0, NULL,
                     "(table iterator)", NULL);
+        unc0_unpin(en, w);
         if (e) {
             unc0_unwake(en, w);
             return e;
@@ -55,6 +55,10 @@ Unc_RetVal unc0_vgetattrv(struct Unc_View *w, Unc_Value *a, Unc_Value *i,
 Unc_RetVal unc0_vsetattrv(struct Unc_View *w, Unc_Value *a, Unc_Value *i,
                                        Unc_Value *v);
 Unc_RetVal unc0_vdelattrv(struct Unc_View *w, Unc_Value *a, Unc_Value *i);
+Unc_RetVal unc0_vgetattri(struct Unc_View *w, Unc_Value *a, Unc_Value *i,
+                                int q, Unc_Value *v);
+Unc_RetVal unc0_vgetattrfi(struct Unc_View *w, Unc_Value *a, Unc_Value *i,
+                                int q, Unc_Value *v);
 Unc_RetVal unc0_vgetindx(struct Unc_View *w, Unc_Value *a, Unc_Value *i,
                                 int q, Unc_Value *v);
 Unc_RetVal unc0_vsetindx(struct Unc_View *w, Unc_Value *a, Unc_Value *i,
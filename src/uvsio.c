@@ -36,6 +36,7 @@ SOFTWARE.
 #include "udebug.h"
 #include "uobj.h"
 #include "ustr.h"
+#include "utarr.h"
 #include "uutf.h"
 #include "uval.h"
 #include "uvali.h"
@@ -165,14 +166,9 @@ static Unc_RetVal cvt2str_u2x(
 
 static Unc_RetVal cvt2str_f(int (*out)(Unc_Size n, const byte *s, void *udata),
             void *udata, Unc_Float f) {
-    struct printf_wrapper pf;
-    pf.udata = udata;
-    pf.out = out;
-    pf.e = 0;
-    unc0_xprintf(&printf_wrapper_f, &pf, 0, 0,
-                "%."EVALSTRINGIFY(DBL_DIG) PRIUnc_Float"g", f);
-    /*unc0_xprintf(&printf_wrapper_f, &pf, 0, "%"PRIUnc_Float"a", f);*/
-    return pf.e;
+    char buf[UNC_FTOASHORTEST_BUF];
+    Unc_Size n = unc0_ftoashortest(buf, f);
+    return (*out)(n, (const byte *)buf, udata);
 }
 
 #if !UNCIL_SANDBOXED
@@ -330,15 +326,19 @@ Unc_RetVal unc0_vcvt2strq(Unc_View *w, Unc_Value *in,
 
 Unc_RetVal unc0_vcvt2strobj(Unc_View *w, Unc_Value *in,
             int (*out)(Unc_Size n, const byte *s, void *udata), void *udata) {
-    void *arr_[32];
-    void **arr = arr_;
-    Unc_Size arr_c = ASIZEOF(arr), arr_n = 0;
+    /* the stack of containers being converted. each one is pushed after
+       the position to continue from */
+    union strobjsave {
+        void *p;
+        Unc_Size i;
+    } arr_[32], *arr = arr_;
+    Unc_Size arr_c = ARRAYSIZE(arr_), arr_n = 0;
     void *toplev;
 
     Unc_Value vx;
     Unc_ValueType intype;
-    Unc_Size bucket_i, bucket_c;
-    Unc_HTblV_V *dnext;
+    Unc_Size bucket_i, bucket_c = 0;
+    Unc_Value *dnext, dkey;
     Unc_Allocator *alloc = &w->world->alloc;
     int first;
     union {
@@ -350,7 +350,6 @@ Unc_RetVal unc0_vcvt2strobj(Unc_View *w, Unc_Value *in,
 
 strobjinit:
     first = 1;
-    dnext = NULL;
     intype = VGETTYPE(in);
     switch (intype) {
     case Unc_TArray:
@@ -362,12 +361,11 @@ strobjinit:
     case Unc_TTable:
         current.d = LEFTOVER(Unc_Dict, VGETENT(in));
         bucket_i = 0;
-        bucket_c = current.d->data.capacity;
         MUST(out(PASSSTRL("{"), udata));
         break;
     default:
         if (arr != arr_)
-            TMFREE(void *, &w->world->alloc, arr, arr_c);
+            TMFREE(union strobjsave, &w->world->alloc, arr, arr_c);
         NEVER();
     }
 
@@ -392,10 +390,10 @@ strobjcont:
             case Unc_TArray:
                 {
                     /* check for cycles */
-                    void *comp = LEFTOVER(void, VGETENT(&vx)),
-                         **x, **xe = &arr[arr_n];
-                    for (x = xe - 1; x >= arr; --x) {
-                        if (*x == comp) {
+                    void *comp = LEFTOVER(void, VGETENT(&vx));
+                    union strobjsave *x;
+                    for (x = &arr[arr_n] - 1; x >= arr; x -= 2) {
+                        if (x->p == comp) {
                             /* cycle! */
                             MUST(out(PASSSTRL("[...]"), udata));
                             goto strobjarrnosave;
@@ -409,13 +407,14 @@ strobjcont:
             case Unc_TTable:
                 /* save */
                 if (arr_n + 2 > arr_c) {
-                    void **np;
+                    union strobjsave *np;
                     Unc_Size z = arr_c + 32;
                     if (arr == arr_) {
-                        np = TMALLOC(void *, alloc, 0, z);
-                        if (np) TMEMCPY(void *, np, arr_, arr_c);
+                        np = TMALLOC(union strobjsave, alloc, 0, z);
+                        if (np) TMEMCPY(union strobjsave, np, arr_, arr_c);
                     } else
-                        np = TMREALLOC(void *, alloc, 0, arr, arr_c, z);
+                        np = TMREALLOC(union strobjsave, alloc, 0,
+                                       arr, arr_c, z);
                     if (!np) {
                         /* nope, cannot save */
                         if (VGETTYPE(&vx) == Unc_TTable)
@@ -428,8 +427,8 @@ strobjcont:
                         arr_c = z;
                     }
                 }
-                arr[arr_n++] = &current.a->data[bucket_i];
-                arr[arr_n++] = current.a;
+                arr[arr_n++].i = bucket_i;
+                arr[arr_n++].p = current.a;
                 ASSERT(UNLEFTOVER(current.a)->type == Unc_TArray);
                 in = &vx;
                 goto strobjinit;
@@ -446,8 +445,7 @@ strobjarrnosave:
         break;
     case Unc_TTable:
         for (;;) {
-            while (!dnext && bucket_i < bucket_c)
-                dnext = current.d->data.buckets[bucket_i++];
+            dnext = unc0_iterhtblv(&current.d->data, &bucket_i, &dkey);
             if (!dnext) { /* end of dict */
                 MUST(out(PASSSTRL("}"), udata));
                 break;
@@ -456,7 +454,7 @@ strobjarrnosave:
                 first = 0;
             else
                 MUST(out(PASSSTRL(", "), udata));
-            vx = dnext->key;
+            vx = dkey;
             switch (vx.type) {
             case Unc_TString:
                 MUST(unc0_vcvt2strrq(w, LEFTOVER(Unc_String, VGETENT(&vx)),
@@ -473,8 +471,7 @@ strobjarrnosave:
                 MUST(unc0_vcvt2str(w, &vx, out, udata));
             }
             MUST(out(PASSSTRL(": "), udata));
-            vx = dnext->val;
-            dnext = dnext->next;
+            vx = *dnext;
             switch (vx.type) {
             case Unc_TString:
                 MUST(unc0_vcvt2strrq(w, LEFTOVER(Unc_String, VGETENT(&vx)),
@@ -483,10 +480,10 @@ strobjarrnosave:
             case Unc_TTable:
                 {
                     /* check for cycles */
-                    void *comp = LEFTOVER(void, VGETENT(&vx)),
-                         **x, **xe = &arr[arr_n];
-                    for (x = xe - 1; x >= arr; --x) {
-                        if (*x == comp) {
+                    void *comp = LEFTOVER(void, VGETENT(&vx));
+                    union strobjsave *x;
+                    for (x = &arr[arr_n] - 1; x >= arr; x -= 2) {
+                        if (x->p == comp) {
                             /* cycle! */
                             MUST(out(PASSSTRL("{...}"), udata));
                             goto strobjdictnosave;
@@ -499,14 +496,15 @@ strobjarrnosave:
                 }
             case Unc_TArray:
                 /* save */
-                if (arr_n + 3 > arr_c) {
-                    void **np;
+                if (arr_n + 2 > arr_c) {
+                    union strobjsave *np;
                     Unc_Size z = arr_c + 32;
                     if (arr == arr_) {
-                        np = TMALLOC(void *, alloc, 0, z);
-                        if (np) TMEMCPY(void *, np, arr_, arr_c);
+                        np = TMALLOC(union strobjsave, alloc, 0, z);
+                        if (np) TMEMCPY(union strobjsave, np, arr_, arr_c);
                     } else
-                        np = TMREALLOC(void *, alloc, 0, arr, arr_c, z);
+                        np = TMREALLOC(union strobjsave, alloc, 0,
+                                       arr, arr_c, z);
                     if (!np) {
                         /* nope, cannot save */
                         if (VGETTYPE(&vx) == Unc_TTable)
@@ -519,9 +517,8 @@ strobjarrnosave:
                         arr_c = z;
                     }
                 }
-                arr[arr_n++] = dnext;
-                arr[arr_n++] = &current.d->data.buckets[bucket_i];
-                arr[arr_n++] = current.d;
+                arr[arr_n++].i = bucket_i;
+                arr[arr_n++].p = current.d;
                 ASSERT(UNLEFTOVER(current.d)->type == Unc_TTable);
                 in = &vx;
                 goto strobjinit;
@@ -538,26 +535,24 @@ strobjdictnosave:
         break;
     default:
         if (arr != arr_)
-            TMFREE(void *, &w->world->alloc, arr, arr_c);
+            TMFREE(union strobjsave, &w->world->alloc, arr, arr_c);
         NEVER();
     }
 
     if (arr_n) {
-        void *p = arr[--arr_n];
+        void *p = arr[--arr_n].p;
         Unc_Entity *e = UNLEFTOVER(p);
         intype = e->type;
 
         switch (e->type) {
         case Unc_TArray:
             current.a = (Unc_Array *)p;
-            bucket_i = (Unc_Value *)arr[--arr_n] - current.a->data;
+            bucket_i = arr[--arr_n].i;
             bucket_c = current.a->size;
             break;
         case Unc_TTable:
             current.d = (Unc_Dict *)p;
-            bucket_i = (Unc_HTblV_V **)arr[--arr_n] - current.d->data.buckets;
-            bucket_c = current.d->data.capacity;
-            dnext = arr[--arr_n];
+            bucket_i = arr[--arr_n].i;
             break;
         default:
             NEVER();
@@ -567,7 +562,7 @@ strobjdictnosave:
     }
 
     if (arr != arr_)
-        TMFREE(void *, &w->world->alloc, arr, arr_c);
+        TMFREE(union strobjsave, &w->world->alloc, arr, arr_c);
     return 0;
 }
 
@@ -613,6 +608,45 @@ Unc_RetVal unc0_vcvt2str(Unc_View *w, Unc_Value *in,
         UNC_UNLOCKL(s->lock);
         return 0;
     }
+    case Unc_TTypedArray:
+    {
+        Unc_RetVal e;
+        Unc_Size i, n;
+        Unc_TypedArray *a = LEFTOVER(Unc_TypedArray, VGETENT(in));
+        Unc_Blob *s = LEFTOVER(Unc_Blob, a->blob);
+        const char *kn = unc0_takindname(a->kind);
+        MUST(out(PASSSTRL("<typedarray("), udata));
+        MUST(out(unc0_strlen(kn), (const byte *)kn, udata));
+        MUST(out(PASSSTRL(", "), udata));
+        UNC_LOCKL(s->lock);
+        n = s->size >> a->shift;
+        e = cvt2str_u(out, udata, n);
+        if (!e)
+            e = n ? out(PASSSTRL(") ="), udata) : out(PASSSTRL(")>"), udata);
+        for (i = 0; !e && i < n; ++i) {
+            Unc_Value v;
+            unc0_taload(a->kind, s->data, i, &v);
+            e = out(PASSSTRL(" "), udata);
+            if (!e)
+                e = VGETTYPE(&v) == Unc_TInt
+                        ? cvt2str_i(out, udata, VGETINT(&v))
+                        : cvt2str_f(out, udata, VGETFLT(&v));
+        }
+        if (!e && n)
+            e = out(PASSSTRL(">"), udata);
+        UNC_UNLOCKL(s->lock);
+        return e;
+    }
+    case Unc_TArrayView:
+    {
+        /* the elements are not printed, since they may lead back here */
+        Unc_ArrayView *a = LEFTOVER(Unc_ArrayView, VGETENT(in));
+        MUST(out(PASSSTRL("<arrayview("), udata));
+        MUST(cvt2str_u(out, udata, a->offset));
+        MUST(out(PASSSTRL(", "), udata));
+        MUST(cvt2str_u(out, udata, unc0_avlength(a)));
+        return out(PASSSTRL(")>"), udata);
+    }
     case Unc_TObject:
     case Unc_TOpaque:
     {
@@ -75,4 +75,10 @@ size_t unc0_xsnprintf(char *out, size_t n, int gflags,
 size_t unc0_printf_specparse(unsigned *output, const char **p_format,
                              int gflags);
 
+/* enough for any output of unc0_ftoashortest, including the null */
+#define UNC_FTOASHORTEST_BUF 32
+/* writes the shortest decimal representation of x that reads back as x,
+   in the same layout as %.15g, and returns its length */
+size_t unc0_ftoashortest(char *out, Unc_Float x);
+
 #endif /* UNCIL_UXPRINTF_H */
@@ -29,6 +29,8 @@ SOFTWARE.
 
 #include <stdarg.h>
 
+#include "udef.h"
+
 #define UNC_SCANF_EOF ((size_t)(-1))
 
 size_t unc0_vxscanf(int (*getch)(void *data),
@@ -40,4 +42,32 @@ size_t unc0_xscanf(int (*getch)(void *data),
 
 size_t unc0_snscanf(const char *s, size_t n, const char *format, ...);
 
+/* the number of significant digits that unc0_decimaltof needs to always round
+   correctly. any digits after these only matter for whether they are zero */
+#define UNC_DECIMAL_DIGITS 768
+
+/* a decimal number being read in one digit at a time. its value is
+   0.(digits) * 10^point, the leading zeros of digits are omitted */
+struct unc0_decimal {
+    Unc_Size n;
+    long point;
+    int trunc; /* were any nonzero digits dropped after the stored ones? */
+    Unc_Byte digits[UNC_DECIMAL_DIGITS];
+};
+
+void unc0_decimalinit(struct unc0_decimal *d);
+/* adds the next digit (0-9). frac is nonzero after the decimal point */
+void unc0_decimaldigit(struct unc0_decimal *d, int digit, int frac);
+/* same as unc0_decimaldigit, with the common case inline */
+#define UNC0_DECIMALDIGIT(d, x, frac) do {                                     \
+        struct unc0_decimal *dD_ = (d);                                        \
+        if (dD_->n && dD_->n < UNC_DECIMAL_DIGITS) {                           \
+            dD_->digits[dD_->n++] = (Unc_Byte)(x);                             \
+            if (!(frac)) ++dD_->point;                                         \
+        } else                                                                 \
+            unc0_decimaldigit(dD_, (x), (frac));                               \
+    } while (0)
+/* returns d * 10^exp, correctly rounded */
+Unc_Float unc0_decimaltof(const struct unc0_decimal *d, long exp);
+
 #endif /* UNCIL_UXSCANF_H */